@@ -11,13 +11,18 @@ namespace deviceClientSDK {
 namespace bluetoothDevice {
 namespace blueZ {
 
+class BlueZDeviceManager;
+
 /**
  * BlueZ implementation of @c A2DPSinkInterface interface
  */
 class BlueZA2DPSink : public common::sdkInterfaces::bluetooth::services::A2DPSinkInterface {
 public:
     // factory method to create new instace of @c BlueZA2DPSink
-    static std::shared_ptr<BlueZA2DPSink> create();
+    static std::shared_ptr<BlueZA2DPSink> create(std::shared_ptr<BlueZDeviceManager> deviceManager);
+
+    // name A2DPSinkInterface functions.
+    bool setSourceStream(std::shared_ptr<common::utils::AudioInputStream> stream) override;
 
     // name BluetoothServiceInterface functions.
     std::shared_ptr<common::sdkInterfaces::bluetooth::services::SDPRecordInterface> getRecord() override;
@@ -26,10 +31,13 @@ public:
 
 private:
     // Private constructor.
-    BlueZA2DPSink();
+    BlueZA2DPSink(std::shared_ptr<BlueZDeviceManager> deviceManager);
 
     // Bluetooth service's SDP record containing the common service information.
     std::shared_ptr<common::utils::bluetooth::A2DPSinkRecord> m_record;
+
+    // A @c BlueZDeviceManager this instance belongs to.
+    std::shared_ptr<BlueZDeviceManager> m_deviceManager;
 };
 
 } // namespace blueZ
@@ -1,6 +1,8 @@
 #ifndef DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_BLUEZA2DPSOURCE_H_
 #define DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_BLUEZA2DPSOURCE_H_
 
+#include <string>
+
 #include <Common/SDKInterfaces/Bluetooth/Services/A2DPSourceInterface.h>
 #include <Common/Utils/Bluetooth/SDPRecords.h>
 #include <Common/Utils/Bluetooth/FormattedAudioStreamAdapter.h>
@@ -19,9 +21,12 @@ public:
     /**
      * Factory method to create a new instance of @c BlueZA2DPSource
      * @param deviceManager A @c BlueZDeviceManager this instance belongs to
+     * @param devicePath The DBus object path of the remote device streaming to this service.
      * @return A new instance of @c BlueZA2DPSource, nullptr if there was an error creating it.
      */
-    static std::shared_ptr<BlueZA2DPSource> create(std::shared_ptr<BlueZDeviceManager> deviceManager);
+    static std::shared_ptr<BlueZA2DPSource> create(
+        std::shared_ptr<BlueZDeviceManager> deviceManager,
+        const std::string& devicePath);
 
     /// @name A2DPSourceInterface functions.
     /// @{
@@ -43,8 +48,9 @@ private:
     /**
      * Private constructor
      * @param deviceManager A @c BlueZDeviceManager this instance belongs to
+     * @param devicePath The DBus object path of the remote device streaming to this service.
      */
-    BlueZA2DPSource(std::shared_ptr<BlueZDeviceManager> deviceManager);
+    BlueZA2DPSource(std::shared_ptr<BlueZDeviceManager> deviceManager, const std::string& devicePath);
 
     /**
      * Bluetooth service's SDP record containing the common service information.
@@ -55,6 +61,11 @@ private:
      * A @c BlueZDeviceManager this instance belongs to
      */
     std::shared_ptr<BlueZDeviceManager> m_deviceManager;
+
+    /**
+     * The DBus object path of the remote device, whose SINK @c MediaEndpoint carries the stream of this service.
+     */
+    const std::string m_devicePath;
 };
 
 } // namespace blueZ
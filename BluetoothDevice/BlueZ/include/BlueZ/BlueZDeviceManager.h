@@ -4,6 +4,7 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <vector>
 
 #include <Common/SDKInterfaces/Bluetooth/BluetoothDeviceInterface.h>
 #include <Common/SDKInterfaces/Bluetooth/BluetoothDeviceManagerInterface.h>
@@ -25,6 +26,7 @@ namespace bluetoothDevice {
 namespace blueZ {
 
 class MediaEndpoint;
+class MediaReactor;
 class BlueZBluetoothDevice;
 
 /**
@@ -54,9 +56,18 @@ public:
     // Get the @c BluetoothEventBus used by this device manager to post bluetooth related events.
     std::shared_ptr<common::utils::bluetooth::BluetoothEventBus> getEventBus();
 
-    // Get the SINK @c MediaEndPoint associated with the device manager.
+    // Get the first SINK @c MediaEndPoint associated with the device manager.
     std::shared_ptr<MediaEndpoint> getMediaEndpoint();
 
+    // Get all the SINK @c MediaEndPoint associated with the device manager, one per device streaming at once.
+    std::vector<std::shared_ptr<MediaEndpoint>> getSinkMediaEndpoints();
+
+    // Get the SINK @c MediaEndPoint configured for the device at @c devicePath, nullptr if there is none.
+    std::shared_ptr<MediaEndpoint> getSinkMediaEndpoint(const std::string& devicePath);
+
+    // Get the SOURCE @c MediaEndPoint associated with the device manager, nullptr if it could not be registered.
+    std::shared_ptr<MediaEndpoint> getSourceMediaEndpoint();
+
     // Get the DBus object path of the current bluetooth hardware adapter used by this device manager.
     std::string getAdapterPath() const;
 
@@ -72,6 +83,13 @@ private:
     // Finalize A2DP streaming related components.
     bool finalizeMedia();
 
+    // Register a @c MediaEndpoint for SBC with BlueZ, for the profile of @c uuid.
+    bool registerMediaEndpoint(std::shared_ptr<MediaEndpoint> endpoint, const std::string& uuid);
+
+    // Install the default processing of the audio received on a SINK @c MediaEndpoint: the speaker tuning, and the
+    // ducking driven by @c AUDIO_DUCKING_CHANGED events.
+    void installSinkProcessing(std::shared_ptr<MediaEndpoint> endpoint);
+
     // Helper method to create a @c BlueZBluetoothDevice class instance from DBus object provided by BlueZ.
     std::shared_ptr<BlueZBluetoothDevice> addDeviceFromDBusObject(const char* objectPath, GVariant* dbusObject);
 
@@ -162,9 +180,21 @@ private:
     // List of known device
     std::map<std::string, std::shared_ptr<BlueZBluetoothDevice>> m_devices;
 
-    // SINK media endpoint used for audio streaming
+    // Reactor driving the streams of all the media endpoints.
+    std::shared_ptr<MediaReactor> m_mediaReactor;
+
+    // First SINK media endpoint used for audio streaming
     std::shared_ptr<MediaEndpoint> m_mediaEndpoint;
 
+    // All the SINK media endpoints, the first one included.
+    std::vector<std::shared_ptr<MediaEndpoint>> m_sinkMediaEndpoints;
+
+    // The ducking stages of the SINK media endpoints, listening to @c m_eventBus.
+    std::vector<std::shared_ptr<common::utils::bluetooth::BluetoothEventListenerInterface>> m_duckingStages;
+
+    // SOURCE media endpoint used for audio streaming to remote sinks
+    std::shared_ptr<MediaEndpoint> m_sourceMediaEndpoint;
+
     // Pairing agent used for device paring.
     std::shared_ptr<PairingAgent> m_pairingAgent;
 
@@ -183,8 +213,8 @@ private:
     // DBus connection
     std::shared_ptr<DBusConnection> m_connection;
 
-    // Current streaming state
-    common::utils::bluetooth::MediaStreamingState m_streamingState;
+    // Current streaming state of each SINK media endpoint, by endpoint path.
+    std::map<std::string, common::utils::bluetooth::MediaStreamingState> m_streamingStates;
 
     // Mutex to synchronize known device list access.
     mutable std::mutex m_devicesMutex;
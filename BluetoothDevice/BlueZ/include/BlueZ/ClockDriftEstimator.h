@@ -0,0 +1,118 @@
+#ifndef DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_CLOCKDRIFTESTIMATOR_H_
+#define DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_CLOCKDRIFTESTIMATOR_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace deviceClientSDK {
+namespace bluetoothDevice {
+namespace blueZ {
+
+/**
+ * Estimates the rate of the sample clock of a remote A2DP source relative to the local monotonic clock the packets are
+ * timestamped with. The clock of the audio device which eventually plays the decoded audio out is not measured: its
+ * own drift from the monotonic clock, a few tens of ppm at most, is not compensated.
+ *
+ * The transit time of a packet, its arrival time minus its RTP timestamp converted to seconds at the nominal sample
+ * rate, varies with the network jitter, but its lower envelope only moves with the drift between the two clocks. The
+ * estimator keeps the smallest transit time of every window of @c WINDOW_DURATION, and fits a line through the last
+ * @c WINDOW_COUNT of them: its slope is the drift.
+ */
+class ClockDriftEstimator {
+public:
+    /// Clock the arrival times are measured with.
+    using Clock = std::chrono::steady_clock;
+
+    /// Duration over which the smallest transit time is kept.
+    static constexpr std::chrono::seconds WINDOW_DURATION{1};
+
+    /// Number of windows the drift is fitted over.
+    static constexpr size_t WINDOW_COUNT = 32;
+
+    /// Number of windows needed for a first estimate.
+    static constexpr size_t MIN_WINDOW_COUNT = 8;
+
+    /// Largest drift believed, as a fraction. Crystals are specified within 100ppm; anything far beyond is not drift.
+    static constexpr double MAX_DRIFT = 0.001;
+
+    /// Constructor.
+    ClockDriftEstimator();
+
+    /**
+     * Prepares the estimator for a new stream. The ratio goes back to 1.
+     *
+     * @param sampleRate The nominal sample rate of the stream, which is the clock rate of its RTP timestamps.
+     */
+    void reset(unsigned int sampleRate);
+
+    /**
+     * Forgets every observation after a discontinuity in the stream, keeping the last estimate until a new one is
+     * made.
+     */
+    void restart();
+
+    /**
+     * Adds the arrival of a packet, in order, to the estimate.
+     *
+     * @param timestamp The RTP timestamp of the packet, in host byte order.
+     * @param arrivalTime The time the packet was received.
+     * @return @c true if the estimate was updated.
+     */
+    bool addObservation(uint32_t timestamp, Clock::time_point arrivalTime);
+
+    /**
+     * Returns the number of samples the remote source produces for every sample's worth of the monotonic clock. It is
+     * 1 until enough windows have been observed.
+     *
+     * @return The ratio of the remote sample clock to the monotonic clock.
+     */
+    double getRatio() const;
+
+private:
+    /// The nominal sample rate.
+    unsigned int m_sampleRate;
+
+    /// @c true once the first observation has been made.
+    bool m_started;
+
+    /// The arrival time the local time is measured from.
+    Clock::time_point m_origin;
+
+    /// The last RTP timestamp observed, to unwrap the next one.
+    uint32_t m_lastTimestamp;
+
+    /// The number of samples since the first observation, according to the RTP timestamps.
+    int64_t m_mediaPosition;
+
+    /// The start of the current window.
+    Clock::time_point m_windowStart;
+
+    /// The smallest transit time of the current window, in seconds.
+    double m_windowMinimum;
+
+    /// The local time of @c m_windowMinimum, in seconds since @c m_origin.
+    double m_windowMinimumTime;
+
+    /// The local times of the smallest transit times of the last windows.
+    std::vector<double> m_times;
+
+    /// The smallest transit times of the last windows.
+    std::vector<double> m_transits;
+
+    /// The number of windows recorded in @c m_times and @c m_transits, up to @c WINDOW_COUNT.
+    size_t m_windowCount;
+
+    /// The index of the next window to record, wrapping around @c WINDOW_COUNT.
+    size_t m_nextWindow;
+
+    /// The current estimate.
+    double m_ratio;
+};
+
+} // namespace blueZ
+} // namespace bluetoothDevice
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_CLOCKDRIFTESTIMATOR_H_
@@ -0,0 +1,344 @@
+#ifndef DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_JITTERBUFFER_H_
+#define DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_JITTERBUFFER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <Common/Utils/Memory/BufferPool.h>
+
+#include "BlueZ/ClockDriftEstimator.h"
+
+namespace deviceClientSDK {
+namespace bluetoothDevice {
+namespace blueZ {
+
+/**
+ * Adaptive jitter buffer for the SBC payloads of the RTP packets of an A2DP stream.
+ *
+ * Packets are stored by RTP sequence number, so that reordered packets are put back in order and duplicates are
+ * dropped, and each of them is released at its playout time: the arrival time of the first packet, plus the media
+ * time elapsed since then according to the RTP timestamps, plus a playout delay. The playout delay follows a target
+ * latency derived from the interarrival jitter (RFC 3550), kept within configurable bounds, one small step per
+ * packet. A packet arriving after its playout time increases the delay right away. The media time is measured with
+ * the sample clock of the remote source, as estimated by a @c ClockDriftEstimator, so that drift between the clocks
+ * does not build up in the buffer; the audio released is meant to be resampled by @c getClockRatio().
+ *
+ * A packet still missing when its playout time passes, while later packets are waiting, is declared lost and replaced
+ * by concealment packets which repeat the last SBC frame released, fading out to silence. The first packet after a
+ * concealment fades back in.
+ *
+ * The packets are held in the @c BufferPool buffers they were received into, and released in them, so that no payload
+ * is copied on its way to the decoder.
+ *
+ * The buffer is meant to be fed and drained by a single thread; @c getStatistics() and @c setLatencyBounds() may be
+ * called from any thread.
+ */
+class JitterBuffer {
+public:
+    /// Clock used to timestamp the arrival and the playout of packets.
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * The SBC payload of a packet released by the jitter buffer.
+     */
+    struct Packet {
+        /// The buffer the packet was received into, which keeps @c payloadData valid. Empty for a concealment packet.
+        common::utils::memory::BufferPool::Buffer buffer;
+
+        /// Pointer to the first SBC frame of the packet.
+        const uint8_t* payloadData;
+
+        /// Number of bytes from @c payloadData to the end of the packet.
+        size_t inputLength;
+
+        /// Number of SBC frames in the packet.
+        size_t frameCount;
+
+        /// Gain to apply to the first decoded sample of the packet.
+        float startGain;
+
+        /// Gain to apply to the last decoded sample of the packet, ramping linearly from @c startGain.
+        float endGain;
+
+        /// @c true if the packet was made up to conceal lost packets.
+        bool concealed;
+    };
+
+    /**
+     * Counters describing the jitter buffer.
+     */
+    struct Statistics {
+        /// Number of packets currently buffered.
+        size_t depth;
+
+        /// Duration of the audio currently buffered.
+        std::chrono::microseconds bufferedDuration;
+
+        /// Interarrival jitter, as defined by RFC 3550.
+        std::chrono::microseconds jitter;
+
+        /// Latency the playout delay is steered to.
+        std::chrono::microseconds targetLatency;
+
+        /// Delay currently added between the expected arrival of a packet and its playout.
+        std::chrono::microseconds playoutDelay;
+
+        /// Number of packets received.
+        uint64_t packetsReceived;
+
+        /// Number of packets received out of order.
+        uint64_t packetsReordered;
+
+        /// Number of packets received more than once.
+        uint64_t packetsDuplicated;
+
+        /// Number of packets received after they had been concealed, which were dropped.
+        uint64_t packetsLate;
+
+        /// Number of packets never received.
+        uint64_t packetsLost;
+
+        /// Number of SBC frames played out by concealment packets.
+        uint64_t framesConcealed;
+
+        /// Number of times a packet arrived after its playout time, and the schedule was pushed back.
+        uint64_t underruns;
+
+        /// Number of times the sequence numbers jumped beyond the buffer, and it started over.
+        uint64_t resynchronizations;
+
+        /// Drift of the sample clock of the remote source from the monotonic clock, in parts per million. Positive
+        /// when the remote source is fast.
+        double clockDrift;
+    };
+
+    /// Number of packets the buffer can hold. A2DP packets carry 10 to 20ms of audio, so this covers the maximum
+    /// latency with room to spare for reordering.
+    static constexpr size_t SLOT_COUNT = 64;
+
+    /// Default lower bound of the target latency.
+    static constexpr std::chrono::milliseconds DEFAULT_MINIMUM_LATENCY{40};
+
+    /// Default upper bound of the target latency.
+    static constexpr std::chrono::milliseconds DEFAULT_MAXIMUM_LATENCY{200};
+
+    /**
+     * Constructor.
+     *
+     * @param minimumLatency The lower bound of the target latency.
+     * @param maximumLatency The upper bound of the target latency.
+     */
+    JitterBuffer(
+        std::chrono::milliseconds minimumLatency = DEFAULT_MINIMUM_LATENCY,
+        std::chrono::milliseconds maximumLatency = DEFAULT_MAXIMUM_LATENCY);
+
+    /**
+     * Sets the bounds of the target latency. Setting both to zero keeps the latency as low as arrival times allow.
+     *
+     * @param minimumLatency The lower bound of the target latency.
+     * @param maximumLatency The upper bound of the target latency, no less than @c minimumLatency.
+     */
+    void setLatencyBounds(std::chrono::milliseconds minimumLatency, std::chrono::milliseconds maximumLatency);
+
+    /**
+     * Empties the buffer and prepares it for a new stream. The statistics are reset.
+     *
+     * @param maxPayloadLength The largest SBC payload expected in a packet, in bytes.
+     * @param sampleRate The sample rate of the stream, which is the clock rate of its RTP timestamps.
+     * @param samplesPerFrame The number of samples (per channel) coded in an SBC frame.
+     * @param frameLength The length of an SBC frame in bytes.
+     */
+    void start(size_t maxPayloadLength, unsigned int sampleRate, size_t samplesPerFrame, size_t frameLength);
+
+    /**
+     * Stores a packet, keeping the buffer it was received into.
+     *
+     * @param sequenceNumber The RTP sequence number of the packet, in host byte order.
+     * @param timestamp The RTP timestamp of the packet, in host byte order.
+     * @param buffer The buffer holding the packet, whose size is the length of the packet.
+     * @param payloadOffset The offset of the first SBC frame in @c buffer.
+     * @param frameCount Number of SBC frames in the packet.
+     * @param arrivalTime The time the packet was received.
+     * @return @c true if the packet was stored, @c false if it was dropped.
+     */
+    bool push(
+        uint16_t sequenceNumber,
+        uint32_t timestamp,
+        common::utils::memory::BufferPool::Buffer buffer,
+        size_t payloadOffset,
+        size_t frameCount,
+        Clock::time_point arrivalTime);
+
+    /**
+     * Releases the next packet if its playout time has come, or the next concealment packet if it is lost. The
+     * payload stays valid as long as @c packet holds its buffer, or for a concealment packet, until the next call to
+     * @c pop().
+     *
+     * @param now The current time.
+     * @param[out] packet The packet released.
+     * @return @c true if a packet was released, else @c false.
+     */
+    bool pop(Clock::time_point now, Packet* packet);
+
+    /**
+     * Returns how long to wait for the next call to @c pop() to release a packet, for use as a @c poll() timeout.
+     *
+     * @param now The current time.
+     * @return The time in milliseconds, rounded up, or -1 if no packet is waiting.
+     */
+    int getReleaseTimeout(Clock::time_point now) const;
+
+    /**
+     * Returns the number of samples the remote source produces for every sample's worth of the monotonic clock.
+     * Resampling the audio released by this ratio keeps a consumer paced by the monotonic clock in step with the remote
+     * source; a consumer paced by the clock of an audio device still drifts by that clock's own error.
+     *
+     * @return The ratio of the remote sample clock to the monotonic clock.
+     */
+    double getClockRatio() const;
+
+    /**
+     * Returns a snapshot of the counters of the buffer.
+     *
+     * @return The statistics of the buffer.
+     */
+    Statistics getStatistics() const;
+
+private:
+    /**
+     * A packet stored in the buffer.
+     */
+    struct Slot {
+        /// @c true if the slot holds a packet.
+        bool used;
+
+        /// The RTP sequence number of the packet.
+        uint16_t sequenceNumber;
+
+        /// The RTP timestamp of the packet.
+        uint32_t timestamp;
+
+        /// The buffer holding the packet.
+        common::utils::memory::BufferPool::Buffer buffer;
+
+        /// The offset of the SBC payload in @c buffer.
+        size_t payloadOffset;
+
+        /// The length of the SBC payload of the packet.
+        size_t inputLength;
+
+        /// The number of SBC frames in the packet.
+        size_t frameCount;
+    };
+
+    /// Returns the slot of a sequence number.
+    Slot& slotOf(uint16_t sequenceNumber);
+
+    /// Returns the playout time of a media timestamp. Must be called with @c m_mutex held.
+    Clock::time_point playoutTimeLocked(uint32_t timestamp) const;
+
+    /// Returns the gain after @c framesConcealed frames of concealment.
+    static float concealmentGain(size_t framesConcealed);
+
+    /// Drops every buffered packet and waits for a packet to start the schedule from. Must be called with @c m_mutex
+    /// held.
+    void resetLocked();
+
+    /// Updates the jitter estimate and the target latency with an in order arrival. Must be called with @c m_mutex
+    /// held.
+    void updateJitterLocked(uint32_t timestamp, Clock::time_point arrivalTime);
+
+    /// Switches the schedule to a new clock ratio from the next packet to release on, so that no playout time already
+    /// passed moves. Must be called with @c m_mutex held.
+    void setClockRatioLocked(double ratio);
+
+    /// Releases the next packet, which is buffered. Must be called with @c m_mutex held.
+    void releaseLocked(Packet* packet);
+
+    /**
+     * Releases a concealment packet for the packets missing before the next buffered one. Must be called with
+     * @c m_mutex held.
+     *
+     * @param[out] packet The concealment packet.
+     * @return @c false if the gap was skipped instead of concealed.
+     */
+    bool concealLocked(Packet* packet);
+
+    /// Serializes the access to the buffer.
+    mutable std::mutex m_mutex;
+
+    /// The lower bound of the target latency.
+    std::chrono::microseconds m_minimumLatency;
+
+    /// The upper bound of the target latency.
+    std::chrono::microseconds m_maximumLatency;
+
+    /// The largest SBC payload of a packet.
+    size_t m_maxPayloadLength;
+
+    /// The clock rate of the RTP timestamps.
+    unsigned int m_sampleRate;
+
+    /// The number of samples per SBC frame.
+    size_t m_samplesPerFrame;
+
+    /// The length of an SBC frame.
+    size_t m_frameLength;
+
+    /// The packets, indexed by sequence number modulo their count.
+    std::vector<Slot> m_slots;
+
+    /// The last SBC frame released, repeated to fill concealment packets.
+    std::vector<uint8_t> m_concealmentPayload;
+
+    /// @c true once the first packet of the stream has set the schedule.
+    bool m_scheduled;
+
+    /// The sequence number of the next packet to release.
+    uint16_t m_nextSequenceNumber;
+
+    /// The RTP timestamp expected for the next packet to release.
+    uint32_t m_nextTimestamp;
+
+    /// The highest sequence number received.
+    uint16_t m_highestSequenceNumber;
+
+    /// The number of frames in the last packet released, used when timestamps can't tell the size of a gap.
+    size_t m_lastFrameCount;
+
+    /// The number of frames concealed since the last packet released, which drives the fade out.
+    size_t m_framesConcealedInRow;
+
+    /// The arrival time the schedule starts from.
+    Clock::time_point m_baseArrivalTime;
+
+    /// The RTP timestamp the schedule starts from.
+    uint32_t m_baseTimestamp;
+
+    /// Estimator of the sample clock of the remote source.
+    ClockDriftEstimator m_driftEstimator;
+
+    /// The ratio of the remote sample clock to the local one the schedule runs at.
+    double m_clockRatio;
+
+    /// The relative transit time of the previous packet, in RTP timestamp units, for the jitter estimate.
+    double m_previousTransit;
+
+    /// The interarrival jitter in RTP timestamp units.
+    double m_jitter;
+
+    /// The number of SBC frames buffered.
+    size_t m_bufferedFrames;
+
+    /// The counters exposed by @c getStatistics().
+    Statistics m_statistics;
+};
+
+} // namespace blueZ
+} // namespace bluetoothDevice
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_JITTERBUFFER_H_
@@ -27,7 +27,7 @@ public:
     MediaContext();
 
     /**
-     * Sets a linux file descriptor that should be used for read/write operations.
+     * Sets a linux file descriptor that should be used for read/write operations. The previous one is closed.
      * @param streamFD linux file descriptor that should be used for read/write operations.
      */
     void setStreamFD(int streamFD);
@@ -92,12 +92,12 @@ private:
     int m_readMTU;
 
     /**
-     * Maximum bytes to be sent in one packet for outbound stream. Reserved for future use.
+     * Maximum bytes to be sent in one packet for outbound stream.
      */
     int m_writeMTU;
 
     /**
-     * libsbc structure containing the context for SBC decoder.
+     * libsbc structure containing the context for SBC decoder, or encoder in SOURCE mode.
      */
     sbc_t m_sbcContext;
 
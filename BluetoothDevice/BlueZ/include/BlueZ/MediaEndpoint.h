@@ -2,19 +2,29 @@
 #define DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_MEDIAENDPOINT_H_
 
 #include <atomic>
-#include <condition_variable>
+#include <mutex>
 #include <vector>
 
+#include <Common/Utils/Audio/AudioProcessingChain.h>
+#include <Common/Utils/Audio/FractionalResampler.h>
 #include <Common/Utils/AudioInputStream.h>
 #include <Common/SDKInterfaces/Bluetooth/Services/A2DPSourceInterface.h>
+#include <Common/Utils/Bluetooth/A2DPRole.h>
 #include <Common/Utils/Bluetooth/FormattedAudioStreamAdapter.h>
+#include <Common/Utils/Memory/BufferPool.h>
+#include <Common/Utils/Threading/ThreadAffinity.h>
 
 #include "BlueZ/BlueZDeviceManager.h"
 #include "BlueZ/BlueZUtils.h"
+#include "BlueZ/JitterBuffer.h"
 #include "BlueZ/MediaContext.h"
+#include "BlueZ/MediaReactor.h"
+#include "BlueZ/PacketPacer.h"
+#include "BlueZ/ReceivePipeline.h"
 
 #include <gio/gio.h>
 #include <sbc/sbc.h>
+#include <sys/socket.h>
 
 namespace deviceClientSDK {
 namespace bluetoothDevice {
@@ -22,8 +32,24 @@ namespace blueZ {
 
 class MediaEndpoint : public DBusObject<MediaEndpoint> {
 public:
-    // Constructor.
-    MediaEndpoint(std::shared_ptr<DBusConnection> connection, const std::string& endpointPath);
+    /**
+     * Constructor.
+     *
+     * @param connection The DBus connection to register the endpoint with.
+     * @param endpointPath The object path to register the endpoint at.
+     * @param role The role played by this device on the streams of the endpoint: @c A2DPRole::SINK to receive audio
+     * from the remote device, @c A2DPRole::SOURCE to send audio to it.
+     * @param reactor The reactor driving the media stream, which may be shared with other endpoints so that streaming
+     * with several devices at once takes a single thread. nullptr to create one for this endpoint alone.
+     *
+     * The endpoint must be created on the thread running the glib main context it is registered with: the DBus calls
+     * it makes from the reactor thread are handed to that context, see @c callMethodOnWorker().
+     */
+    MediaEndpoint(
+        std::shared_ptr<DBusConnection> connection,
+        const std::string& endpointPath,
+        common::utils::bluetooth::A2DPRole role,
+        std::shared_ptr<MediaReactor> reactor = nullptr);
 
     // Destructor.
     ~MediaEndpoint();
@@ -53,7 +79,8 @@ public:
     std::string getEndpointPath() const;
 
     /**
-     * Get DBus object path of the device the BlueZ currently uses this media endpoint with for streaming.
+     * Get DBus object path of the device the BlueZ currently uses this media endpoint with for streaming. It is safe to
+     * call this method from any thread.
      *
      * @return Device object path.
      */
@@ -61,37 +88,135 @@ public:
 
     /**
      * Get the @c FormattedAudioStreamAdapter for the audio stream being received from the remote bluetooth device over
-     * A2DP. It is safe to call this method early.
+     * A2DP. It is safe to call this method early. The data published has been through the stages set with
+     * @c setProcessingStages(), like the data of the @c AudioInputStream. A chain set on the adapter with
+     * @c FormattedAudioStreamAdapter::setProcessingChain() only applies to its listener.
      *
      * @return An @c FormattedAudioStreamAdapter object used by @c MediaEndpoint.
      */
     std::shared_ptr<common::utils::bluetooth::FormattedAudioStreamAdapter> getAudioStream();
 
+    /**
+     * Get the @c AudioInputStream for the audio stream being received from the remote bluetooth device over A2DP. The
+     * first call switches the media endpoint to decode SBC frames directly into the ring buffer of the stream, without
+     * going through an intermediate PCM buffer. The stream holds 16-bit samples, in the format reported by
+     * @c getAudioStream()->getAudioFormat(), and is consumed with @c AudioInputStream::Reader. Data is still forwarded
+     * to the listener of the @c FormattedAudioStreamAdapter, straight from the ring buffer. It is safe to call this
+     * method early.
+     *
+     * @return An @c AudioInputStream object written by @c MediaEndpoint, nullptr if there was an error creating it.
+     */
+    std::shared_ptr<common::utils::AudioInputStream> getAudioInputStream();
+
+    /**
+     * Get the counters of the jitter buffer the received packets go through: its depth, the measured jitter and
+     * latency, and the packets lost, late, reordered and concealed. The counters restart with every stream.
+     *
+     * @return A snapshot of the statistics of the jitter buffer.
+     */
+    JitterBuffer::Statistics getJitterBufferStatistics() const;
+
+    /**
+     * Set the bounds of the latency of the jitter buffer. The latency adapts to the jitter measured on the stream
+     * within these bounds. It is safe to call this method at any time.
+     *
+     * @param minimumLatency The lower bound of the latency.
+     * @param maximumLatency The upper bound of the latency.
+     */
+    void setJitterBufferLatency(std::chrono::milliseconds minimumLatency, std::chrono::milliseconds maximumLatency);
+
+    /**
+     * Enable or disable the compensation of the drift between the sample clock of the remote device and the local
+     * clock. When enabled, the decoded audio is resampled by the ratio of the clocks, as estimated from the RTP
+     * timestamps, so that the latency stays constant over long sessions. The local clock is the monotonic system
+     * clock the packets are timed with, not the clock of an audio device: enable it when the audio is consumed at the
+     * pace of the system clock. A drift within a few ppm is left alone. Resampling costs the direct decoding into the
+     * ring buffer of the @c AudioInputStream, which then takes a copy, so it is disabled by default. It is safe to call
+     * this method at any time.
+     *
+     * @param enabled Whether to compensate the clock drift.
+     */
+    void setClockDriftCompensation(bool enabled);
+
+    /**
+     * Enable or disable the pipelined reception of the stream received in SINK mode. By default, a single thread
+     * receives the packets, decodes them and delivers the audio, so that a slow consumer of the audio delays the
+     * draining of the socket. In pipelined mode, a thread of its own receives the packets into a pool of buffers and
+     * hands them to the media reactor through a lock-free queue, which then only decodes and delivers. The receiving
+     * thread can be pinned to a CPU; the decoding is pinned with the reactor, see @c MediaReactor::setAffinity(). The
+     * setting takes effect with the next stream.
+     *
+     * @param enabled Whether to receive the packets on a thread of their own.
+     * @param receiveCPU The CPU to pin the receiving thread to, or @c common::utils::threading::ANY_CPU.
+     */
+    void setPipelinedReceive(bool enabled, int receiveCPU = common::utils::threading::ANY_CPU);
+
+    /**
+     * Set the stages run on the audio received in SINK mode, such as the speaker tuning with an @c EqualizerStage and
+     * a @c LimiterStage. They run on the decoded PCM before it reaches either output: the ring buffer of the
+     * @c AudioInputStream and the listener of the @c FormattedAudioStreamAdapter. The stages work on floats; the PCM
+     * is converted to and from them around the stages, which must keep its sample rate and number of channels. The
+     * stages are configured for the format of each stream when it starts, so the setting takes effect with the next
+     * stream.
+     *
+     * @param stages The stages, in the order they run, or none to leave the PCM as decoded.
+     */
+    void setProcessingStages(std::vector<std::shared_ptr<common::utils::audio::AudioProcessingStage>> stages);
+
+    /**
+     * Get the stages run on the audio received in SINK mode.
+     *
+     * @return The stages set with @c setProcessingStages().
+     */
+    std::vector<std::shared_ptr<common::utils::audio::AudioProcessingStage>> getProcessingStages() const;
+
+    /**
+     * Set the @c AudioInputStream to stream to the remote device over A2DP, when the endpoint is a
+     * @c A2DPRole::SOURCE one. The stream must hold 16-bit samples, in the format reported by
+     * @c getAudioStream()->getAudioFormat(), which follows the configuration negotiated with the remote device. If a
+     * transport is configured, it is acquired right away and streaming starts with the data in the stream; it stops,
+     * and the transport is released, once the writer of the stream closes and its data has been sent. Setting a null
+     * stream stops streaming.
+     *
+     * @param stream The stream to read the PCM data to send from, or nullptr.
+     * @return @c true on success, @c false if this is not a source endpoint or the transport could not be acquired.
+     */
+    bool setSourceStream(std::shared_ptr<common::utils::AudioInputStream> stream);
+
+    /**
+     * Get the counters of the pacing of the packets sent in SOURCE mode: the send time jitter, the lateness, and the
+     * depth of the transmit queue. The counters restart with every stream.
+     *
+     * @return A snapshot of the statistics of the packet pacer.
+     */
+    PacketPacer::Statistics getSourceStatistics() const;
+
 private:   
     /**
      * Operating mode of the @c MediaEndpoint and its media stream
      */
     enum class OperatingMode {
         /**
-         * There is no streaming currently active. Media streaming thread is waiting for the new mode.
+         * There is no streaming currently active. The media stream is not watched by the reactor.
          */
         INACTIVE,
 
         /**
-         * The @c MediaEnpoint is working in SINK mode, receiving audio stream from the remote bluetooth device. Media
-         * streaming thread is reading the data from the file descriptor provided by BlueZ.
+         * The @c MediaEnpoint is working in SINK mode, receiving audio stream from the remote bluetooth device. The
+         * reactor reads the data from the file descriptor provided by BlueZ.
          */
         SINK,
 
         /**
-         * Reserved for future use.
+         * The @c MediaEndpoint is working in SOURCE mode, sending audio stream to the remote bluetooth device. The
+         * reactor encodes the data of the source @c AudioInputStream and writes it to the file descriptor provided by
+         * BlueZ.
          */
         SOURCE,
 
         /**
-         * The @c MediaEndpoint has been released and any operation on it should fail. Media streaming thread will
-         * stop processing the data and exit as soon as returns from any active blocking operation such as poll() or
-         * read().
+         * The @c MediaEndpoint has been released and any operation on it should fail. The reactor stops watching
+         * the media stream right away.
          */
         RELEASED
     };
@@ -99,29 +224,263 @@ private:
     // Returns a string representation of @c OperatingMode enum class
     std::string operatingModeToString(OperatingMode mode);
 
-    // A media streaming thread main function.
-    void mediaThread();
-
-    // Set the current operating mode for the media endpoint.
+    // Set the current operating mode for the media endpoint, which the reactor then switches the stream to.
     void setOperatingMode(OperatingMode mode);
 
-    // Disconnects the device and enters INACTIVE state.
+    /**
+     * Starts, stops or restarts the stream to follow the operating mode and the transport acquired. Runs on the
+     * reactor thread.
+     */
+    void onOperatingModeChanged();
+
+    /**
+     * Starts receiving the stream in SINK mode. Runs on the reactor thread.
+     *
+     * @param mediaContext The @c MediaContext holding the SBC decoder and the MTUs.
+     * @param pipelined Whether to receive the packets with @c m_receivePipeline.
+     * @param receiveCPU The CPU to pin the receiving thread of @c m_receivePipeline to.
+     */
+    void startSink(std::shared_ptr<MediaContext> mediaContext, bool pipelined, int receiveCPU);
+
+    /**
+     * Receives the packets ready and plays out those which are due. Runs on the reactor thread.
+     *
+     * @param events The epoll events reported for the stream, or for the eventfd of @c m_receivePipeline.
+     */
+    void onSinkReadable(uint32_t events);
+
+    /**
+     * Starts sending the stream in SOURCE mode. Runs on the reactor thread.
+     *
+     * @param mediaContext The @c MediaContext holding the SBC encoder and the MTUs.
+     */
+    void startSource(std::shared_ptr<MediaContext> mediaContext);
+
+    /**
+     * Sends the packet pending if it is due, encodes the next one if the data of the source stream is available, and
+     * updates the descriptors watched until there is more to do. Runs on the reactor thread.
+     */
+    void serviceSource();
+
+    /**
+     * Ends the stream sent in SOURCE mode, and releases its transport. Runs on the reactor thread.
+     *
+     * @param failed Whether the stream failed, in which case the device is disconnected.
+     */
+    void finishSource(bool failed);
+
+    /**
+     * Stops watching the stream, and releases the resources of the stream. Runs on the reactor thread.
+     *
+     * @param nextMode The mode to stream in next; the transport of a SOURCE stream is kept for another one.
+     */
+    void stopStreaming(OperatingMode nextMode);
+
+    /**
+     * Plays out the packets due in SINK mode, or services the source stream in SOURCE mode, when @c m_timerFD expires.
+     * Runs on the reactor thread.
+     *
+     * @param events The epoll events reported for @c m_timerFD.
+     */
+    void onTimer(uint32_t events);
+
+    /**
+     * Sets @c m_timerFD to expire after a timeout. Runs on the reactor thread.
+     *
+     * @param timeout The timeout in milliseconds, 0 to expire right away, or -1 to disarm the timer.
+     */
+    void armTimer(int timeout);
+
+    /**
+     * Changes the events watched on a descriptor of the stream, unless they are the same already. Runs on the reactor
+     * thread.
+     *
+     * @param fd The descriptor.
+     * @param events The epoll events to watch.
+     * @param[in,out] watchedEvents The events watched so far.
+     * @return @c true on success, else @c false.
+     */
+    bool updateWatch(int fd, uint32_t events, uint32_t* watchedEvents);
+
+    // Disconnects the device and enters INACTIVE state. The device is disconnected on @c m_workerContext.
     void abortStreaming();
 
+    /**
+     * Acquires the media transport configured by BlueZ, and stores its file descriptor and MTUs in
+     * @c m_currentMediaContext.
+     *
+     * @return @c true on success, else @c false.
+     */
+    bool acquireTransport();
+
+    /**
+     * Releases the media transport acquired by @c acquireTransport(), and closes its file descriptor. The transport is
+     * released on @c m_workerContext.
+     *
+     * @param mediaContext The @c MediaContext holding the file descriptor.
+     */
+    void releaseTransport(std::shared_ptr<MediaContext> mediaContext);
+
+    /**
+     * Calls a method of a BlueZ object on @c m_workerContext, without waiting for it. The reactor thread drives the
+     * streams of every endpoint, so it must not block on a DBus round trip; the call is queued to the glib thread
+     * instead, or made right away when already on it.
+     *
+     * @param interfaceName The interface of the method.
+     * @param objectPath The object to call the method on.
+     * @param methodName The method, which takes no parameters.
+     */
+    void callMethodOnWorker(
+        const std::string& interfaceName,
+        const std::string& objectPath,
+        const std::string& methodName);
+
+    /**
+     * Encodes the PCM data in @c m_sbcBuffer into an RTP packet in @c m_ioBuffer.
+     *
+     * @param mediaContext The @c MediaContext holding the SBC encoder.
+     * @param pcmLength Length in bytes of the PCM data, a whole number of SBC frames.
+     * @param sequenceNumber The RTP sequence number of the packet.
+     * @param timestamp The RTP timestamp of the packet.
+     * @param[out] frameCount The number of SBC frames in the packet.
+     * @return The length of the packet, or 0 if the data could not be encoded.
+     */
+    size_t encodeRTPPacket(
+        std::shared_ptr<MediaContext> mediaContext,
+        size_t pcmLength,
+        uint16_t sequenceNumber,
+        uint32_t timestamp,
+        size_t* frameCount);
+
+    /**
+     * The SBC payload of one RTP packet received from BlueZ, or of a concealment packet, as played out by
+     * @c m_jitterBuffer.
+     */
+    using SBCPacket = JitterBuffer::Packet;
+
+    /**
+     * Sets up the buffers used to receive a batch of packets at once, allocating @c m_receivePool unless the one of
+     * the previous stream is large enough. No buffer of the previous stream may be held.
+     *
+     * @param mtu The maximum size of a packet.
+     */
+    void prepareReceiveBuffers(size_t mtu);
+
+    /**
+     * Receives all the packets queued on the media stream, up to a batch, without blocking. The SBC payloads of the
+     * valid packets are stored in @c m_jitterBuffer.
+     *
+     * @param fd The media stream file descriptor.
+     * @param[out] endOfStream Set to @c true if the remote device closed the stream.
+     * @return The number of packets received (including invalid ones), or -1 if there was an error.
+     */
+    ssize_t receivePacketBatch(int fd, bool* endOfStream);
+
+    /**
+     * Takes all the packets queued by @c m_receivePipeline, and stores the SBC payloads of the valid ones in
+     * @c m_jitterBuffer.
+     *
+     * @param[out] endOfStream Set to @c true if the remote device closed the stream.
+     * @return The number of packets taken (including invalid ones), or -1 if the stream could not be read.
+     */
+    ssize_t receivePipelinedPackets(bool* endOfStream);
+
+    /**
+     * Stores a received RTP packet in @c m_jitterBuffer, unless the packet is invalid.
+     *
+     * @param packet The buffer holding the packet, whose size is the length of the packet.
+     * @param arrivalTime The time the packet was received.
+     */
+    void bufferPacket(common::utils::memory::BufferPool::Buffer packet, JitterBuffer::Clock::time_point arrivalTime);
+
+    /**
+     * Decodes the packets of @c m_jitterBuffer whose playout time has come, a batch at a time.
+     *
+     * @param writer The @c Writer of the @c AudioInputStream, nullptr to decode to @c m_sbcBuffer instead.
+     * @param mediaContext The @c MediaContext holding the SBC decoder.
+     * @param sbcFrameLength Length in bytes of one SBC frame.
+     * @param sbcCodeSize Length in bytes of the PCM data of one decoded SBC frame.
+     * @param now The current time, or the end of time to play out every packet buffered.
+     */
+    void playOutPackets(
+        common::utils::AudioInputStream::Writer* writer,
+        std::shared_ptr<MediaContext> mediaContext,
+        size_t sbcFrameLength,
+        size_t sbcCodeSize,
+        JitterBuffer::Clock::time_point now);
+
+    /**
+     * Decodes the SBC frames of a batch of RTP packets into @c m_sbcBuffer, resamples them if requested, and sends the
+     * result to the @c FormattedAudioStreamAdapter, and to the @c AudioInputStream if there is one.
+     *
+     * @param writer The @c Writer of the @c AudioInputStream, or nullptr.
+     * @param mediaContext The @c MediaContext holding the SBC decoder.
+     * @param packets The SBC payloads of the packets.
+     * @param packetCount Number of packets in @c packets.
+     * @param sbcFrameLength Length in bytes of one SBC frame.
+     * @param sbcCodeSize Length in bytes of the PCM data of one decoded SBC frame.
+     * @param resample Whether to resample the decoded data with @c m_resampler.
+     */
+    void decodeToAudioStream(
+        common::utils::AudioInputStream::Writer* writer,
+        std::shared_ptr<MediaContext> mediaContext,
+        const SBCPacket* packets,
+        size_t packetCount,
+        size_t sbcFrameLength,
+        size_t sbcCodeSize,
+        bool resample);
+
+    /**
+     * Decodes the SBC frames of a batch of RTP packets in place into the ring buffer of the @c AudioInputStream, and
+     * forwards the decoded data to the @c FormattedAudioStreamAdapter.
+     *
+     * @param writer The @c Writer of the @c AudioInputStream.
+     * @param mediaContext The @c MediaContext holding the SBC decoder.
+     * @param packets The SBC payloads of the packets.
+     * @param packetCount Number of packets in @c packets.
+     * @param sbcFrameLength Length in bytes of one SBC frame.
+     * @param sbcCodeSize Length in bytes of the PCM data of one decoded SBC frame.
+     */
+    void decodeToAudioInputStream(
+        common::utils::AudioInputStream::Writer* writer,
+        std::shared_ptr<MediaContext> mediaContext,
+        const SBCPacket* packets,
+        size_t packetCount,
+        size_t sbcFrameLength,
+        size_t sbcCodeSize);
+
+    /**
+     * Creates @c m_processingChain for the stages set with @c setProcessingStages(). Runs on the reactor thread when a
+     * stream starts in SINK mode.
+     *
+     * @param audioFormat The format of the decoded PCM.
+     * @param maxFrames The largest number of frames decoded from a batch of packets.
+     */
+    void createProcessingChain(const common::utils::AudioFormat& audioFormat, size_t maxFrames);
+
+    /**
+     * Runs @c m_processingChain in place on decoded PCM, if there is a chain.
+     *
+     * @param data The PCM, in the format of the stream.
+     * @param size The size of the PCM in bytes.
+     */
+    void processAudio(uint8_t* data, size_t size);
+
     /**
      * An object path where media endpoint is/should be registered.
      */
     std::string m_endpointPath;
 
     /**
-     * An object path of the device that is currently being used to stream from using this media endpoint.
+     * The role played by this device on the streams of the endpoint.
      */
-    std::string m_streamingDevicePath;
+    const common::utils::bluetooth::A2DPRole m_role;
 
     /**
-     * Flag signalling that operating mode has changed
+     * An object path of the device that is currently being used to stream from using this media endpoint. Written on
+     * the glib thread under @c m_mutex.
      */
-    bool m_operatingModeChanged;
+    std::string m_streamingDevicePath;
 
     /**
      * Current @c OperatingMode.
@@ -129,14 +488,36 @@ private:
     std::atomic<OperatingMode> m_operatingMode;
 
     /**
-     * Buffer used to decode SBC data to. Contains raw PCM data after the decoding.
+     * Whether to compensate the drift between the sample clock of the remote device and the system clock.
+     */
+    std::atomic<bool> m_clockDriftCompensation;
+
+    /**
+     * Whether to receive the packets on a thread of their own in SINK mode, guarded by @c m_mutex.
+     */
+    bool m_pipelinedReceive;
+
+    /**
+     * The CPU to pin the receiving thread to in pipelined mode, guarded by @c m_mutex.
+     */
+    int m_receiveCPU;
+
+    /**
+     * The stages run on the audio received in SINK mode, guarded by @c m_mutex.
+     */
+    std::vector<std::shared_ptr<common::utils::audio::AudioProcessingStage>> m_processingStages;
+
+    /**
+     * Buffer used to decode SBC data to. Contains raw PCM data after the decoding. When decoding into the
+     * @c AudioInputStream, it only holds the one frame which straddles the wrap of the ring buffer. In SOURCE mode,
+     * it collects the PCM data of the next packet to encode.
      */
     std::vector<uint8_t> m_sbcBuffer;
 
     /**
-     * Mutex synchronizing the state of media thread.
+     * Mutex synchronizing the operating mode and the media context with the reactor thread.
      */
-    std::mutex m_mutex;
+    mutable std::mutex m_mutex;
 
     /**
      * Mutex synchronizing the creation/querying of the audio @c FormattedAudioStreamAdapter object.
@@ -144,20 +525,93 @@ private:
     std::mutex m_streamMutex;
 
     /**
-     * A condition variable to listen for operating state changes.
+     * @c FormattedAudioStreamAdapter object exposed to the clients and used to send decoded audio data to.
      */
-    std::condition_variable m_modeChangeSignal;
+    std::shared_ptr<common::utils::bluetooth::FormattedAudioStreamAdapter> m_ioStream;
 
     /**
-     * @c FormattedAudioStreamAdapter object exposed to the clients and used to send decoded audio data to.
+     * @c AudioInputStream object exposed to the clients. SBC frames are decoded directly into its ring buffer.
      */
-    std::shared_ptr<common::utils::bluetooth::FormattedAudioStreamAdapter> m_ioStream;
+    std::shared_ptr<common::utils::AudioInputStream> m_audioInputStream;
+
+    /**
+     * The @c Writer of @c m_audioInputStream, used by the reactor thread.
+     */
+    std::shared_ptr<common::utils::AudioInputStream::Writer> m_audioInputStreamWriter;
 
     /**
-     * Buffer for receiving encoded data from BlueZ. This buffer contains RTP packets with SBC packets payload.
+     * The @c AudioInputStream streamed to the remote device in SOURCE mode.
+     */
+    std::shared_ptr<common::utils::AudioInputStream> m_sourceStream;
+
+    /**
+     * Pacer sending the packets in SOURCE mode at the rate the remote device plays them out.
+     */
+    PacketPacer m_pacer;
+
+    /**
+     * Buffer holding the RTP packet being sent in SOURCE mode.
      */
     std::vector<uint8_t> m_ioBuffer;
 
+    /**
+     * The @c recvmmsg() message headers pointing at @c m_receiveBuffers.
+     */
+    std::vector<mmsghdr> m_packetHeaders;
+
+    /**
+     * The I/O vectors of @c m_packetHeaders, one per buffer of @c m_receiveBuffers.
+     */
+    std::vector<iovec> m_packetVectors;
+
+    /**
+     * MTU sized buffers the packets are received into when they are received on the reactor thread. The packets stay
+     * in them through @c m_jitterBuffer to the decoder. Only reallocated when a stream comes with a larger MTU.
+     */
+    std::unique_ptr<common::utils::memory::BufferPool> m_receivePool;
+
+    /**
+     * Buffers taken from @c m_receivePool, which the next batch of packets is received into.
+     */
+    std::vector<common::utils::memory::BufferPool::Buffer> m_receiveBuffers;
+
+    /**
+     * The SBC payloads of the batch of packets being played out.
+     */
+    std::vector<SBCPacket> m_packets;
+
+    /**
+     * Pipeline receiving the packets on a thread of its own in pipelined mode.
+     */
+    ReceivePipeline m_receivePipeline;
+
+    /**
+     * Jitter buffer putting the received packets back in order and playing them out on time, concealing the lost
+     * ones.
+     */
+    JitterBuffer m_jitterBuffer;
+
+    /**
+     * Resampler following the clock of the remote device, between the SBC decoder and the outputs.
+     */
+    common::utils::audio::FractionalResampler m_resampler;
+
+    /**
+     * Whether @c m_resampler was in use for the last batch of packets.
+     */
+    bool m_resampling;
+
+    /**
+     * Buffer the output of @c m_resampler goes to.
+     */
+    std::vector<uint8_t> m_resampledBuffer;
+
+    /**
+     * The chain running @c m_processingStages on the stream received in SINK mode, between conversions to and from
+     * floats, or nullptr. Only used on the reactor thread.
+     */
+    std::unique_ptr<common::utils::audio::AudioProcessingChain> m_processingChain;
+
     /**
      * The @c AudioFormat associated with the stream.
      */
@@ -169,10 +623,122 @@ private:
      */
     std::shared_ptr<MediaContext> m_currentMediaContext;
 
-    /*
-     * Dedicated thread for I/O.
+    /**
+     * State of the stream sent in SOURCE mode, kept by the reactor thread between the wakeups.
+     */
+    struct SourceState {
+        /// The reader of the source @c AudioInputStream.
+        std::shared_ptr<common::utils::AudioInputStream::Reader> reader;
+
+        /// The readiness eventfd of @c reader, or -1 if it is polled with @c m_timerFD instead.
+        int readerFD;
+
+        /// Interval in milliseconds at which @c reader is polled when it has no eventfd.
+        int readerPollTimeout;
+
+        /// Size in bytes of a word of the source stream.
+        size_t wordSize;
+
+        /// Length in bytes of the PCM data of one SBC frame.
+        size_t sbcCodeSize;
+
+        /// Length in bytes of the PCM data of a full packet.
+        size_t pcmPerPacket;
+
+        /// Number of samples per channel of one SBC frame.
+        size_t samplesPerFrame;
+
+        /// RTP sequence number of the next packet.
+        uint16_t sequenceNumber;
+
+        /// RTP timestamp of the next packet.
+        uint32_t timestamp;
+
+        /// Length in bytes of the PCM data collected in @c m_sbcBuffer for the next packet.
+        size_t pcmBuffered;
+
+        /// Length of the packet pending in @c m_ioBuffer, 0 if there is none.
+        size_t packetLength;
+
+        /// Number of samples per channel of the packet pending.
+        size_t packetSamples;
+
+        /// Whether the packet pending did not fit in the transmit buffer.
+        bool transmitBufferFull;
+
+        /// The events watched on the media stream.
+        uint32_t streamEvents;
+
+        /// The events watched on @c readerFD.
+        uint32_t readerEvents;
+
+        /// The events watched on the timerfd of @c m_pacer.
+        uint32_t pacerEvents;
+    };
+
+    /**
+     * The reactor watching the media stream, and running everything which touches the stream state below.
+     */
+    std::shared_ptr<MediaReactor> m_reactor;
+
+    /**
+     * The glib main context of the thread the endpoint was created on, which makes the DBus calls of the reactor
+     * thread.
+     */
+    GMainContext* m_workerContext;
+
+    /**
+     * A timerfd waking the reactor up at the playout time of the next packet of the jitter buffer in SINK mode, and
+     * when the source stream is to be polled, or the next packet is due without a timerfd of @c m_pacer, in SOURCE
+     * mode. -1 if it could not be created.
+     */
+    int m_timerFD;
+
+    /**
+     * The mode the reactor is streaming in. Only used on the reactor thread, like the members below.
+     */
+    OperatingMode m_streamingMode;
+
+    /**
+     * The @c MediaContext being streamed with.
+     */
+    std::shared_ptr<MediaContext> m_streamingContext;
+
+    /**
+     * The file descriptor of the transport being streamed with, as acquired; a new one restarts the stream.
+     */
+    int m_streamingContextFD;
+
+    /**
+     * A duplicate of the transport file descriptor, owned by the reactor, so that the watch outlives a transport
+     * acquired again from the DBus thread.
+     */
+    int m_streamFD;
+
+    /**
+     * Length in bytes of one SBC frame of the stream.
+     */
+    size_t m_sbcFrameLength;
+
+    /**
+     * Length in bytes of the PCM data of one SBC frame of the stream.
+     */
+    size_t m_sbcCodeSize;
+
+    /**
+     * Whether the packets received in SINK mode come from @c m_receivePipeline.
+     */
+    bool m_pipelined;
+
+    /**
+     * The @c Writer of @c m_audioInputStream the stream received in SINK mode is decoded to, or nullptr.
+     */
+    std::shared_ptr<common::utils::AudioInputStream::Writer> m_sinkWriter;
+
+    /**
+     * State of the stream sent in SOURCE mode.
      */
-    std::thread m_thread;
+    SourceState m_source;
 };
 
 } // namespace blueZ
@@ -0,0 +1,174 @@
+#ifndef DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_MEDIAREACTOR_H_
+#define DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_MEDIAREACTOR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <Common/Utils/Threading/ThreadAffinity.h>
+
+namespace deviceClientSDK {
+namespace bluetoothDevice {
+namespace blueZ {
+
+/**
+ * A single thread multiplexing the file descriptors of any number of media streams on one epoll set, and running the
+ * handler of each descriptor which becomes ready. The media endpoints share it, so that the number of threads does
+ * not grow with the number of streams.
+ *
+ * The descriptors are watched level triggered. Handlers run on the reactor thread, one at a time, and must not block.
+ * Descriptors are added, modified and removed from the reactor thread only, typically from a handler or from a task
+ * handed over with @c post(), which any thread may call. This way a handler never runs after its descriptor has been
+ * removed, and the state of a stream is only ever touched from the reactor thread.
+ */
+class MediaReactor {
+public:
+    /**
+     * A handler called when its descriptor is ready.
+     *
+     * @param events The epoll events reported for the descriptor.
+     */
+    using Handler = std::function<void(uint32_t events)>;
+
+    /// A task run on the reactor thread.
+    using Task = std::function<void()>;
+
+    /**
+     * Creates a reactor, and starts its thread.
+     *
+     * @param cpu The CPU to pin the reactor thread to, or @c common::utils::threading::ANY_CPU.
+     * @return The reactor, or nullptr if the epoll set could not be created.
+     */
+    static std::shared_ptr<MediaReactor> create(int cpu = common::utils::threading::ANY_CPU);
+
+    /// Destructor. Stops the thread; the tasks still queued are dropped. Must not be called from the reactor thread.
+    ~MediaReactor();
+
+    /**
+     * Starts watching a descriptor. Must be called from the reactor thread.
+     *
+     * @param fd The descriptor, which must not be watched already.
+     * @param events The epoll events to watch. Errors and hang ups are always reported.
+     * @param handler The handler to call when the descriptor is ready.
+     * @return @c true on success, else @c false.
+     */
+    bool add(int fd, uint32_t events, Handler handler);
+
+    /**
+     * Changes the events watched on a descriptor. Must be called from the reactor thread.
+     *
+     * @param fd A descriptor added with @c add().
+     * @param events The epoll events to watch, 0 to only hear about errors and hang ups.
+     * @return @c true on success, else @c false.
+     */
+    bool modify(int fd, uint32_t events);
+
+    /**
+     * Stops watching a descriptor, which must be removed before it is closed. Must be called from the reactor thread.
+     * Its handler is not called anymore, even for events already collected.
+     *
+     * @param fd A descriptor added with @c add().
+     */
+    void remove(int fd);
+
+    /**
+     * Runs a task on the reactor thread, after the tasks posted before it. May be called from any thread.
+     *
+     * @param task The task.
+     */
+    void post(Task task);
+
+    /**
+     * Runs a task on the reactor thread, and waits for it to complete. Runs it right away when called from the reactor
+     * thread.
+     *
+     * @param task The task.
+     */
+    void run(Task task);
+
+    /**
+     * Tells whether the caller runs on the reactor thread.
+     *
+     * @return @c true if called from the reactor thread.
+     */
+    bool isReactorThread() const;
+
+    /**
+     * Pins the reactor thread to a CPU, or lets it run on any CPU again. All the streams driven by the reactor are
+     * then handled on that CPU. May be called from any thread; waits until the thread has been pinned.
+     *
+     * @param cpu The CPU, or @c common::utils::threading::ANY_CPU.
+     * @return @c true on success, else @c false.
+     */
+    bool setAffinity(int cpu);
+
+private:
+    /**
+     * A descriptor being watched.
+     */
+    struct Watch {
+        /// The descriptor.
+        int fd;
+
+        /// The handler of the descriptor.
+        Handler handler;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param epollFD The epoll set.
+     * @param taskFD The eventfd signalled when a task is posted.
+     * @param cpu The CPU to pin the reactor thread to, or @c common::utils::threading::ANY_CPU.
+     */
+    MediaReactor(int epollFD, int taskFD, int cpu);
+
+    /**
+     * The reactor thread main function.
+     *
+     * @param cpu The CPU to pin the thread to, or @c common::utils::threading::ANY_CPU.
+     */
+    void reactorThread(int cpu);
+
+    /// Runs the tasks posted so far.
+    void runTasks();
+
+    /// The epoll set.
+    const int m_epollFD;
+
+    /// The eventfd signalled when a task is posted.
+    const int m_taskFD;
+
+    /// The descriptors watched, by the key registered with epoll. Only used on the reactor thread.
+    std::unordered_map<uint64_t, std::shared_ptr<Watch>> m_watches;
+
+    /// The keys of the descriptors watched. Only used on the reactor thread.
+    std::unordered_map<int, uint64_t> m_keys;
+
+    /// The key of the next descriptor added, so that events of a removed descriptor never reach a new one.
+    uint64_t m_nextKey;
+
+    /// Serializes the access to @c m_tasks.
+    std::mutex m_taskMutex;
+
+    /// The tasks posted.
+    std::deque<Task> m_tasks;
+
+    /// Set to stop the reactor thread.
+    std::atomic<bool> m_stopping;
+
+    /// The reactor thread.
+    std::thread m_thread;
+};
+
+} // namespace blueZ
+} // namespace bluetoothDevice
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_MEDIAREACTOR_H_
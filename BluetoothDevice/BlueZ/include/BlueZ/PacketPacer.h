@@ -0,0 +1,150 @@
+#ifndef DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_PACKETPACER_H_
+#define DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_PACKETPACER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace deviceClientSDK {
+namespace bluetoothDevice {
+namespace blueZ {
+
+/**
+ * Paces the packets of an A2DP stream sent to a remote device at the rate the remote device plays them out, so that
+ * the transmit buffers of the kernel and of the controller never hold more than a packet or two.
+ *
+ * Each packet is due at an absolute deadline: the time the schedule started, plus the duration of the audio sent
+ * before it. Deadlines do not accumulate rounding or wakeup errors. A packet sent late is followed by the next ones as
+ * soon as they are due, back to back, until the schedule is caught up; a packet sent more than @c MAX_CATCH_UP late
+ * restarts the schedule instead, rather than bursting out the backlog. The deadlines are waited for with a
+ * @c timerfd, which the caller polls along with its other descriptors.
+ *
+ * The pacer is meant to be driven by a single thread; @c getStatistics() may be called from any thread.
+ */
+class PacketPacer {
+public:
+    /// Clock of the deadlines, which is the clock of the @c timerfd.
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Counters describing the pacing of the stream.
+     */
+    struct Statistics {
+        /// Number of packets sent.
+        uint64_t packetsSent;
+
+        /// Number of times a packet was sent too late to catch up, and the schedule restarted.
+        uint64_t scheduleRestarts;
+
+        /// Smoothed mean deviation of the send times from the deadlines, as RFC 3550 computes interarrival jitter.
+        std::chrono::microseconds sendJitter;
+
+        /// Largest delay of a send time after its deadline.
+        std::chrono::microseconds maxLateness;
+
+        /// Number of bytes queued in the transmit buffer after the last packet was sent.
+        size_t queueDepth;
+
+        /// Largest number of bytes queued in the transmit buffer after a packet was sent.
+        size_t maxQueueDepth;
+    };
+
+    /// Lateness beyond which the packets are not sent back to back to catch up with the schedule.
+    static constexpr std::chrono::milliseconds MAX_CATCH_UP{30};
+
+    /// Constructor. Creates the @c timerfd.
+    PacketPacer();
+
+    /// Destructor. Closes the @c timerfd.
+    ~PacketPacer();
+
+    /**
+     * Returns the @c timerfd, which becomes readable when the next packet is due once @c arm() has been called.
+     *
+     * @return The file descriptor, or -1 if it could not be created, in which case the caller has to poll with a
+     * timeout of @c getDueTimeout().
+     */
+    int getFD() const;
+
+    /**
+     * Prepares the pacer for a new stream. The statistics are reset, and the first packet is due as soon as it is
+     * ready.
+     *
+     * @param sampleRate The sample rate of the stream.
+     */
+    void start(unsigned int sampleRate);
+
+    /**
+     * Tells whether the next packet is due.
+     *
+     * @param now The current time.
+     * @return @c true if the next packet should be sent now.
+     */
+    bool isDue(Clock::time_point now) const;
+
+    /**
+     * Returns how long to wait for the next packet to be due, for use as a @c poll() timeout.
+     *
+     * @param now The current time.
+     * @return The time in milliseconds, rounded up.
+     */
+    int getDueTimeout(Clock::time_point now) const;
+
+    /**
+     * Sets the @c timerfd to become readable at the deadline of the next packet, and clears its past expirations.
+     *
+     * @return @c true on success, else @c false.
+     */
+    bool arm();
+
+    /**
+     * Records that the next packet was sent, and moves the deadline past it.
+     *
+     * @param sampleCount The number of samples (per channel) in the packet.
+     * @param sendTime The time the packet was sent.
+     * @param queueDepth The number of bytes queued in the transmit buffer after the packet was sent.
+     */
+    void onPacketSent(size_t sampleCount, Clock::time_point sendTime, size_t queueDepth);
+
+    /**
+     * Returns a snapshot of the counters of the pacer.
+     *
+     * @return The statistics of the pacer.
+     */
+    Statistics getStatistics() const;
+
+private:
+    /// Returns the deadline of the next packet.
+    Clock::time_point nextDeadline() const;
+
+    /// The @c timerfd.
+    int m_timerFD;
+
+    /// The sample rate of the stream.
+    unsigned int m_sampleRate;
+
+    /// @c true once the first packet has started the schedule.
+    bool m_started;
+
+    /// The time the schedule started at.
+    Clock::time_point m_origin;
+
+    /// The number of samples sent since @c m_origin.
+    uint64_t m_samplesSent;
+
+    /// The send jitter in microseconds, kept as a floating point for the smoothing.
+    double m_sendJitter;
+
+    /// Serializes the access to @c m_statistics.
+    mutable std::mutex m_statisticsMutex;
+
+    /// The counters exposed by @c getStatistics().
+    Statistics m_statistics;
+};
+
+} // namespace blueZ
+} // namespace bluetoothDevice
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_PACKETPACER_H_
@@ -0,0 +1,183 @@
+#ifndef DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_RECEIVEPIPELINE_H_
+#define DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_RECEIVEPIPELINE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <Common/Utils/Memory/BufferPool.h>
+#include <Common/Utils/Threading/SPSCQueue.h>
+
+#include <sys/socket.h>
+
+namespace deviceClientSDK {
+namespace bluetoothDevice {
+namespace blueZ {
+
+/**
+ * Receives the packets of a media stream on a thread of its own, and hands them to a consumer thread, so that the
+ * socket keeps being drained while the consumer is busy decoding and delivering audio.
+ *
+ * The packets are received into a @c BufferPool of MTU sized buffers, which is only reallocated when a stream comes
+ * with a larger MTU than the ones before. Filled buffers go to the consumer through a lock-free single producer, single
+ * consumer queue, and return to the pool once the consumer drops them. Neither thread locks or allocates per packet.
+ * When the consumer holds every buffer, the receiving thread waits for one to be released, and the packets wait in the
+ * socket buffer.
+ *
+ * All the methods but the constructor, @c start() and @c stop() are meant to be called from the consumer thread.
+ */
+class ReceivePipeline {
+public:
+    /// Clock used to timestamp the arrival of packets.
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * State of the receiving thread.
+     */
+    enum class State {
+        /// Packets are being received.
+        RUNNING,
+
+        /// The remote device closed the stream. No packet follows the ones queued.
+        END_OF_STREAM,
+
+        /// The stream could not be read. No packet follows the ones queued.
+        FAILED
+    };
+
+    /**
+     * A packet received. The consumer may keep its buffer as long as it likes; the receiving thread is only starved
+     * when every buffer of the pool is held.
+     */
+    struct Packet {
+        /// The buffer holding the packet, whose size is the length of the packet.
+        common::utils::memory::BufferPool::Buffer buffer;
+
+        /// The time the packet was received.
+        Clock::time_point arrivalTime;
+    };
+
+    /// Default number of buffers in the pool.
+    static constexpr size_t DEFAULT_BUFFER_COUNT = 64;
+
+    /**
+     * Constructor. Creates the eventfds of the pipeline.
+     *
+     * @param bufferCount The number of buffers in the pool.
+     */
+    explicit ReceivePipeline(size_t bufferCount = DEFAULT_BUFFER_COUNT);
+
+    /// Destructor. Stops the receiving thread.
+    ~ReceivePipeline();
+
+    /**
+     * Starts receiving the packets of a stream, allocating the pool of buffers unless the one of the previous stream is
+     * large enough. Every buffer of the previous stream must have been released.
+     *
+     * @param fd The media stream file descriptor.
+     * @param mtu The maximum size of a packet.
+     * @param cpu The CPU to pin the receiving thread to, or @c common::utils::threading::ANY_CPU.
+     * @return @c true if the receiving thread started, @c false if the eventfds of the pipeline are missing.
+     */
+    bool start(int fd, size_t mtu, int cpu);
+
+    /// Stops the receiving thread and drops the packets still queued.
+    void stop();
+
+    /**
+     * Returns an eventfd which becomes readable when packets are queued, or when the receiving thread stops.
+     *
+     * @return The file descriptor to poll.
+     */
+    int getFD() const;
+
+    /**
+     * Clears the readiness of @c getFD(), and returns the state of the receiving thread. Once a terminal state is
+     * returned, every packet received before it can be popped.
+     *
+     * @return The state of the receiving thread.
+     */
+    State acknowledge();
+
+    /**
+     * Removes the oldest packet from the queue.
+     *
+     * @param[out] packet The packet, whose buffer should be released with @c release() once processed.
+     * @return @c true if a packet was popped, @c false if the queue is empty.
+     */
+    bool pop(Packet* packet);
+
+    /**
+     * Drops the buffer of a packet, and wakes the receiving thread up if it was waiting for one.
+     *
+     * @param packet A packet returned by @c pop().
+     */
+    void release(Packet* packet);
+
+    /**
+     * Wakes the receiving thread up if it was waiting for a buffer. To be called after dropping buffers which were
+     * kept past @c release(), such as those moved out of the packets into a jitter buffer.
+     */
+    void notifyReleased();
+
+private:
+    /// The receiving thread main function.
+    void receiveThread(int fd, int cpu);
+
+    /**
+     * Receives the packets queued on the stream into the buffers held by the receiving thread, and queues them.
+     *
+     * @param fd The media stream file descriptor.
+     * @return @c false if the stream ended or failed.
+     */
+    bool receiveBatch(int fd);
+
+    /// Sets the terminal state of the receiving thread, and wakes the consumer up.
+    void finish(State state);
+
+    /// The number of buffers in the pool.
+    const size_t m_bufferCount;
+
+    /// The buffers, as large as the largest MTU seen.
+    std::unique_ptr<common::utils::memory::BufferPool> m_pool;
+
+    /// Packets received, for the consumer.
+    common::utils::threading::SPSCQueue<Packet> m_packets;
+
+    /// Buffers taken from @c m_pool by the receiving thread, which the next packets are received into.
+    std::vector<common::utils::memory::BufferPool::Buffer> m_heldBuffers;
+
+    /// The @c recvmmsg() message headers pointing at @c m_heldBuffers.
+    std::vector<mmsghdr> m_packetHeaders;
+
+    /// The I/O vectors of @c m_packetHeaders.
+    std::vector<iovec> m_packetVectors;
+
+    /// The eventfd signalled to the consumer.
+    int m_readyFD;
+
+    /// The eventfd which wakes the receiving thread up when it waits for buffers, or has to stop.
+    int m_wakeFD;
+
+    /// Set by the receiving thread when it waits for the consumer to release a buffer.
+    std::atomic<bool> m_starved;
+
+    /// Set to stop the receiving thread.
+    std::atomic<bool> m_stopping;
+
+    /// The state of the receiving thread.
+    std::atomic<State> m_state;
+
+    /// The receiving thread.
+    std::thread m_thread;
+};
+
+} // namespace blueZ
+} // namespace bluetoothDevice
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_BLUETOOTHDEVICE_BLUEZ_RECEIVEPIPELINE_H_
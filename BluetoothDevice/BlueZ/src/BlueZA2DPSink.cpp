@@ -2,6 +2,7 @@
 
 #include "BlueZ/BlueZA2DPSink.h"
 #include "BlueZ/BlueZDeviceManager.h"
+#include "BlueZ/MediaEndpoint.h"
 
 namespace deviceClientSDK {
 namespace bluetoothDevice {
@@ -10,9 +11,26 @@ namespace blueZ {
 
 using namespace common::utils;
 using namespace common::sdkInterfaces::bluetooth::services;
+using namespace common::utils::logger;
 
-std::shared_ptr<BlueZA2DPSink> BlueZA2DPSink::create() {
-    return std::shared_ptr<BlueZA2DPSink>(new BlueZA2DPSink());
+static const std::string TAG_BLUEZA2DPSINK = "BlueZA2DPSink\t";
+
+std::shared_ptr<BlueZA2DPSink> BlueZA2DPSink::create(std::shared_ptr<BlueZDeviceManager> deviceManager) {
+    if(nullptr == deviceManager) {
+        LOG_ERROR << TAG_BLUEZA2DPSINK << "createFailed, reason: deviceManager is null";
+        return nullptr;
+    }
+    return std::shared_ptr<BlueZA2DPSink>(new BlueZA2DPSink(deviceManager));
+}
+
+bool BlueZA2DPSink::setSourceStream(std::shared_ptr<common::utils::AudioInputStream> stream) {
+    auto endpoint = m_deviceManager->getSourceMediaEndpoint();
+    if(!endpoint) {
+        LOG_ERROR << TAG_BLUEZA2DPSINK << "setSourceStreamFailed; reason: Failed to get source media endpoint";
+        return false;
+    }
+
+    return endpoint->setSourceStream(stream);
 }
 
 void BlueZA2DPSink::setup() {
@@ -25,7 +43,9 @@ std::shared_ptr<SDPRecordInterface> BlueZA2DPSink::getRecord() {
     return m_record;
 }
 
-BlueZA2DPSink::BlueZA2DPSink() : m_record{std::make_shared<bluetooth::A2DPSinkRecord>("")} {
+BlueZA2DPSink::BlueZA2DPSink(std::shared_ptr<BlueZDeviceManager> deviceManager) :
+        m_record{std::make_shared<bluetooth::A2DPSinkRecord>("")},
+        m_deviceManager{deviceManager} {
 }
 
 } // namespace blueZ
@@ -14,18 +14,22 @@ using namespace common::utils;
 using namespace common::sdkInterfaces::bluetooth::services;
 using namespace common::utils::logger;
 
-std::shared_ptr<BlueZA2DPSource> BlueZA2DPSource::create(std::shared_ptr<BlueZDeviceManager> deviceManager) {
+std::shared_ptr<BlueZA2DPSource> BlueZA2DPSource::create(
+    std::shared_ptr<BlueZDeviceManager> deviceManager,
+    const std::string& devicePath) {
     if(nullptr == deviceManager) {
         LOG_ERROR << TAG_BLUEZA2DPSOURCE << "createFailed, reason: deviceManager is null";
         return nullptr;
     }
-    return std::shared_ptr<BlueZA2DPSource>(new BlueZA2DPSource(deviceManager));
+    return std::shared_ptr<BlueZA2DPSource>(new BlueZA2DPSource(deviceManager, devicePath));
 }
 
 std::shared_ptr<common::utils::bluetooth::FormattedAudioStreamAdapter> BlueZA2DPSource::getSourceStream() {
-    auto endpoint = m_deviceManager->getMediaEndpoint();
+    // Several devices can stream at once, each to an endpoint of its own.
+    auto endpoint = m_deviceManager->getSinkMediaEndpoint(m_devicePath);
     if(!endpoint) {
-        LOG_ERROR << TAG_BLUEZA2DPSOURCE << "getSourceStreamFailed; reason: Failed to get media endpoint";
+        LOG_ERROR << TAG_BLUEZA2DPSOURCE << "getSourceStreamFailed; reason: No media endpoint configured for device; "
+                  << "devicePath: " << m_devicePath;
         return nullptr;
     }
 
@@ -42,9 +46,10 @@ std::shared_ptr<SDPRecordInterface> BlueZA2DPSource::getRecord() {
     return m_record;
 }
 
-BlueZA2DPSource::BlueZA2DPSource(std::shared_ptr<BlueZDeviceManager> deviceManager) :
+BlueZA2DPSource::BlueZA2DPSource(std::shared_ptr<BlueZDeviceManager> deviceManager, const std::string& devicePath) :
         m_record{std::make_shared<bluetooth::A2DPSourceRecord>("")},
-        m_deviceManager{deviceManager} {
+        m_deviceManager{deviceManager},
+        m_devicePath{devicePath} {
 }
 
 } // namespace blueZ
@@ -144,7 +144,7 @@ bool BlueZBluetoothDevice::init() {
 bool BlueZBluetoothDevice::initializeServices(const std::unordered_set<std::string>& uuids) {
     for(const auto& uuid : uuids) {
         if(A2DPSourceInterface::UUID == uuid && !serviceExists(uuid)) {
-            auto a2dpSource = BlueZA2DPSource::create(m_deviceManager);
+            auto a2dpSource = BlueZA2DPSource::create(m_deviceManager, m_objectPath);
             if(!a2dpSource) {
                 LOG_ERROR << TAG_BLUEZBLUETOOTHDEVICE << "reason: createA2DPFailed";
                 return false;
@@ -168,7 +168,7 @@ bool BlueZBluetoothDevice::initializeServices(const std::unordered_set<std::stri
                 insertService(avrcpTarget);
             }
         } else if(A2DPSinkInterface::UUID == uuid && !serviceExists(uuid)) {
-            auto a2dpSink = BlueZA2DPSink::create();
+            auto a2dpSink = BlueZA2DPSink::create(m_deviceManager);
             if(!a2dpSink) {
                 LOG_ERROR << TAG_BLUEZBLUETOOTHDEVICE << "reason: createA2DPSinkFailed";
                 return false;
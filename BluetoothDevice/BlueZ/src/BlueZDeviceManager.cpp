@@ -3,6 +3,9 @@
 #include <string>
 #include <unordered_map>
 
+#include <Common/Utils/Audio/DuckingStage.h>
+#include <Common/Utils/Audio/EqualizerStage.h>
+#include <Common/Utils/Audio/LimiterStage.h>
 #include <Common/Utils/Bluetooth/BluetoothEvents.h>
 #include <Common/Utils/Bluetooth/SDPRecords.h>
 #include <Common/Utils/UUIDGeneration/UUIDGeneration.h>
@@ -13,6 +16,7 @@
 #include "BlueZ/BlueZDeviceManager.h"
 #include "BlueZ/BlueZHostController.h"
 #include "BlueZ/MediaEndpoint.h"
+#include "BlueZ/MediaReactor.h"
 
 namespace deviceClientSDK {
 namespace bluetoothDevice {
@@ -52,6 +56,18 @@ static const int SBC_BITPOOL_MAX = 64;
  */
 static const char* DBUS_ENDPOINT_PATH_SINK = "/com/device/sdk/sinkendpoint";
 
+/**
+ * Number of SINK media endpoints registered, which is the number of remote devices that can stream to this device at
+ * once: BlueZ uses an endpoint for one stream at a time. The endpoints after the first one are at the path of the
+ * first one followed by their index.
+ */
+static const size_t SINK_ENDPOINT_COUNT = 3;
+
+/**
+ * DBus object path for the SOURCE media endpoint
+ */
+static const char* DBUS_ENDPOINT_PATH_SOURCE = "/com/device/sdk/sourceendpoint";
+
 /**
  * BlueZ A2DP streaming state when audio data is streaming from the device, but we still did not acquire the file
  * descriptor.
@@ -137,10 +153,58 @@ bool BlueZDeviceManager::init() {
 }
 
 bool BlueZDeviceManager::initializeMedia() {
+    // All the streams, in either direction, are driven by one thread.
+    m_mediaReactor = MediaReactor::create();
+    if(!m_mediaReactor) {
+        LOG_ERROR << TAG_BLUEZDEVICEMANAGER << "initializeMediaFailed; reason: Failed to create media reactor";
+        return false;
+    }
+
     // Create Media interface proxy to register MediaEndpoint
-    m_mediaEndpoint = std::make_shared<MediaEndpoint>(m_connection, DBUS_ENDPOINT_PATH_SINK);
+    // The processing is installed before BlueZ knows of the endpoint, so that no stream can start without it.
+    m_mediaEndpoint =
+        std::make_shared<MediaEndpoint>(m_connection, DBUS_ENDPOINT_PATH_SINK, A2DPRole::SINK, m_mediaReactor);
+    installSinkProcessing(m_mediaEndpoint);
+    if(!registerMediaEndpoint(m_mediaEndpoint, A2DPSinkInterface::UUID)) {
+        return false;
+    }
+    m_sinkMediaEndpoints.push_back(m_mediaEndpoint);
 
-    if(!m_mediaEndpoint->registerWithDBus()) {
+    // Receiving from more than one device at once is optional: the first endpoint is enough to work as a sink.
+    for(size_t i = 1; i < SINK_ENDPOINT_COUNT; ++i) {
+        auto endpoint = std::make_shared<MediaEndpoint>(
+            m_connection, DBUS_ENDPOINT_PATH_SINK + std::to_string(i), A2DPRole::SINK, m_mediaReactor);
+        installSinkProcessing(endpoint);
+        if(!registerMediaEndpoint(endpoint, A2DPSinkInterface::UUID)) {
+            break;
+        }
+        m_sinkMediaEndpoints.push_back(endpoint);
+    }
+
+    // Streaming to remote sinks is optional: the device still works as a sink without it.
+    m_sourceMediaEndpoint = std::make_shared<MediaEndpoint>(
+        m_connection, DBUS_ENDPOINT_PATH_SOURCE, A2DPRole::SOURCE, m_mediaReactor);
+    if(!registerMediaEndpoint(m_sourceMediaEndpoint, A2DPSourceInterface::UUID)) {
+        m_sourceMediaEndpoint.reset();
+    }
+
+    return true;
+}
+
+void BlueZDeviceManager::installSinkProcessing(std::shared_ptr<MediaEndpoint> endpoint) {
+    // Each endpoint has stages of its own, since they keep the state of its stream. The equalizer starts flat and the
+    // limiter at full scale, until they are tuned through MediaEndpoint::getProcessingStages(). The ducking comes
+    // last, so that the limiter does not make up for it.
+    auto ducking = std::make_shared<audio::DuckingStage>();
+    m_eventBus->addListener({BluetoothEventType::AUDIO_DUCKING_CHANGED}, ducking);
+    m_duckingStages.push_back(ducking);
+
+    endpoint->setProcessingStages(
+        {std::make_shared<audio::EqualizerStage>(), std::make_shared<audio::LimiterStage>(), ducking});
+}
+
+bool BlueZDeviceManager::registerMediaEndpoint(std::shared_ptr<MediaEndpoint> endpoint, const std::string& uuid) {
+    if(!endpoint->registerWithDBus()) {
         LOG_ERROR << TAG_BLUEZDEVICEMANAGER << "registerEndpointFailed";
         return false;
     }
@@ -169,10 +233,10 @@ bool BlueZDeviceManager::initializeMedia() {
 
     b = g_variant_builder_new(G_VARIANT_TYPE("a{sv}"));
 
-    std::string a2dpSinkUuid = A2DPSinkInterface::UUID;
-    std::transform(a2dpSinkUuid.begin(), a2dpSinkUuid.end(), a2dpSinkUuid.begin(), ::toupper);
+    std::string endpointUuid = uuid;
+    std::transform(endpointUuid.begin(), endpointUuid.end(), endpointUuid.begin(), ::toupper);
 
-    g_variant_builder_add(b, "{sv}", "UUID", g_variant_new_string(a2dpSinkUuid.c_str()));
+    g_variant_builder_add(b, "{sv}", "UUID", g_variant_new_string(endpointUuid.c_str()));
     g_variant_builder_add(b, "{sv}", "Codec", g_variant_new_byte(A2DP_CODEC_SBC));
     g_variant_builder_add(b, "{sv}", "Capabilities", caps);
 
@@ -180,10 +244,13 @@ bool BlueZDeviceManager::initializeMedia() {
     GVariant* parameters = g_variant_builder_end(b);
 
     m_mediaProxy->callMethod(
-        "RegisterEndpoint", g_variant_new("(o@a{sv})", DBUS_ENDPOINT_PATH_SINK, parameters), error.toOutputParameter());
+        "RegisterEndpoint",
+        g_variant_new("(o@a{sv})", endpoint->getEndpointPath().c_str(), parameters),
+        error.toOutputParameter());
 
     if(error.hasError()) {
-        LOG_ERROR << TAG_BLUEZDEVICEMANAGER << "Failed to register MediaEndpoint";
+        LOG_ERROR << TAG_BLUEZDEVICEMANAGER << "Failed to register MediaEndpoint; path: "
+                  << endpoint->getEndpointPath();
         return false;
     }
 
@@ -249,7 +316,8 @@ void BlueZDeviceManager::onMediaStreamPropertyChanged(const std::string& path, c
 
     char* newStateStr;
     common::utils::bluetooth::MediaStreamingState newState;
-    if(changesMap.getCString(MEDIATRANSPORT_PROPERTY_STATE, &newStateStr)) {
+    const bool stateChanged = changesMap.getCString(MEDIATRANSPORT_PROPERTY_STATE, &newStateStr);
+    if(stateChanged) {
 
         LOG_DEBUG << TAG_BLUEZDEVICEMANAGER << "onMediaStreamPropertyChanged, newState: " << newStateStr;
 
@@ -272,22 +340,33 @@ void BlueZDeviceManager::onMediaStreamPropertyChanged(const std::string& path, c
             return;
         }
 
+        if(stateChanged && m_sourceMediaEndpoint && path == m_sourceMediaEndpoint->getStreamingDevicePath()) {
+            m_sourceMediaEndpoint->onMediaTransportStateChanged(newState, path);
+        }
+
         MediaStreamingStateChangedEvent event(newState, A2DPRole::SOURCE, device);
         m_eventBus->sendEvent(event);
         return;
     } else if(A2DPSinkInterface::UUID == uuid) {
-        if(path != m_mediaEndpoint->getStreamingDevicePath()) {
-            // LOG_DEBUG << TAG_BLUEZDEVICEMANAGER << "reason: pathMismatch; path: "
-            //           << m_mediaEndpoint->getStreamingDevicePath();
+        // Each device streams through the endpoint BlueZ configured for it.
+        std::shared_ptr<MediaEndpoint> endpoint;
+        for(const auto& sinkEndpoint : m_sinkMediaEndpoints) {
+            if(path == sinkEndpoint->getStreamingDevicePath()) {
+                endpoint = sinkEndpoint;
+                break;
+            }
+        }
+        if(!endpoint || !stateChanged) {
             return;
         }
 
-        if(m_streamingState == newState) {
+        auto streamingState = m_streamingStates.find(endpoint->getEndpointPath());
+        if(streamingState != m_streamingStates.end() && streamingState->second == newState) {
             return;
         }
 
-        m_streamingState = newState;
-        m_mediaEndpoint->onMediaTransportStateChanged(newState, path);
+        m_streamingStates[endpoint->getEndpointPath()] = newState;
+        endpoint->onMediaTransportStateChanged(newState, path);
 
         MediaStreamingStateChangedEvent event(newState, bluetooth::A2DPRole::SINK, device);
         m_eventBus->sendEvent(event);
@@ -514,8 +593,7 @@ BlueZDeviceManager::~BlueZDeviceManager() {
 BlueZDeviceManager::BlueZDeviceManager(
     const std::shared_ptr<common::utils::bluetooth::BluetoothEventBus>& eventBus) : 
         RequiresShutdown{"BlueZDeviceManager"},
-        m_eventBus{eventBus},
-        m_streamingState{common::utils::bluetooth::MediaStreamingState::IDLE} {
+        m_eventBus{eventBus} {
 
 }
 
@@ -611,6 +689,25 @@ std::shared_ptr<MediaEndpoint> BlueZDeviceManager::getMediaEndpoint() {
     return m_mediaEndpoint;
 }
 
+std::vector<std::shared_ptr<MediaEndpoint>> BlueZDeviceManager::getSinkMediaEndpoints() {
+    return m_sinkMediaEndpoints;
+}
+
+std::shared_ptr<MediaEndpoint> BlueZDeviceManager::getSinkMediaEndpoint(const std::string& devicePath) {
+    // The transports of a device are objects under its path.
+    const std::string transportPathPrefix = devicePath + "/";
+    for(const auto& endpoint : m_sinkMediaEndpoints) {
+        if(0 == endpoint->getStreamingDevicePath().compare(0, transportPathPrefix.size(), transportPathPrefix)) {
+            return endpoint;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<MediaEndpoint> BlueZDeviceManager::getSourceMediaEndpoint() {
+    return m_sourceMediaEndpoint;
+}
+
 std::shared_ptr<BluetoothHostControllerInterface> BlueZDeviceManager::getHostController() {
     return m_hostController;
 }
@@ -622,15 +719,43 @@ std::shared_ptr<common::utils::bluetooth::BluetoothEventBus> BlueZDeviceManager:
 bool BlueZDeviceManager::finalizeMedia() {
     ManagedGError error;
 
-    m_mediaProxy->callMethod(
-        "UnregisterEndpoint", g_variant_new("(o)", DBUS_ENDPOINT_PATH_SINK), error.toOutputParameter());
+    if(m_sourceMediaEndpoint) {
+        m_mediaProxy->callMethod(
+            "UnregisterEndpoint", g_variant_new("(o)", DBUS_ENDPOINT_PATH_SOURCE), error.toOutputParameter());
 
-    if(error.hasError()) {
-        LOG_ERROR << TAG_BLUEZDEVICEMANAGER << "finalizeMediaFailed; reason: Failed to unregister MediaEndpoint";
-        return false;
+        if(error.hasError()) {
+            LOG_ERROR << TAG_BLUEZDEVICEMANAGER
+                      << "finalizeMediaFailed; reason: Failed to unregister source MediaEndpoint";
+            return false;
+        }
+
+        m_sourceMediaEndpoint.reset();
+    }
+
+    while(!m_sinkMediaEndpoints.empty()) {
+        m_mediaProxy->callMethod(
+            "UnregisterEndpoint",
+            g_variant_new("(o)", m_sinkMediaEndpoints.back()->getEndpointPath().c_str()),
+            error.toOutputParameter());
+
+        if(error.hasError()) {
+            LOG_ERROR << TAG_BLUEZDEVICEMANAGER << "finalizeMediaFailed; reason: Failed to unregister MediaEndpoint";
+            return false;
+        }
+
+        m_sinkMediaEndpoints.pop_back();
     }
 
     m_mediaEndpoint.reset();
+    m_streamingStates.clear();
+
+    for(auto& ducking : m_duckingStages) {
+        m_eventBus->removeListener({BluetoothEventType::AUDIO_DUCKING_CHANGED}, ducking);
+    }
+    m_duckingStages.clear();
+
+    // Every endpoint is gone, so nothing is watched anymore.
+    m_mediaReactor.reset();
 
     return true;
 }
@@ -0,0 +1,112 @@
+#include "BlueZ/ClockDriftEstimator.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace deviceClientSDK {
+namespace bluetoothDevice {
+namespace blueZ {
+
+constexpr std::chrono::seconds ClockDriftEstimator::WINDOW_DURATION;
+constexpr size_t ClockDriftEstimator::WINDOW_COUNT;
+constexpr size_t ClockDriftEstimator::MIN_WINDOW_COUNT;
+constexpr double ClockDriftEstimator::MAX_DRIFT;
+
+ClockDriftEstimator::ClockDriftEstimator() :
+        m_sampleRate{0},
+        m_started{false},
+        m_lastTimestamp{0},
+        m_mediaPosition{0},
+        m_windowMinimum{0},
+        m_windowMinimumTime{0},
+        m_times(WINDOW_COUNT),
+        m_transits(WINDOW_COUNT),
+        m_windowCount{0},
+        m_nextWindow{0},
+        m_ratio{1.0} {
+}
+
+void ClockDriftEstimator::reset(unsigned int sampleRate) {
+    m_sampleRate = sampleRate;
+    m_ratio = 1.0;
+    restart();
+}
+
+void ClockDriftEstimator::restart() {
+    m_started = false;
+    m_windowCount = 0;
+    m_nextWindow = 0;
+}
+
+bool ClockDriftEstimator::addObservation(uint32_t timestamp, Clock::time_point arrivalTime) {
+    if(0 == m_sampleRate) {
+        return false;
+    }
+
+    if(!m_started) {
+        m_started = true;
+        m_origin = arrivalTime;
+        m_lastTimestamp = timestamp;
+        m_mediaPosition = 0;
+        m_windowStart = arrivalTime;
+        m_windowMinimum = std::numeric_limits<double>::max();
+    }
+
+    m_mediaPosition += static_cast<int32_t>(timestamp - m_lastTimestamp);
+    m_lastTimestamp = timestamp;
+
+    const double localTime = std::chrono::duration<double>(arrivalTime - m_origin).count();
+    const double transit = localTime - static_cast<double>(m_mediaPosition) / m_sampleRate;
+    if(transit < m_windowMinimum) {
+        m_windowMinimum = transit;
+        m_windowMinimumTime = localTime;
+    }
+
+    if(arrivalTime - m_windowStart < WINDOW_DURATION) {
+        return false;
+    }
+
+    m_times[m_nextWindow] = m_windowMinimumTime;
+    m_transits[m_nextWindow] = m_windowMinimum;
+    m_nextWindow = (m_nextWindow + 1) % WINDOW_COUNT;
+    m_windowCount = std::min(m_windowCount + 1, WINDOW_COUNT);
+    m_windowStart = arrivalTime;
+    m_windowMinimum = std::numeric_limits<double>::max();
+
+    if(m_windowCount < MIN_WINDOW_COUNT) {
+        return false;
+    }
+
+    // Least squares slope of the transit times over the local times. The transit time grows by the slope every
+    // second, so the remote clock advances by one minus the slope.
+    double meanTime = 0;
+    double meanTransit = 0;
+    for(size_t i = 0; i < m_windowCount; ++i) {
+        meanTime += m_times[i];
+        meanTransit += m_transits[i];
+    }
+    meanTime /= m_windowCount;
+    meanTransit /= m_windowCount;
+
+    double covariance = 0;
+    double variance = 0;
+    for(size_t i = 0; i < m_windowCount; ++i) {
+        covariance += (m_times[i] - meanTime) * (m_transits[i] - meanTransit);
+        variance += (m_times[i] - meanTime) * (m_times[i] - meanTime);
+    }
+    if(variance <= 0) {
+        return false;
+    }
+
+    const double drift = std::min(std::max(covariance / variance, -MAX_DRIFT), MAX_DRIFT);
+    m_ratio = 1.0 - drift;
+    return true;
+}
+
+double ClockDriftEstimator::getRatio() const {
+    return m_ratio;
+}
+
+} // namespace blueZ
+} // namespace bluetoothDevice
+} // namespace deviceClientSDK
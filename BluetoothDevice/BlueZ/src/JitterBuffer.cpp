@@ -0,0 +1,389 @@
+#include <Common/Utils/Logger/Log.h>
+#include "BlueZ/JitterBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace deviceClientSDK {
+namespace bluetoothDevice {
+namespace blueZ {
+
+using namespace common::utils::logger;
+
+static const std::string TAG_JITTERBUFFER = "JitterBuffer\t";
+
+// Multiple of the interarrival jitter used as the target latency.
+constexpr double JITTER_MULTIPLIER = 4.0;
+
+// Largest change of the playout delay per packet released, so that the schedule moves smoothly to the target.
+constexpr std::chrono::microseconds ADAPTATION_STEP(500);
+
+// Number of concealed frames over which the repeated audio fades out to silence.
+constexpr size_t CONCEALMENT_FADE_FRAMES = 8;
+
+constexpr size_t JitterBuffer::SLOT_COUNT;
+constexpr std::chrono::milliseconds JitterBuffer::DEFAULT_MINIMUM_LATENCY;
+constexpr std::chrono::milliseconds JitterBuffer::DEFAULT_MAXIMUM_LATENCY;
+
+/**
+ * Returns the signed distance from one RTP sequence number to another, accounting for wrap around.
+ */
+static int sequenceDistance(uint16_t from, uint16_t to) {
+    return static_cast<int16_t>(static_cast<uint16_t>(to - from));
+}
+
+JitterBuffer::JitterBuffer(std::chrono::milliseconds minimumLatency, std::chrono::milliseconds maximumLatency) :
+        m_minimumLatency{minimumLatency},
+        m_maximumLatency{std::max(minimumLatency, maximumLatency)},
+        m_maxPayloadLength{0},
+        m_sampleRate{0},
+        m_samplesPerFrame{0},
+        m_frameLength{0},
+        m_slots(SLOT_COUNT) {
+    start(0, 0, 0, 0);
+}
+
+void JitterBuffer::setLatencyBounds(
+    std::chrono::milliseconds minimumLatency,
+    std::chrono::milliseconds maximumLatency) {
+    if(maximumLatency < minimumLatency) {
+        LOG_ERROR << TAG_JITTERBUFFER << "setLatencyBoundsFailed; reason: maximum below minimum";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_minimumLatency = minimumLatency;
+    m_maximumLatency = maximumLatency;
+    m_statistics.targetLatency = std::min(std::max(m_statistics.targetLatency, m_minimumLatency), m_maximumLatency);
+}
+
+void JitterBuffer::start(size_t maxPayloadLength, unsigned int sampleRate, size_t samplesPerFrame, size_t frameLength) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_maxPayloadLength = maxPayloadLength;
+    m_sampleRate = sampleRate;
+    m_samplesPerFrame = samplesPerFrame;
+    m_frameLength = frameLength;
+    m_concealmentPayload.resize(maxPayloadLength);
+
+    m_statistics = Statistics();
+    m_statistics.targetLatency = m_minimumLatency;
+    m_statistics.playoutDelay = m_minimumLatency;
+    m_jitter = 0;
+    m_driftEstimator.reset(sampleRate);
+    m_clockRatio = 1.0;
+    resetLocked();
+}
+
+bool JitterBuffer::push(
+    uint16_t sequenceNumber,
+    uint32_t timestamp,
+    common::utils::memory::BufferPool::Buffer buffer,
+    size_t payloadOffset,
+    size_t frameCount,
+    Clock::time_point arrivalTime) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(0 == m_sampleRate || payloadOffset > buffer.size() || buffer.size() - payloadOffset > m_maxPayloadLength) {
+        LOG_ERROR << TAG_JITTERBUFFER << "pushFailed; reason: packet does not fit";
+        return false;
+    }
+    const size_t inputLength = buffer.size() - payloadOffset;
+
+    ++m_statistics.packetsReceived;
+
+    if(m_scheduled) {
+        int distance = sequenceDistance(m_nextSequenceNumber, sequenceNumber);
+        if(distance >= static_cast<int>(SLOT_COUNT) || distance <= -static_cast<int>(SLOT_COUNT)) {
+            // Too far ahead to be buffered, or too far behind to be a late packet: the sender started over.
+            LOG_DEBUG << TAG_JITTERBUFFER << "Resynchronizing; distance: " << distance;
+            ++m_statistics.resynchronizations;
+            resetLocked();
+        } else if(distance < 0) {
+            // Its turn has passed, and it was concealed.
+            ++m_statistics.packetsLate;
+            return false;
+        }
+    }
+
+    if(!m_scheduled) {
+        m_scheduled = true;
+        m_nextSequenceNumber = sequenceNumber;
+        m_nextTimestamp = timestamp;
+        m_highestSequenceNumber = sequenceNumber;
+        m_baseArrivalTime = arrivalTime;
+        m_baseTimestamp = timestamp;
+        m_previousTransit = 0;
+    }
+
+    Slot& slot = slotOf(sequenceNumber);
+    if(slot.used) {
+        ++m_statistics.packetsDuplicated;
+        return false;
+    }
+
+    auto lateness = std::chrono::duration_cast<std::chrono::microseconds>(arrivalTime - playoutTimeLocked(timestamp));
+    if(lateness > m_maximumLatency) {
+        // The sender stalled: start the schedule over from this packet.
+        ++m_statistics.underruns;
+        m_baseArrivalTime = arrivalTime;
+        m_baseTimestamp = timestamp;
+        m_previousTransit = 0;
+        m_driftEstimator.restart();
+    } else if(lateness > std::chrono::microseconds::zero()) {
+        // Arrived after its playout time: push the whole schedule back so that it, and the packets after it, are in
+        // time again. The delay then steers back to the target like after any other change.
+        ++m_statistics.underruns;
+        m_statistics.playoutDelay += lateness;
+    }
+
+    if(sequenceDistance(m_highestSequenceNumber, sequenceNumber) < 0) {
+        ++m_statistics.packetsReordered;
+    } else {
+        m_highestSequenceNumber = sequenceNumber;
+        updateJitterLocked(timestamp, arrivalTime);
+        if(m_driftEstimator.addObservation(timestamp, arrivalTime)) {
+            setClockRatioLocked(m_driftEstimator.getRatio());
+        }
+    }
+
+    slot.used = true;
+    slot.sequenceNumber = sequenceNumber;
+    slot.timestamp = timestamp;
+    slot.buffer = std::move(buffer);
+    slot.payloadOffset = payloadOffset;
+    slot.inputLength = inputLength;
+    slot.frameCount = frameCount;
+
+    ++m_statistics.depth;
+    m_bufferedFrames += frameCount;
+    return true;
+}
+
+bool JitterBuffer::pop(Clock::time_point now, Packet* packet) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    while(m_statistics.depth > 0) {
+        if(slotOf(m_nextSequenceNumber).used) {
+            if(now < playoutTimeLocked(slotOf(m_nextSequenceNumber).timestamp)) {
+                return false;
+            }
+            releaseLocked(packet);
+            return true;
+        }
+
+        // The next packet is missing, but a later one is buffered. Wait for it until its playout time.
+        if(now < playoutTimeLocked(m_nextTimestamp)) {
+            return false;
+        }
+        if(concealLocked(packet)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int JitterBuffer::getReleaseTimeout(Clock::time_point now) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if(0 == m_statistics.depth) {
+        return -1;
+    }
+
+    const Slot& slot = m_slots[m_nextSequenceNumber % SLOT_COUNT];
+    uint32_t timestamp = slot.used && slot.sequenceNumber == m_nextSequenceNumber ? slot.timestamp : m_nextTimestamp;
+    auto timeout = playoutTimeLocked(timestamp) - now;
+    if(timeout <= Clock::duration::zero()) {
+        return 0;
+    }
+
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        timeout + std::chrono::milliseconds(1) - Clock::duration(1)).count());
+}
+
+double JitterBuffer::getClockRatio() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_clockRatio;
+}
+
+JitterBuffer::Statistics JitterBuffer::getStatistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Statistics statistics = m_statistics;
+    statistics.clockDrift = (m_clockRatio - 1.0) * 1000000;
+    if(m_sampleRate > 0) {
+        statistics.bufferedDuration = std::chrono::microseconds(
+            static_cast<int64_t>(m_bufferedFrames * m_samplesPerFrame) * 1000000 / m_sampleRate);
+        statistics.jitter = std::chrono::microseconds(static_cast<int64_t>(m_jitter * 1000000 / m_sampleRate));
+    }
+    return statistics;
+}
+
+JitterBuffer::Slot& JitterBuffer::slotOf(uint16_t sequenceNumber) {
+    Slot& slot = m_slots[sequenceNumber % SLOT_COUNT];
+    if(slot.used && slot.sequenceNumber != sequenceNumber) {
+        // Left over from a previous lap of the sequence numbers, which the checks of push() should never let happen.
+        // Drop it, and keep the counters in step so that concealLocked() doesn't look for it.
+        LOG_ERROR << TAG_JITTERBUFFER << "Dropping stale slot; sequenceNumber: " << slot.sequenceNumber;
+        slot.used = false;
+        slot.buffer.reset();
+        --m_statistics.depth;
+        m_bufferedFrames -= slot.frameCount;
+    }
+    return slot;
+}
+
+JitterBuffer::Clock::time_point JitterBuffer::playoutTimeLocked(uint32_t timestamp) const {
+    // The media time elapsed since the start of the schedule, on the clock of the remote source.
+    double elapsed = static_cast<int32_t>(timestamp - m_baseTimestamp) / (m_sampleRate * m_clockRatio);
+    return m_baseArrivalTime + std::chrono::microseconds(static_cast<int64_t>(elapsed * 1000000)) +
+        m_statistics.playoutDelay;
+}
+
+float JitterBuffer::concealmentGain(size_t framesConcealed) {
+    if(framesConcealed >= CONCEALMENT_FADE_FRAMES) {
+        return 0.0f;
+    }
+    return 1.0f - static_cast<float>(framesConcealed) / CONCEALMENT_FADE_FRAMES;
+}
+
+void JitterBuffer::resetLocked() {
+    for(auto& slot : m_slots) {
+        slot.used = false;
+        slot.buffer.reset();
+    }
+    m_scheduled = false;
+    m_nextSequenceNumber = 0;
+    m_nextTimestamp = 0;
+    m_highestSequenceNumber = 0;
+    m_driftEstimator.restart();
+    m_lastFrameCount = 0;
+    m_framesConcealedInRow = 0;
+    m_baseTimestamp = 0;
+    m_previousTransit = 0;
+    m_bufferedFrames = 0;
+    m_statistics.depth = 0;
+}
+
+void JitterBuffer::updateJitterLocked(uint32_t timestamp, Clock::time_point arrivalTime) {
+    // RFC 3550, section 6.4.1: the transit time is the arrival time in timestamp units minus the timestamp. Only its
+    // variation matters, so it is taken relative to the start of the schedule.
+    double arrival = std::chrono::duration<double>(arrivalTime - m_baseArrivalTime).count() * m_sampleRate;
+    double transit = arrival - static_cast<int32_t>(timestamp - m_baseTimestamp);
+    if(m_statistics.packetsReceived > 1) {
+        m_jitter += (std::fabs(transit - m_previousTransit) - m_jitter) / 16;
+    }
+    m_previousTransit = transit;
+
+    auto target =
+        std::chrono::microseconds(static_cast<int64_t>(JITTER_MULTIPLIER * m_jitter * 1000000 / m_sampleRate));
+    m_statistics.targetLatency = std::min(std::max(target, m_minimumLatency), m_maximumLatency);
+}
+
+void JitterBuffer::setClockRatioLocked(double ratio) {
+    m_baseArrivalTime = playoutTimeLocked(m_nextTimestamp) - m_statistics.playoutDelay;
+    m_baseTimestamp = m_nextTimestamp;
+    m_clockRatio = ratio;
+}
+
+void JitterBuffer::releaseLocked(Packet* packet) {
+    Slot& slot = slotOf(m_nextSequenceNumber);
+
+    packet->buffer = std::move(slot.buffer);
+    packet->payloadData = packet->buffer.data() + slot.payloadOffset;
+    packet->inputLength = slot.inputLength;
+    packet->frameCount = slot.frameCount;
+    packet->concealed = false;
+    // Fade back in after a concealment.
+    packet->startGain = concealmentGain(m_framesConcealedInRow);
+    packet->endGain = 1.0f;
+
+    if(slot.frameCount > 0 && slot.frameCount * m_frameLength <= slot.inputLength) {
+        // Keep the last frame to repeat it, should the next packet be lost.
+        size_t lastFrameOffset = (slot.frameCount - 1) * m_frameLength;
+        for(size_t offset = 0; offset + m_frameLength <= m_concealmentPayload.size(); offset += m_frameLength) {
+            memcpy(m_concealmentPayload.data() + offset, packet->payloadData + lastFrameOffset, m_frameLength);
+        }
+        m_lastFrameCount = slot.frameCount;
+    }
+    m_framesConcealedInRow = 0;
+
+    slot.used = false;
+    --m_statistics.depth;
+    m_bufferedFrames -= slot.frameCount;
+    ++m_nextSequenceNumber;
+    m_nextTimestamp = slot.timestamp + static_cast<uint32_t>(slot.frameCount * m_samplesPerFrame);
+
+    // Steer the playout delay to the target, a step at a time.
+    auto error = m_statistics.targetLatency - m_statistics.playoutDelay;
+    m_statistics.playoutDelay += std::min(std::max(error, -ADAPTATION_STEP), ADAPTATION_STEP);
+}
+
+bool JitterBuffer::concealLocked(Packet* packet) {
+    // Every buffered packet is less than SLOT_COUNT ahead of the next one to release, so with a packet buffered the
+    // search ends within the buffer.
+    uint16_t nextSequenceNumber = m_nextSequenceNumber;
+    size_t searched = 0;
+    while(!slotOf(++nextSequenceNumber).used) {
+        if(++searched == SLOT_COUNT) {
+            LOG_ERROR << TAG_JITTERBUFFER << "concealFailed; reason: no packet buffered; depth: "
+                      << m_statistics.depth;
+            resetLocked();
+            return false;
+        }
+    }
+    const Slot& next = slotOf(nextSequenceNumber);
+    const size_t missingPackets = static_cast<size_t>(sequenceDistance(m_nextSequenceNumber, nextSequenceNumber));
+
+    // Size the gap by the timestamps, or failing that, as if the missing packets were as long as the last one.
+    const int32_t gapSamples = static_cast<int32_t>(next.timestamp - m_nextTimestamp);
+    size_t gapFrames = 0;
+    if(gapSamples > 0 && m_samplesPerFrame > 0) {
+        gapFrames = static_cast<size_t>(gapSamples) / m_samplesPerFrame;
+    } else if(gapSamples < 0) {
+        gapFrames = missingPackets * m_lastFrameCount;
+    }
+
+    const size_t maxGapFrames = m_samplesPerFrame > 0
+        ? static_cast<size_t>(m_maximumLatency.count() * m_sampleRate / 1000000 / m_samplesPerFrame)
+        : 0;
+    const size_t framesPerPacket = m_frameLength > 0 ? m_concealmentPayload.size() / m_frameLength : 0;
+
+    if(0 == gapFrames || 0 == m_lastFrameCount || gapFrames > maxGapFrames || 0 == framesPerPacket) {
+        // Nothing to conceal, nothing to conceal with, or a gap too long to be worth filling: skip to the next packet
+        // and let it play at its own time.
+        m_statistics.packetsLost += missingPackets;
+        m_nextSequenceNumber = nextSequenceNumber;
+        m_nextTimestamp = next.timestamp;
+        return false;
+    }
+
+    const size_t frameCount = std::min(gapFrames, framesPerPacket);
+    packet->buffer.reset();
+    packet->payloadData = m_concealmentPayload.data();
+    packet->inputLength = frameCount * m_frameLength;
+    packet->frameCount = frameCount;
+    packet->concealed = true;
+    packet->startGain = concealmentGain(m_framesConcealedInRow);
+    packet->endGain = concealmentGain(m_framesConcealedInRow + frameCount);
+
+    m_framesConcealedInRow += frameCount;
+    m_statistics.framesConcealed += frameCount;
+    m_nextTimestamp += static_cast<uint32_t>(frameCount * m_samplesPerFrame);
+
+    if(frameCount == gapFrames) {
+        // The whole gap is concealed; the next packet buffered is up.
+        m_statistics.packetsLost += missingPackets;
+        m_nextSequenceNumber = nextSequenceNumber;
+        m_nextTimestamp = next.timestamp;
+    }
+    return true;
+}
+
+} // namespace blueZ
+} // namespace bluetoothDevice
+} // namespace deviceClientSDK
@@ -20,6 +20,9 @@ MediaContext::MediaContext() : m_mediaStreamFD{INVALID_FD}, m_readMTU{0}, m_writ
 }
 
 void MediaContext::setStreamFD(int streamFD) {
+    if (m_mediaStreamFD != INVALID_FD && m_mediaStreamFD != streamFD) {
+        close(m_mediaStreamFD);
+    }
     m_mediaStreamFD = streamFD;
 }
 
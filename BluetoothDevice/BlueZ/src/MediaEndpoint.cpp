@@ -2,10 +2,23 @@
 #include "BlueZ/MediaEndpoint.h"
 #include "BlueZ/BlueZConstants.h"
 
+#include <Common/Utils/Audio/ConversionStage.h>
+#include <Common/Utils/Memory/Memory.h>
+
 // https://github.com/Arkq/bluez-alsa
 // Version 1.2.0
 #include <Common/Utils/bluez-alsa/a2dp-rtp.h>
-#include <poll.h>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cmath>
+#include <errno.h>
+#include <fcntl.h>
+#include <functional>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cstring>
 
 namespace deviceClientSDK {
 namespace bluetoothDevice {
@@ -18,8 +31,17 @@ static const std::string TAG_MEDIAENDPOINT = "MediaEndpoint\t";
 // General error for DBus methods.
 constexpr const char* DBUS_ERROR_FAILED = "org.bluez.Error.Rejected";
 
-// Timeout to wait for new data coming frome BlueZ audio stream.
-static const std::chrono::milliseconds POLL_TIMEOUT_MS(100);
+// Maximum number of packets received from the BlueZ audio stream with one system call. Each packet carries ~3ms of
+// audio, so this covers a scheduling delay of ~50ms.
+constexpr size_t MAX_PACKETS_PER_BATCH = 16;
+
+// Number of buffers the packets received are kept in: as many as the jitter buffer holds, plus a batch being decoded
+// and a batch being received, so that receiving never waits for the jitter buffer.
+constexpr size_t RECEIVE_BUFFER_COUNT = JitterBuffer::SLOT_COUNT + 2 * MAX_PACKETS_PER_BATCH;
+
+// Clock drift, as a fraction, below which the stream is not resampled, so that the decoding into the AudioInputStream
+// survives the estimate wandering around 1. 20ppm builds up to ~70ms of latency over an hour.
+constexpr double CLOCK_DRIFT_DEAD_BAND = 0.00002;
 
 // Name of the BlueZ MediaEndpoint1::SetConfiguration method.
 constexpr const char* MEDIAENDPOINT1_SETCONFIGURATION_METHOD_NAME = "SetConfiguration";
@@ -78,6 +100,210 @@ constexpr size_t MAX_SANE_CODE_SIZE = MAX_SANE_FRAME_LENGTH * 32;
 // Min sane code size for SBC codec
 constexpr size_t MIN_SANE_CODE_SIZE = 1;
 
+// Size of one word of the @c AudioInputStream: one 16-bit PCM sample.
+constexpr size_t AUDIO_INPUT_STREAM_WORD_SIZE = sizeof(int16_t);
+
+// Number of words the @c AudioInputStream can hold: 2^17, about 1.37 seconds of 48kHz stereo audio (1.49 seconds at
+// 44.1kHz).  The stream rounds its size up to a power of two, so this is the size that is actually allocated.
+constexpr size_t AUDIO_INPUT_STREAM_BUFFER_SIZE_IN_WORDS = 1 << 17;
+
+// Maximum number of readers of the @c AudioInputStream.
+constexpr size_t AUDIO_INPUT_STREAM_MAX_READERS = 4;
+
+// Number of packets the transmit buffer of the media stream holds in SOURCE mode. Packets are paced, so the buffer
+// only has to absorb the scheduling jitter of the media reactor; the smaller it is, the lower the latency.
+constexpr size_t TRANSMIT_BUFFER_PACKETS = 3;
+
+// Size of the RTP header of the packets sent, which carry no CSRC.
+constexpr size_t RTP_HEADER_SIZE = offsetof(rtp_header_t, csrc);
+
+// RTP version of the packets sent.
+constexpr uint16_t RTP_VERSION = 2;
+
+// RTP payload type of the packets sent, from the dynamic range as A2DP uses.
+constexpr uint16_t RTP_PAYLOAD_TYPE_SBC = 96;
+
+// Synchronization source identifier of the packets sent. There is one source per transport.
+constexpr uint32_t RTP_SSRC = 1;
+
+// Maximum number of SBC frames in one RTP packet, as the frame count of the SBC payload header has 4 bits.
+constexpr size_t MAX_SBC_FRAMES_PER_PACKET = 15;
+
+/**
+ * Runs a call queued on a glib main context by @c MediaEndpoint::callMethodOnWorker().
+ *
+ * @param data The @c std::function<void()> to run.
+ * @return @c G_SOURCE_REMOVE, as the call runs once.
+ */
+static gboolean runWorkerCall(gpointer data) {
+    (*static_cast<std::function<void()>*>(data))();
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Deletes a call queued on a glib main context by @c MediaEndpoint::callMethodOnWorker(), once it has run or the
+ * context is gone.
+ *
+ * @param data The @c std::function<void()> to delete.
+ */
+static void deleteWorkerCall(gpointer data) {
+    delete static_cast<std::function<void()>*>(data);
+}
+
+/**
+ * Decodes SBC frames into @c output until the frames, the input data or the room in @c output run out. @c input,
+ * @c inputLength and @c frameCount are advanced past the frames decoded.
+ *
+ * @return Number of PCM bytes written to @c output.
+ */
+static size_t decodeSBCFrames(
+    sbc_t* sbcContext,
+    const uint8_t** input,
+    size_t* inputLength,
+    size_t* frameCount,
+    size_t sbcFrameLength,
+    size_t sbcCodeSize,
+    uint8_t* output,
+    size_t outputLength) {
+    size_t totalDecoded = 0;
+
+    while(*frameCount > 0 && *inputLength >= sbcFrameLength && outputLength >= sbcCodeSize) {
+        size_t bytesDecoded = 0;
+        ssize_t bytesProcessed = sbc_decode(sbcContext, *input, *inputLength, output, outputLength, &bytesDecoded);
+        if(bytesProcessed < 0) {
+            LOG_ERROR << TAG_MEDIAENDPOINT << "decodeSBCFramesFailed; reason: SBC decoding error";
+            *frameCount = 0;
+            break;
+        }
+
+        --*frameCount;
+        *input += bytesProcessed;
+        *inputLength -= bytesProcessed;
+
+        output += bytesDecoded;
+        outputLength -= bytesDecoded;
+        totalDecoded += bytesDecoded;
+    }
+
+    return totalDecoded;
+}
+
+/**
+ * Encodes PCM data into up to @c maxFrameCount SBC frames in @c output, until the input data or the room in @c output
+ * run out. Only whole frames of PCM data are encoded.
+ *
+ * @return Number of SBC frames written to @c output, whose length is returned in @c outputWritten.
+ */
+static size_t encodeSBCFrames(
+    sbc_t* sbcContext,
+    const uint8_t* input,
+    size_t inputLength,
+    size_t maxFrameCount,
+    size_t sbcCodeSize,
+    uint8_t* output,
+    size_t outputLength,
+    size_t* outputWritten) {
+    size_t frameCount = 0;
+    *outputWritten = 0;
+
+    while(frameCount < maxFrameCount && inputLength >= sbcCodeSize) {
+        ssize_t bytesEncoded = 0;
+        ssize_t bytesProcessed = sbc_encode(sbcContext, input, inputLength, output, outputLength, &bytesEncoded);
+        if(bytesProcessed <= 0 || bytesEncoded <= 0) {
+            LOG_ERROR << TAG_MEDIAENDPOINT << "encodeSBCFramesFailed; reason: SBC encoding error";
+            break;
+        }
+
+        ++frameCount;
+        input += bytesProcessed;
+        inputLength -= bytesProcessed;
+
+        output += bytesEncoded;
+        outputLength -= bytesEncoded;
+        *outputWritten += bytesEncoded;
+    }
+
+    return frameCount;
+}
+
+/**
+ * Sends a packet to the media stream without blocking.
+ *
+ * @return The number of bytes sent, or -1 if there was an error, with @c errno set to @c EAGAIN if the packet did not
+ * fit in the socket buffer.
+ */
+static ssize_t sendPacket(int fd, const uint8_t* packet, size_t packetLength) {
+    ssize_t sent = send(fd, packet, packetLength, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if(sent < 0 && ENOTSOCK == errno) {
+        // Not a socket: fall back to writing it.
+        sent = write(fd, packet, packetLength);
+    }
+    return sent;
+}
+
+/**
+ * Returns the number of bytes queued in the transmit buffer of the media stream, or 0 if it can't be told.
+ */
+static size_t getTransmitQueueDepth(int fd) {
+    int queued = 0;
+    if(ioctl(fd, TIOCOUTQ, &queued) < 0 || queued < 0) {
+        return 0;
+    }
+    return static_cast<size_t>(queued);
+}
+
+/**
+ * Scales 16-bit PCM samples by a gain ramping linearly from @c startGain to @c endGain, to fade concealed audio.
+ */
+static void applyGainRamp(uint8_t* data, size_t length, float startGain, float endGain, bool bigEndian) {
+    const size_t sampleCount = length / sizeof(int16_t);
+    if(0 == sampleCount) {
+        return;
+    }
+
+    const float step = (endGain - startGain) / sampleCount;
+    float gain = startGain;
+    for(size_t i = 0; i < sampleCount; ++i, data += sizeof(int16_t), gain += step) {
+        int16_t sample = bigEndian
+            ? static_cast<int16_t>((data[0] << 8) | data[1])
+            : static_cast<int16_t>((data[1] << 8) | data[0]);
+        sample = static_cast<int16_t>(sample * gain);
+        data[bigEndian ? 0 : 1] = static_cast<uint8_t>(static_cast<uint16_t>(sample) >> 8);
+        data[bigEndian ? 1 : 0] = static_cast<uint8_t>(sample);
+    }
+}
+
+/**
+ * Locates the SBC payload of an RTP packet, and reads its sequence number and timestamp.
+ *
+ * @return @c false if the packet is not a valid RTP packet.
+ */
+static bool parseRTPPacket(
+    const uint8_t* packet,
+    size_t packetLength,
+    size_t* headersSize,
+    size_t* frameCount,
+    uint16_t* sequenceNumber,
+    uint32_t* timestamp) {
+    if(packetLength < sizeof(rtp_header)) {
+        return false;
+    }
+
+    const rtp_header_t* rtpHeader = reinterpret_cast<const rtp_header_t*>(packet);
+    const rtp_payload_sbc_t* rtpPayload =
+        reinterpret_cast<const rtp_payload_sbc_t*>(&rtpHeader->csrc[rtpHeader->cc]);
+    const uint8_t* payloadData = reinterpret_cast<const uint8_t*>(rtpPayload + 1);
+
+    *headersSize = static_cast<size_t>(payloadData - packet);
+    if(*headersSize > packetLength) {
+        return false;
+    }
+    *frameCount = rtpPayload->frame_count;
+    *sequenceNumber = ntohs(rtpHeader->seq_number);
+    *timestamp = ntohl(rtpHeader->timestamp);
+    return true;
+}
+
 /**
  * XML description of the MediaEndpoint1 interface to be implemented by this object. The format is defined by DBus.
  * This data is used during the registration of the media endpoint object.
@@ -104,7 +330,11 @@ static const gchar mediaEndpointIntrospectionXml[] =
     " </interface>"
     "</node>";
 
-MediaEndpoint::MediaEndpoint(std::shared_ptr<DBusConnection> connection, const std::string& endpointPath) : 
+MediaEndpoint::MediaEndpoint(
+    std::shared_ptr<DBusConnection> connection,
+    const std::string& endpointPath,
+    common::utils::bluetooth::A2DPRole role,
+    std::shared_ptr<MediaReactor> reactor) :
         DBusObject(
             connection,
             mediaEndpointIntrospectionXml,
@@ -114,177 +344,689 @@ MediaEndpoint::MediaEndpoint(std::shared_ptr<DBusConnection> connection, const s
              {MEDIAENDPOINT1_CLEARCONFIGURATION_METHOD_NAME, &MediaEndpoint::onClearConfiguration},
              {MEDIAENDPOINT1_RELEASE_METHOD_NAME, &MediaEndpoint::onRelease}}),
         m_endpointPath{endpointPath},
-        m_operatingModeChanged{false},
-        m_operatingMode{OperatingMode::INACTIVE} {
+        m_role{role},
+        m_operatingMode{OperatingMode::INACTIVE},
+        m_clockDriftCompensation{false},
+        m_pipelinedReceive{false},
+        m_receiveCPU{common::utils::threading::ANY_CPU},
+        m_receivePipeline{RECEIVE_BUFFER_COUNT},
+        m_resampling{false},
+        m_reactor{reactor},
+        m_workerContext{g_main_context_ref_thread_default()},
+        m_timerFD{timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)},
+        m_streamingMode{OperatingMode::INACTIVE},
+        m_streamingContextFD{MediaContext::INVALID_FD},
+        m_streamFD{MediaContext::INVALID_FD},
+        m_sbcFrameLength{0},
+        m_sbcCodeSize{0},
+        m_pipelined{false},
+        m_source() {
+
+    if(!m_reactor) {
+        m_reactor = MediaReactor::create();
+    }
+    if(!m_reactor) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "MediaEndpointFailed; reason: Failed to create media reactor";
+    }
 
-    m_thread = std::thread(&MediaEndpoint::mediaThread, this);
+    if(m_timerFD < 0) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "MediaEndpointFailed; reason: Failed to create timerfd; error: "
+                  << strerror(errno);
+    }
 }
 
 MediaEndpoint::~MediaEndpoint() {
     setOperatingMode(OperatingMode::RELEASED);
-    if(m_thread.joinable()) {
-        m_thread.join();
+    if(m_reactor) {
+        // The mode change posted above runs first, and stops watching the stream; nothing refers to this afterwards.
+        m_reactor->run([this]() { stopStreaming(OperatingMode::RELEASED); });
     }
+    if(m_timerFD >= 0) {
+        close(m_timerFD);
+    }
+    g_main_context_unref(m_workerContext);
 }
 
 void MediaEndpoint::abortStreaming() {
     setOperatingMode(OperatingMode::INACTIVE);
-    std::shared_ptr<DBusProxy> deviceProxy = 
-        DBusProxy::create(BlueZConstants::BLUEZ_DEVICE_INTERFACE, m_streamingDevicePath);
-    if(deviceProxy) {
-        deviceProxy->callMethod("Disconnect");
-    }
+    callMethodOnWorker(BlueZConstants::BLUEZ_DEVICE_INTERFACE, getStreamingDevicePath(), "Disconnect");
 }
 
-// This code in this method is based on a work of Arkadiusz Bokowy licensed under the terms of the MIT license.
-// https://github.com/Arkq/bluez-alsa/blob/88aefeea56b7ea20668796c2c7a8312bf595eef4/src/io.c#L144
-void MediaEndpoint::mediaThread() {
+void MediaEndpoint::callMethodOnWorker(
+    const std::string& interfaceName,
+    const std::string& objectPath,
+    const std::string& methodName) {
+    // The call only holds copies of its parameters, so it can outlive the endpoint.
+    auto call = new std::function<void()>([interfaceName, objectPath, methodName]() {
+        std::shared_ptr<DBusProxy> proxy = DBusProxy::create(interfaceName, objectPath);
+        if(!proxy) {
+            LOG_ERROR << TAG_MEDIAENDPOINT << "callMethodFailed; reason: Failed to create proxy; method: "
+                      << methodName;
+            return;
+        }
+
+        ManagedGError error;
+        proxy->callMethod(methodName, nullptr, error.toOutputParameter());
+        if(error.hasError()) {
+            // The transport is already released when the remote device suspended the stream, and the device may be
+            // gone already.
+            LOG_DEBUG << TAG_MEDIAENDPOINT << "callMethod; method: " << methodName
+                      << "; message: " << error.getMessage();
+        }
+    });
 
-    pollfd pollStruct = { /* fd */ 0, /* requested events */ POLLIN, /* return events */ 0};
+    g_main_context_invoke_full(m_workerContext, G_PRIORITY_DEFAULT, runWorkerCall, call, deleteWorkerCall);
+}
 
+void MediaEndpoint::onOperatingModeChanged() {
+    OperatingMode mode;
     std::shared_ptr<MediaContext> mediaContext;
+    int contextFD = MediaContext::INVALID_FD;
+    bool pipelined = false;
+    int receiveCPU = common::utils::threading::ANY_CPU;
+    {
+        std::lock_guard<std::mutex> modeLock(m_mutex);
+        mode = m_operatingMode;
+        mediaContext = m_currentMediaContext;
+        if(mediaContext) {
+            contextFD = mediaContext->getStreamFD();
+        }
+        pipelined = m_pipelinedReceive;
+        receiveCPU = m_receiveCPU;
+    }
 
-    while(m_operatingMode != OperatingMode::RELEASED) {
-       // Reset any media context that could still esist.
-        {
-            std::unique_lock<std::mutex> modeLock(m_mutex);
+    if(mode == m_streamingMode && mediaContext == m_streamingContext && contextFD == m_streamingContextFD) {
+        // Nothing changed for the stream: several changes were posted before this ran, or the mode was set again.
+        return;
+    }
 
-            m_modeChangeSignal.wait(modeLock, [this]() {return m_operatingModeChanged; });
-            m_operatingModeChanged = false;
+    // The transport may have been acquired again, in which case the stream restarts on the new one.
+    stopStreaming(mode);
 
-            if(m_operatingMode != OperatingMode::SINK) {
-                continue;
-            }
+    if(mode != OperatingMode::SINK && mode != OperatingMode::SOURCE) {
+        return;
+    }
 
-            if(!m_currentMediaContext || !m_currentMediaContext->isSBCInitialized()) {
-                LOG_ERROR << TAG_MEDIAENDPOINT << "mediaThreadFailed; reason: no valid media context, no media streaming started";
-                continue;
-            }
+    if(!mediaContext || !mediaContext->isSBCInitialized() || contextFD < 0) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "onOperatingModeChangedFailed; reason: no valid media context, no media "
+                  << "streaming started";
+        return;
+    }
 
-            mediaContext = m_currentMediaContext;
+    LOG_DEBUG << TAG_MEDIAENDPOINT << "Starting media streaming...";
 
-        }
+    m_sbcCodeSize = sbc_get_codesize(mediaContext->getSBCContextPtr());
+    m_sbcFrameLength = sbc_get_frame_length(mediaContext->getSBCContextPtr());
 
-        LOG_DEBUG << TAG_MEDIAENDPOINT << "Starting media streaming...";
+    LOG_DEBUG << TAG_MEDIAENDPOINT << "codec size: " << m_sbcCodeSize << "\t"
+                                   << "frame length: " << m_sbcFrameLength;
 
-        pollStruct.fd = mediaContext->getStreamFD();
-        m_ioBuffer.resize(static_cast<unsigned long>(mediaContext->getReadMTU()));
+    if(m_sbcFrameLength < MIN_SANE_FRAME_LENGTH || m_sbcFrameLength > MAX_SANE_FRAME_LENGTH) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "onOperatingModeChangedFailed; reason: invalid sbcFrameLength";
+        abortStreaming();
+        return;
+    }
 
-        const size_t sbcCodeSize = sbc_get_codesize(mediaContext->getSBCContextPtr());
-        const size_t sbcFrameLength = sbc_get_frame_length(mediaContext->getSBCContextPtr());
+    if(m_sbcCodeSize < MIN_SANE_CODE_SIZE || m_sbcCodeSize > MAX_SANE_CODE_SIZE) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "onOperatingModeChangedFailed; reason: invalid sbcCodeSize";
+        abortStreaming();
+        return;
+    }
 
-        LOG_DEBUG << TAG_MEDIAENDPOINT << "codec size: " << sbcCodeSize << "\t"
-                                       << "frame length: " << sbcFrameLength;
-        
-        if(sbcFrameLength < MIN_SANE_FRAME_LENGTH || sbcFrameLength > MAX_SANE_FRAME_LENGTH) {
-            LOG_ERROR << TAG_MEDIAENDPOINT << "mediaThreadFailed; reason: invalid sbcFrameLength";
-            abortStreaming();
-            continue;
+    // Watch a descriptor of our own: the transport one is closed by acquireTransport() when it is acquired again.
+    m_streamFD = fcntl(contextFD, F_DUPFD_CLOEXEC, 0);
+    if(m_streamFD < 0) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "onOperatingModeChangedFailed; reason: Failed to duplicate media stream "
+                  << "file descriptor; error: " << strerror(errno);
+        abortStreaming();
+        return;
+    }
+    m_streamingMode = mode;
+    m_streamingContext = mediaContext;
+    m_streamingContextFD = contextFD;
+
+    if(OperatingMode::SOURCE == mode) {
+        startSource(mediaContext);
+    } else {
+        startSink(mediaContext, pipelined, receiveCPU);
+    }
+}
+
+void MediaEndpoint::stopStreaming(OperatingMode nextMode) {
+    if(OperatingMode::INACTIVE == m_streamingMode) {
+        return;
+    }
+
+    armTimer(-1);
+    m_reactor->remove(m_timerFD);
+    m_reactor->remove(m_streamFD);
+
+    if(OperatingMode::SINK == m_streamingMode) {
+        if(m_pipelined) {
+            m_reactor->remove(m_receivePipeline.getFD());
+            m_receivePipeline.stop();
+            m_pipelined = false;
+        }
+        m_sinkWriter.reset();
+        m_processingChain.reset();
+    } else {
+        if(m_source.readerFD >= 0) {
+            m_reactor->remove(m_source.readerFD);
         }
+        m_reactor->remove(m_pacer.getFD());
+        m_source.reader.reset();
+        if(OperatingMode::SOURCE != nextMode) {
+            releaseTransport(m_streamingContext);
+        }
+    }
+
+    close(m_streamFD);
+    m_streamFD = MediaContext::INVALID_FD;
+    m_streamingMode = OperatingMode::INACTIVE;
+    m_streamingContext.reset();
+    m_streamingContextFD = MediaContext::INVALID_FD;
+}
+
+// This code in this method is based on a work of Arkadiusz Bokowy licensed under the terms of the MIT license.
+// https://github.com/Arkq/bluez-alsa/blob/88aefeea56b7ea20668796c2c7a8312bf595eef4/src/io.c#L144
+void MediaEndpoint::startSink(std::shared_ptr<MediaContext> mediaContext, bool pipelined, int receiveCPU) {
+    const size_t readMTU = static_cast<size_t>(mediaContext->getReadMTU());
+
+    common::utils::AudioFormat audioFormat;
+    {
+        std::lock_guard<std::mutex> guard(m_streamMutex);
+        m_sinkWriter = m_audioInputStreamWriter;
+        audioFormat = m_audioFormat;
+    }
 
-        if(sbcCodeSize < MIN_SANE_CODE_SIZE || sbcCodeSize > MAX_SANE_CODE_SIZE) {
-            LOG_ERROR << TAG_MEDIAENDPOINT << "mediaThreadFailed; reason: invalid sbcCodeSize";
-            abortStreaming();
-            continue;            
+    const size_t bytesPerSample = audioFormat.numChannels * sizeof(int16_t);
+    if(0 == bytesPerSample || 0 == audioFormat.sampleRateHz) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "startSinkFailed; reason: invalid audio format";
+        abortStreaming();
+        stopStreaming(OperatingMode::INACTIVE);
+        return;
+    }
+    // The jitter buffer drops the buffers of the previous stream first, so that the pools may be reallocated.
+    m_jitterBuffer.start(readMTU, audioFormat.sampleRateHz, m_sbcCodeSize / bytesPerSample, m_sbcFrameLength);
+    prepareReceiveBuffers(readMTU);
+
+    // output buffer size = decoded block size * (number of encoded blocks in a packet + 1 to fill possible gap)
+    // * number of packets in a batch. Concealment packets are no larger than received ones.
+    // When decoding into the AudioInputStream without resampling, only the frame straddling the wrap of the ring
+    // is decoded here.
+    const size_t outBufferSize = m_sbcCodeSize * (readMTU / m_sbcFrameLength + 1) * MAX_PACKETS_PER_BATCH;
+    m_sbcBuffer.resize(outBufferSize);
+
+    // The resampler produces a little more than it is given when the remote clock is slow.
+    m_resampler.reset(audioFormat.numChannels);
+    m_resampling = false;
+    m_resampledBuffer.resize(
+        bytesPerSample *
+        (static_cast<size_t>(outBufferSize / bytesPerSample / (1.0 - ClockDriftEstimator::MAX_DRIFT)) + 2));
+
+    createProcessingChain(audioFormat, m_resampledBuffer.size() / bytesPerSample);
+
+    if(pipelined) {
+        pipelined = m_receivePipeline.start(m_streamFD, readMTU, receiveCPU);
+        if(!pipelined) {
+            LOG_ERROR << TAG_MEDIAENDPOINT << "startSinkFailed; reason: Failed to start receive pipeline, "
+                      << "receiving on the reactor thread instead";
         }
+    }
+    m_pipelined = pipelined;
+
+    // The packets are received on the reactor thread, or by the pipeline which wakes it up with the packets queued.
+    const int fd = pipelined ? m_receivePipeline.getFD() : m_streamFD;
+    if(!m_reactor->add(fd, EPOLLIN, [this](uint32_t events) { onSinkReadable(events); }) ||
+       (m_timerFD >= 0 && !m_reactor->add(m_timerFD, EPOLLIN, [this](uint32_t events) { onTimer(events); }))) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "startSinkFailed; reason: Failed to watch bluetooth media stream";
+        abortStreaming();
+        stopStreaming(OperatingMode::INACTIVE);
+        return;
+    }
+}
+
+void MediaEndpoint::onSinkReadable(uint32_t events) {
+    // Drain every packet queued since the last wakeup into the jitter buffer, a batch at a time.
+    bool endOfStream = false;
+    ssize_t packetsReceived = 0;
+    if(m_pipelined) {
+        packetsReceived = receivePipelinedPackets(&endOfStream);
+    } else {
+        do {
+            packetsReceived = receivePacketBatch(m_streamFD, &endOfStream);
+            if(packetsReceived < 0) {
+                LOG_ERROR << TAG_MEDIAENDPOINT << "onSinkReadableFailed; reason: Failed to read bluetooth media stream";
+            }
+        } while(static_cast<size_t>(packetsReceived) == MAX_PACKETS_PER_BATCH && !endOfStream);
+    }
+
+    if(packetsReceived < 0) {
+        abortStreaming();
+        stopStreaming(OperatingMode::INACTIVE);
+        return;
+    }
+
+    // Play out the packets which are due, or everything left at the end of the stream.
+    playOutPackets(
+        m_sinkWriter.get(),
+        m_streamingContext,
+        m_sbcFrameLength,
+        m_sbcCodeSize,
+        endOfStream ? JitterBuffer::Clock::time_point::max() : JitterBuffer::Clock::now());
+
+    if(endOfStream) {
+        // End of stream. switch to inactive mode.
+        setOperatingMode(OperatingMode::INACTIVE);
+        stopStreaming(OperatingMode::INACTIVE);
+        return;
+    }
+
+    // Wake up when the next packet buffered is due.
+    armTimer(m_jitterBuffer.getReleaseTimeout(JitterBuffer::Clock::now()));
+}
+
+void MediaEndpoint::onTimer(uint32_t events) {
+    uint64_t expirations = 0;
+    if(read(m_timerFD, &expirations, sizeof(expirations)) < 0 && EAGAIN != errno) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "onTimerFailed; reason: Failed to read timerfd; error: " << strerror(errno);
+    }
 
-        // output buffer size = decoded block size * (number of encoded blocks in the input buffer + 1 to fill possible gap)
-        const size_t outBufferSize = sbcCodeSize * (m_ioBuffer.size() / sbcFrameLength + 1);
-        m_sbcBuffer.resize(outBufferSize);
+    if(OperatingMode::SOURCE == m_streamingMode) {
+        serviceSource();
+        return;
+    }
 
-        int positionInReadBuf = 0;
-        
-        // Staying in current mode
-        while(m_operatingMode == OperatingMode::SINK) {
-            int timeout = poll(&pollStruct, 1, static_cast<int>(POLL_TIMEOUT_MS.count()));
+    playOutPackets(m_sinkWriter.get(), m_streamingContext, m_sbcFrameLength, m_sbcCodeSize, JitterBuffer::Clock::now());
+    armTimer(m_jitterBuffer.getReleaseTimeout(JitterBuffer::Clock::now()));
+}
 
-            if(timeout == 0) {
+void MediaEndpoint::armTimer(int timeout) {
+    if(m_timerFD < 0) {
+        return;
+    }
+
+    // A zero it_value disarms the timer, so a timeout of 0 expires after a nanosecond instead.
+    itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if(timeout > 0) {
+        spec.it_value.tv_sec = timeout / 1000;
+        spec.it_value.tv_nsec = static_cast<long>(timeout % 1000) * 1000000;
+    } else if(0 == timeout) {
+        spec.it_value.tv_nsec = 1;
+    }
+    if(timerfd_settime(m_timerFD, 0, &spec, nullptr) < 0) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "armTimerFailed; reason: Failed to set timerfd; error: " << strerror(errno);
+    }
+}
+
+bool MediaEndpoint::updateWatch(int fd, uint32_t events, uint32_t* watchedEvents) {
+    if(events == *watchedEvents) {
+        return true;
+    }
+    if(!m_reactor->modify(fd, events)) {
+        return false;
+    }
+    *watchedEvents = events;
+    return true;
+}
+
+void MediaEndpoint::startSource(std::shared_ptr<MediaContext> mediaContext) {
+    std::shared_ptr<common::utils::AudioInputStream> stream;
+    common::utils::AudioFormat audioFormat;
+    {
+        std::lock_guard<std::mutex> guard(m_streamMutex);
+        stream = m_sourceStream;
+        audioFormat = m_audioFormat;
+    }
+
+    if(!stream) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "startSourceFailed; reason: no source stream";
+        setOperatingMode(OperatingMode::INACTIVE);
+        stopStreaming(OperatingMode::INACTIVE);
+        return;
+    }
+
+    const size_t wordSize = stream->getWordSize();
+    const size_t writeMTU = static_cast<size_t>(mediaContext->getWriteMTU());
+    const size_t headersSize = RTP_HEADER_SIZE + sizeof(rtp_payload_sbc_t);
+    const size_t framesPerPacket =
+        writeMTU > headersSize ? std::min((writeMTU - headersSize) / m_sbcFrameLength, MAX_SBC_FRAMES_PER_PACKET) : 0;
+    const size_t bytesPerSample = audioFormat.numChannels * sizeof(int16_t);
+    if(0 == framesPerPacket || 0 == wordSize || 0 != m_sbcCodeSize % wordSize || 0 == bytesPerSample ||
+       0 == audioFormat.sampleRateHz) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "startSourceFailed; reason: invalid writeMTU or audio format";
+        finishSource(true);
+        return;
+    }
+
+    std::shared_ptr<common::utils::AudioInputStream::Reader> reader =
+        stream->createReader(common::utils::AudioInputStream::Reader::Policy::NONBLOCKING);
+    if(!reader) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "startSourceFailed; reason: Failed to create AudioInputStream reader";
+        setOperatingMode(OperatingMode::INACTIVE);
+        stopStreaming(OperatingMode::INACTIVE);
+        return;
+    }
+
+    // Fill every packet up to the MTU: the fewer the packets, the lower the overhead on the air and in the kernel.
+    // The reader is only woken up once the PCM data of a whole packet is available.
+    const size_t pcmPerPacket = framesPerPacket * m_sbcCodeSize;
+    reader->setWakeWatermark(pcmPerPacket / wordSize);
+    m_sbcBuffer.resize(pcmPerPacket);
+    m_ioBuffer.resize(writeMTU);
+
+    LOG_DEBUG << TAG_MEDIAENDPOINT << "write MTU: " << writeMTU << "\t"
+                                   << "frames per packet: " << framesPerPacket;
+
+    // Packets are sent at the pace they are played out, so a few of them are enough to fill the transmit buffer.
+    const int transmitBufferSize = static_cast<int>(TRANSMIT_BUFFER_PACKETS * writeMTU);
+    if(setsockopt(m_streamFD, SOL_SOCKET, SO_SNDBUF, &transmitBufferSize, sizeof(int)) < 0) {
+        LOG_DEBUG << TAG_MEDIAENDPOINT << "Failed to set transmit buffer size; error: " << strerror(errno);
+    }
+    m_pacer.start(audioFormat.sampleRateHz);
+
+    m_source = SourceState();
+    m_source.reader = reader;
+    m_source.readerFD = reader->getEventFD();
+    m_source.wordSize = wordSize;
+    m_source.sbcCodeSize = m_sbcCodeSize;
+    m_source.pcmPerPacket = pcmPerPacket;
+    m_source.samplesPerFrame = m_sbcCodeSize / bytesPerSample;
+
+    // Without a readiness eventfd, the reader is polled every packet duration instead, and without a pacer timerfd,
+    // the deadline of the next packet is waited for with m_timerFD.
+    m_source.readerPollTimeout = m_source.readerFD < 0
+        ? std::max(1, static_cast<int>(framesPerPacket * m_source.samplesPerFrame * 1000 / audioFormat.sampleRateHz))
+        : -1;
+
+    // The descriptors start with no events, which serviceSource() sets as needed. Errors and hang ups of the audio
+    // stream are always reported.
+    const MediaReactor::Handler service = [this](uint32_t events) { serviceSource(); };
+    bool watched = m_reactor->add(m_streamFD, 0, [this](uint32_t events) {
+        if(events & (EPOLLERR | EPOLLHUP)) {
+            LOG_ERROR << TAG_MEDIAENDPOINT << "serviceSourceFailed; reason: bluetooth media stream error or hang up";
+            finishSource(true);
+            return;
+        }
+        serviceSource();
+    });
+    watched = watched && (m_source.readerFD < 0 || m_reactor->add(m_source.readerFD, 0, service));
+    watched = watched && (m_pacer.getFD() < 0 || m_reactor->add(m_pacer.getFD(), 0, service));
+    watched = watched && (m_timerFD < 0 || m_reactor->add(m_timerFD, EPOLLIN, [this](uint32_t events) {
+        onTimer(events);
+    }));
+    if(!watched) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "startSourceFailed; reason: Failed to watch bluetooth media stream";
+        finishSource(true);
+        return;
+    }
+
+    serviceSource();
+}
+
+void MediaEndpoint::serviceSource() {
+    SourceState& source = m_source;
+    bool endOfStream = false;
+
+    while(true) {
+        const PacketPacer::Clock::time_point now = PacketPacer::Clock::now();
+        if(source.packetLength > 0 && m_pacer.isDue(now)) {
+            ssize_t sent = sendPacket(m_streamFD, m_ioBuffer.data(), source.packetLength);
+            if(sent >= 0) {
+                source.packetLength = 0;
+                source.transmitBufferFull = false;
+                m_pacer.onPacketSent(source.packetSamples, now, getTransmitQueueDepth(m_streamFD));
+            } else if(EAGAIN == errno || EWOULDBLOCK == errno) {
+                source.transmitBufferFull = true;
+            } else if(EINTR == errno) {
                 continue;
+            } else {
+                LOG_ERROR << TAG_MEDIAENDPOINT << "serviceSourceFailed; reason: Failed to write bluetooth media stream";
+                finishSource(true);
+                return;
             }
-            if(timeout < 0) {
-                LOG_ERROR << TAG_MEDIAENDPOINT << "mediaThreadFailed; reason: Failed to poll bluetooth media stream";
-                abortStreaming();
-                break;
-            }
+        }
 
-            // Check if we are still in SINK mode
-            if(m_operatingMode != OperatingMode::SINK) {
+        if(source.packetLength > 0) {
+            break;
+        }
+
+        // Collect the PCM data of the next packet, until the reader runs dry and rearms its eventfd.
+        while(source.pcmBuffered < source.pcmPerPacket) {
+            ssize_t wordsRead = source.reader->read(
+                m_sbcBuffer.data() + source.pcmBuffered, (source.pcmPerPacket - source.pcmBuffered) / source.wordSize);
+            if(wordsRead > 0) {
+                source.pcmBuffered += wordsRead * source.wordSize;
+            } else if(common::utils::AudioInputStream::Reader::Error::OVERRUN == wordsRead) {
+                LOG_ERROR << TAG_MEDIAENDPOINT << "serviceSource; reason: source stream overrun, skipping ahead";
+                source.reader->seek(0, common::utils::AudioInputStream::Reader::Reference::BEFORE_WRITER);
+            } else {
+                endOfStream = common::utils::AudioInputStream::Reader::Error::CLOSED == wordsRead;
                 break;
             }
+        }
 
-            ssize_t bytesReadSigned = 
-                read(pollStruct.fd, m_ioBuffer.data() + positionInReadBuf, m_ioBuffer.size() - positionInReadBuf);
+        if(endOfStream && source.pcmBuffered > 0) {
+            // Pad the last frame with silence.
+            const size_t paddedLength =
+                (source.pcmBuffered + source.sbcCodeSize - 1) / source.sbcCodeSize * source.sbcCodeSize;
+            memset(m_sbcBuffer.data() + source.pcmBuffered, 0, paddedLength - source.pcmBuffered);
+            source.pcmBuffered = paddedLength;
+        }
 
-            if(bytesReadSigned < 0) {
-                LOG_ERROR << TAG_MEDIAENDPOINT << "mediaThreadFailed; reason: Failed to read bluetooth media stream";
-                abortStreaming();
-                break;
+        if(source.pcmBuffered == source.pcmPerPacket || (endOfStream && source.pcmBuffered > 0)) {
+            size_t frameCount = 0;
+            source.packetLength = encodeRTPPacket(
+                m_streamingContext, source.pcmBuffered, source.sequenceNumber, source.timestamp, &frameCount);
+            source.pcmBuffered = 0;
+            if(0 == source.packetLength) {
+                finishSource(true);
+                return;
             }
+            ++source.sequenceNumber;
+            source.packetSamples = frameCount * source.samplesPerFrame;
+            source.timestamp += static_cast<uint32_t>(source.packetSamples);
+            continue;
+        }
 
-            if(bytesReadSigned == 0) {
-                // End of stream. switch to inactive mode.
-                setOperatingMode(OperatingMode::INACTIVE);
-                break;
-            }
+        if(endOfStream) {
+            LOG_DEBUG << TAG_MEDIAENDPOINT << "Source stream ended";
+            finishSource(false);
+            return;
+        }
+        break;
+    }
 
-            size_t bytesRead = static_cast<size_t>(bytesReadSigned);
+    // Sleep until the pending packet is due, or there is room for it, or data for the next one.
+    int timeout = -1;
+    bool waitForDeadline = false;
+    if(source.packetLength > 0) {
+        if(source.transmitBufferFull) {
+            // Wait for EPOLLOUT.
+        } else if(m_pacer.arm()) {
+            waitForDeadline = true;
+        } else {
+            timeout = m_pacer.getDueTimeout(PacketPacer::Clock::now());
+        }
+    } else if(source.readerFD < 0) {
+        timeout = source.readerPollTimeout;
+    }
 
-            if(bytesRead < sizeof(rtp_header)) {
-                // Invalid RPT frame. Skip it
-                continue;
-            }
+    const uint32_t readable = EPOLLIN;
+    const uint32_t writable = EPOLLOUT;
+    bool watched = updateWatch(m_streamFD, source.transmitBufferFull ? writable : 0, &source.streamEvents);
+    if(source.readerFD >= 0) {
+        watched = watched && updateWatch(source.readerFD, 0 == source.packetLength ? readable : 0, &source.readerEvents);
+    }
+    if(m_pacer.getFD() >= 0) {
+        watched = watched && updateWatch(m_pacer.getFD(), waitForDeadline ? readable : 0, &source.pacerEvents);
+    }
+    if(!watched) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "serviceSourceFailed; reason: Failed to watch bluetooth media stream";
+        finishSource(true);
+        return;
+    }
+    armTimer(timeout);
+}
 
-            // Decode RTP frame and SBC payload.
-            rtp_header_t* rtpHeader = reinterpret_cast<rtp_header_t*>(m_ioBuffer.data());
-            const rtp_payload_sbc_t* rtpPayload = 
-                reinterpret_cast<const rtp_payload_sbc_t*>(&rtpHeader->csrc[rtpHeader->cc]);
-            
-            const uint8_t* payloadData = reinterpret_cast<const uint8_t*>(rtpPayload + 1);
-            uint8_t* output = m_sbcBuffer.data();
-            size_t headersSize = reinterpret_cast<size_t>(payloadData) - reinterpret_cast<size_t>(m_ioBuffer.data());
-            size_t inputLength = bytesRead - headersSize;
-            if (inputLength > m_ioBuffer.size()) {
-                // Invalid RTP frame, skip it
-                continue;
-            }
-            size_t outputLength = outBufferSize;
-            size_t frameCount = rtpPayload->frame_count;
-
-            while(frameCount-- && inputLength >= sbcFrameLength) {
-                ssize_t bytesProcessed = 0;
-                size_t bytesDecoded = 0;
-
-                if ((bytesProcessed = sbc_decode(
-                         mediaContext->getSBCContextPtr(),
-                         payloadData,
-                         inputLength,
-                         output,
-                         outputLength,
-                         &bytesDecoded)) < 0) {
-                    LOG_ERROR << TAG_MEDIAENDPOINT << "mediaThreadFailed; reason: SBC decoding error";
-                    break;
-                }
+void MediaEndpoint::finishSource(bool failed) {
+    if(failed) {
+        abortStreaming();
+    } else {
+        setOperatingMode(OperatingMode::INACTIVE);
+    }
+    stopStreaming(OperatingMode::INACTIVE);
+}
 
-                payloadData += bytesProcessed;
-                inputLength -= bytesProcessed;
+size_t MediaEndpoint::encodeRTPPacket(
+    std::shared_ptr<MediaContext> mediaContext,
+    size_t pcmLength,
+    uint16_t sequenceNumber,
+    uint32_t timestamp,
+    size_t* frameCount) {
+    uint8_t* packet = m_ioBuffer.data();
+    memset(packet, 0, RTP_HEADER_SIZE + sizeof(rtp_payload_sbc_t));
+
+    rtp_header_t* rtpHeader = reinterpret_cast<rtp_header_t*>(packet);
+    rtpHeader->version = RTP_VERSION;
+    rtpHeader->paytype = RTP_PAYLOAD_TYPE_SBC;
+    rtpHeader->seq_number = htons(sequenceNumber);
+    rtpHeader->timestamp = htonl(timestamp);
+    rtpHeader->ssrc = htonl(RTP_SSRC);
+
+    rtp_payload_sbc_t* rtpPayload = reinterpret_cast<rtp_payload_sbc_t*>(packet + RTP_HEADER_SIZE);
+    uint8_t* payloadData = reinterpret_cast<uint8_t*>(rtpPayload + 1);
+    const size_t headersSize = static_cast<size_t>(payloadData - packet);
+
+    size_t payloadLength = 0;
+    *frameCount = encodeSBCFrames(
+        mediaContext->getSBCContextPtr(),
+        m_sbcBuffer.data(),
+        pcmLength,
+        MAX_SBC_FRAMES_PER_PACKET,
+        sbc_get_codesize(mediaContext->getSBCContextPtr()),
+        payloadData,
+        m_ioBuffer.size() - headersSize,
+        &payloadLength);
+    if(0 == *frameCount) {
+        return 0;
+    }
 
-                output += bytesDecoded;
-                outputLength -= bytesDecoded;
-            }
+    rtpPayload->frame_count = static_cast<uint8_t>(*frameCount);
+    return headersSize + payloadLength;
+}
 
-            size_t writeSize = output - m_sbcBuffer.data();
+void MediaEndpoint::prepareReceiveBuffers(size_t mtu) {
+    m_packets.clear();
+    m_receiveBuffers.clear();
+    if(!m_receivePool || m_receivePool->getBufferSize() < mtu) {
+        m_receivePool.reset();
+        m_receivePool =
+            common::utils::memory::make_unique<common::utils::memory::BufferPool>(mtu, RECEIVE_BUFFER_COUNT);
+    }
 
-            // Check if we are still in SINK mode
-            if(m_operatingMode != OperatingMode::SINK) {
-                break;
-            }
+    m_receiveBuffers.reserve(MAX_PACKETS_PER_BATCH);
+    m_packetVectors.resize(MAX_PACKETS_PER_BATCH);
+    m_packetHeaders.resize(MAX_PACKETS_PER_BATCH);
+    m_packets.reserve(MAX_PACKETS_PER_BATCH);
+
+    for(size_t i = 0; i < MAX_PACKETS_PER_BATCH; ++i) {
+        memset(&m_packetHeaders[i], 0, sizeof(mmsghdr));
+        m_packetHeaders[i].msg_hdr.msg_iov = &m_packetVectors[i];
+        m_packetHeaders[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+ssize_t MediaEndpoint::receivePacketBatch(int fd, bool* endOfStream) {
+    // Take buffers for the whole batch. The pool has room for a full jitter buffer, a batch being decoded and this
+    // one, so it only runs out if buffers leak.
+    while(m_receiveBuffers.size() < MAX_PACKETS_PER_BATCH) {
+        common::utils::memory::BufferPool::Buffer buffer = m_receivePool->acquire();
+        if(!buffer) {
+            break;
+        }
+        m_receiveBuffers.push_back(std::move(buffer));
+    }
+    if(m_receiveBuffers.empty()) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "receivePacketBatchFailed; reason: No receive buffer left";
+        return -1;
+    }
+
+    const size_t bufferCount = m_receiveBuffers.size();
+    for(size_t i = 0; i < bufferCount; ++i) {
+        m_packetVectors[i].iov_base = m_receiveBuffers[i].data();
+        m_packetVectors[i].iov_len = m_receiveBuffers[i].capacity();
+    }
+
+    int received = recvmmsg(fd, m_packetHeaders.data(), bufferCount, MSG_DONTWAIT, nullptr);
+    if(received < 0) {
+        if(EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno) {
+            return 0;
+        }
+        if(ENOTSOCK != errno) {
+            return -1;
+        }
 
-            m_ioStream->send(m_sbcBuffer.data(), writeSize);
-        } // IO loop, continue while still in SINK mode
-    }     // while(true) - thread loop
+        // Not a socket: fall back to reading the one packet the reactor reported.
+        ssize_t bytesRead = read(fd, m_packetVectors[0].iov_base, m_packetVectors[0].iov_len);
+        if(bytesRead < 0) {
+            return -1;
+        }
+        m_packetHeaders[0].msg_len = static_cast<unsigned int>(bytesRead);
+        received = 1;
+    }
+
+    const auto arrivalTime = JitterBuffer::Clock::now();
+
+    for(int i = 0; i < received; ++i) {
+        size_t packetLength = m_packetHeaders[i].msg_len;
+        if(0 == packetLength) {
+            // A zero length message marks the end of the stream; anything after it is the same.
+            *endOfStream = true;
+            break;
+        }
+
+        m_receiveBuffers[i].setSize(packetLength);
+        bufferPacket(std::move(m_receiveBuffers[i]), arrivalTime);
+    }
+    m_receiveBuffers.erase(m_receiveBuffers.begin(), m_receiveBuffers.begin() + received);
+
+    return received;
+}
+
+ssize_t MediaEndpoint::receivePipelinedPackets(bool* endOfStream) {
+    // The state is read first: once the pipeline has stopped, the queue holds everything it received.
+    const ReceivePipeline::State state = m_receivePipeline.acknowledge();
+
+    ssize_t received = 0;
+    ReceivePipeline::Packet packet;
+    while(m_receivePipeline.pop(&packet)) {
+        bufferPacket(std::move(packet.buffer), packet.arrivalTime);
+        m_receivePipeline.release(&packet);
+        ++received;
+    }
+
+    if(ReceivePipeline::State::FAILED == state) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "receivePipelinedPacketsFailed; reason: Receive pipeline failed";
+        return -1;
+    }
+    *endOfStream = ReceivePipeline::State::END_OF_STREAM == state;
+    return received;
+}
 
-    mediaContext.reset();
-    LOG_DEBUG << TAG_MEDIAENDPOINT << "Exiting media thread";
+void MediaEndpoint::bufferPacket(
+    common::utils::memory::BufferPool::Buffer packet,
+    JitterBuffer::Clock::time_point arrivalTime) {
+    size_t headersSize = 0;
+    size_t frameCount = 0;
+    uint16_t sequenceNumber = 0;
+    uint32_t timestamp = 0;
+    if(!parseRTPPacket(packet.data(), packet.size(), &headersSize, &frameCount, &sequenceNumber, &timestamp)) {
+        // Invalid RTP frame, skip it
+        return;
+    }
+    m_jitterBuffer.push(sequenceNumber, timestamp, std::move(packet), headersSize, frameCount, arrivalTime);
 }
 
 std::shared_ptr<common::utils::bluetooth::FormattedAudioStreamAdapter> MediaEndpoint::getAudioStream() {
@@ -298,106 +1040,516 @@ std::shared_ptr<common::utils::bluetooth::FormattedAudioStreamAdapter> MediaEndp
     return m_ioStream;
 }
 
-std::string MediaEndpoint::getEndpointPath() const {
-    return m_endpointPath;
+std::shared_ptr<common::utils::AudioInputStream> MediaEndpoint::getAudioInputStream() {
+    std::lock_guard<std::mutex> guard(m_streamMutex);
+
+    if(m_audioInputStream) {
+        return m_audioInputStream;
+    }
+
+    size_t bufferSize = common::utils::AudioInputStream::calculateBufferSize(
+        AUDIO_INPUT_STREAM_BUFFER_SIZE_IN_WORDS, AUDIO_INPUT_STREAM_WORD_SIZE, AUDIO_INPUT_STREAM_MAX_READERS);
+    auto buffer = std::make_shared<common::utils::AudioInputStream::Buffer>(bufferSize);
+
+    std::shared_ptr<common::utils::AudioInputStream> stream = common::utils::AudioInputStream::create(
+        buffer, AUDIO_INPUT_STREAM_WORD_SIZE, AUDIO_INPUT_STREAM_MAX_READERS);
+    if(!stream) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "getAudioInputStreamFailed; reason: Failed to create AudioInputStream";
+        return nullptr;
+    }
+
+    std::shared_ptr<common::utils::AudioInputStream::Writer> writer =
+        stream->createWriter(common::utils::AudioInputStream::Writer::Policy::NONBLOCKABLE);
+    if(!writer) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "getAudioInputStreamFailed; reason: Failed to create AudioInputStream writer";
+        return nullptr;
+    }
+
+    m_audioInputStream = stream;
+    m_audioInputStreamWriter = writer;
+    return m_audioInputStream;
 }
 
-std::string MediaEndpoint::getStreamingDevicePath() const {
-    return m_streamingDevicePath;
+JitterBuffer::Statistics MediaEndpoint::getJitterBufferStatistics() const {
+    return m_jitterBuffer.getStatistics();
 }
 
-void MediaEndpoint::setOperatingMode(OperatingMode mode) {
-    std::lock_guard<std::mutex> modeLock(m_mutex);
+void MediaEndpoint::setJitterBufferLatency(
+    std::chrono::milliseconds minimumLatency,
+    std::chrono::milliseconds maximumLatency) {
+    m_jitterBuffer.setLatencyBounds(minimumLatency, maximumLatency);
+}
 
-    m_operatingMode = mode;
-    m_operatingModeChanged = true;
-    m_modeChangeSignal.notify_all();
+void MediaEndpoint::setClockDriftCompensation(bool enabled) {
+    m_clockDriftCompensation = enabled;
 }
 
-void MediaEndpoint::onMediaTransportStateChanged(
-    common::utils::bluetooth::MediaStreamingState newState,
-    const std::string& devicePath) {
+void MediaEndpoint::setPipelinedReceive(bool enabled, int receiveCPU) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_pipelinedReceive = enabled;
+    m_receiveCPU = receiveCPU;
+}
 
-    if(m_operatingMode == OperatingMode::RELEASED) {
-        // Release the media thread already.
+void MediaEndpoint::setProcessingStages(
+    std::vector<std::shared_ptr<common::utils::audio::AudioProcessingStage>> stages) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_processingStages = std::move(stages);
+}
+
+std::vector<std::shared_ptr<common::utils::audio::AudioProcessingStage>> MediaEndpoint::getProcessingStages() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_processingStages;
+}
+
+PacketPacer::Statistics MediaEndpoint::getSourceStatistics() const {
+    return m_pacer.getStatistics();
+}
+
+bool MediaEndpoint::setSourceStream(std::shared_ptr<common::utils::AudioInputStream> stream) {
+    if(common::utils::bluetooth::A2DPRole::SOURCE != m_role) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "setSourceStreamFailed; reason: not a source endpoint";
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_streamMutex);
+        m_sourceStream = stream;
+    }
+
+    if(!stream) {
+        if(m_operatingMode == OperatingMode::SOURCE) {
+            setOperatingMode(OperatingMode::INACTIVE);
+        }
+        return true;
+    }
+
+    if(m_operatingMode != OperatingMode::INACTIVE || m_streamingDevicePath.empty()) {
+        // Already streaming, in which case the new stream is picked up with the next one, or no transport configured
+        // yet, in which case streaming starts once the remote device asks for it.
+        return true;
+    }
+
+    if(!acquireTransport()) {
+        return false;
+    }
+
+    setOperatingMode(OperatingMode::SOURCE);
+    return true;
+}
+
+void MediaEndpoint::playOutPackets(
+    common::utils::AudioInputStream::Writer* writer,
+    std::shared_ptr<MediaContext> mediaContext,
+    size_t sbcFrameLength,
+    size_t sbcCodeSize,
+    JitterBuffer::Clock::time_point now) {
+
+    // Follow the clock of the remote device once the jitter buffer has an estimate of it, keeping on resampling down
+    // to half the dead band so that an estimate hovering around it doesn't switch back and forth. The resampler works
+    // on samples in host byte order.
+    const double clockRatio = m_jitterBuffer.getClockRatio();
+    const double deadBand = m_resampling ? CLOCK_DRIFT_DEAD_BAND / 2 : CLOCK_DRIFT_DEAD_BAND;
+    const bool resample = m_clockDriftCompensation && std::fabs(clockRatio - 1.0) > deadBand &&
+        (SBC_BE == mediaContext->getSBCContextPtr()->endian) == (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__);
+    if(resample && !m_resampling) {
+        // Don't interpolate with what was left from the last time the resampler ran.
+        m_resampler.reset(m_resampler.getNumChannels());
+    }
+    m_resampler.setRatio(clockRatio);
+    m_resampling = resample;
+
+    while(m_operatingMode == OperatingMode::SINK) {
+        m_packets.clear();
+        SBCPacket packet;
+        while(m_packets.size() < MAX_PACKETS_PER_BATCH && m_jitterBuffer.pop(now, &packet)) {
+            m_packets.push_back(std::move(packet));
+            if(m_packets.back().concealed) {
+                // The payload of a concealment packet only lasts until the next pop().
+                break;
+            }
+        }
+
+        if(m_packets.empty()) {
+            break;
+        }
+
+        if(writer && !resample) {
+            decodeToAudioInputStream(
+                writer, mediaContext, m_packets.data(), m_packets.size(), sbcFrameLength, sbcCodeSize);
+        } else {
+            decodeToAudioStream(
+                writer, mediaContext, m_packets.data(), m_packets.size(), sbcFrameLength, sbcCodeSize, resample);
+        }
+    }
+
+    // The buffers of the packets played out go back to their pool; the receiving thread may be waiting for them.
+    m_packets.clear();
+    if(m_pipelined) {
+        m_receivePipeline.notifyReleased();
+    }
+}
+
+void MediaEndpoint::decodeToAudioStream(
+    common::utils::AudioInputStream::Writer* writer,
+    std::shared_ptr<MediaContext> mediaContext,
+    const SBCPacket* packets,
+    size_t packetCount,
+    size_t sbcFrameLength,
+    size_t sbcCodeSize,
+    bool resample) {
+
+    sbc_t* sbcContext = mediaContext->getSBCContextPtr();
+    const bool bigEndian = SBC_BE == sbcContext->endian;
+    size_t writeSize = 0;
+
+    for(size_t i = 0; i < packetCount; ++i) {
+        const uint8_t* payloadData = packets[i].payloadData;
+        size_t inputLength = packets[i].inputLength;
+        size_t frameCount = packets[i].frameCount;
+
+        uint8_t* output = m_sbcBuffer.data() + writeSize;
+        size_t decoded = decodeSBCFrames(
+            sbcContext,
+            &payloadData,
+            &inputLength,
+            &frameCount,
+            sbcFrameLength,
+            sbcCodeSize,
+            output,
+            m_sbcBuffer.size() - writeSize);
+        if(packets[i].startGain != 1.0f || packets[i].endGain != 1.0f) {
+            applyGainRamp(output, decoded, packets[i].startGain, packets[i].endGain, bigEndian);
+        }
+        writeSize += decoded;
+    }
+
+    uint8_t* data = m_sbcBuffer.data();
+    if(resample) {
+        const size_t frameSize = m_resampler.getNumChannels() * sizeof(int16_t);
+        writeSize = frameSize * m_resampler.process(
+            reinterpret_cast<const int16_t*>(m_sbcBuffer.data()),
+            writeSize / frameSize,
+            reinterpret_cast<int16_t*>(m_resampledBuffer.data()),
+            m_resampledBuffer.size() / frameSize);
+        data = m_resampledBuffer.data();
+    }
+
+    // Check if we are still in SINK mode
+    if(m_operatingMode != OperatingMode::SINK) {
         return;
     }
 
-    if(m_streamingDevicePath != devicePath) {
+    processAudio(data, writeSize);
+    if(writer) {
+        writer->write(data, writeSize / writer->getWordSize());
+    }
+    m_ioStream->send(data, writeSize);
+}
+
+void MediaEndpoint::decodeToAudioInputStream(
+    common::utils::AudioInputStream::Writer* writer,
+    std::shared_ptr<MediaContext> mediaContext,
+    const SBCPacket* packets,
+    size_t packetCount,
+    size_t sbcFrameLength,
+    size_t sbcCodeSize) {
+
+    const size_t wordSize = writer->getWordSize();
+    common::utils::AudioInputStream::Writer::Span first;
+    common::utils::AudioInputStream::Writer::Span second;
+
+    // Reserve room for the whole batch, so that it is committed, and the readers are woken up, only once.
+    size_t totalFrameCount = 0;
+    for(size_t i = 0; i < packetCount; ++i) {
+        totalFrameCount += packets[i].frameCount;
+    }
+    if(0 == totalFrameCount) {
         return;
     }
 
-    if(newState == common::utils::bluetooth::MediaStreamingState::PENDING) {
-        // pending: streaming but not acquired.
-        std::shared_ptr<DBusProxy> transportProxy = 
-            DBusProxy::create(BlueZConstants::BLUEZ_MEDIATRANSPORT_INTERFACE, m_streamingDevicePath);
+    ssize_t reserved = writer->reserve(totalFrameCount * sbcCodeSize / wordSize, &first, &second);
+    if(reserved <= 0) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "decodeToAudioInputStreamFailed; reason: Failed to reserve stream space";
+        return;
+    }
 
-        if(!transportProxy) {
-            LOG_ERROR << TAG_MEDIAENDPOINT  << "onMediaTransportStateChangedFailed"
-                                            << "reason: Failed to get MediaTransport1 proxy";
-            return;
+    sbc_t* sbcContext = mediaContext->getSBCContextPtr();
+    const bool bigEndian = SBC_BE == sbcContext->endian;
+    const size_t firstSize = first.nWords * wordSize;
+    const size_t secondSize = second.nWords * wordSize;
+    size_t firstDecoded = 0;
+    size_t secondDecoded = 0;
+    bool pastWrap = false;
+
+    for(size_t i = 0; i < packetCount; ++i) {
+        const uint8_t* payloadData = packets[i].payloadData;
+        size_t inputLength = packets[i].inputLength;
+        size_t frameCount = packets[i].frameCount;
+        const size_t packetStart = firstDecoded + secondDecoded;
+
+        if(!pastWrap) {
+            // Decode straight into the ring up to the wrap.
+            firstDecoded += decodeSBCFrames(
+                sbcContext,
+                &payloadData,
+                &inputLength,
+                &frameCount,
+                sbcFrameLength,
+                sbcCodeSize,
+                first.data + firstDecoded,
+                firstSize - firstDecoded);
+            if(0 == frameCount) {
+                // The packet ran out before the room did. Any room left short of a frame is filled by the next one.
+                continue;
+            }
+            pastWrap = true;
+
+            if(secondSize > 0 && firstDecoded < firstSize) {
+                // The next frame straddles the wrap. Decode it aside and split it across the two spans.
+                size_t straddling = decodeSBCFrames(
+                    sbcContext,
+                    &payloadData,
+                    &inputLength,
+                    &frameCount,
+                    sbcFrameLength,
+                    sbcCodeSize,
+                    m_sbcBuffer.data(),
+                    sbcCodeSize);
+                size_t head = std::min(firstSize - firstDecoded, straddling);
+                memcpy(first.data + firstDecoded, m_sbcBuffer.data(), head);
+                memcpy(second.data, m_sbcBuffer.data() + head, straddling - head);
+                firstDecoded += head;
+                secondDecoded = straddling - head;
+            }
         }
 
-        ManagedGError error;
-        // Do not free, we do not own this object.
-        GUnixFDList* fdList = nullptr;
-        ManagedGVariant transportDetails = 
-            transportProxy->callMethodWithFDList("Acquire", nullptr, &fdList, error.toOutputParameter());
-        if(error.hasError()) {
-            LOG_ERROR << TAG_MEDIAENDPOINT << "onMediaTransportStateChangedFailed; reason: Failed to acquire media stream";
-            return;
-        } else if(!fdList) {
-            LOG_ERROR << TAG_MEDIAENDPOINT  << "onMediaTransportStateChangedFailed; reason: nullFdlist; message: " 
-                                            << error.getMessage();
-            return;
+        // Continue straight into the ring after the wrap.
+        secondDecoded += decodeSBCFrames(
+            sbcContext,
+            &payloadData,
+            &inputLength,
+            &frameCount,
+            sbcFrameLength,
+            sbcCodeSize,
+            second.data + secondDecoded,
+            secondSize - secondDecoded);
+
+        if(packets[i].startGain != 1.0f || packets[i].endGain != 1.0f) {
+            // Fade the packet where it landed, which may be on both sides of the wrap.
+            const size_t packetEnd = firstDecoded + secondDecoded;
+            const size_t split = std::min(std::max(packetStart, firstSize), packetEnd);
+            const float splitGain = packetEnd > packetStart
+                ? packets[i].startGain + (packets[i].endGain - packets[i].startGain) * (split - packetStart) /
+                    (packetEnd - packetStart)
+                : packets[i].endGain;
+            if(split > packetStart) {
+                applyGainRamp(
+                    first.data + packetStart, split - packetStart, packets[i].startGain, splitGain, bigEndian);
+            }
+            if(packetEnd > split) {
+                applyGainRamp(
+                    second.data + (split - firstSize), packetEnd - split, splitGain, packets[i].endGain, bigEndian);
+            }
         }
+    }
 
-        gint32 streamFDIndex = 0;
-        guint16 readMTU = 0;
-        guint16 writeMTU = 0;
-        g_variant_get(transportDetails.get(), "(hqq)", &streamFDIndex, &readMTU, &writeMTU);
+    // The readers only see the data once committed, so it can still be processed in the ring.
+    processAudio(first.data, firstDecoded);
+    processAudio(second.data, secondDecoded);
+    writer->commit((firstDecoded + secondDecoded) / wordSize);
 
-        if (streamFDIndex > g_unix_fd_list_get_length(fdList)) {
-            LOG_ERROR << TAG_MEDIAENDPOINT << "onMediaTransportStateChangedFailed; reason: indexOutOfBounds";
-            return;
-        }
+    // Check if we are still in SINK mode
+    if(m_operatingMode != OperatingMode::SINK) {
+        return;
+    }
+
+    if(firstDecoded > 0) {
+        m_ioStream->send(first.data, firstDecoded);
+    }
+    if(secondDecoded > 0) {
+        m_ioStream->send(second.data, secondDecoded);
+    }
+}
 
-        // g_unix_fd_list_get duplicates the fd
-        gint streamFD = g_unix_fd_list_get(fdList, streamFDIndex, error.toOutputParameter());
+void MediaEndpoint::createProcessingChain(const common::utils::AudioFormat& audioFormat, size_t maxFrames) {
+    std::vector<std::shared_ptr<common::utils::audio::AudioProcessingStage>> stages;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        stages = m_processingStages;
+    }
 
-        if (streamFD < 0) {
-            LOG_ERROR << TAG_MEDIAENDPOINT << "onMediaTransportStateChangedFailed; reason: Invalid media stream file descriptor";
-            return;
+    m_processingChain.reset();
+    if(stages.empty()) {
+        return;
+    }
+
+    stages.insert(
+        stages.begin(),
+        std::make_shared<common::utils::audio::ConversionStage>(
+            common::utils::audio::ConversionStage::getFloatFormat(audioFormat.numChannels)));
+    stages.push_back(std::make_shared<common::utils::audio::ConversionStage>(audioFormat));
+    m_processingChain = common::utils::audio::AudioProcessingChain::create(audioFormat, maxFrames, std::move(stages));
+    if(!m_processingChain) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "createProcessingChainFailed; reason: stages do not support the stream; "
+                  << "numChannels: " << audioFormat.numChannels << "; rate: " << audioFormat.sampleRateHz;
+        return;
+    }
+
+    // The PCM is processed in place, so the stages must give back as many frames as they are given.
+    const common::utils::AudioFormat outputFormat = m_processingChain->getOutputFormat();
+    if(outputFormat.sampleRateHz != audioFormat.sampleRateHz || outputFormat.numChannels != audioFormat.numChannels) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "createProcessingChainFailed; reason: stages change the sample rate or "
+                  << "channels; numChannels: " << outputFormat.numChannels << "; rate: " << outputFormat.sampleRateHz;
+        m_processingChain.reset();
+    }
+}
+
+void MediaEndpoint::processAudio(uint8_t* data, size_t size) {
+    if(!m_processingChain) {
+        return;
+    }
+
+    const common::utils::AudioFormat audioFormat = m_processingChain->getInputFormat();
+    const size_t frameSize = audioFormat.numChannels * audioFormat.sampleSizeInBits / 8;
+    const size_t blockSize = m_processingChain->getMaxFrames() * frameSize;
+    for(size_t offset = 0; offset < size; offset += blockSize) {
+        const size_t inputSize = std::min(blockSize, size - offset);
+        const unsigned char* output = nullptr;
+        if(m_processingChain->process(data + offset, inputSize, &output) == inputSize) {
+            memcpy(data + offset, output, inputSize);
         }
+    }
+}
 
-        if (error.hasError()) {
-            LOG_ERROR << TAG_MEDIAENDPOINT << "onMediaTransportStateChangedFailed; reason: failedToGetFD " << error.getMessage();
-            close(streamFD);
-            return;
+std::string MediaEndpoint::getEndpointPath() const {
+    return m_endpointPath;
+}
+
+std::string MediaEndpoint::getStreamingDevicePath() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_streamingDevicePath;
+}
+
+void MediaEndpoint::setOperatingMode(OperatingMode mode) {
+    {
+        std::lock_guard<std::mutex> modeLock(m_mutex);
+        m_operatingMode = mode;
+    }
+
+    if(m_reactor) {
+        // The reactor picks the latest mode up, whichever thread this is called from.
+        m_reactor->post([this]() { onOperatingModeChanged(); });
+    }
+}
+
+bool MediaEndpoint::acquireTransport() {
+    std::shared_ptr<DBusProxy> transportProxy = 
+        DBusProxy::create(BlueZConstants::BLUEZ_MEDIATRANSPORT_INTERFACE, m_streamingDevicePath);
+
+    if(!transportProxy) {
+        LOG_ERROR << TAG_MEDIAENDPOINT  << "acquireTransportFailed"
+                                        << "reason: Failed to get MediaTransport1 proxy";
+        return false;
+    }
+
+    ManagedGError error;
+    // Do not free, we do not own this object.
+    GUnixFDList* fdList = nullptr;
+    ManagedGVariant transportDetails = 
+        transportProxy->callMethodWithFDList("Acquire", nullptr, &fdList, error.toOutputParameter());
+    if(error.hasError()) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "acquireTransportFailed; reason: Failed to acquire media stream";
+        return false;
+    } else if(!fdList) {
+        LOG_ERROR << TAG_MEDIAENDPOINT  << "acquireTransportFailed; reason: nullFdlist; message: " 
+                                        << error.getMessage();
+        return false;
+    }
+
+    gint32 streamFDIndex = 0;
+    guint16 readMTU = 0;
+    guint16 writeMTU = 0;
+    g_variant_get(transportDetails.get(), "(hqq)", &streamFDIndex, &readMTU, &writeMTU);
+
+    if (streamFDIndex > g_unix_fd_list_get_length(fdList)) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "acquireTransportFailed; reason: indexOutOfBounds";
+        return false;
+    }
+
+    // g_unix_fd_list_get duplicates the fd
+    gint streamFD = g_unix_fd_list_get(fdList, streamFDIndex, error.toOutputParameter());
+
+    if (streamFD < 0) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "acquireTransportFailed; reason: Invalid media stream file descriptor";
+        return false;
+    }
+
+    if (error.hasError()) {
+        LOG_ERROR << TAG_MEDIAENDPOINT << "acquireTransportFailed; reason: failedToGetFD " << error.getMessage();
+        close(streamFD);
+        return false;
+    }
+
+    LOG_DEBUG << TAG_MEDIAENDPOINT  << "Transport details.";
+    LOG_DEBUG << TAG_MEDIAENDPOINT  << "File descriptor index: " << streamFDIndex
+                                    << ", file descriptor:  " << streamFD << ", read MTU: " << readMTU
+                                    << ", write MTU: " << writeMTU;
+
+    {
+        std::lock_guard<std::mutex> modeLock(m_mutex);
+
+        if (!m_currentMediaContext) {
+            m_currentMediaContext = std::make_shared<MediaContext>();
         }
 
-        LOG_DEBUG << TAG_MEDIAENDPOINT  << "Transport details.";
-        LOG_DEBUG << TAG_MEDIAENDPOINT  << "File descriptor index: " << streamFDIndex
-                                        << ", file descriptor:  " << streamFD << ", read MTU: " << readMTU
-                                        << ", write MTU: " << writeMTU;
+        m_currentMediaContext->setStreamFD(streamFD);
 
-        {
-            std::lock_guard<std::mutex> modeLock(m_mutex);
+        m_currentMediaContext->setReadMTU(readMTU);
+        m_currentMediaContext->setWriteMTU(writeMTU);
+    }
 
-            if (!m_currentMediaContext) {
-                m_currentMediaContext = std::make_shared<MediaContext>();
-            }
+    return true;
+}
 
-            m_currentMediaContext->setStreamFD(streamFD);
+void MediaEndpoint::releaseTransport(std::shared_ptr<MediaContext> mediaContext) {
+    callMethodOnWorker(BlueZConstants::BLUEZ_MEDIATRANSPORT_INTERFACE, getStreamingDevicePath(), "Release");
+
+    std::lock_guard<std::mutex> modeLock(m_mutex);
+    mediaContext->setStreamFD(MediaContext::INVALID_FD);
+}
 
-            m_currentMediaContext->setReadMTU(readMTU);
-            m_currentMediaContext->setWriteMTU(writeMTU);
+void MediaEndpoint::onMediaTransportStateChanged(
+    common::utils::bluetooth::MediaStreamingState newState,
+    const std::string& devicePath) {
+
+    if(m_operatingMode == OperatingMode::RELEASED) {
+        // Released already.
+        return;
+    }
+
+    if(m_streamingDevicePath != devicePath) {
+        return;
+    }
+
+    if(newState == common::utils::bluetooth::MediaStreamingState::PENDING) {
+        // pending: streaming but not acquired.
+        if(common::utils::bluetooth::A2DPRole::SOURCE == m_role) {
+            // The remote device asks for the stream to start; there is only something to send with a source stream.
+            std::lock_guard<std::mutex> guard(m_streamMutex);
+            if(!m_sourceStream) {
+                return;
+            }
+        }
+
+        if(!acquireTransport()) {
+            return;
         }
 
         // Make sure we have stream created
         getAudioStream();
 
-        setOperatingMode(OperatingMode::SINK);
+        setOperatingMode(
+            common::utils::bluetooth::A2DPRole::SOURCE == m_role ? OperatingMode::SOURCE : OperatingMode::SINK);
     } else if (common::utils::bluetooth::MediaStreamingState::IDLE == newState) {
         setOperatingMode(OperatingMode::INACTIVE);
     }
@@ -0,0 +1,207 @@
+#include <Common/Utils/Logger/Log.h>
+#include "BlueZ/MediaReactor.h"
+
+#include <Common/Utils/SDS/EventFD.h>
+#include <sys/epoll.h>
+#include <errno.h>
+#include <unistd.h>
+#include <cstring>
+#include <future>
+
+namespace deviceClientSDK {
+namespace bluetoothDevice {
+namespace blueZ {
+
+using namespace common::utils::logger;
+
+static const std::string TAG_MEDIAREACTOR = "MediaReactor\t";
+
+// The epoll key of the task eventfd. The keys of the descriptors watched start after it.
+constexpr uint64_t TASK_KEY = 0;
+
+// Largest number of events collected by one epoll_wait().
+constexpr int MAX_EVENTS = 16;
+
+std::shared_ptr<MediaReactor> MediaReactor::create(int cpu) {
+    int epollFD = epoll_create1(EPOLL_CLOEXEC);
+    if(epollFD < 0) {
+        LOG_ERROR << TAG_MEDIAREACTOR << "createFailed; reason: Failed to create epoll set; error: " << strerror(errno);
+        return nullptr;
+    }
+
+    int taskFD = common::utils::sds::eventFDCreate();
+    if(taskFD < 0) {
+        LOG_ERROR << TAG_MEDIAREACTOR << "createFailed; reason: Failed to create eventfd; error: " << strerror(errno);
+        close(epollFD);
+        return nullptr;
+    }
+
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u64 = TASK_KEY;
+    if(epoll_ctl(epollFD, EPOLL_CTL_ADD, taskFD, &event) < 0) {
+        LOG_ERROR << TAG_MEDIAREACTOR << "createFailed; reason: Failed to watch eventfd; error: " << strerror(errno);
+        close(taskFD);
+        close(epollFD);
+        return nullptr;
+    }
+
+    return std::shared_ptr<MediaReactor>(new MediaReactor(epollFD, taskFD, cpu));
+}
+
+MediaReactor::MediaReactor(int epollFD, int taskFD, int cpu) :
+        m_epollFD{epollFD},
+        m_taskFD{taskFD},
+        m_nextKey{TASK_KEY + 1},
+        m_stopping{false} {
+    m_thread = std::thread(&MediaReactor::reactorThread, this, cpu);
+}
+
+MediaReactor::~MediaReactor() {
+    m_stopping = true;
+    common::utils::sds::eventFDSignal(m_taskFD);
+    if(m_thread.joinable()) {
+        m_thread.join();
+    }
+    close(m_taskFD);
+    close(m_epollFD);
+}
+
+bool MediaReactor::add(int fd, uint32_t events, Handler handler) {
+    const uint64_t key = m_nextKey++;
+
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.u64 = key;
+    if(epoll_ctl(m_epollFD, EPOLL_CTL_ADD, fd, &event) < 0) {
+        LOG_ERROR << TAG_MEDIAREACTOR << "addFailed; fd: " << fd << "; error: " << strerror(errno);
+        return false;
+    }
+
+    m_watches[key] = std::make_shared<Watch>(Watch{fd, std::move(handler)});
+    m_keys[fd] = key;
+    return true;
+}
+
+bool MediaReactor::modify(int fd, uint32_t events) {
+    auto key = m_keys.find(fd);
+    if(key == m_keys.end()) {
+        LOG_ERROR << TAG_MEDIAREACTOR << "modifyFailed; reason: fd not watched; fd: " << fd;
+        return false;
+    }
+
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.u64 = key->second;
+    if(epoll_ctl(m_epollFD, EPOLL_CTL_MOD, fd, &event) < 0) {
+        LOG_ERROR << TAG_MEDIAREACTOR << "modifyFailed; fd: " << fd << "; error: " << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void MediaReactor::remove(int fd) {
+    auto key = m_keys.find(fd);
+    if(key == m_keys.end()) {
+        return;
+    }
+
+    if(epoll_ctl(m_epollFD, EPOLL_CTL_DEL, fd, nullptr) < 0) {
+        LOG_ERROR << TAG_MEDIAREACTOR << "removeFailed; fd: " << fd << "; error: " << strerror(errno);
+    }
+    m_watches.erase(key->second);
+    m_keys.erase(key);
+}
+
+void MediaReactor::post(Task task) {
+    {
+        std::lock_guard<std::mutex> guard(m_taskMutex);
+        m_tasks.push_back(std::move(task));
+    }
+    common::utils::sds::eventFDSignal(m_taskFD);
+}
+
+void MediaReactor::run(Task task) {
+    if(isReactorThread()) {
+        task();
+        return;
+    }
+
+    std::promise<void> done;
+    post([&task, &done]() {
+        task();
+        done.set_value();
+    });
+    done.get_future().wait();
+}
+
+bool MediaReactor::isReactorThread() const {
+    return std::this_thread::get_id() == m_thread.get_id();
+}
+
+bool MediaReactor::setAffinity(int cpu) {
+    bool pinned = false;
+    run([cpu, &pinned]() { pinned = common::utils::threading::setThisThreadAffinity(cpu); });
+    if(!pinned) {
+        LOG_ERROR << TAG_MEDIAREACTOR << "setAffinityFailed; reason: Failed to pin thread; cpu: " << cpu;
+    }
+    return pinned;
+}
+
+void MediaReactor::reactorThread(int cpu) {
+    if(common::utils::threading::ANY_CPU != cpu && !common::utils::threading::setThisThreadAffinity(cpu)) {
+        LOG_ERROR << TAG_MEDIAREACTOR << "reactorThreadFailed; reason: Failed to pin thread; cpu: " << cpu;
+    }
+
+    epoll_event events[MAX_EVENTS];
+
+    while(!m_stopping) {
+        int count = epoll_wait(m_epollFD, events, MAX_EVENTS, -1);
+        if(count < 0) {
+            if(EINTR == errno) {
+                continue;
+            }
+            LOG_ERROR << TAG_MEDIAREACTOR << "reactorThreadFailed; reason: Failed to wait for events; error: "
+                      << strerror(errno);
+            break;
+        }
+
+        for(int i = 0; i < count && !m_stopping; ++i) {
+            if(TASK_KEY == events[i].data.u64) {
+                common::utils::sds::eventFDDrain(m_taskFD);
+                runTasks();
+                continue;
+            }
+
+            // A handler run before may have removed this descriptor.
+            auto watch = m_watches.find(events[i].data.u64);
+            if(watch == m_watches.end()) {
+                continue;
+            }
+            // Keep the handler alive while it runs, in case it removes its own descriptor.
+            std::shared_ptr<Watch> current = watch->second;
+            current->handler(events[i].events);
+        }
+    }
+
+    LOG_DEBUG << TAG_MEDIAREACTOR << "Exiting reactor thread";
+}
+
+void MediaReactor::runTasks() {
+    std::deque<Task> tasks;
+    {
+        std::lock_guard<std::mutex> guard(m_taskMutex);
+        tasks.swap(m_tasks);
+    }
+
+    for(auto& task : tasks) {
+        task();
+    }
+}
+
+} // namespace blueZ
+} // namespace bluetoothDevice
+} // namespace deviceClientSDK
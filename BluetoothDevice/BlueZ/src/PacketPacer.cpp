@@ -0,0 +1,154 @@
+#include <Common/Utils/Logger/Log.h>
+#include "BlueZ/PacketPacer.h"
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+
+namespace deviceClientSDK {
+namespace bluetoothDevice {
+namespace blueZ {
+
+using namespace common::utils::logger;
+
+static const std::string TAG_PACKETPACER = "PacketPacer\t";
+
+// Gain of the send jitter smoothing, as used by RFC 3550 for the interarrival jitter.
+constexpr double JITTER_GAIN = 1.0 / 16;
+
+// Number of nanoseconds in a second.
+constexpr uint64_t NANOSECONDS_PER_SECOND = 1000000000ULL;
+
+constexpr std::chrono::milliseconds PacketPacer::MAX_CATCH_UP;
+
+PacketPacer::PacketPacer() :
+        m_timerFD{timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)},
+        m_sampleRate{0},
+        m_started{false},
+        m_samplesSent{0},
+        m_sendJitter{0},
+        m_statistics() {
+    if(m_timerFD < 0) {
+        LOG_ERROR << TAG_PACKETPACER << "PacketPacerFailed; reason: Failed to create timerfd; error: "
+                  << strerror(errno);
+    }
+}
+
+PacketPacer::~PacketPacer() {
+    if(m_timerFD >= 0) {
+        close(m_timerFD);
+    }
+}
+
+int PacketPacer::getFD() const {
+    return m_timerFD;
+}
+
+void PacketPacer::start(unsigned int sampleRate) {
+    m_sampleRate = sampleRate;
+    m_started = false;
+    m_samplesSent = 0;
+    m_sendJitter = 0;
+
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    m_statistics = Statistics();
+}
+
+PacketPacer::Clock::time_point PacketPacer::nextDeadline() const {
+    if(!m_started || 0 == m_sampleRate) {
+        return Clock::time_point::min();
+    }
+
+    // Computed from the start of the schedule every time, so that no rounding error builds up.
+    const std::chrono::nanoseconds elapsed(
+        m_samplesSent / m_sampleRate * NANOSECONDS_PER_SECOND +
+        m_samplesSent % m_sampleRate * NANOSECONDS_PER_SECOND / m_sampleRate);
+    return m_origin + std::chrono::duration_cast<Clock::duration>(elapsed);
+}
+
+bool PacketPacer::isDue(Clock::time_point now) const {
+    return now >= nextDeadline();
+}
+
+int PacketPacer::getDueTimeout(Clock::time_point now) const {
+    const Clock::time_point deadline = nextDeadline();
+    if(now >= deadline) {
+        return 0;
+    }
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                deadline - now + std::chrono::milliseconds(1) - Clock::duration(1))
+                                .count());
+}
+
+bool PacketPacer::arm() {
+    if(m_timerFD < 0) {
+        return false;
+    }
+
+    // Clear the expirations of past deadlines, so that poll() only wakes up for the next one.
+    uint64_t expirations;
+    if(read(m_timerFD, &expirations, sizeof(expirations)) < 0 && EAGAIN != errno) {
+        LOG_ERROR << TAG_PACKETPACER << "armFailed; reason: Failed to read timerfd; error: " << strerror(errno);
+    }
+
+    // Steady clock is CLOCK_MONOTONIC, so its time points are absolute times for the timerfd. A deadline in the past
+    // fires right away; a zero it_value would disarm the timer instead.
+    const auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::max(nextDeadline(), Clock::time_point(Clock::duration(1))).time_since_epoch());
+    itimerspec deadline;
+    memset(&deadline, 0, sizeof(deadline));
+    deadline.it_value.tv_sec = static_cast<time_t>(sinceEpoch.count() / NANOSECONDS_PER_SECOND);
+    deadline.it_value.tv_nsec = static_cast<long>(sinceEpoch.count() % NANOSECONDS_PER_SECOND);
+
+    if(timerfd_settime(m_timerFD, TFD_TIMER_ABSTIME, &deadline, nullptr) < 0) {
+        LOG_ERROR << TAG_PACKETPACER << "armFailed; reason: Failed to set timerfd; error: " << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void PacketPacer::onPacketSent(size_t sampleCount, Clock::time_point sendTime, size_t queueDepth) {
+    bool restarted = false;
+    std::chrono::microseconds lateness(0);
+
+    if(!m_started) {
+        m_started = true;
+        m_origin = sendTime;
+        m_samplesSent = 0;
+    } else {
+        lateness = std::chrono::duration_cast<std::chrono::microseconds>(sendTime - nextDeadline());
+        if(lateness > MAX_CATCH_UP) {
+            // Too late to catch up without a burst: the schedule starts over from this packet.
+            LOG_DEBUG << TAG_PACKETPACER << "Restarting schedule; lateness: " << lateness.count() << "us";
+            m_origin = sendTime;
+            m_samplesSent = 0;
+            restarted = true;
+        }
+    }
+
+    m_samplesSent += sampleCount;
+    m_sendJitter += (std::abs(static_cast<double>(lateness.count())) - m_sendJitter) * JITTER_GAIN;
+
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    ++m_statistics.packetsSent;
+    if(restarted) {
+        ++m_statistics.scheduleRestarts;
+    }
+    m_statistics.sendJitter = std::chrono::microseconds(static_cast<int64_t>(m_sendJitter));
+    m_statistics.maxLateness = std::max(m_statistics.maxLateness, lateness);
+    m_statistics.queueDepth = queueDepth;
+    m_statistics.maxQueueDepth = std::max(m_statistics.maxQueueDepth, queueDepth);
+}
+
+PacketPacer::Statistics PacketPacer::getStatistics() const {
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    return m_statistics;
+}
+
+} // namespace blueZ
+} // namespace bluetoothDevice
+} // namespace deviceClientSDK
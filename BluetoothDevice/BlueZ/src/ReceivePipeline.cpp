@@ -0,0 +1,244 @@
+#include <Common/Utils/Logger/Log.h>
+#include "BlueZ/ReceivePipeline.h"
+
+#include <Common/Utils/Memory/Memory.h>
+#include <Common/Utils/SDS/EventFD.h>
+#include <Common/Utils/Threading/ThreadAffinity.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace deviceClientSDK {
+namespace bluetoothDevice {
+namespace blueZ {
+
+using namespace common::utils::logger;
+
+static const std::string TAG_RECEIVEPIPELINE = "ReceivePipeline\t";
+
+// Largest number of packets received with one system call.
+constexpr size_t MAX_PACKETS_PER_BATCH = 16;
+
+// Index of the media stream in the poll set of the receiving thread.
+constexpr size_t POLL_INDEX_STREAM = 0;
+
+// Index of the wakeup eventfd in the poll set of the receiving thread.
+constexpr size_t POLL_INDEX_WAKE = 1;
+
+constexpr size_t ReceivePipeline::DEFAULT_BUFFER_COUNT;
+
+ReceivePipeline::ReceivePipeline(size_t bufferCount) :
+        m_bufferCount{bufferCount},
+        m_packets(bufferCount),
+        m_readyFD{common::utils::sds::eventFDCreate()},
+        m_wakeFD{common::utils::sds::eventFDCreate()},
+        m_starved{false},
+        m_stopping{false},
+        m_state{State::RUNNING} {
+    if(m_readyFD < 0 || m_wakeFD < 0) {
+        LOG_ERROR << TAG_RECEIVEPIPELINE << "ReceivePipelineFailed; reason: Failed to create eventfd; error: "
+                  << strerror(errno);
+    }
+}
+
+ReceivePipeline::~ReceivePipeline() {
+    stop();
+    if(m_readyFD >= 0) {
+        close(m_readyFD);
+    }
+    if(m_wakeFD >= 0) {
+        close(m_wakeFD);
+    }
+}
+
+bool ReceivePipeline::start(int fd, size_t mtu, int cpu) {
+    if(m_readyFD < 0 || m_wakeFD < 0) {
+        return false;
+    }
+
+    stop();
+
+    if(!m_pool || m_pool->getBufferSize() < mtu) {
+        m_pool.reset();
+        m_pool = common::utils::memory::make_unique<common::utils::memory::BufferPool>(mtu, m_bufferCount);
+    }
+
+    m_heldBuffers.reserve(MAX_PACKETS_PER_BATCH);
+    m_packetVectors.resize(MAX_PACKETS_PER_BATCH);
+    m_packetHeaders.resize(MAX_PACKETS_PER_BATCH);
+    for(size_t i = 0; i < MAX_PACKETS_PER_BATCH; ++i) {
+        memset(&m_packetHeaders[i], 0, sizeof(mmsghdr));
+        m_packetHeaders[i].msg_hdr.msg_iov = &m_packetVectors[i];
+        m_packetHeaders[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    common::utils::sds::eventFDDrain(m_readyFD);
+    common::utils::sds::eventFDDrain(m_wakeFD);
+    m_starved = false;
+    m_stopping = false;
+    m_state = State::RUNNING;
+
+    m_thread = std::thread(&ReceivePipeline::receiveThread, this, fd, cpu);
+    return true;
+}
+
+void ReceivePipeline::stop() {
+    if(!m_thread.joinable()) {
+        return;
+    }
+
+    m_stopping = true;
+    common::utils::sds::eventFDSignal(m_wakeFD);
+    m_thread.join();
+
+    // Both ends of the queue are idle now; return its buffers for the next stream.
+    Packet packet;
+    while(m_packets.pop(&packet)) {
+        packet.buffer.reset();
+    }
+    m_heldBuffers.clear();
+}
+
+int ReceivePipeline::getFD() const {
+    return m_readyFD;
+}
+
+ReceivePipeline::State ReceivePipeline::acknowledge() {
+    common::utils::sds::eventFDDrain(m_readyFD);
+    return m_state.load(std::memory_order_acquire);
+}
+
+bool ReceivePipeline::pop(Packet* packet) {
+    return m_packets.pop(packet);
+}
+
+void ReceivePipeline::release(Packet* packet) {
+    packet->buffer.reset();
+    notifyReleased();
+}
+
+void ReceivePipeline::notifyReleased() {
+    // Pairs with the fence of the receiving thread, so that either it sees the buffer, or this sees it starved.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(m_starved.load(std::memory_order_relaxed) && m_starved.exchange(false)) {
+        common::utils::sds::eventFDSignal(m_wakeFD);
+    }
+}
+
+void ReceivePipeline::receiveThread(int fd, int cpu) {
+    if(common::utils::threading::ANY_CPU != cpu && !common::utils::threading::setThisThreadAffinity(cpu)) {
+        LOG_ERROR << TAG_RECEIVEPIPELINE << "receiveThreadFailed; reason: Failed to pin thread; cpu: " << cpu;
+    }
+
+    pollfd pollStructs[] = {
+        { /* fd */ fd, /* requested events */ POLLIN, /* return events */ 0},
+        { /* fd */ m_wakeFD, /* requested events */ POLLIN, /* return events */ 0}};
+
+    while(!m_stopping) {
+        // Take buffers to receive the next batch into.
+        while(m_heldBuffers.size() < MAX_PACKETS_PER_BATCH) {
+            common::utils::memory::BufferPool::Buffer buffer = m_pool->acquire();
+            if(!buffer) {
+                break;
+            }
+            m_heldBuffers.push_back(std::move(buffer));
+        }
+        if(m_heldBuffers.empty()) {
+            // The consumer holds every buffer. Ask it for a wakeup, then check again in case it released one before
+            // seeing the request.
+            m_starved = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            common::utils::memory::BufferPool::Buffer buffer = m_pool->acquire();
+            if(buffer) {
+                m_starved = false;
+                m_heldBuffers.push_back(std::move(buffer));
+            }
+        }
+
+        // Without a buffer, the packets wait in the socket buffer; a negative fd is ignored by poll().
+        pollStructs[POLL_INDEX_STREAM].fd = m_heldBuffers.empty() ? -1 : fd;
+        if(poll(pollStructs, sizeof(pollStructs) / sizeof(pollStructs[0]), -1) < 0) {
+            if(EINTR == errno) {
+                continue;
+            }
+            LOG_ERROR << TAG_RECEIVEPIPELINE << "receiveThreadFailed; reason: Failed to poll bluetooth media stream";
+            finish(State::FAILED);
+            return;
+        }
+
+        if(pollStructs[POLL_INDEX_WAKE].revents) {
+            common::utils::sds::eventFDDrain(m_wakeFD);
+        }
+        if(pollStructs[POLL_INDEX_STREAM].revents && !receiveBatch(fd)) {
+            return;
+        }
+    }
+}
+
+bool ReceivePipeline::receiveBatch(int fd) {
+    const size_t bufferCount = m_heldBuffers.size();
+    for(size_t i = 0; i < bufferCount; ++i) {
+        m_packetVectors[i].iov_base = m_heldBuffers[i].data();
+        m_packetVectors[i].iov_len = m_heldBuffers[i].capacity();
+    }
+
+    int received = recvmmsg(fd, m_packetHeaders.data(), bufferCount, MSG_DONTWAIT, nullptr);
+    if(received < 0) {
+        if(EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno) {
+            return true;
+        }
+        if(ENOTSOCK != errno) {
+            LOG_ERROR << TAG_RECEIVEPIPELINE << "receiveBatchFailed; reason: Failed to read bluetooth media stream";
+            finish(State::FAILED);
+            return false;
+        }
+
+        // Not a socket: fall back to reading the one packet poll() reported.
+        ssize_t bytesRead = read(fd, m_packetVectors[0].iov_base, m_packetVectors[0].iov_len);
+        if(bytesRead < 0) {
+            LOG_ERROR << TAG_RECEIVEPIPELINE << "receiveBatchFailed; reason: Failed to read bluetooth media stream";
+            finish(State::FAILED);
+            return false;
+        }
+        m_packetHeaders[0].msg_len = static_cast<unsigned int>(bytesRead);
+        received = 1;
+    }
+
+    const Clock::time_point arrivalTime = Clock::now();
+
+    size_t queued = 0;
+    bool endOfStream = false;
+    Packet packet;
+    packet.arrivalTime = arrivalTime;
+    for(; queued < static_cast<size_t>(received); ++queued) {
+        if(0 == m_packetHeaders[queued].msg_len) {
+            // A zero length message marks the end of the stream; anything after it is the same.
+            endOfStream = true;
+            break;
+        }
+        packet.buffer = std::move(m_heldBuffers[queued]);
+        packet.buffer.setSize(m_packetHeaders[queued].msg_len);
+        // Can't fail: the queue holds as many packets as there are buffers.
+        m_packets.push(std::move(packet));
+    }
+    m_heldBuffers.erase(m_heldBuffers.begin(), m_heldBuffers.begin() + queued);
+
+    if(endOfStream) {
+        finish(State::END_OF_STREAM);
+        return false;
+    }
+    if(queued > 0) {
+        common::utils::sds::eventFDSignal(m_readyFD);
+    }
+    return true;
+}
+
+void ReceivePipeline::finish(State state) {
+    m_state.store(state, std::memory_order_release);
+    common::utils::sds::eventFDSignal(m_readyFD);
+}
+
+} // namespace blueZ
+} // namespace bluetoothDevice
+} // namespace deviceClientSDK
@@ -0,0 +1,510 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BlueZ/JitterBuffer.h"
+
+using namespace deviceClientSDK::bluetoothDevice::blueZ;
+using deviceClientSDK::common::utils::memory::BufferPool;
+
+// Sample rate of the stream.
+static const unsigned int SAMPLE_RATE = 44100;
+
+// Number of samples (per channel) of an SBC frame: 16 blocks of 8 subbands.
+static const size_t SAMPLES_PER_FRAME = 128;
+
+// Length of an SBC frame in bytes.
+static const size_t FRAME_LENGTH = 119;
+
+// Number of SBC frames of each packet, about 14.5ms of audio.
+static const size_t FRAMES_PER_PACKET = 5;
+
+// Length of the payload of each packet.
+static const size_t PAYLOAD_LENGTH = FRAME_LENGTH * FRAMES_PER_PACKET;
+
+// Length of the headers before the payload of each packet.
+static const size_t HEADERS_LENGTH = 13;
+
+// Number of samples (per channel) of each packet.
+static const uint32_t PACKET_SAMPLES = SAMPLES_PER_FRAME * FRAMES_PER_PACKET;
+
+// RTP timestamp of the first packet, close to the wrap so that the timestamps wrap in the longer tests.
+static const uint32_t BASE_TIMESTAMP = 0xfffff000;
+
+// Time the first packet arrives at.
+static const JitterBuffer::Clock::time_point BASE_TIME{std::chrono::seconds(10)};
+
+// Margin around a playout time, well above the rounding of the schedule to microseconds.
+static const std::chrono::milliseconds MARGIN{1};
+
+// Playout delay of a stream which arrives on time: the default minimum latency.
+static const std::chrono::milliseconds DELAY = JitterBuffer::DEFAULT_MINIMUM_LATENCY;
+
+// Number of packet buffers: enough for a full jitter buffer, a packet being pushed and one released.
+static const size_t POOL_BUFFER_COUNT = JitterBuffer::SLOT_COUNT + 2;
+
+// Number of packets of the randomized test.
+static const size_t RANDOM_PACKETS = 5000;
+
+/**
+ * Returns the time the packet of a given index is sent at, which is its arrival time if the network adds no delay.
+ *
+ * @param index The index of the packet in the stream.
+ * @return The send time of the packet.
+ */
+static JitterBuffer::Clock::time_point sendTime(int index) {
+    return BASE_TIME +
+           std::chrono::microseconds(static_cast<int64_t>(index) * PACKET_SAMPLES * 1000000 / SAMPLE_RATE);
+}
+
+/**
+ * Pushes the packet of a given index in a buffer of @c pool, its payload holding its sequence number: the first two
+ * bytes hold all of it, the others its low byte.
+ *
+ * @param pool The pool of the packet buffers.
+ * @param jitterBuffer The jitter buffer.
+ * @param firstSequenceNumber The sequence number of the packet of index 0.
+ * @param index The index of the packet in the stream.
+ * @param arrivalTime The time the packet arrives at.
+ * @return The result of @c push().
+ */
+static bool pushPacket(
+    BufferPool* pool,
+    JitterBuffer* jitterBuffer,
+    uint16_t firstSequenceNumber,
+    int index,
+    JitterBuffer::Clock::time_point arrivalTime) {
+    const uint16_t sequenceNumber = static_cast<uint16_t>(firstSequenceNumber + index);
+    BufferPool::Buffer buffer = pool->acquire();
+    if(!buffer) {
+        printf("packet buffers exhausted\n");
+        return false;
+    }
+    uint8_t* payload = buffer.data() + HEADERS_LENGTH;
+    memset(payload, static_cast<uint8_t>(sequenceNumber), PAYLOAD_LENGTH);
+    payload[0] = static_cast<uint8_t>(sequenceNumber >> 8);
+    buffer.setSize(HEADERS_LENGTH + PAYLOAD_LENGTH);
+    return jitterBuffer->push(
+        sequenceNumber,
+        BASE_TIMESTAMP + static_cast<uint32_t>(index) * PACKET_SAMPLES,
+        std::move(buffer),
+        HEADERS_LENGTH,
+        FRAMES_PER_PACKET,
+        arrivalTime);
+}
+
+/**
+ * Returns the sequence number a released packet was pushed with.
+ *
+ * @param packet The packet.
+ * @return Its sequence number.
+ */
+static uint16_t sequenceNumberOf(const JitterBuffer::Packet& packet) {
+    return static_cast<uint16_t>(packet.payloadData[0] << 8 | packet.payloadData[1]);
+}
+
+/**
+ * Pops a packet which must be the received packet of a given sequence number, played at full gain.
+ *
+ * @param jitterBuffer The jitter buffer.
+ * @param now The time to pop at.
+ * @param sequenceNumber The sequence number expected.
+ * @param startGain The start gain expected.
+ * @return @c true if the packet was released as expected.
+ */
+static bool expectPacket(
+    JitterBuffer* jitterBuffer,
+    JitterBuffer::Clock::time_point now,
+    uint16_t sequenceNumber,
+    float startGain = 1.0f) {
+    JitterBuffer::Packet packet;
+    if(!jitterBuffer->pop(now, &packet)) {
+        printf("packet %u not released\n", sequenceNumber);
+        return false;
+    }
+    if(packet.concealed || sequenceNumberOf(packet) != sequenceNumber || packet.inputLength != PAYLOAD_LENGTH ||
+       packet.frameCount != FRAMES_PER_PACKET || packet.startGain != startGain || packet.endGain != 1.0f) {
+        printf("packet %u expected, %u released\n", sequenceNumber, sequenceNumberOf(packet));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Checks that the buffer is empty, its counters say so, and every packet buffer went back to the pool.
+ *
+ * @param pool The pool of the packet buffers.
+ * @param jitterBuffer The jitter buffer.
+ * @return @c true if the buffer is empty.
+ */
+static bool expectEmpty(BufferPool* pool, JitterBuffer* jitterBuffer) {
+    JitterBuffer::Packet packet;
+    auto statistics = jitterBuffer->getStatistics();
+    if(jitterBuffer->pop(JitterBuffer::Clock::time_point::max(), &packet) || statistics.depth != 0 ||
+       statistics.bufferedDuration.count() != 0 || jitterBuffer->getReleaseTimeout(BASE_TIME) != -1) {
+        printf("buffer not empty: depth %zu\n", statistics.depth);
+        return false;
+    }
+    if(pool->getAvailableCount() != POOL_BUFFER_COUNT) {
+        printf("packet buffers held: %zu\n", POOL_BUFFER_COUNT - pool->getAvailableCount());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Starts a jitter buffer for the stream of the tests.
+ *
+ * @param jitterBuffer The jitter buffer.
+ */
+static void startStream(JitterBuffer* jitterBuffer) {
+    jitterBuffer->start(PAYLOAD_LENGTH, SAMPLE_RATE, SAMPLES_PER_FRAME, FRAME_LENGTH);
+}
+
+/**
+ * Streams packets arriving on time, and checks that each is released at its playout time, not before.
+ *
+ * @return @c true if every packet was released in order at its time.
+ */
+static bool testInOrder() {
+    const int count = 20;
+    const uint16_t first = 100;
+    BufferPool pool(HEADERS_LENGTH + PAYLOAD_LENGTH, POOL_BUFFER_COUNT);
+    JitterBuffer jitterBuffer;
+    startStream(&jitterBuffer);
+
+    bool ok = true;
+    for(int i = 0; i < count; ++i) {
+        ok = pushPacket(&pool, &jitterBuffer, first, i, sendTime(i)) && ok;
+    }
+    auto statistics = jitterBuffer.getStatistics();
+    const auto bufferedDuration =
+        std::chrono::microseconds(static_cast<int64_t>(count) * PACKET_SAMPLES * 1000000 / SAMPLE_RATE);
+    if(statistics.depth != count || std::abs((statistics.bufferedDuration - bufferedDuration).count()) > 1) {
+        printf("buffered %zu packets, %lld us\n", statistics.depth,
+               static_cast<long long>(statistics.bufferedDuration.count()));
+        ok = false;
+    }
+
+    JitterBuffer::Packet packet;
+    for(int i = 0; i < count && ok; ++i) {
+        const auto playoutTime = sendTime(i) + DELAY;
+        const int timeout = jitterBuffer.getReleaseTimeout(playoutTime - std::chrono::milliseconds(5));
+        if(timeout < 4 || timeout > 6) {
+            printf("release timeout of packet %d: %d\n", i, timeout);
+            ok = false;
+        }
+        if(jitterBuffer.pop(playoutTime - MARGIN, &packet)) {
+            printf("packet %d released early\n", i);
+            ok = false;
+        }
+        ok = expectPacket(&jitterBuffer, playoutTime + MARGIN, static_cast<uint16_t>(first + i)) && ok;
+    }
+    return expectEmpty(&pool, &jitterBuffer) && ok;
+}
+
+/**
+ * Streams packets out of order and duplicated, and checks that they are released once each, in order.
+ *
+ * @return @c true if the packets were put back in order and the duplicates dropped.
+ */
+static bool testReorderAndDuplicate() {
+    BufferPool pool(HEADERS_LENGTH + PAYLOAD_LENGTH, POOL_BUFFER_COUNT);
+    JitterBuffer jitterBuffer;
+    startStream(&jitterBuffer);
+
+    bool ok = pushPacket(&pool, &jitterBuffer, 0, 0, sendTime(0));
+    ok = pushPacket(&pool, &jitterBuffer, 0, 2, sendTime(2)) && ok;
+    ok = pushPacket(&pool, &jitterBuffer, 0, 1, sendTime(2)) && ok;
+    if(pushPacket(&pool, &jitterBuffer, 0, 1, sendTime(2))) {
+        printf("duplicate stored\n");
+        ok = false;
+    }
+
+    const auto now = sendTime(2) + DELAY + MARGIN;
+    for(uint16_t sequenceNumber = 0; sequenceNumber < 3; ++sequenceNumber) {
+        ok = expectPacket(&jitterBuffer, now, sequenceNumber) && ok;
+    }
+
+    auto statistics = jitterBuffer.getStatistics();
+    if(statistics.packetsReceived != 4 || statistics.packetsReordered != 1 || statistics.packetsDuplicated != 1 ||
+       statistics.packetsLost != 0) {
+        printf("received %llu, reordered %llu, duplicated %llu\n",
+               static_cast<unsigned long long>(statistics.packetsReceived),
+               static_cast<unsigned long long>(statistics.packetsReordered),
+               static_cast<unsigned long long>(statistics.packetsDuplicated));
+        ok = false;
+    }
+    return expectEmpty(&pool, &jitterBuffer) && ok;
+}
+
+/**
+ * Loses a packet, and checks that it is concealed with the last frame released, fading out, that the next packet
+ * fades back in, and that the lost packet is dropped when it shows up late.
+ *
+ * @return @c true if the lost packet was concealed.
+ */
+static bool testConcealment() {
+    BufferPool pool(HEADERS_LENGTH + PAYLOAD_LENGTH, POOL_BUFFER_COUNT);
+    JitterBuffer jitterBuffer;
+    startStream(&jitterBuffer);
+
+    bool ok = true;
+    for(int i : {0, 1, 3, 4}) {
+        ok = pushPacket(&pool, &jitterBuffer, 0, i, sendTime(i)) && ok;
+    }
+    ok = expectPacket(&jitterBuffer, sendTime(1) + DELAY + MARGIN, 0) && ok;
+    ok = expectPacket(&jitterBuffer, sendTime(1) + DELAY + MARGIN, 1) && ok;
+
+    // Packet 2 is waited for until its playout time.
+    JitterBuffer::Packet packet;
+    if(jitterBuffer.pop(sendTime(2) + DELAY - MARGIN, &packet)) {
+        printf("packet concealed early\n");
+        ok = false;
+    }
+    if(!jitterBuffer.pop(sendTime(2) + DELAY + MARGIN, &packet) || !packet.concealed ||
+       packet.frameCount != FRAMES_PER_PACKET || packet.inputLength != PAYLOAD_LENGTH || packet.startGain != 1.0f ||
+       packet.endGain >= packet.startGain) {
+        printf("packet 2 not concealed\n");
+        return false;
+    }
+    for(size_t i = 0; i < packet.inputLength; ++i) {
+        if(packet.payloadData[i] != 1) {
+            printf("concealment does not repeat the last frame\n");
+            ok = false;
+            break;
+        }
+    }
+    const float concealmentEndGain = packet.endGain;
+
+    if(jitterBuffer.pop(sendTime(2) + DELAY + MARGIN, &packet)) {
+        printf("packet 3 released early\n");
+        ok = false;
+    }
+    if(pushPacket(&pool, &jitterBuffer, 0, 2, sendTime(3))) {
+        printf("late packet stored\n");
+        ok = false;
+    }
+    ok = expectPacket(&jitterBuffer, sendTime(3) + DELAY + MARGIN, 3, concealmentEndGain) && ok;
+    ok = expectPacket(&jitterBuffer, sendTime(4) + DELAY + MARGIN, 4) && ok;
+
+    auto statistics = jitterBuffer.getStatistics();
+    if(statistics.packetsLost != 1 || statistics.packetsLate != 1 || statistics.framesConcealed != FRAMES_PER_PACKET) {
+        printf("lost %llu, late %llu, concealed %llu frames\n",
+               static_cast<unsigned long long>(statistics.packetsLost),
+               static_cast<unsigned long long>(statistics.packetsLate),
+               static_cast<unsigned long long>(statistics.framesConcealed));
+        ok = false;
+    }
+    return expectEmpty(&pool, &jitterBuffer) && ok;
+}
+
+/**
+ * Loses more packets than the maximum latency covers, and checks that the gap is skipped rather than concealed.
+ *
+ * @return @c true if the gap was skipped.
+ */
+static bool testLongGap() {
+    const int gap = 30;
+    BufferPool pool(HEADERS_LENGTH + PAYLOAD_LENGTH, POOL_BUFFER_COUNT);
+    JitterBuffer jitterBuffer;
+    startStream(&jitterBuffer);
+
+    bool ok = pushPacket(&pool, &jitterBuffer, 0, 0, sendTime(0));
+    ok = pushPacket(&pool, &jitterBuffer, 0, gap, sendTime(gap)) && ok;
+    ok = expectPacket(&jitterBuffer, sendTime(0) + DELAY + MARGIN, 0) && ok;
+
+    JitterBuffer::Packet packet;
+    if(jitterBuffer.pop(sendTime(1) + DELAY + MARGIN, &packet)) {
+        printf("long gap concealed\n");
+        ok = false;
+    }
+    ok = expectPacket(&jitterBuffer, sendTime(gap) + DELAY + MARGIN, gap) && ok;
+
+    auto statistics = jitterBuffer.getStatistics();
+    if(statistics.packetsLost != gap - 1 || statistics.framesConcealed != 0) {
+        printf("lost %llu, concealed %llu frames\n",
+               static_cast<unsigned long long>(statistics.packetsLost),
+               static_cast<unsigned long long>(statistics.framesConcealed));
+        ok = false;
+    }
+    return expectEmpty(&pool, &jitterBuffer) && ok;
+}
+
+/**
+ * Streams packets across the wrap of the sequence numbers.
+ *
+ * @return @c true if the packets were released in order across the wrap.
+ */
+static bool testSequenceWrap() {
+    const uint16_t first = 65534;
+    BufferPool pool(HEADERS_LENGTH + PAYLOAD_LENGTH, POOL_BUFFER_COUNT);
+    JitterBuffer jitterBuffer;
+    startStream(&jitterBuffer);
+
+    bool ok = true;
+    for(int i = 0; i < 4; ++i) {
+        ok = pushPacket(&pool, &jitterBuffer, first, i, sendTime(i)) && ok;
+    }
+    for(int i = 0; i < 4; ++i) {
+        ok = expectPacket(&jitterBuffer, sendTime(i) + DELAY + MARGIN, static_cast<uint16_t>(first + i)) && ok;
+    }
+    return expectEmpty(&pool, &jitterBuffer) && ok;
+}
+
+/**
+ * Jumps the sequence numbers beyond the buffer, and checks that it starts over from the new packet.
+ *
+ * @return @c true if the buffer resynchronized on the new packet.
+ */
+static bool testResynchronization() {
+    const int jump = 1000;
+    BufferPool pool(HEADERS_LENGTH + PAYLOAD_LENGTH, POOL_BUFFER_COUNT);
+    JitterBuffer jitterBuffer;
+    startStream(&jitterBuffer);
+
+    bool ok = pushPacket(&pool, &jitterBuffer, 0, 0, sendTime(0));
+    ok = pushPacket(&pool, &jitterBuffer, 0, 1, sendTime(1)) && ok;
+    ok = pushPacket(&pool, &jitterBuffer, 0, jump, sendTime(2)) && ok;
+
+    auto statistics = jitterBuffer.getStatistics();
+    if(statistics.resynchronizations != 1 || statistics.depth != 1) {
+        printf("resynchronizations %llu, depth %zu\n",
+               static_cast<unsigned long long>(statistics.resynchronizations), statistics.depth);
+        ok = false;
+    }
+    ok = expectPacket(&jitterBuffer, sendTime(2) + DELAY + MARGIN, jump) && ok;
+    return expectEmpty(&pool, &jitterBuffer) && ok;
+}
+
+/**
+ * Delivers a packet after its playout time, and checks that the schedule is pushed back so that it is played.
+ *
+ * @return @c true if the late packet was played and the underrun counted.
+ */
+static bool testUnderrun() {
+    const auto lateness = std::chrono::milliseconds(20);
+    BufferPool pool(HEADERS_LENGTH + PAYLOAD_LENGTH, POOL_BUFFER_COUNT);
+    JitterBuffer jitterBuffer;
+    startStream(&jitterBuffer);
+
+    bool ok = pushPacket(&pool, &jitterBuffer, 0, 0, sendTime(0));
+    ok = expectPacket(&jitterBuffer, sendTime(0) + DELAY + MARGIN, 0) && ok;
+
+    const auto arrivalTime = sendTime(1) + DELAY + lateness;
+    ok = pushPacket(&pool, &jitterBuffer, 0, 1, arrivalTime) && ok;
+    auto statistics = jitterBuffer.getStatistics();
+    if(statistics.underruns != 1 || statistics.playoutDelay < DELAY + lateness - MARGIN) {
+        printf("underruns %llu, playout delay %lld us\n",
+               static_cast<unsigned long long>(statistics.underruns),
+               static_cast<long long>(statistics.playoutDelay.count()));
+        ok = false;
+    }
+    ok = expectPacket(&jitterBuffer, arrivalTime + MARGIN, 1) && ok;
+    return expectEmpty(&pool, &jitterBuffer) && ok;
+}
+
+/**
+ * Streams @c RANDOM_PACKETS packets with random network delays, losses and duplicates, popping the packets due before
+ * each arrival, then drains the buffer.
+ *
+ * @return @c true if the packets were released in order, each stored packet once, and the counters came back to zero.
+ */
+static bool testRandomStream() {
+    struct Arrival {
+        int index;
+        JitterBuffer::Clock::time_point time;
+    };
+
+    std::minstd_rand random(1);
+    std::vector<Arrival> arrivals;
+    for(size_t i = 0; i < RANDOM_PACKETS; ++i) {
+        if(0 == random() % 50) {
+            continue;
+        }
+        const int index = static_cast<int>(i);
+        arrivals.push_back({index, sendTime(index) + std::chrono::microseconds(random() % 30000)});
+        if(0 == random() % 100) {
+            arrivals.push_back({index, sendTime(index) + std::chrono::microseconds(random() % 30000)});
+        }
+    }
+    std::stable_sort(arrivals.begin(), arrivals.end(), [](const Arrival& a, const Arrival& b) {
+        return a.time < b.time;
+    });
+
+    BufferPool pool(HEADERS_LENGTH + PAYLOAD_LENGTH, POOL_BUFFER_COUNT);
+    JitterBuffer jitterBuffer;
+    startStream(&jitterBuffer);
+    bool ok = true;
+    size_t stored = 0;
+    size_t released = 0;
+    int lastReleased = -1;
+    JitterBuffer::Packet packet;
+    auto popDue = [&](JitterBuffer::Clock::time_point now) {
+        while(jitterBuffer.pop(now, &packet)) {
+            if(packet.concealed) {
+                continue;
+            }
+            const int index = sequenceNumberOf(packet);
+            if(index <= lastReleased) {
+                printf("packet %d released after %d\n", index, lastReleased);
+                ok = false;
+            }
+            lastReleased = index;
+            ++released;
+        }
+    };
+
+    for(const auto& arrival : arrivals) {
+        popDue(arrival.time);
+        if(pushPacket(&pool, &jitterBuffer, 0, arrival.index, arrival.time)) {
+            ++stored;
+        }
+    }
+    popDue(JitterBuffer::Clock::time_point::max());
+    packet.buffer.reset();
+
+    auto statistics = jitterBuffer.getStatistics();
+    if(released != stored || statistics.packetsReceived != arrivals.size() ||
+       stored + statistics.packetsDuplicated + statistics.packetsLate != arrivals.size()) {
+        printf("stored %zu, released %zu, duplicated %llu, late %llu\n", stored, released,
+               static_cast<unsigned long long>(statistics.packetsDuplicated),
+               static_cast<unsigned long long>(statistics.packetsLate));
+        ok = false;
+    }
+    if(std::fabs(statistics.clockDrift) > 50) {
+        printf("clock drift %f ppm\n", statistics.clockDrift);
+        ok = false;
+    }
+    return expectEmpty(&pool, &jitterBuffer) && ok;
+}
+
+/**
+ * Reports the outcome of a test.
+ *
+ * @param name The name of the test.
+ * @param ok Whether the test passed.
+ * @return @c ok.
+ */
+static bool report(const std::string& name, bool ok) {
+    printf("%-44s %s\n", name.c_str(), ok ? "passed" : "FAILED");
+    return ok;
+}
+
+int main() {
+    bool ok = report("in order", testInOrder());
+    ok = report("reordered and duplicated", testReorderAndDuplicate()) && ok;
+    ok = report("concealment", testConcealment()) && ok;
+    ok = report("long gap", testLongGap()) && ok;
+    ok = report("sequence number wrap", testSequenceWrap()) && ok;
+    ok = report("resynchronization", testResynchronization()) && ok;
+    ok = report("underrun", testUnderrun()) && ok;
+    ok = report("random stream, " + std::to_string(RANDOM_PACKETS) + " packets", testRandomStream()) && ok;
+    return ok ? 0 : 1;
+}
@@ -1,7 +1,10 @@
 #ifndef DEVICE_CLIENT_SDK_COMMON_SDKINTERFACES_BLUETOOTH_SERVICES_A2DPSINKINTERFACE_H_
 #define DEVICE_CLIENT_SDK_COMMON_SDKINTERFACES_BLUETOOTH_SERVICES_A2DPSINKINTERFACE_H_
 
+#include <memory>
+
 #include "Common/SDKInterfaces/Bluetooth/Services/BluetoothServiceInterface.h"
+#include "Common/Utils/AudioInputStream.h"
 
 namespace deviceClientSDK {
 namespace common {
@@ -19,6 +22,21 @@ public:
 
     /// The Service Name.
     static constexpr const char* NAME = "AudioSink";
+
+    /**
+     * Sets the stream of raw PCM data to encode and send to the connected device. The samples must be 16-bit, in the
+     * format negotiated with the device. Streaming starts right away if the device is connected, and stops once the
+     * writer of the stream closes and its data has been sent.
+     *
+     * @param stream The stream to send, or nullptr to stop streaming.
+     * @return @c true on success, else @c false.
+     */
+    virtual bool setSourceStream(std::shared_ptr<common::utils::AudioInputStream> stream) = 0;
+
+    /**
+     * Destructor.
+     */
+    virtual ~A2DPSinkInterface() = default;
 };
 
 }  // namespace services
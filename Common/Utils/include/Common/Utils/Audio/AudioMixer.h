@@ -0,0 +1,203 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_AUDIOMIXER_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_AUDIOMIXER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Common/Utils/AudioFormat.h"
+#include "Common/Utils/AudioInputStream.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * Mixes the audio of several @c AudioInputStream readers of the same format into one @c AudioInputStream, such as the
+ * streams of several remote devices, or a remote device and locally generated speech, on their way to a single output.
+ *
+ * Every call to @c mix() produces one block: it borrows up to a block of audio from each input straight from its ring
+ * buffer, accumulates it scaled by the gain of the input into a float buffer, and rounds the sum to 16-bit samples,
+ * saturating once, straight into the ring buffer of the output. The block is as long as the longest input available,
+ * so an input running short only contributes silence to the rest of the block. An input whose stream closes is
+ * removed.
+ *
+ * The inner loops are the vectorized kernels of @c PCMKernels.h, and nothing is allocated once the mixer is created,
+ * so that the cost of a block only depends on its length and the number of inputs. @c mix() is meant to be called from
+ * a single thread; the other methods may be called from any thread, @c setGain() without locking.
+ */
+class AudioMixer {
+public:
+    /**
+     * Counters describing the mixing.
+     */
+    struct Statistics {
+        /// Number of blocks produced.
+        uint64_t blocksMixed;
+
+        /// Number of frames produced.
+        uint64_t framesMixed;
+
+        /// Number of times an input had less than a block of audio available.
+        uint64_t inputUnderruns;
+
+        /// Number of times the writer of an input overwrote audio before it was mixed.
+        uint64_t inputOverruns;
+
+        /// Number of frames which did not fit in the output stream, and were dropped.
+        uint64_t framesDropped;
+
+        /// Time taken by the last block.
+        std::chrono::microseconds lastBlockTime;
+
+        /// Largest time taken by a block.
+        std::chrono::microseconds maxBlockTime;
+    };
+
+    /// Default number of frames per block: 5.3ms at 48kHz.
+    static constexpr size_t DEFAULT_BLOCK_FRAMES = 256;
+
+    /**
+     * Creates a mixer.
+     *
+     * @param format The format of the inputs and the output: interleaved 16-bit signed linear PCM in host byte order.
+     * @param output The writer of the output stream, whose words are 16-bit samples.
+     * @param maxInputs The largest number of inputs mixed at once.
+     * @param blockFrames The largest number of frames produced by a call to @c mix().
+     * @return The mixer, or nullptr if a parameter is invalid.
+     */
+    static std::unique_ptr<AudioMixer> create(
+        const AudioFormat& format,
+        std::shared_ptr<AudioInputStream::Writer> output,
+        size_t maxInputs,
+        size_t blockFrames = DEFAULT_BLOCK_FRAMES);
+
+    /**
+     * Adds an input.
+     *
+     * @param reader The reader of the input stream, whose words are 16-bit samples. It should be @c NONBLOCKING, as
+     * @c mix() does not wait for data.
+     * @param gain The gain of the input, 1 to mix it unchanged.
+     * @return The identifier of the input, never reused, or -1 if the reader or gain are invalid or the mixer is full.
+     */
+    int addInput(std::shared_ptr<AudioInputStream::Reader> reader, float gain = 1.0f);
+
+    /**
+     * Removes an input. The audio it has not supplied yet stays in its stream.
+     *
+     * @param id The identifier returned by @c addInput().
+     * @return @c true on success, @c false if there is no such input.
+     */
+    bool removeInput(int id);
+
+    /**
+     * Sets the gain of an input, applied from the next block on. It does not lock, so that the gain can be driven from
+     * a real time thread.
+     *
+     * @param id The identifier returned by @c addInput().
+     * @param gain The gain, 0 to mute the input.
+     * @return @c true on success, @c false if there is no such input or the gain is invalid.
+     */
+    bool setGain(int id, float gain);
+
+    /**
+     * Mixes one block of the audio available on the inputs into the output.
+     *
+     * @return The number of frames written to the output, 0 if no input had any audio.
+     */
+    size_t mix();
+
+    /// Returns the format of the inputs and the output.
+    AudioFormat getAudioFormat() const;
+
+    /// Returns the largest number of frames produced by a call to @c mix().
+    size_t getBlockFrames() const;
+
+    /**
+     * Get the counters of the mixing.
+     *
+     * @return A snapshot of the statistics of the mixer.
+     */
+    Statistics getStatistics() const;
+
+private:
+    /**
+     * An input of the mixer.
+     */
+    struct Input {
+        /// The identifier of the input, -1 if the slot is free.
+        std::atomic<int> id;
+
+        /// The gain of the input.
+        std::atomic<float> gain;
+
+        /// The reader of the input stream, only touched with @c m_mutex held.
+        std::shared_ptr<AudioInputStream::Reader> reader;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param format The format of the inputs and the output.
+     * @param output The writer of the output stream.
+     * @param maxInputs The largest number of inputs mixed at once.
+     * @param blockFrames The largest number of frames produced by a call to @c mix().
+     */
+    AudioMixer(
+        const AudioFormat& format,
+        std::shared_ptr<AudioInputStream::Writer> output,
+        size_t maxInputs,
+        size_t blockFrames);
+
+    /**
+     * Mixes a span of samples of an input into @c m_accumulator.
+     *
+     * @param samples The samples.
+     * @param offset The position of the first sample in the block.
+     * @param count The number of samples.
+     * @param gain The gain of the input.
+     */
+    void accumulate(const int16_t* samples, size_t offset, size_t count, float gain);
+
+    /// The format of the inputs and the output.
+    const AudioFormat m_format;
+
+    /// The writer of the output stream.
+    const std::shared_ptr<AudioInputStream::Writer> m_output;
+
+    /// The largest number of frames of a block.
+    const size_t m_blockFrames;
+
+    /// The inputs, one slot per input which can be mixed at once.
+    const std::unique_ptr<Input[]> m_inputs;
+
+    /// The number of slots of @c m_inputs.
+    const size_t m_maxInputs;
+
+    /// The identifier of the next input added.
+    int m_nextId;
+
+    /// The sums of the block being mixed.
+    std::vector<float> m_accumulator;
+
+    /// The number of samples at the start of @c m_accumulator which hold a sum for the block being mixed.
+    size_t m_accumulated;
+
+    /// The counters of the mixing.
+    Statistics m_statistics;
+
+    /// Serializes the access to the readers of the inputs, @c m_nextId and @c m_statistics.
+    mutable std::mutex m_mutex;
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_AUDIOMIXER_H_
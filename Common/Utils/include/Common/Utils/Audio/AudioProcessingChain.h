@@ -0,0 +1,157 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_AUDIOPROCESSINGCHAIN_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_AUDIOPROCESSINGCHAIN_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/Utils/Audio/AudioProcessingStage.h"
+#include "Common/Utils/AudioFormat.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * An ordered chain of @c AudioProcessingStage run on each block of audio, such as the blocks published by a
+ * @c FormattedAudioStreamAdapter.
+ *
+ * The stages are configured one after the other when the chain is created, each for the output format of the one
+ * before, and the two buffers the blocks go through between stages are sized then for the largest block of any stage.
+ * Processing a block then allocates nothing: each stage reads the output of the one before and writes to the other
+ * buffer, or to the same one if it works in place. The time taken by each stage is measured, so that the CPU budget of
+ * the audio path can be checked.
+ *
+ * @c process() is meant to be called from one thread at a time, such as the media thread; the statistics may be read
+ * from any thread.
+ */
+class AudioProcessingChain {
+public:
+    /**
+     * Counters describing a stage.
+     */
+    struct StageStatistics {
+        /// The name of the stage.
+        std::string name;
+
+        /// Number of blocks processed.
+        uint64_t blocks;
+
+        /// Number of frames processed.
+        uint64_t frames;
+
+        /// Time taken by the last block.
+        std::chrono::nanoseconds lastTime;
+
+        /// Largest time taken by a block.
+        std::chrono::nanoseconds maxTime;
+
+        /// Total time taken by all the blocks.
+        std::chrono::nanoseconds totalTime;
+    };
+
+    /**
+     * Creates a chain, configuring its stages.
+     *
+     * @param inputFormat The format of the blocks processed.
+     * @param maxFrames The largest number of frames of a block processed.
+     * @param stages The stages, in the order they run. A chain without stages passes the blocks through.
+     * @return The chain, or nullptr if a stage does not support its input.
+     */
+    static std::unique_ptr<AudioProcessingChain> create(
+        const AudioFormat& inputFormat,
+        size_t maxFrames,
+        std::vector<std::shared_ptr<AudioProcessingStage>> stages);
+
+    /**
+     * Runs the stages on a block. A trailing partial frame of the input is ignored.
+     *
+     * @param input The block, in the input format.
+     * @param inputSize The size of the block in bytes, of at most @c getMaxFrames() frames.
+     * @param[out] output The block produced, in the output format. It stays valid until the next call.
+     * @return The size of the block produced in bytes, 0 if the input is too large or produced no frames.
+     */
+    size_t process(const unsigned char* input, size_t inputSize, const unsigned char** output);
+
+    /// Returns the format of the blocks processed.
+    AudioFormat getInputFormat() const;
+
+    /// Returns the format of the blocks produced.
+    AudioFormat getOutputFormat() const;
+
+    /// Returns the largest number of frames of a block processed.
+    size_t getMaxFrames() const;
+
+    /**
+     * Get the counters of the stages.
+     *
+     * @return A snapshot of the statistics of each stage, in the order they run.
+     */
+    std::vector<StageStatistics> getStatistics() const;
+
+private:
+    /**
+     * A stage of the chain.
+     */
+    struct Stage {
+        /// The stage.
+        std::shared_ptr<AudioProcessingStage> stage;
+
+        /// Whether the stage processes its input in place.
+        bool inPlace;
+
+        /// Number of blocks processed.
+        std::atomic<uint64_t> blocks;
+
+        /// Number of frames processed.
+        std::atomic<uint64_t> frames;
+
+        /// Time taken by the last block, in nanoseconds.
+        std::atomic<int64_t> lastTime;
+
+        /// Largest time taken by a block, in nanoseconds.
+        std::atomic<int64_t> maxTime;
+
+        /// Total time taken by all the blocks, in nanoseconds.
+        std::atomic<int64_t> totalTime;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param inputFormat The format of the blocks processed.
+     * @param maxFrames The largest number of frames of a block processed.
+     * @param numStages The number of stages.
+     */
+    AudioProcessingChain(const AudioFormat& inputFormat, size_t maxFrames, size_t numStages);
+
+    /// The format of the blocks processed.
+    const AudioFormat m_inputFormat;
+
+    /// The largest number of frames of a block processed.
+    const size_t m_maxFrames;
+
+    /// The format of the blocks produced.
+    AudioFormat m_outputFormat;
+
+    /// The stages, in the order they run.
+    std::unique_ptr<Stage[]> m_stages;
+
+    /// The number of stages.
+    const size_t m_numStages;
+
+    /// The buffers the blocks go through between stages.
+    std::vector<unsigned char> m_buffers[2];
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_AUDIOPROCESSINGCHAIN_H_
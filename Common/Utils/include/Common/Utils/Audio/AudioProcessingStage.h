@@ -0,0 +1,73 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_AUDIOPROCESSINGSTAGE_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_AUDIOPROCESSINGSTAGE_H_
+
+#include <cstddef>
+#include <string>
+
+#include "Common/Utils/AudioFormat.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * Interface to be implemented by a stage of an @c AudioProcessingChain, such as a gain, a format conversion, a
+ * resampler, an equalizer or a meter.
+ *
+ * A stage is configured once, off the audio path, for the format and largest block of its input; it allocates what it
+ * needs then. It then processes blocks on the audio path, where it must neither allocate nor block.
+ */
+class AudioProcessingStage {
+public:
+    /**
+     * Destructor.
+     */
+    virtual ~AudioProcessingStage() = default;
+
+    /**
+     * Returns the name of the stage, used in the statistics of the chain.
+     */
+    virtual std::string getName() const = 0;
+
+    /**
+     * Prepares the stage for its input.
+     *
+     * @param inputFormat The format of the blocks processed.
+     * @param maxInputFrames The largest number of frames of a block processed.
+     * @param[out] outputFormat The format of the blocks produced.
+     * @param[out] maxOutputFrames The largest number of frames of a block produced.
+     * @return @c true on success, @c false if the stage does not support the input format.
+     */
+    virtual bool configure(
+        const AudioFormat& inputFormat,
+        size_t maxInputFrames,
+        AudioFormat* outputFormat,
+        size_t* maxOutputFrames) = 0;
+
+    /**
+     * Tells whether the stage can process a block in place, its output overwriting its input.
+     *
+     * @return @c true if @c process() accepts the same buffer as its input and output.
+     */
+    virtual bool canProcessInPlace() const {
+        return false;
+    }
+
+    /**
+     * Processes a block.
+     *
+     * @param input The frames, in the input format.
+     * @param output The buffer for the frames produced, in the output format, of at least the largest block produced.
+     * @param frames The number of frames of the input, at most the largest block processed.
+     * @return The number of frames produced.
+     */
+    virtual size_t process(const unsigned char* input, unsigned char* output, size_t frames) = 0;
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_AUDIOPROCESSINGSTAGE_H_
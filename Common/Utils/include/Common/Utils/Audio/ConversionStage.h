@@ -0,0 +1,65 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_CONVERSIONSTAGE_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_CONVERSIONSTAGE_H_
+
+#include <memory>
+
+#include "Common/Utils/Audio/AudioProcessingStage.h"
+#include "Common/Utils/Audio/FormatConverter.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * A stage converting the sample format, byte order, layout or channels of the audio with a @c FormatConverter, such as
+ * from the 16-bit samples of a stream to the floats the other stages work on, and back.
+ */
+class ConversionStage : public AudioProcessingStage {
+public:
+    /**
+     * Constructor.
+     *
+     * @param targetFormat The format to convert the audio to. Its sample rate is ignored: the rate is kept.
+     */
+    explicit ConversionStage(const AudioFormat& targetFormat);
+
+    /**
+     * Builds the format of interleaved floats in the host byte order the other stages work on.
+     *
+     * @param numChannels The number of channels.
+     * @return The format.
+     */
+    static AudioFormat getFloatFormat(unsigned int numChannels);
+
+    /// @name AudioProcessingStage Functions
+    /// @{
+    std::string getName() const override;
+    bool configure(
+        const AudioFormat& inputFormat,
+        size_t maxInputFrames,
+        AudioFormat* outputFormat,
+        size_t* maxOutputFrames) override;
+    size_t process(const unsigned char* input, unsigned char* output, size_t frames) override;
+    /// @}
+
+private:
+    /// The format to convert the audio to.
+    AudioFormat m_targetFormat;
+
+    /// The converter, created by @c configure().
+    std::unique_ptr<FormatConverter> m_converter;
+
+    /// The size of a frame of the input, in bytes.
+    size_t m_inputFrameSize;
+
+    /// The size of a frame of the output, in bytes.
+    size_t m_outputFrameSize;
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_CONVERSIONSTAGE_H_
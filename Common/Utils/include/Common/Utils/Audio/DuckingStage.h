@@ -0,0 +1,134 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_DUCKINGSTAGE_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_DUCKINGSTAGE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "Common/Utils/Audio/AudioProcessingStage.h"
+#include "Common/Utils/Bluetooth/BluetoothEventListenerInterface.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * A stage ducking float audio under a voice interaction, such as the music streamed over Bluetooth while the
+ * assistant listens and speaks.
+ *
+ * The audio is ducked and restored with @c duck() and @c unduck(), or by @c AudioDuckingChangedEvent when the stage
+ * listens to @c AUDIO_DUCKING_CHANGED on a @c BluetoothEventBus. These only store an atomic flag, so the caller never
+ * waits for the audio thread. The audio thread picks the request up at the start of the next block, and ramps the gain
+ * linearly from frame to frame over the attack or release time, without buffering the audio.
+ */
+class DuckingStage
+        : public AudioProcessingStage
+        , public bluetooth::BluetoothEventListenerInterface {
+public:
+    /**
+     * Constructor.
+     *
+     * @param duckedGain The gain of the ducked audio, such as 0.25 for about -12 dB.
+     * @param attack The time taken to duck the audio from the full gain.
+     * @param release The time taken to restore the audio to the full gain.
+     */
+    DuckingStage(
+        float duckedGain = 0.25f,
+        std::chrono::milliseconds attack = std::chrono::milliseconds(20),
+        std::chrono::milliseconds release = std::chrono::milliseconds(250));
+
+    /// Ducks the audio from the next block on.
+    void duck();
+
+    /// Restores the audio from the next block on.
+    void unduck();
+
+    /// Returns whether the audio is ducked, or being ducked.
+    bool isDucked() const;
+
+    /**
+     * Sets the gain of the ducked audio, ramped to from the next block on if the audio is ducked.
+     *
+     * @param duckedGain The gain, between 0 and 1.
+     * @return @c true on success, @c false if the gain is out of range.
+     */
+    bool setDuckedGain(float duckedGain);
+
+    /**
+     * Sets the time taken to duck the audio from the full gain, applied from the next ramp on.
+     *
+     * @param attack The time, 0 to duck the audio at once.
+     * @return @c true on success, @c false if the time is negative.
+     */
+    bool setAttack(std::chrono::milliseconds attack);
+
+    /**
+     * Sets the time taken to restore the audio to the full gain, applied from the next ramp on.
+     *
+     * @param release The time, 0 to restore the audio at once.
+     * @return @c true on success, @c false if the time is negative.
+     */
+    bool setRelease(std::chrono::milliseconds release);
+
+    /// Returns the gain at the end of the last block.
+    float getGain() const;
+
+    /// @name AudioProcessingStage Functions
+    /// @{
+    std::string getName() const override;
+    bool configure(
+        const AudioFormat& inputFormat,
+        size_t maxInputFrames,
+        AudioFormat* outputFormat,
+        size_t* maxOutputFrames) override;
+    bool canProcessInPlace() const override;
+    size_t process(const unsigned char* input, unsigned char* output, size_t frames) override;
+    /// @}
+
+    /// @name BluetoothEventListenerInterface Functions
+    /// @{
+    void onEventFired(const bluetooth::BluetoothEvent& event) override;
+    /// @}
+
+private:
+    /// Whether the audio must be ducked.
+    std::atomic<bool> m_ducked;
+
+    /// The gain of the ducked audio.
+    std::atomic<float> m_duckedGain;
+
+    /// The time taken to duck the audio, in milliseconds.
+    std::atomic<int64_t> m_attackMs;
+
+    /// The time taken to restore the audio, in milliseconds.
+    std::atomic<int64_t> m_releaseMs;
+
+    /// The gain at the end of the last block, for other threads.
+    std::atomic<float> m_gain;
+
+    /// The sample rate of the audio.
+    unsigned int m_sampleRateHz;
+
+    /// The number of channels of the audio.
+    unsigned int m_numChannels;
+
+    /// The gain at the end of the last block, owned by the audio thread.
+    float m_currentGain;
+
+    /// The gain the ramp in progress, or the last one, goes to.
+    float m_rampTarget;
+
+    /// The change of the gain from one frame to the next of the ramp in progress.
+    float m_rampStep;
+
+    /// The number of frames left to the ramp in progress.
+    size_t m_rampFrames;
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_DUCKINGSTAGE_H_
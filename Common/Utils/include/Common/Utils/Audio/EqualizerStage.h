@@ -0,0 +1,161 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_EQUALIZERSTAGE_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_EQUALIZERSTAGE_H_
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "Common/Utils/Audio/AudioProcessingStage.h"
+#include "Common/Utils/Audio/PCMKernels.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * A stage equalizing float audio with a cascade of biquad filters, one per band, such as the fixed tuning of a
+ * speaker cabinet. The channels are filtered side by side with @c biquadCascade().
+ *
+ * The coefficients of the bands are computed on the thread setting them, never on the audio thread, and handed over
+ * through three preallocated sets: the setter fills a spare set and swaps it with the pending one, and the audio
+ * thread swaps the pending set with its own at the start of a block if it is newer. Neither side waits for the other
+ * nor allocates.
+ */
+class EqualizerStage : public AudioProcessingStage {
+public:
+    /**
+     * The shapes of the filter of a band.
+     */
+    enum class FilterType {
+        /// Boosts or cuts around the frequency, over a width set by the quality factor.
+        PEAKING,
+        /// Boosts or cuts below the frequency.
+        LOW_SHELF,
+        /// Boosts or cuts above the frequency.
+        HIGH_SHELF,
+        /// Removes the frequencies above the frequency; the gain is ignored.
+        LOW_PASS,
+        /// Removes the frequencies below the frequency; the gain is ignored.
+        HIGH_PASS
+    };
+
+    /**
+     * A band of the equalizer.
+     */
+    struct Band {
+        /// The shape of the filter.
+        FilterType type;
+
+        /// The center frequency of a peak, or the corner frequency of the other filters.
+        float frequencyHz;
+
+        /// The gain at the frequency of a peak, or of the shelf, in dB.
+        float gainDb;
+
+        /// The quality factor, 0.707 for the flattest pass or shelf.
+        float q;
+    };
+
+    /// The largest number of bands.
+    static constexpr size_t MAX_BANDS = 10;
+
+    /**
+     * Constructor. The equalizer starts without bands, passing the audio unchanged.
+     */
+    EqualizerStage();
+
+    /**
+     * Sets the bands, applied from the next block on. Their coefficients are computed on the calling thread, if the
+     * stage is configured already, or when it is.
+     *
+     * @param bands The bands, at most @c MAX_BANDS. None to pass the audio unchanged.
+     * @return @c true on success, @c false if there are too many bands, or one of them is invalid or above the
+     *     Nyquist frequency.
+     */
+    bool setBands(const std::vector<Band>& bands);
+
+    /// Returns the bands.
+    std::vector<Band> getBands() const;
+
+    /**
+     * Computes the coefficients of the filter of a band, after the Audio EQ Cookbook of Robert Bristow-Johnson.
+     *
+     * @param band The band.
+     * @param sampleRateHz The sample rate of the audio filtered.
+     * @param[out] coefficients The coefficients.
+     * @return @c true on success, @c false if the band is invalid or above the Nyquist frequency.
+     */
+    static bool computeCoefficients(const Band& band, unsigned int sampleRateHz, BiquadCoefficients* coefficients);
+
+    /// @name AudioProcessingStage Functions
+    /// @{
+    std::string getName() const override;
+    bool configure(
+        const AudioFormat& inputFormat,
+        size_t maxInputFrames,
+        AudioFormat* outputFormat,
+        size_t* maxOutputFrames) override;
+    bool canProcessInPlace() const override;
+    size_t process(const unsigned char* input, unsigned char* output, size_t frames) override;
+    /// @}
+
+private:
+    /**
+     * The coefficients of the sections of the cascade.
+     */
+    struct CoefficientSet {
+        /// The coefficients of each section.
+        BiquadCoefficients sections[MAX_BANDS];
+
+        /// The number of sections.
+        size_t numSections;
+    };
+
+    /// The flag marking the pending set as newer than the one of the audio thread.
+    static constexpr unsigned int NEW_SET = 0x4;
+
+    /**
+     * Computes the coefficients of bands into the spare set, and makes it the pending one. Called with
+     * @c m_bandsMutex locked.
+     *
+     * @param bands The bands.
+     * @param sampleRateHz The sample rate of the audio filtered.
+     * @return @c true on success, @c false if a band is invalid.
+     */
+    bool publish(const std::vector<Band>& bands, unsigned int sampleRateHz);
+
+    /// Serializes the setters, and guards the bands and the sample rate.
+    mutable std::mutex m_bandsMutex;
+
+    /// The bands.
+    std::vector<Band> m_bands;
+
+    /// The sample rate of the audio, 0 until the stage is configured.
+    unsigned int m_sampleRateHz;
+
+    /// The set in use by the audio thread, the pending set, and the spare set of the setter.
+    CoefficientSet m_sets[3];
+
+    /// The index of the spare set, owned by the setter.
+    unsigned int m_spareSet;
+
+    /// The index of the pending set, with @c NEW_SET if it was not picked up by the audio thread yet.
+    std::atomic<unsigned int> m_pendingSet;
+
+    /// The index of the set in use, owned by the audio thread.
+    unsigned int m_currentSet;
+
+    /// The number of channels of the audio.
+    unsigned int m_numChannels;
+
+    /// The state of the filters, for every band whether it is in use or not.
+    std::vector<float> m_state;
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_EQUALIZERSTAGE_H_
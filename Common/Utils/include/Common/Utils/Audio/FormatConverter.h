@@ -0,0 +1,159 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_FORMATCONVERTER_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_FORMATCONVERTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Common/Utils/AudioFormat.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * Converts blocks of linear PCM audio from one @c AudioFormat to another, such as the blocks handed to a
+ * @c FormattedAudioStreamAdapterListener, between:
+ *
+ * @li 16-bit signed integer samples and 32-bit float samples, as @c AudioFormat has no flag for floats, 32-bit
+ *     samples are taken to be IEEE floats, scaled so that 1.0 is the full scale of a 16-bit sample;
+ * @li little and big endian samples;
+ * @li interleaved frames and a plane per channel (@c Layout::NON_INTERLEAVED), the planes of a block following each
+ *     other in the buffer;
+ * @li the same number of channels, or stereo down to mono.
+ *
+ * The sample rate is not converted. The conversion is planned when the converter is created as a short chain of
+ * vectorized kernels from @c PCMKernels.h, picked for the sample type and channel count by template specialization,
+ * so that converting a block only runs the steps it needs without testing the formats again. A conversion which only
+ * needs one step, such as int16 to float or stereo to mono, runs straight from the input to the output.
+ */
+class FormatConverter {
+public:
+    /**
+     * Creates a converter.
+     *
+     * @param source The format of the audio converted.
+     * @param target The format to convert the audio to.
+     * @return The converter, or nullptr if the conversion is not supported.
+     */
+    static std::unique_ptr<FormatConverter> create(const AudioFormat& source, const AudioFormat& target);
+
+    /**
+     * Tells whether a format can be converted from and to.
+     *
+     * @param format The format.
+     * @return @c true if the format is 16-bit signed or 32-bit float linear PCM with at least one channel.
+     */
+    static bool isSupported(const AudioFormat& format);
+
+    /**
+     * Tells whether a format holds interleaved floats in the host byte order, the format audio is processed in.
+     *
+     * @param format The format.
+     * @return @c true if the format is 32-bit float linear PCM in the host byte order, mono or interleaved.
+     */
+    static bool isHostFloat(const AudioFormat& format);
+
+    /// Returns the byte order of the samples of the host.
+    static AudioFormat::Endianness getHostEndianness();
+
+    /**
+     * Converts a block of audio. A trailing partial frame of the input is ignored.
+     *
+     * @param input The block in the source format.
+     * @param inputSize The size of the block in bytes.
+     * @param output The buffer for the block in the target format, which must not overlap the input.
+     * @param outputSize The size of the output buffer in bytes, at least @c getOutputSize(inputSize).
+     * @return The number of bytes written to the output, 0 if the output buffer is too small.
+     */
+    size_t convert(const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize);
+
+    /**
+     * Returns the size of the block @c convert() makes out of a block.
+     *
+     * @param inputSize The size of the block in the source format in bytes.
+     * @return The size of the converted block in bytes.
+     */
+    size_t getOutputSize(size_t inputSize) const;
+
+    /**
+     * Sizes the buffers between the steps of the conversion for blocks of up to a number of frames, so that converting
+     * them does not allocate.
+     *
+     * @param frames The largest number of frames of a block.
+     */
+    void reserve(size_t frames);
+
+    /// Returns the format of the audio converted.
+    AudioFormat getSourceFormat() const;
+
+    /// Returns the format the audio is converted to.
+    AudioFormat getTargetFormat() const;
+
+private:
+    /**
+     * A step of a conversion, such as a kernel converting samples or moving channels.
+     *
+     * @param input The frames.
+     * @param frames The number of frames.
+     * @param channels The number of channels of the input frames.
+     * @param output The buffer for the converted frames.
+     */
+    using Step = void (*)(const uint8_t* input, size_t frames, unsigned int channels, uint8_t* output);
+
+    /// The largest number of steps of a conversion.
+    static constexpr size_t MAX_STEPS = 6;
+
+    /**
+     * Constructor.
+     *
+     * @param source The format of the audio converted.
+     * @param target The format to convert the audio to.
+     */
+    FormatConverter(const AudioFormat& source, const AudioFormat& target);
+
+    /**
+     * Appends a step to the conversion.
+     *
+     * @param step The step.
+     * @param channels The number of channels of the frames the step converts.
+     * @param outputSampleSize The size of the samples the step produces, in bytes.
+     */
+    void addStep(Step step, unsigned int channels, size_t outputSampleSize);
+
+    /// The format of the audio converted.
+    const AudioFormat m_source;
+
+    /// The format the audio is converted to.
+    const AudioFormat m_target;
+
+    /// The size of a frame of the source format, in bytes.
+    const size_t m_sourceFrameSize;
+
+    /// The size of a frame of the target format, in bytes.
+    const size_t m_targetFrameSize;
+
+    /// The steps of the conversion.
+    Step m_steps[MAX_STEPS];
+
+    /// The number of channels of the frames each step converts.
+    unsigned int m_stepChannels[MAX_STEPS];
+
+    /// The number of steps of the conversion.
+    size_t m_numSteps;
+
+    /// The size of the largest frame between two steps, in bytes.
+    size_t m_maxIntermediateFrameSize;
+
+    /// The buffers holding the frames between two steps, grown to the largest block converted.
+    std::vector<uint8_t> m_intermediate[2];
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_FORMATCONVERTER_H_
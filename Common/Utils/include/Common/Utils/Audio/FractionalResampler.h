@@ -0,0 +1,96 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_FRACTIONALRESAMPLER_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_FRACTIONALRESAMPLER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * A streaming resampler of interleaved 16-bit PCM audio by an arbitrary ratio close to 1, meant to absorb the drift
+ * between two sample clocks running at the same nominal rate.
+ *
+ * Output samples are interpolated with a 4-point Catmull-Rom spline between the input samples around their position,
+ * which costs a handful of multiplications per sample and keeps the audio band flat enough for ratios within a few
+ * percent of 1. The position is kept in 32.32 fixed point, so that it neither drifts nor loses precision over hours of
+ * audio. The ratio can be changed between blocks without discontinuity.
+ */
+class FractionalResampler {
+public:
+    /**
+     * Constructor.
+     *
+     * @param numChannels The number of interleaved channels.
+     */
+    explicit FractionalResampler(unsigned int numChannels = 1);
+
+    /**
+     * Starts a new stream. The ratio is kept.
+     *
+     * @param numChannels The number of interleaved channels.
+     */
+    void reset(unsigned int numChannels);
+
+    /**
+     * Sets the number of input frames consumed for every output frame.
+     *
+     * @param ratio The ratio of the input rate to the output rate, greater than zero.
+     */
+    void setRatio(double ratio);
+
+    /// Returns the number of input frames consumed for every output frame.
+    double getRatio() const;
+
+    /// Returns the number of interleaved channels.
+    unsigned int getNumChannels() const;
+
+    /**
+     * Returns the number of output frames @c process() may produce at most from an input block.
+     *
+     * @param inputFrames The number of frames of the input block.
+     * @return The largest number of output frames.
+     */
+    size_t getMaxOutputFrames(size_t inputFrames) const;
+
+    /**
+     * Resamples a block of audio. The output is delayed by two input frames, the span of the interpolation.
+     *
+     * @param input The interleaved input samples.
+     * @param inputFrames The number of frames in @c input.
+     * @param output The buffer for the interleaved output samples.
+     * @param outputFrames The number of frames @c output can hold, at least @c getMaxOutputFrames(inputFrames).
+     * @return The number of frames written to @c output.
+     */
+    size_t process(const int16_t* input, size_t inputFrames, int16_t* output, size_t outputFrames);
+
+private:
+    /// The number of interleaved channels.
+    unsigned int m_numChannels;
+
+    /// The ratio set by @c setRatio().
+    double m_ratio;
+
+    /// The number of input frames per output frame, in 32.32 fixed point.
+    uint64_t m_step;
+
+    /// The position of the next output frame, in 32.32 fixed point input frames from the first frame of
+    /// @c m_history.
+    uint64_t m_position;
+
+    /// The last input frames of the previous block, which the interpolation still needs.
+    std::vector<int16_t> m_history;
+
+    /// @c false until the first block of the stream has filled @c m_history.
+    bool m_primed;
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_FRACTIONALRESAMPLER_H_
@@ -0,0 +1,61 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_GAINSTAGE_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_GAINSTAGE_H_
+
+#include <atomic>
+
+#include "Common/Utils/Audio/AudioProcessingStage.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * A stage scaling float audio by a gain, which can be changed from any thread without locking.
+ */
+class GainStage : public AudioProcessingStage {
+public:
+    /**
+     * Constructor.
+     *
+     * @param gain The gain, 1 to pass the audio unchanged.
+     */
+    explicit GainStage(float gain = 1.0f);
+
+    /**
+     * Sets the gain, applied from the next block on.
+     *
+     * @param gain The gain, 0 to mute the audio.
+     * @return @c true on success, @c false if the gain is negative or not a number.
+     */
+    bool setGain(float gain);
+
+    /// Returns the gain.
+    float getGain() const;
+
+    /// @name AudioProcessingStage Functions
+    /// @{
+    std::string getName() const override;
+    bool configure(
+        const AudioFormat& inputFormat,
+        size_t maxInputFrames,
+        AudioFormat* outputFormat,
+        size_t* maxOutputFrames) override;
+    bool canProcessInPlace() const override;
+    size_t process(const unsigned char* input, unsigned char* output, size_t frames) override;
+    /// @}
+
+private:
+    /// The gain.
+    std::atomic<float> m_gain;
+
+    /// The number of channels of the audio.
+    unsigned int m_numChannels;
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_GAINSTAGE_H_
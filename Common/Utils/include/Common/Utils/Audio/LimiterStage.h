@@ -0,0 +1,142 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_LIMITERSTAGE_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_LIMITERSTAGE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "Common/Utils/Audio/AudioProcessingStage.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * A look-ahead peak limiter for float audio, keeping the samples within a ceiling without clipping them.
+ *
+ * The audio is delayed by the look-ahead time, while the gain needed to bring each frame under the ceiling is held
+ * over the look-ahead window and smoothed by a moving average of the same length: the gain then ramps down over the
+ * look-ahead time before a peak leaves the delay, and is never above the gain the peak needs. It recovers from a peak
+ * with the release time. All channels share the gain, so that the stereo image does not move.
+ *
+ * The ceiling and release time can be changed from any thread; the coefficients they need are computed on that thread
+ * and handed to the audio thread atomically.
+ */
+class LimiterStage : public AudioProcessingStage {
+public:
+    /**
+     * Constructor.
+     *
+     * @param ceiling The largest magnitude of a sample produced, 1.0 being the full scale of a 16-bit sample.
+     * @param lookAhead The look-ahead time, which is also the latency of the stage.
+     * @param release The time the gain takes to recover by about two thirds after a peak.
+     */
+    LimiterStage(
+        float ceiling = 1.0f,
+        std::chrono::microseconds lookAhead = std::chrono::microseconds(1500),
+        std::chrono::milliseconds release = std::chrono::milliseconds(50));
+
+    /**
+     * Sets the ceiling, applied from the next block on.
+     *
+     * @param ceiling The largest magnitude of a sample produced, 1.0 being the full scale of a 16-bit sample.
+     * @return @c true on success, @c false if the ceiling is not positive.
+     */
+    bool setCeiling(float ceiling);
+
+    /**
+     * Sets the release time, applied from the next block on.
+     *
+     * @param release The time the gain takes to recover by about two thirds after a peak.
+     * @return @c true on success, @c false if the release time is negative.
+     */
+    bool setRelease(std::chrono::milliseconds release);
+
+    /// Returns the delay the stage adds to the audio, in frames. Valid once the stage is configured.
+    size_t getLatencyFrames() const;
+
+    /// Returns the lowest gain applied in the last block, 1 if the audio was not limited.
+    float getGain() const;
+
+    /// @name AudioProcessingStage Functions
+    /// @{
+    std::string getName() const override;
+    bool configure(
+        const AudioFormat& inputFormat,
+        size_t maxInputFrames,
+        AudioFormat* outputFormat,
+        size_t* maxOutputFrames) override;
+    bool canProcessInPlace() const override;
+    size_t process(const unsigned char* input, unsigned char* output, size_t frames) override;
+    /// @}
+
+private:
+    /**
+     * Computes the coefficient of the release for a sample rate. Called with @c m_parametersMutex locked.
+     *
+     * @param release The release time.
+     * @param sampleRateHz The sample rate.
+     * @return The share of the way to the target gain the gain recovers by each frame.
+     */
+    static float computeReleaseCoefficient(std::chrono::milliseconds release, unsigned int sampleRateHz);
+
+    /// The look-ahead time.
+    const std::chrono::microseconds m_lookAhead;
+
+    /// The largest magnitude of a sample produced.
+    std::atomic<float> m_ceiling;
+
+    /// The share of the way to the target gain the gain recovers by each frame.
+    std::atomic<float> m_releaseCoefficient;
+
+    /// The lowest gain applied in the last block.
+    std::atomic<float> m_lastGain;
+
+    /// Guards the release time and the sample rate against concurrent setters.
+    std::mutex m_parametersMutex;
+
+    /// The release time.
+    std::chrono::milliseconds m_release;
+
+    /// The sample rate of the audio, 0 until the stage is configured.
+    unsigned int m_sampleRateHz;
+
+    /// The number of channels of the audio.
+    unsigned int m_numChannels;
+
+    /// The length of the look-ahead window, in frames.
+    size_t m_windowFrames;
+
+    /// The number of frames processed.
+    uint64_t m_frameIndex;
+
+    /// The position of the next frame in @c m_delay and @c m_heldGains.
+    size_t m_position;
+
+    /// The frames of the look-ahead window, the oldest of which leaves the delay next.
+    std::vector<float> m_delay;
+
+    /// The gains needed by the frames of the window which may still be the lowest, oldest first, and their indices.
+    std::vector<float> m_minGains;
+    std::vector<uint64_t> m_minGainIndices;
+
+    /// The position of the oldest entry of @c m_minGains, and the number of entries.
+    size_t m_minGainsStart;
+    size_t m_minGainsSize;
+
+    /// The gains held and released over the window, averaged into the gain applied.
+    std::vector<float> m_heldGains;
+
+    /// The gain held and released for the last frame.
+    float m_releasedGain;
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_LIMITERSTAGE_H_
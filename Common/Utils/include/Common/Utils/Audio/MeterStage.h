@@ -0,0 +1,64 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_METERSTAGE_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_METERSTAGE_H_
+
+#include <atomic>
+
+#include "Common/Utils/Audio/AudioProcessingStage.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * A stage measuring the level of float audio, which it passes through unchanged. The levels can be read from any
+ * thread; 1.0 is the full scale of a 16-bit sample.
+ */
+class MeterStage : public AudioProcessingStage {
+public:
+    /**
+     * Constructor.
+     */
+    MeterStage();
+
+    /// Returns the largest magnitude of a sample of the last block.
+    float getPeak() const;
+
+    /// Returns the root mean square of the samples of the last block.
+    float getRms() const;
+
+    /// Returns the largest magnitude of a sample since the last call, and starts over.
+    float takeMaxPeak();
+
+    /// @name AudioProcessingStage Functions
+    /// @{
+    std::string getName() const override;
+    bool configure(
+        const AudioFormat& inputFormat,
+        size_t maxInputFrames,
+        AudioFormat* outputFormat,
+        size_t* maxOutputFrames) override;
+    bool canProcessInPlace() const override;
+    size_t process(const unsigned char* input, unsigned char* output, size_t frames) override;
+    /// @}
+
+private:
+    /// The number of channels of the audio.
+    unsigned int m_numChannels;
+
+    /// The largest magnitude of a sample of the last block.
+    std::atomic<float> m_peak;
+
+    /// The root mean square of the samples of the last block.
+    std::atomic<float> m_rms;
+
+    /// The largest magnitude of a sample since the last call to @c takeMaxPeak().
+    std::atomic<float> m_maxPeak;
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_METERSTAGE_H_
@@ -0,0 +1,218 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_PCMKERNELS_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_PCMKERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * Inner loops working on blocks of PCM samples, vectorized with NEON on ARM and SSE2 on x86, with a scalar fallback
+ * for other targets and for the samples left over at the end of a block. They neither allocate nor lock, so that
+ * their cost only depends on the number of samples, and take pointers of any alignment.
+ *
+ * Samples are 16-bit signed integers in host byte order, and 32-bit floats scaled to the same range.
+ */
+
+/**
+ * Returns the name of the instruction set the kernels are built for: "NEON", "SSE2" or "scalar".
+ */
+const char* getPCMKernelsName();
+
+/**
+ * Converts samples to floats scaled by a gain: @c output[i] = @c input[i] * @c gain.
+ *
+ * @param input The samples.
+ * @param count The number of samples.
+ * @param gain The gain.
+ * @param output The buffer for the scaled samples.
+ */
+void scaleToFloat(const int16_t* input, size_t count, float gain, float* output);
+
+/**
+ * Adds samples scaled by a gain to an accumulator: @c accumulator[i] += @c input[i] * @c gain. The accumulator does
+ * not saturate, so any number of inputs can be added before the sum is clipped once by @c saturateToInt16().
+ *
+ * @param input The samples.
+ * @param count The number of samples.
+ * @param gain The gain.
+ * @param accumulator The sums.
+ */
+void accumulateScaled(const int16_t* input, size_t count, float gain, float* accumulator);
+
+/**
+ * Scales floats by a gain: @c output[i] = @c input[i] * @c gain. The input and output may be the same buffer.
+ *
+ * @param input The floats.
+ * @param count The number of floats.
+ * @param gain The gain.
+ * @param output The buffer for the scaled floats.
+ */
+void scaleFloat(const float* input, size_t count, float gain, float* output);
+
+/**
+ * Scales interleaved float frames by a gain changing linearly from one frame to the next: the samples of frame @c i are
+ * multiplied by @c startGain + @c i * @c step, computed afresh for each frame so that long ramps do not drift. The
+ * input and output may be the same buffer.
+ *
+ * @param input The frames.
+ * @param frames The number of frames.
+ * @param channels The number of channels of a frame.
+ * @param startGain The gain of the first frame.
+ * @param step The change of the gain from one frame to the next.
+ * @param output The buffer for the scaled frames.
+ */
+void rampFloat(
+    const float* input,
+    size_t frames,
+    unsigned int channels,
+    float startGain,
+    float step,
+    float* output);
+
+/**
+ * Finds the largest magnitude of floats.
+ *
+ * @param input The floats.
+ * @param count The number of floats.
+ * @return The largest absolute value, 0 if there are none.
+ */
+float peakAbsolute(const float* input, size_t count);
+
+/**
+ * Computes the dot product of two vectors of floats, such as a window of samples and the coefficients of a filter.
+ *
+ * @param a The first vector.
+ * @param b The second vector.
+ * @param count The number of elements of each vector.
+ * @return The sum of the products of the elements.
+ */
+float dotProduct(const float* a, const float* b, size_t count);
+
+/**
+ * The coefficients of a biquad filter section, normalized so that a0 is 1:
+ * @c y[n] = @c b0 x[n] + @c b1 x[n-1] + @c b2 x[n-2] - @c a1 y[n-1] - @c a2 y[n-2].
+ */
+struct BiquadCoefficients {
+    /// The coefficients of the input.
+    float b0;
+    float b1;
+    float b2;
+
+    /// The coefficients of the output.
+    float a1;
+    float a2;
+};
+
+/// The number of channels @c biquadCascade() filters side by side, in the lanes of a vector.
+constexpr unsigned int BIQUAD_LANES = 4;
+
+/**
+ * Runs interleaved float frames through a cascade of biquad sections in transposed direct form II. The channels of a
+ * frame are filtered side by side, @c BIQUAD_LANES at a time, and each section runs over the whole block before the
+ * next, so that its coefficients and state stay in registers. The input and output may be the same buffer.
+ *
+ * @param input The frames.
+ * @param frames The number of frames.
+ * @param channels The number of channels of a frame.
+ * @param sections The coefficients of the sections, in the order they run.
+ * @param numSections The number of sections.
+ * @param state The two state variables of each lane, section and group of @c BIQUAD_LANES channels, carried from one
+ *     block to the next: the @c 2 * BIQUAD_LANES floats of each group of channels follow each other for a section, then
+ *     come those of the next section. They start at zero.
+ * @param output The buffer for the filtered frames.
+ */
+void biquadCascade(
+    const float* input,
+    size_t frames,
+    unsigned int channels,
+    const BiquadCoefficients* sections,
+    size_t numSections,
+    float* state,
+    float* output);
+
+/**
+ * Rounds floats to the nearest 16-bit sample, saturating those out of range.
+ *
+ * @param input The floats.
+ * @param count The number of floats.
+ * @param output The buffer for the samples.
+ */
+void saturateToInt16(const float* input, size_t count, int16_t* output);
+
+/**
+ * Scales floats by a gain, and rounds them to the nearest 16-bit sample, saturating those out of range.
+ *
+ * @param input The floats.
+ * @param count The number of floats.
+ * @param gain The gain.
+ * @param output The buffer for the samples.
+ */
+void scaleToInt16(const float* input, size_t count, float gain, int16_t* output);
+
+/**
+ * Reverses the byte order of 16-bit words. The input and output may be the same buffer.
+ *
+ * @param input The words.
+ * @param count The number of words.
+ * @param output The buffer for the swapped words.
+ */
+void swapBytes16(const uint16_t* input, size_t count, uint16_t* output);
+
+/**
+ * Reverses the byte order of 32-bit words. The input and output may be the same buffer.
+ *
+ * @param input The words.
+ * @param count The number of words.
+ * @param output The buffer for the swapped words.
+ */
+void swapBytes32(const uint32_t* input, size_t count, uint32_t* output);
+
+/**
+ * Mixes interleaved stereo frames down to mono, averaging the two channels; 16-bit averages round toward minus
+ * infinity.
+ *
+ * @param input The stereo frames.
+ * @param frames The number of frames.
+ * @param output The buffer for the mono samples.
+ */
+void downmixStereo(const int16_t* input, size_t frames, int16_t* output);
+
+/// @copydoc downmixStereo(const int16_t*,size_t,int16_t*)
+void downmixStereo(const float* input, size_t frames, float* output);
+
+/**
+ * Splits interleaved stereo frames into a plane per channel.
+ *
+ * @param input The stereo frames.
+ * @param frames The number of frames.
+ * @param left The buffer for the samples of the first channel.
+ * @param right The buffer for the samples of the second channel.
+ */
+void deinterleaveStereo(const int16_t* input, size_t frames, int16_t* left, int16_t* right);
+
+/// @copydoc deinterleaveStereo(const int16_t*,size_t,int16_t*,int16_t*)
+void deinterleaveStereo(const float* input, size_t frames, float* left, float* right);
+
+/**
+ * Interleaves a plane per channel into stereo frames.
+ *
+ * @param left The samples of the first channel.
+ * @param right The samples of the second channel.
+ * @param frames The number of frames.
+ * @param output The buffer for the stereo frames.
+ */
+void interleaveStereo(const int16_t* left, const int16_t* right, size_t frames, int16_t* output);
+
+/// @copydoc interleaveStereo(const int16_t*,const int16_t*,size_t,int16_t*)
+void interleaveStereo(const float* left, const float* right, size_t frames, float* output);
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_PCMKERNELS_H_
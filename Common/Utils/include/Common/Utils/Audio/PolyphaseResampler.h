@@ -0,0 +1,134 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_POLYPHASERESAMPLER_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_POLYPHASERESAMPLER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * A streaming resampler of mono float audio between two fixed rates, such as from the 44.1kHz or 48kHz of a stream to
+ * the 16kHz of speech recognition.
+ *
+ * The rates are reduced to a ratio of integers L/M: the audio is upsampled by L, low pass filtered and decimated by M,
+ * only computing the output samples kept. Each output sample is then one dot product between a window of input
+ * samples and one of the L phases of the filter, run by the vectorized @c dotProduct() kernel. The filter is a Kaiser
+ * windowed sinc cutting at 90% of the lower Nyquist frequency, with about 80dB of stop band attenuation. It is designed
+ * once per ratio and shared by all the resamplers of the process, so that the common ratios (44.1kHz, 48kHz or 32kHz to
+ * 16kHz) are computed a single time.
+ *
+ * Blocks of any size can be processed, without allocating. The output is delayed by half the length of the filter.
+ */
+class PolyphaseResampler {
+public:
+    /// The largest number of phases of the filter: the L of the reduced ratio of the rates.
+    static constexpr unsigned int MAX_PHASES = 1024;
+
+    /**
+     * Creates a resampler.
+     *
+     * @param inputRateHz The sample rate of the input.
+     * @param outputRateHz The sample rate of the output.
+     * @return The resampler, or nullptr if a rate is 0 or their ratio needs more than @c MAX_PHASES phases.
+     */
+    static std::unique_ptr<PolyphaseResampler> create(unsigned int inputRateHz, unsigned int outputRateHz);
+
+    /// Starts a new stream, from silence.
+    void reset();
+
+    /**
+     * Returns the number of output samples @c process() may produce at most from an input block.
+     *
+     * @param inputFrames The number of samples of the input block.
+     * @return The largest number of output samples.
+     */
+    size_t getMaxOutputFrames(size_t inputFrames) const;
+
+    /**
+     * Resamples a block of audio.
+     *
+     * @param input The samples.
+     * @param inputFrames The number of samples.
+     * @param output The buffer for the resampled samples, of at least @c getMaxOutputFrames(inputFrames) samples.
+     * @return The number of samples written to the output.
+     */
+    size_t process(const float* input, size_t inputFrames, float* output);
+
+    /// Returns the sample rate of the input.
+    unsigned int getInputRate() const;
+
+    /// Returns the sample rate of the output.
+    unsigned int getOutputRate() const;
+
+    /// Returns the number of taps of each phase of the filter.
+    size_t getTapsPerPhase() const;
+
+private:
+    /**
+     * The phases of the filter for a ratio.
+     */
+    struct FilterBank {
+        /// The upsampling factor, and the number of phases.
+        unsigned int interpolation;
+
+        /// The decimation factor.
+        unsigned int decimation;
+
+        /// The number of taps of each phase, a multiple of the vector size of the kernels.
+        size_t taps;
+
+        /// The taps of each phase, one phase after the other, each reversed so as to be dotted with a window of input.
+        std::vector<float> coefficients;
+    };
+
+    /**
+     * Designs the filter for a ratio, or finds it if it was designed before.
+     *
+     * @param interpolation The upsampling factor.
+     * @param decimation The decimation factor.
+     * @return The filter.
+     */
+    static std::shared_ptr<const FilterBank> getFilterBank(unsigned int interpolation, unsigned int decimation);
+
+    /**
+     * Constructor.
+     *
+     * @param inputRateHz The sample rate of the input.
+     * @param outputRateHz The sample rate of the output.
+     * @param bank The filter for the ratio of the rates.
+     */
+    PolyphaseResampler(unsigned int inputRateHz, unsigned int outputRateHz, std::shared_ptr<const FilterBank> bank);
+
+    /// The sample rate of the input.
+    const unsigned int m_inputRateHz;
+
+    /// The sample rate of the output.
+    const unsigned int m_outputRateHz;
+
+    /// The filter for the ratio of the rates.
+    const std::shared_ptr<const FilterBank> m_bank;
+
+    /// The input samples still needed by the filter, followed by the samples of the block being processed.
+    std::vector<float> m_window;
+
+    /// The number of samples in @c m_window.
+    size_t m_windowFrames;
+
+    /// The position in @c m_window of the first input sample of the next output sample; may be past its end.
+    size_t m_position;
+
+    /// The phase of the filter for the next output sample.
+    unsigned int m_phase;
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_POLYPHASERESAMPLER_H_
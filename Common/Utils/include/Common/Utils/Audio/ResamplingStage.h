@@ -0,0 +1,60 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_RESAMPLINGSTAGE_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_RESAMPLINGSTAGE_H_
+
+#include <memory>
+#include <vector>
+
+#include "Common/Utils/Audio/AudioProcessingStage.h"
+#include "Common/Utils/Audio/PolyphaseResampler.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * A stage resampling mono or stereo float audio to another rate with a @c PolyphaseResampler per channel.
+ */
+class ResamplingStage : public AudioProcessingStage {
+public:
+    /**
+     * Constructor.
+     *
+     * @param outputRateHz The sample rate to resample the audio to.
+     */
+    explicit ResamplingStage(unsigned int outputRateHz);
+
+    /// @name AudioProcessingStage Functions
+    /// @{
+    std::string getName() const override;
+    bool configure(
+        const AudioFormat& inputFormat,
+        size_t maxInputFrames,
+        AudioFormat* outputFormat,
+        size_t* maxOutputFrames) override;
+    size_t process(const unsigned char* input, unsigned char* output, size_t frames) override;
+    /// @}
+
+private:
+    /// The sample rate to resample the audio to.
+    const unsigned int m_outputRateHz;
+
+    /// The resampler of each channel, created by @c configure().
+    std::vector<std::unique_ptr<PolyphaseResampler>> m_resamplers;
+
+    /// The planes of the channels of a stereo block, then the planes of the channels resampled.
+    std::vector<float> m_planes;
+
+    /// The largest number of frames of a block processed.
+    size_t m_maxInputFrames;
+
+    /// The largest number of frames of a block produced.
+    size_t m_maxOutputFrames;
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_RESAMPLINGSTAGE_H_
@@ -0,0 +1,152 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_RESAMPLINGTAP_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_RESAMPLINGTAP_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Common/Utils/Audio/FormatConverter.h"
+#include "Common/Utils/Audio/PolyphaseResampler.h"
+#include "Common/Utils/AudioFormat.h"
+#include "Common/Utils/AudioInputStream.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+/**
+ * Taps the audio of an @c AudioInputStream, such as the stream of an A2DP sink, and writes it to another
+ * @c AudioInputStream as 16-bit mono audio at a lower rate, by default the 16kHz expected by speech recognition and
+ * wake word detection. Consumers needing that format can then share one resampled stream instead of each resampling
+ * the source on their own.
+ *
+ * Every call to @c process() borrows a block of the source stream in place, converts it to mono floats with a
+ * @c FormatConverter, resamples it with a @c PolyphaseResampler and rounds the result straight into the ring buffer of
+ * the target stream. Nothing is allocated once the tap is created. The tap is driven by its caller, one thread at a
+ * time: with a @c BLOCKING reader, a thread can simply call @c process() in a loop.
+ */
+class ResamplingTap {
+public:
+    /**
+     * Counters describing the tap.
+     */
+    struct Statistics {
+        /// Number of frames read from the source stream.
+        uint64_t framesRead;
+
+        /// Number of frames written to the target stream.
+        uint64_t framesWritten;
+
+        /// Number of times the writer of the source stream overwrote audio before it was read.
+        uint64_t overruns;
+
+        /// Number of frames which did not fit in the target stream, and were dropped.
+        uint64_t framesDropped;
+    };
+
+    /// The default sample rate of the target stream.
+    static constexpr unsigned int DEFAULT_TARGET_RATE_HZ = 16000;
+
+    /// The default number of frames read at most from the source stream at once: 10ms at 48kHz.
+    static constexpr size_t DEFAULT_BLOCK_FRAMES = 480;
+
+    /**
+     * Creates a tap.
+     *
+     * @param sourceFormat The format of the source stream: mono or interleaved stereo, 16-bit or float samples.
+     * @param reader The reader of the source stream, whose words are samples.
+     * @param writer The writer of the target stream, whose words are 16-bit samples.
+     * @param targetRateHz The sample rate of the target stream.
+     * @param blockFrames The largest number of frames read from the source stream by a call to @c process().
+     * @return The tap, or nullptr if a parameter is invalid.
+     */
+    static std::unique_ptr<ResamplingTap> create(
+        const AudioFormat& sourceFormat,
+        std::shared_ptr<AudioInputStream::Reader> reader,
+        std::shared_ptr<AudioInputStream::Writer> writer,
+        unsigned int targetRateHz = DEFAULT_TARGET_RATE_HZ,
+        size_t blockFrames = DEFAULT_BLOCK_FRAMES);
+
+    /**
+     * Reads a block of the source stream, and writes it resampled to the target stream. When the source stream closes,
+     * the target stream is closed too.
+     *
+     * @param timeout The time to wait for audio, if the reader is @c BLOCKING. Zero waits forever.
+     * @return The number of frames read from the source stream, 0 once it has closed, or a negative
+     * @c AudioInputStream::Reader::Error.
+     */
+    ssize_t process(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    /// Returns the format of the target stream.
+    AudioFormat getTargetFormat() const;
+
+    /**
+     * Get the counters of the tap.
+     *
+     * @return A snapshot of the statistics of the tap.
+     */
+    Statistics getStatistics() const;
+
+private:
+    /**
+     * Constructor.
+     *
+     * @param reader The reader of the source stream.
+     * @param writer The writer of the target stream.
+     * @param converter The converter of the source audio to mono floats.
+     * @param resampler The resampler to the target rate.
+     * @param targetFormat The format of the target stream.
+     * @param blockFrames The largest number of frames read from the source stream at once.
+     */
+    ResamplingTap(
+        std::shared_ptr<AudioInputStream::Reader> reader,
+        std::shared_ptr<AudioInputStream::Writer> writer,
+        std::unique_ptr<FormatConverter> converter,
+        std::unique_ptr<PolyphaseResampler> resampler,
+        const AudioFormat& targetFormat,
+        size_t blockFrames);
+
+    /// The reader of the source stream.
+    const std::shared_ptr<AudioInputStream::Reader> m_reader;
+
+    /// The writer of the target stream.
+    const std::shared_ptr<AudioInputStream::Writer> m_writer;
+
+    /// The converter of the source audio to mono floats.
+    const std::unique_ptr<FormatConverter> m_converter;
+
+    /// The resampler to the target rate.
+    const std::unique_ptr<PolyphaseResampler> m_resampler;
+
+    /// The format of the target stream.
+    const AudioFormat m_targetFormat;
+
+    /// The largest number of frames read from the source stream at once.
+    const size_t m_blockFrames;
+
+    /// The number of words of a frame of the source stream.
+    const size_t m_sourceChannels;
+
+    /// The block read, as mono floats.
+    std::vector<float> m_mono;
+
+    /// The block resampled.
+    std::vector<float> m_resampled;
+
+    /// The counters of the tap.
+    Statistics m_statistics;
+
+    /// Serializes the access to @c m_statistics.
+    mutable std::mutex m_statisticsMutex;
+};
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_AUDIO_RESAMPLINGTAP_H_
@@ -24,7 +24,9 @@ enum class BluetoothEventType {
     // Represents when an AVRCP command has been receviced.
     AVRCP_COMMAND_RECEIVED,
     // When the BluetoothDeviceManager has initialized.
-    BLUETOOTH_DEVICE_MANAGER_INITIALIZED
+    BLUETOOTH_DEVICE_MANAGER_INITIALIZED,
+    // When the Bluetooth audio must be ducked under, or restored after, a voice interaction.
+    AUDIO_DUCKING_CHANGED
 };
 
 // Helper struct allow enum class to be a key in collections.
@@ -79,6 +81,9 @@ public:
     // Get @c AVRCP command associated with the event.
     std::shared_ptr<common::sdkInterfaces::bluetooth::services::AVRCPCommand> getAVRCPCommand() const;
 
+    // Get whether the audio must be ducked, for an @c AUDIO_DUCKING_CHANGED event.
+    bool isDucked() const;
+
 protected:
     /**
      * Constructor
@@ -90,7 +95,8 @@ protected:
             common::sdkInterfaces::bluetooth::DeviceState::IDLE,
         MediaStreamingState mediaStreamingState = MediaStreamingState::IDLE,
         std::shared_ptr<A2DPRole> a2dpRole =  nullptr,
-        std::shared_ptr<common::sdkInterfaces::bluetooth::services::AVRCPCommand> avrcpCommand = nullptr
+        std::shared_ptr<common::sdkInterfaces::bluetooth::services::AVRCPCommand> avrcpCommand = nullptr,
+        bool ducked = false
     );
 
 private:
@@ -111,6 +117,9 @@ private:
 
     // @C AVRCPCommand that is received
     std::shared_ptr<common::sdkInterfaces::bluetooth::services::AVRCPCommand> m_avrcpCommand;
+
+    // Whether the audio must be ducked
+    bool m_ducked;
 };
 
 inline BluetoothEvent::BluetoothEvent(
@@ -119,13 +128,15 @@ inline BluetoothEvent::BluetoothEvent(
     common::sdkInterfaces::bluetooth::DeviceState deviceState,
     MediaStreamingState mediaStreamingState,
     std::shared_ptr<A2DPRole> a2dpRole,
-    std::shared_ptr<common::sdkInterfaces::bluetooth::services::AVRCPCommand> avrcpCommand) :
+    std::shared_ptr<common::sdkInterfaces::bluetooth::services::AVRCPCommand> avrcpCommand,
+    bool ducked) :
         m_type{type},
         m_device{device},
         m_deviceState{deviceState},
         m_mediaStreamingState{mediaStreamingState},
         m_a2dpRole{a2dpRole},
-        m_avrcpCommand{avrcpCommand} {
+        m_avrcpCommand{avrcpCommand},
+        m_ducked{ducked} {
 
 }
 
@@ -153,6 +164,10 @@ inline std::shared_ptr<common::sdkInterfaces::bluetooth::services::AVRCPCommand>
     return m_avrcpCommand;
 }
 
+inline bool BluetoothEvent::isDucked() const {
+    return m_ducked;
+}
+
 
 /**
  * Event indicating that a new device was discovered. This must be sent when
@@ -294,6 +309,31 @@ inline BluetoothDeviceManagerInitializedEvent::BluetoothDeviceManagerInitialized
 
 }
 
+/**
+ * Event asking for the Bluetooth audio to be ducked, such as when the assistant wakes up, or restored once the voice
+ * interaction is over.
+ */
+class AudioDuckingChangedEvent : public BluetoothEvent {
+public:
+    /**
+     * Constructor.
+     * @param ducked Whether the audio must be ducked.
+     */
+    explicit AudioDuckingChangedEvent(bool ducked);
+};
+
+inline AudioDuckingChangedEvent::AudioDuckingChangedEvent(bool ducked) :
+    BluetoothEvent(
+        BluetoothEventType::AUDIO_DUCKING_CHANGED,
+        nullptr,
+        common::sdkInterfaces::bluetooth::DeviceState::IDLE,
+        MediaStreamingState::IDLE,
+        nullptr,
+        nullptr,
+        ducked) {
+
+}
+
 }  // namespace bluetooth
 }  // namespace utils
 }  // namespace common
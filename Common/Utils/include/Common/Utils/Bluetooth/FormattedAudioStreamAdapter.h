@@ -4,6 +4,7 @@
 #include <memory>
 #include <mutex>
 
+#include "Common/Utils/Audio/AudioProcessingChain.h"
 #include "Common/Utils/AudioFormat.h"
 #include "Common/Utils/Bluetooth/FormattedAudioStreamAdapterListener.h"
 
@@ -39,7 +40,17 @@ public:
     void setListener(std::shared_ptr<FormattedAudioStreamAdapterListener> listener);
 
     /**
-     * Publish data to the listener.
+     * Set the chain of DSP stages run on the data before it is published. The listener then receives the blocks
+     * produced by the chain, along with its output format. The chain runs on the thread calling @c send().
+     *
+     * @param chain The chain, created for the @c AudioFormat of the adapter, or nullptr to publish the data unchanged.
+     * @return @c true on success, @c false if the chain was created for another format.
+     */
+    bool setProcessingChain(std::shared_ptr<audio::AudioProcessingChain> chain);
+
+    /**
+     * Publish data to the listener, through the processing chain if there is one. Data larger than the blocks of the
+     * chain is processed and published in several blocks.
      *
      * @param buffer Buffer containing the data
      * @param size Size of the data block in bytes. The value must be greater than zero.
@@ -54,7 +65,10 @@ private:
     // the listener to receive data.
     std::weak_ptr<FormattedAudioStreamAdapterListener> m_listener;
 
-    // Mutex to guard listener changes.
+    // The chain of DSP stages the data goes through before it is published, if any.
+    std::shared_ptr<audio::AudioProcessingChain> m_processingChain;
+
+    // Mutex to guard listener and processing chain changes.
     std::mutex m_readerFunctionMutex;
 };
 
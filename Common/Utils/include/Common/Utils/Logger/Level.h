@@ -2,6 +2,7 @@
 #define DEVICE_CLIENT_SDK_COMMON_UTILS_LOGGER_LEVEL_H_
 
 #include <string.h>
+#include <string>
 
 namespace deviceClientSDK {
 namespace common {
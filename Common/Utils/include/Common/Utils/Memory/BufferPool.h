@@ -0,0 +1,166 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_MEMORY_BUFFERPOOL_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_MEMORY_BUFFERPOOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace memory {
+
+/**
+ * A fixed number of fixed size buffers, allocated at once, and handed out as reference counted handles.
+ *
+ * The buffers are carved out of one slab, each starting on a cache line. Acquiring a buffer pops it from a lock-free
+ * free list, and dropping the last handle to it pushes it back, so that buffers can be passed between threads and
+ * processing stages without ever calling the allocator once the pool is built. The reference count lives with the
+ * buffer, so copying a handle costs an atomic increment and no allocation.
+ *
+ * Any thread may acquire buffers and drop handles. The pool must outlive every handle to its buffers.
+ */
+class BufferPool {
+private:
+    /// The bookkeeping of a buffer.
+    struct Header;
+
+public:
+    /**
+     * A handle to a buffer of a @c BufferPool. The buffer returns to the pool when its last handle is destroyed or
+     * reset. A default constructed handle is empty.
+     */
+    class Buffer {
+    public:
+        /// Constructs an empty handle.
+        Buffer();
+
+        /// Constructs another handle to the buffer of @c other.
+        Buffer(const Buffer& other);
+
+        /// Takes the buffer of @c other, which becomes empty.
+        Buffer(Buffer&& other);
+
+        /// Drops the buffer held, and takes another handle to the buffer of @c other.
+        Buffer& operator=(const Buffer& other);
+
+        /// Drops the buffer held, and takes the buffer of @c other, which becomes empty.
+        Buffer& operator=(Buffer&& other);
+
+        /// Destructor. Drops the buffer held.
+        ~Buffer();
+
+        /// Drops the buffer held, which returns to its pool if this was the last handle to it.
+        void reset();
+
+        /// @return @c true if the handle holds a buffer.
+        explicit operator bool() const;
+
+        /// @return The first byte of the buffer, or nullptr if the handle is empty.
+        uint8_t* data() const;
+
+        /// @return The number of bytes the buffer can hold, 0 if the handle is empty.
+        size_t capacity() const;
+
+        /// @return The number of bytes in use, as set with @c setSize(). 0 when the buffer is acquired.
+        size_t size() const;
+
+        /**
+         * Sets the number of bytes in use, which every handle to the buffer shares.
+         *
+         * @param size The number of bytes, no more than @c capacity().
+         */
+        void setSize(size_t size);
+
+        /// @return The number of handles to the buffer, 0 if the handle is empty.
+        size_t useCount() const;
+
+    private:
+        friend class BufferPool;
+
+        /// Constructs the first handle to a buffer just acquired.
+        explicit Buffer(Header* header);
+
+        /// The bookkeeping of the buffer held, or nullptr.
+        Header* m_header;
+    };
+
+    /**
+     * Constructor. Allocates every buffer.
+     *
+     * @param bufferSize The number of bytes of each buffer.
+     * @param bufferCount The number of buffers.
+     */
+    BufferPool(size_t bufferSize, size_t bufferCount);
+
+    /// Destructor. Every handle must have been dropped.
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * Takes a buffer out of the pool.
+     *
+     * @return A handle to the buffer, or an empty handle if every buffer is in use.
+     */
+    Buffer acquire();
+
+    /// @return The number of bytes of each buffer.
+    size_t getBufferSize() const;
+
+    /// @return The number of buffers.
+    size_t getBufferCount() const;
+
+    /// @return The number of buffers not in use, a snapshot when other threads use the pool.
+    size_t getAvailableCount() const;
+
+private:
+    struct Header {
+        /// The pool the buffer returns to.
+        BufferPool* pool;
+
+        /// The first byte of the buffer.
+        uint8_t* data;
+
+        /// The number of handles to the buffer.
+        std::atomic<uint32_t> referenceCount;
+
+        /// The index of the next buffer on the free list.
+        std::atomic<uint32_t> next;
+
+        /// The number of bytes in use.
+        size_t size;
+    };
+
+    /// Puts a buffer whose last handle was dropped back on the free list.
+    void release(Header* header);
+
+    /// The number of bytes of each buffer.
+    const size_t m_bufferSize;
+
+    /// The number of buffers.
+    const size_t m_bufferCount;
+
+    /// The memory of the buffers, with room to align the first one.
+    std::vector<uint8_t> m_slab;
+
+    /// The bookkeeping of the buffers.
+    std::unique_ptr<Header[]> m_headers;
+
+    /// The top of the free list: the index of its first buffer in the low half, and a count of its updates in the high
+    /// half, so that a compare and swap based on a stale top can't succeed.
+    std::atomic<uint64_t> m_freeList;
+
+    /// The number of buffers on the free list.
+    std::atomic<size_t> m_availableCount;
+};
+
+}  // namespace memory
+}  // namespace utils
+}  // namespace common
+}  // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_MEMORY_BUFFERPOOL_H_
@@ -1,14 +1,19 @@
 #ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_BUFFERLAYOUT_H_
 #define DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_BUFFERLAYOUT_H_
 
+#include <chrono>
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
+#include <limits>
 #include <mutex>
 #include <string>
 #include <vector>
 
 
 #include "Common/Utils/Logger/Log.h"
+#include "EventFD.h"
+#include "Futex.h"
 #include "SharedDataStream.h"
 
 namespace deviceClientSDK {
@@ -24,8 +29,14 @@ public:
     // Magic number used to identify a valid Header in memory.
     static const uint32_t MAGIC_NUMBER = 0x53445348;
 
-    // Version of this header layout.
-    static const uint32_t VERSION = 2;
+    // Version of this header layout.  Version 4 puts the header, the cursors written by each side and the data on
+    // cache lines of their own, and rounds the data size to a power of two.  Version 5 gives each Reader its own
+    // condition variable and wake index.  Version 6 leaves oldestUnconsumedCursor to the Writer, which rescans the
+    // reader cursors when it runs short of space.  Version 7 adds the Reader eventfds.
+    static const uint32_t VERSION = 7;
+
+    // Fields written by different threads are kept this many bytes apart so they do not share a cache line.
+    static const size_t CACHE_LINE_SIZE = 64;
 
     // A constructor.
     BufferLayout(std::shared_ptr<Buffer> buffer);
@@ -39,63 +50,188 @@ public:
         uint32_t traitsNameHash;
         uint16_t wordSize;
         uint8_t maxReaders;
-        ConditionVariable dataAvailableConditionVariable;
         Mutex dataAvailableMutex;
         ConditionVariable spaceAvailableConditionVariable;
         Mutex backwardSeekMutex;
         AtomicBool isWriterEnabled;
         AtomicBool hasWriterBeenClosed;
         Mutex writerEnableMutex;
-        AtomicIndex writeStartCursor;
-        AtomicIndex writeEndCursor;
-        AtomicIndex oldestUnconsumedCursor;
         uint32_t referenceCount;
         Mutex attachMutex;
-        Mutex readerEnableMutex;      
+        Mutex readerEnableMutex;
+        // Written by the Writer on every write.  Single-reader streams sleep on the wake sequences instead of the
+        // condition variables.
+        alignas(CACHE_LINE_SIZE) AtomicIndex writeStartCursor;
+        AtomicIndex writeEndCursor;
+        AtomicBool isReaderSleeping;
+        AtomicIndex readerWakeSequence;
+        // Written by the Writer when it runs short of space, and read by the Readers as they consume data.
+        alignas(CACHE_LINE_SIZE) AtomicIndex oldestUnconsumedCursor;
+        AtomicBool isWriterSleeping;
+        AtomicIndex writerWakeSequence;
+    };
+
+    // The cursors of one Reader, which only that Reader moves, on a cache line of their own.
+    struct alignas(CACHE_LINE_SIZE) ReaderCursors {
+        AtomicIndex cursor;
+        AtomicIndex closeIndex;
+    };
+
+    // What a blocked Reader is waiting for.  The Writer only wakes a Reader once writeStartCursor reaches its index.
+    // A Reader polling an eventfd (see Reader::getEventFD()) publishes the descriptor, tagged with its process id, in
+    // eventFD, and arms it through eventState.
+    struct alignas(CACHE_LINE_SIZE) ReaderWake {
+        AtomicIndex index;
+        AtomicBool isSleeping;
+        ConditionVariable dataAvailableConditionVariable;
+        AtomicIndex eventFD;
+        AtomicIndex eventState;
     };
 
+    // Values of ReaderWake::eventState.  Only the Writer moves an armed eventfd to signalling, and back to disarmed
+    // once it has signalled it, so the Reader can wait for a signal in flight before closing the descriptor.
+    static const Index EVENT_DISARMED = 0;
+    static const Index EVENT_ARMED = 1;
+    static const Index EVENT_SIGNALLING = 2;
+
     Header* getHeader() const;
     AtomicBool* getReaderEnabledArray() const;
-    AtomicIndex* getReaderCursorArray() const;
-    AtomicIndex* getReaderCloseIndexArray() const;
+    AtomicIndex* getReaderCursor(size_t id) const;
+    AtomicIndex* getReaderCloseIndex(size_t id) const;
+    ReaderWake* getReaderWake(size_t id) const;
     Index getDataSize() const;
+    size_t getWordSize() const;
     uint8_t* getData(Index at = 0) const;
     bool init(size_t wordSize, size_t maxReaders);
     bool attach();
     void detach();
+
+    /**
+     * Re-initializes a header left behind by users which are all gone (see @c SharedDataStream::recover()), keeping
+     * the data and the write position.
+     *
+     * @return @c true if the header was valid and has been re-initialized, else @c false.
+     */
+    bool recover();
     bool isReaderEnabled(size_t id) const;
     void enableReaderLocked(size_t id);
     void disableReaderLocked(size_t id);
     Index wordsUntilWrap(Index after) const;
-    static size_t calculateDataOffset(size_t wordSize, size_t maxReaders);
+    static size_t calculateDataOffset(size_t maxReaders);
+    static size_t roundUpToPowerOfTwo(size_t size);
     void updateOldestUnconsumedCursor();
     void updateOldestUnconsumedCursorLocked();
 
+    /**
+     * Wakes up a @c BLOCKING @c Writer waiting for space, if any.  Readers call this after moving forward, instead of
+     * updating @c oldestUnconsumedCursor themselves; the @c Writer then rescans the cursors.
+     */
+    void notifySpaceAvailable();
+
+    /**
+     * Waits for @c predicate to be satisfied, on behalf of a @c BLOCKING @c Writer on a stream with several readers.
+     *
+     * @param lock A lock held on @c backwardSeekMutex.
+     * @param timeout The maximum time to wait, or zero to wait forever.
+     * @param predicate The condition to wait for; it is called with @c lock held.
+     * @return The value of @c predicate when the wait ended.
+     */
+    template <typename Predicate>
+    bool waitForSpaceLocked(std::unique_lock<Mutex>* lock, std::chrono::milliseconds timeout, Predicate predicate);
+
+    /**
+     * Whether this is a single-producer/single-consumer stream (@c maxReaders is 1).  Such streams skip the mutexes
+     * and condition variables on the @c read()/@c write() paths: the cursors are only moved with atomics, and a side
+     * which has to wait sleeps on a futex (see @c waitForSequence() and @c signalSequence()).
+     */
+    bool isSingleReader() const;
+
+    /**
+     * Sleeps until @c predicate is satisfied, on a single-reader stream.  The other side must call
+     * @c signalSequence() with the same @c isSleeping and @c sequence after every change which can satisfy
+     * @c predicate.
+     *
+     * @param isSleeping The flag telling the other side that this side may be sleeping.
+     * @param sequence The word to sleep on, which the other side increments to wake this side up.
+     * @param timeout The maximum time to wait, or zero to wait forever.
+     * @param predicate The condition to wait for.
+     * @return The value of @c predicate when the wait ended.
+     */
+    template <typename Predicate>
+    bool waitForSequence(
+        AtomicBool* isSleeping,
+        AtomicIndex* sequence,
+        std::chrono::milliseconds timeout,
+        Predicate predicate);
+
+    /**
+     * Wakes up the side sleeping in @c waitForSequence(), if any.
+     *
+     * @param isSleeping The flag of the side to wake up.
+     * @param sequence The word that side sleeps on.
+     */
+    void signalSequence(AtomicBool* isSleeping, AtomicIndex* sequence);
+
+    /**
+     * Wakes up the blocked @c Readers whose wake index @c writeStartCursor has reached.
+     *
+     * @param force Wake up every blocked @c Reader regardless of its wake index (used when the @c Writer closes).
+     */
+    void notifyDataAvailable(bool force = false);
+
 private:
+    /**
+     * Signals the eventfd of a Reader, if it is armed, belongs to this process, and @c writeStartCursor has reached
+     * its wake index (or @c force is set).
+     *
+     * @param wake The wake state of the Reader.
+     * @param writeStartCursor The current @c writeStartCursor.
+     * @param force Whether to signal regardless of the wake index.
+     */
+    void signalReaderEventFD(ReaderWake* wake, Index writeStartCursor, bool force);
+
+    /**
+     * Finds the oldest cursor of the enabled readers.
+     *
+     * @return The oldest cursor, or @c std::numeric_limits<Index>::max() if no reader is enabled.
+     */
+    Index findOldestReaderCursor() const;
+
     static uint32_t stableHash(const char* string);
     static size_t alignSizeTo(size_t size, size_t align);
     static size_t calculateReaderEnabledArrayOffset();
-    static size_t calculateReaderCursorArrayOffset(size_t maxReaders);
-    static size_t calculateReaderCloseIndexArrayOffset(size_t maxReaders);
+    static size_t calculateReaderCursorsArrayOffset(size_t maxReaders);
+    static size_t calculateReaderWakeArrayOffset(size_t maxReaders);
     void calculateAndCacheConstants(size_t wordSize, size_t maxReaders);
+    uint8_t getLegacyVersion() const;
+    bool verifyHeader() const;
     static const std::string TAG;
     bool isAttached() const;
     std::shared_ptr<Buffer> m_buffer;
+    uint8_t* m_header;
     AtomicBool* m_readerEnabledArray;
-    AtomicIndex* m_readerCursorArray;
-    AtomicIndex* m_readerCloseIndexArray;
+    ReaderCursors* m_readerCursorsArray;
+    ReaderWake* m_readerWakeArray;
     Index m_dataSize;
+    Index m_dataMask;
+    size_t m_wordSize;
     uint8_t* m_data;
+    bool m_isSingleReader;
 };
 
 template <typename T>
 SharedDataStream<T>::BufferLayout::BufferLayout(std::shared_ptr<Buffer> buffer) : 
         m_buffer{buffer},
+        m_header{reinterpret_cast<uint8_t*>(
+            alignSizeTo(reinterpret_cast<uintptr_t>(m_buffer->data()), CACHE_LINE_SIZE))},
         m_readerEnabledArray{nullptr},
-        m_readerCursorArray{nullptr},
-        m_readerCloseIndexArray{nullptr},
+        m_readerCursorsArray{nullptr},
+        m_readerWakeArray{nullptr},
         m_dataSize{0},
-        m_data{nullptr} {
+        m_dataMask{0},
+        m_wordSize{0},
+        m_data{nullptr},
+        m_isSingleReader{false} {
 }
 
 template <typename T>
@@ -105,7 +241,7 @@ SharedDataStream<T>::BufferLayout::~BufferLayout() {
 
 template <typename T>
 typename SharedDataStream<T>::BufferLayout::Header* SharedDataStream<T>::BufferLayout::getHeader() const {
-    return reinterpret_cast<Header*>(m_buffer->data());
+    return reinterpret_cast<Header*>(m_header);
 }
 
 template <typename T>
@@ -114,13 +250,19 @@ typename SharedDataStream<T>::AtomicBool* SharedDataStream<T>::BufferLayout::get
 }
 
 template <typename T>
-typename SharedDataStream<T>::AtomicIndex* SharedDataStream<T>::BufferLayout::getReaderCursorArray() const {
-    return m_readerCursorArray;
+typename SharedDataStream<T>::AtomicIndex* SharedDataStream<T>::BufferLayout::getReaderCursor(size_t id) const {
+    return &m_readerCursorsArray[id].cursor;
 }
 
 template <typename T>
-typename SharedDataStream<T>::AtomicIndex* SharedDataStream<T>::BufferLayout::getReaderCloseIndexArray() const {
-    return m_readerCloseIndexArray;
+typename SharedDataStream<T>::AtomicIndex* SharedDataStream<T>::BufferLayout::getReaderCloseIndex(size_t id) const {
+    return &m_readerCursorsArray[id].closeIndex;
+}
+
+template <typename T>
+typename SharedDataStream<T>::BufferLayout::ReaderWake* SharedDataStream<T>::BufferLayout::getReaderWake(
+    size_t id) const {
+    return &m_readerWakeArray[id];
 }
 
 template <typename T>
@@ -128,9 +270,14 @@ typename SharedDataStream<T>::Index SharedDataStream<T>::BufferLayout::getDataSi
     return m_dataSize;
 }
 
+template <typename T>
+size_t SharedDataStream<T>::BufferLayout::getWordSize() const {
+    return m_wordSize;
+}
+
 template <typename T>
 uint8_t* SharedDataStream<T>::BufferLayout::getData(Index at) const {
-    return m_data + (at % getDataSize()) * getHeader()->wordSize;
+    return m_data + (at & m_dataMask) * m_wordSize;
 }
 
 template <typename T>
@@ -155,8 +302,8 @@ bool SharedDataStream<T>::BufferLayout::init(size_t wordSize, size_t maxReaders)
     size_t id;
     for (id = 0; id < maxReaders; ++id) {
         new (m_readerEnabledArray + id) AtomicBool;
-        new (m_readerCursorArray + id) AtomicIndex;
-        new (m_readerCloseIndexArray + id) AtomicIndex;
+        new (m_readerCursorsArray + id) ReaderCursors;
+        new (m_readerWakeArray + id) ReaderWake;
     }
 
     // Header field initialization.
@@ -170,13 +317,21 @@ bool SharedDataStream<T>::BufferLayout::init(size_t wordSize, size_t maxReaders)
     header->writeStartCursor = 0;
     header->writeEndCursor = 0;
     header->oldestUnconsumedCursor = 0;
+    header->isReaderSleeping = false;
+    header->readerWakeSequence = 0;
+    header->isWriterSleeping = false;
+    header->writerWakeSequence = 0;
     header->referenceCount = 1;
 
     // Reader arrays initialization.
     for (id = 0; id < maxReaders; ++id) {
         m_readerEnabledArray[id] = false;
-        m_readerCursorArray[id] = 0;
-        m_readerCloseIndexArray[id] = 0;
+        m_readerCursorsArray[id].cursor = 0;
+        m_readerCursorsArray[id].closeIndex = 0;
+        m_readerWakeArray[id].index = 0;
+        m_readerWakeArray[id].isSleeping = false;
+        m_readerWakeArray[id].eventFD = 0;
+        m_readerWakeArray[id].eventState = EVENT_DISARMED;
     }
 
     return true;
@@ -185,21 +340,13 @@ bool SharedDataStream<T>::BufferLayout::init(size_t wordSize, size_t maxReaders)
 template <typename T>
 bool SharedDataStream<T>::BufferLayout::attach() {
     // Verify compatibility.
-    auto header = getHeader();
-    if (header->magic != MAGIC_NUMBER) {
-        LOG_ERROR <<  "attachFailed, reason: magicnumber";
-        return false;
-    }
-    if (header->version != VERSION) {
-        LOG_ERROR <<  "attachFailed, reason: incompatibleVersion";
-        return false;
-    }
-    if (header->traitsNameHash != stableHash(T::traitsName)) {
-        LOG_ERROR <<  "attachFailed, reason: traitsNameHashMismatch";
+    if (!verifyHeader()) {
+        // Logged in verifyHeader().
         return false;
     }
 
     // Attach.
+    auto header = getHeader();
     std::lock_guard<Mutex> lock(header->attachMutex);
     if (0 == header->referenceCount) {
         LOG_ERROR <<  "attachFailed, reason: zeroUsers";
@@ -232,8 +379,8 @@ void SharedDataStream<T>::BufferLayout::detach() {
 
     // Destruction of reader arrays.
     for (size_t id = 0; id < header->maxReaders; ++id) {
-        m_readerCloseIndexArray[id].~AtomicIndex();
-        m_readerCursorArray[id].~AtomicIndex();
+        m_readerWakeArray[id].~ReaderWake();
+        m_readerCursorsArray[id].~ReaderCursors();
         m_readerEnabledArray[id].~AtomicBool();
     }
 
@@ -241,6 +388,52 @@ void SharedDataStream<T>::BufferLayout::detach() {
     header->~Header();
 }
 
+template <typename T>
+bool SharedDataStream<T>::BufferLayout::recover() {
+    // Verify compatibility.
+    if (!verifyHeader()) {
+        // Logged in verifyHeader().
+        return false;
+    }
+
+    // Keep what describes the data, and rebuild everything else: the mutexes and condition variables may have been
+    // held or waited on by users which died, and the reference count and the reader and writer flags describe users
+    // which are gone.
+    auto header = getHeader();
+    size_t wordSize = header->wordSize;
+    size_t maxReaders = header->maxReaders;
+    Index writeStartCursor = header->writeStartCursor;
+    Index writeEndCursor = header->writeEndCursor;
+    size_t expectedSize = calculateBufferSize(1, wordSize, maxReaders);
+    if (0 == expectedSize || expectedSize > m_buffer->size()) {
+        LOG_ERROR << "recoverFailed, reason: bufferSizeMismatch";
+        return false;
+    }
+    if (!init(wordSize, maxReaders)) {
+        // Logged in init().
+        return false;
+    }
+
+    // A Writer which died between claiming space and committing it may have half-written that space, which then holds
+    // neither the old data nor the new.  Silence it rather than hand it out as the oldest data.
+    if (writeEndCursor > writeStartCursor && writeEndCursor - writeStartCursor <= m_dataSize) {
+        Index at = writeStartCursor;
+        while (at < writeEndCursor) {
+            Index nWords = wordsUntilWrap(at);
+            if (nWords > writeEndCursor - at) {
+                nWords = writeEndCursor - at;
+            }
+            memset(getData(at), 0, nWords * m_wordSize);
+            at += nWords;
+        }
+    }
+
+    header->writeStartCursor = writeStartCursor;
+    header->writeEndCursor = writeStartCursor;
+    header->oldestUnconsumedCursor = writeStartCursor;
+    return true;
+}
+
 template <typename T>
 bool SharedDataStream<T>::BufferLayout::isReaderEnabled(size_t id) const {
     return m_readerEnabledArray[id];
@@ -258,26 +451,67 @@ void SharedDataStream<T>::BufferLayout::disableReaderLocked(size_t id) {
 
 template <typename T>
 typename SharedDataStream<T>::Index SharedDataStream<T>::BufferLayout::wordsUntilWrap(Index after) const {
-    return alignSizeTo(after, getDataSize()) - after;
+    return m_dataSize - (after & m_dataMask);
+}
+
+template <typename T>
+size_t SharedDataStream<T>::BufferLayout::calculateDataOffset(size_t maxReaders) {
+    return calculateReaderWakeArrayOffset(maxReaders) + (maxReaders * sizeof(ReaderWake));
 }
 
 template <typename T>
-size_t SharedDataStream<T>::BufferLayout::calculateDataOffset(size_t wordSize, size_t maxReaders) {
-    return alignSizeTo(calculateReaderCloseIndexArrayOffset(maxReaders) + (maxReaders * sizeof(AtomicIndex)), wordSize);
+size_t SharedDataStream<T>::BufferLayout::roundUpToPowerOfTwo(size_t size) {
+    size_t rounded = 1;
+    while (rounded < size && rounded <= std::numeric_limits<size_t>::max() / 2) {
+        rounded <<= 1;
+    }
+    return rounded < size ? 0 : rounded;
 }
 
 template <typename T>
 void SharedDataStream<T>::BufferLayout::updateOldestUnconsumedCursor() {
-    // Note: as an optimization, we could skip this function if Writer policy is nonblockable (ACSDK-251).
-    std::lock_guard<Mutex> backwardSeekLock(getHeader()->backwardSeekMutex);
-    updateOldestUnconsumedCursorLocked();
+    // This is called when a Reader goes away, so that a Writer blocked on it can move on.
+    auto header = getHeader();
+    {
+        // With a single reader, the only thread which seeks backwards is the one calling this function, so there is
+        // nothing to lock out.
+        std::unique_lock<Mutex> backwardSeekLock(header->backwardSeekMutex, std::defer_lock);
+        if (!m_isSingleReader) {
+            backwardSeekLock.lock();
+        }
+
+        // If no barrier was found, block at the write cursor so that we retain data until a reader comes along to
+        // read it.
+        Index oldest = findOldestReaderCursor();
+        if (std::numeric_limits<Index>::max() == oldest) {
+            oldest = header->writeStartCursor;
+        }
+        if (oldest > header->oldestUnconsumedCursor) {
+            header->oldestUnconsumedCursor = oldest;
+        }
+    }
+    notifySpaceAvailable();
 }
 
 template <typename T>
 void SharedDataStream<T>::BufferLayout::updateOldestUnconsumedCursorLocked() {
     auto header = getHeader();
 
-    // Note: as an optimization, we could skip this function if Writer policy is nonblockable (ACSDK-251).
+    // This is only called by a Writer which is short of space, with backwardSeekMutex held (unless there is a single
+    // reader).  Readers do not call it as they read: it scans every reader, so keeping oldestUnconsumedCursor exact
+    // would cost each read O(maxReaders) and the lock.  oldestUnconsumedCursor lags behind the readers instead, which
+    // is always safe, and Readers only wake up a waiting Writer (see notifySpaceAvailable()).
+    Index oldest = findOldestReaderCursor();
+
+    // With no readers, leave the barrier where the last reader left it (see updateOldestUnconsumedCursor()).
+    if (std::numeric_limits<Index>::max() != oldest && oldest > header->oldestUnconsumedCursor) {
+        header->oldestUnconsumedCursor = oldest;
+    }
+}
+
+template <typename T>
+typename SharedDataStream<T>::Index SharedDataStream<T>::BufferLayout::findOldestReaderCursor() const {
+    auto header = getHeader();
 
     // The only barrier to a blocking writer overrunning a reader is oldestUnconsumedCursor, so we have to be careful
     // not to ever move it ahead of any readers.  The loop below searches through the readers to find the oldest point,
@@ -296,31 +530,152 @@ void SharedDataStream<T>::BufferLayout::updateOldestUnconsumedCursorLocked() {
         // - if a reader becomes re-enabled, its cursor defaults to writeCursor (which will never be the oldest)
         // - if a reader is created that wants to be at an older index, it gets there by doing a backward seek (which
         //   is locked when this function is called)
-        if (isReaderEnabled(id) && getReaderCursorArray()[id] < oldest) {
-            oldest = getReaderCursorArray()[id];
+        if (isReaderEnabled(id)) {
+            Index cursor = *getReaderCursor(id);
+            if (cursor < oldest) {
+                oldest = cursor;
+            }
         }
     }
+    return oldest;
+}
+
+template <typename T>
+bool SharedDataStream<T>::BufferLayout::isSingleReader() const {
+    return m_isSingleReader;
+}
 
-    // If no barrier was found, block at the write cursor so that we retain data until a reader comes along to read it.
-    if (std::numeric_limits<Index>::max() == oldest) {
-        oldest = header->writeStartCursor;
+template <typename T>
+template <typename Predicate>
+bool SharedDataStream<T>::BufferLayout::waitForSequence(
+    AtomicBool* isSleeping,
+    AtomicIndex* sequence,
+    std::chrono::milliseconds timeout,
+    Predicate predicate) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+        // The flag is raised before the predicate is checked, and signalSequence() checks it after the other side
+        // has made its change, so either we see the change or the other side sees the flag and bumps the sequence.
+        // If the bump lands between the load below and the futex wait, the wait returns immediately.
+        *isSleeping = true;
+        auto expected = static_cast<uint32_t>(sequence->load());
+        if (predicate()) {
+            *isSleeping = false;
+            return true;
+        }
+
+        auto remaining = std::chrono::nanoseconds::zero();
+        if (timeout != std::chrono::milliseconds::zero()) {
+            remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::nanoseconds::zero()) {
+                *isSleeping = false;
+                return predicate();
+            }
+        }
+        futexWait(futexWord(sequence), expected, remaining);
     }
+}
 
-    // Now that we've measured the oldest cursor, we can safely update oldestUnconsumedCursor with no risk of an
-    // overrun of any readers.
+template <typename T>
+void SharedDataStream<T>::BufferLayout::signalSequence(AtomicBool* isSleeping, AtomicIndex* sequence) {
+    if (*isSleeping) {
+        // Only wake the sleeper once; it raises the flag again if it goes back to sleep.
+        *isSleeping = false;
+        ++*sequence;
+        futexWake(futexWord(sequence));
+    }
+}
 
-    // To clarify the logic here, the code above reviewed all of the enabled readers to see where the oldest cursor is
-    // at.  This value is captured in the 'oldest' variable.  Now we want to move up our writer barrier
-    // ('oldestUnconsumedCursor') if it is older than it needs to be.
-    if (oldest > header->oldestUnconsumedCursor) {
-        header->oldestUnconsumedCursor = oldest;
+template <typename T>
+void SharedDataStream<T>::BufferLayout::notifyDataAvailable(bool force) {
+    auto header = getHeader();
+    Index writeStartCursor = header->writeStartCursor;
+
+    // The sleeping flag has to be checked before the wake index; see waitForSequence() and Reader::waitForData().
+    if (m_isSingleReader) {
+        if (header->isReaderSleeping && (force || writeStartCursor >= m_readerWakeArray[0].index)) {
+            signalSequence(&header->isReaderSleeping, &header->readerWakeSequence);
+        }
+        signalReaderEventFD(&m_readerWakeArray[0], writeStartCursor, force);
+        return;
+    }
+    for (size_t id = 0; id < header->maxReaders; ++id) {
+        auto wake = &m_readerWakeArray[id];
+        if (wake->isSleeping && (force || writeStartCursor >= wake->index)) {
+            wake->dataAvailableConditionVariable.notify_one();
+        }
+        signalReaderEventFD(wake, writeStartCursor, force);
+    }
+}
 
-        // Notify the writer(s).
-        // Note: as an optimization, we could skip this if there are no blocking writers (ACSDK-251).
+template <typename T>
+void SharedDataStream<T>::BufferLayout::signalReaderEventFD(ReaderWake* wake, Index writeStartCursor, bool force) {
+    // Like the sleeping flags, the state has to be checked before the wake index; see Reader::armEventFD().
+    if (EVENT_ARMED != wake->eventState || (!force && writeStartCursor < wake->index)) {
+        return;
+    }
+    if (static_cast<Index>(getpid()) != (wake->eventFD >> 32)) {
+        // The descriptor is only meaningful in the Reader's process.
+        return;
+    }
+    Index armed = EVENT_ARMED;
+    if (!wake->eventState.compare_exchange_strong(armed, EVENT_SIGNALLING)) {
+        return;
+    }
+
+    // The Reader may have rearmed with a later index since the check above; it can not change the index or close the
+    // descriptor while we are signalling.
+    if (!force && writeStartCursor < wake->index) {
+        wake->eventState = EVENT_ARMED;
+        return;
+    }
+    Index eventFD = wake->eventFD;
+    if (eventFD != 0) {
+        eventFDSignal(static_cast<int>(eventFD & 0xffffffff));
+    }
+    wake->eventState = EVENT_DISARMED;
+}
+
+template <typename T>
+void SharedDataStream<T>::BufferLayout::notifySpaceAvailable() {
+    auto header = getHeader();
+    if (m_isSingleReader) {
+        signalSequence(&header->isWriterSleeping, &header->writerWakeSequence);
+        return;
+    }
+
+    // The Writer raises isWriterSleeping before it rescans the cursors, so if the flag is down here, the rescan will
+    // see the move.  If it is up, the Writer may be between its rescan and its wait; it holds backwardSeekMutex
+    // throughout, so taking the mutex here makes sure the notification comes after the wait has started.
+    if (header->isWriterSleeping) {
+        {
+            std::lock_guard<Mutex> backwardSeekLock(header->backwardSeekMutex);
+        }
         header->spaceAvailableConditionVariable.notify_all();
     }
 }
 
+template <typename T>
+template <typename Predicate>
+bool SharedDataStream<T>::BufferLayout::waitForSpaceLocked(
+    std::unique_lock<Mutex>* lock,
+    std::chrono::milliseconds timeout,
+    Predicate predicate) {
+    auto header = getHeader();
+    auto sleepingPredicate = [header, &predicate] {
+        header->isWriterSleeping = true;
+        return predicate();
+    };
+    bool ready = true;
+    if (std::chrono::milliseconds::zero() == timeout) {
+        header->spaceAvailableConditionVariable.wait(*lock, sleepingPredicate);
+    } else {
+        ready = header->spaceAvailableConditionVariable.wait_for(*lock, timeout, sleepingPredicate);
+    }
+    header->isWriterSleeping = false;
+    return ready;
+}
+
 template <typename T>
 uint32_t SharedDataStream<T>::BufferLayout::stableHash(const char* string) {
     // Simple, stable hash which XORs all bytes of string into the hash value.
@@ -349,23 +704,74 @@ size_t SharedDataStream<T>::BufferLayout::calculateReaderEnabledArrayOffset() {
 }
 
 template <typename T>
-size_t SharedDataStream<T>::BufferLayout::calculateReaderCursorArrayOffset(size_t maxReaders) {
-    return alignSizeTo(calculateReaderEnabledArrayOffset() + (maxReaders * sizeof(AtomicBool)), alignof(AtomicIndex));
+size_t SharedDataStream<T>::BufferLayout::calculateReaderCursorsArrayOffset(size_t maxReaders) {
+    return alignSizeTo(calculateReaderEnabledArrayOffset() + (maxReaders * sizeof(AtomicBool)), CACHE_LINE_SIZE);
 }
 
 template <typename T>
-size_t SharedDataStream<T>::BufferLayout::calculateReaderCloseIndexArrayOffset(size_t maxReaders) {
-    return calculateReaderCursorArrayOffset(maxReaders) + (maxReaders * sizeof(AtomicIndex));
+size_t SharedDataStream<T>::BufferLayout::calculateReaderWakeArrayOffset(size_t maxReaders) {
+    return calculateReaderCursorsArrayOffset(maxReaders) + (maxReaders * sizeof(ReaderCursors));
 }
 
 template <typename T>
 void SharedDataStream<T>::BufferLayout::calculateAndCacheConstants(size_t wordSize, size_t maxReaders) {
+    m_readerEnabledArray = reinterpret_cast<AtomicBool*>(m_header + calculateReaderEnabledArrayOffset());
+    m_readerCursorsArray = reinterpret_cast<ReaderCursors*>(m_header + calculateReaderCursorsArrayOffset(maxReaders));
+    m_readerWakeArray = reinterpret_cast<ReaderWake*>(m_header + calculateReaderWakeArrayOffset(maxReaders));
+    m_data = m_header + calculateDataOffset(maxReaders);
+
+    // The data size is the largest power of two which fits, so that indexes wrap with a mask.
+    auto buffer = reinterpret_cast<uint8_t*>(m_buffer->data());
+    Index wordsInBuffer = (m_buffer->size() - (m_data - buffer)) / wordSize;
+    m_dataSize = roundUpToPowerOfTwo(wordsInBuffer);
+    if (m_dataSize > wordsInBuffer) {
+        m_dataSize >>= 1;
+    }
+    // A buffer sized by calculateBufferSize() only has the slack left for aligning the header on a cache line.
+    if ((wordsInBuffer - m_dataSize) * wordSize > CACHE_LINE_SIZE) {
+        LOG_WARN << "calculateAndCacheConstants, reason: dataTruncatedToPowerOfTwo, wordsInBuffer: " << wordsInBuffer
+                 << ", dataSize: " << m_dataSize;
+    }
+    m_dataMask = m_dataSize - 1;
+    m_wordSize = wordSize;
+    m_isSingleReader = (1 == maxReaders);
+}
+
+template <typename T>
+uint8_t SharedDataStream<T>::BufferLayout::getLegacyVersion() const {
+    // Layouts before version 4 put the header at the start of the buffer instead of on a cache line boundary.  All
+    // versions start with the 32-bit magic number followed by the 8-bit version.
     auto buffer = reinterpret_cast<uint8_t*>(m_buffer->data());
-    m_readerEnabledArray = reinterpret_cast<AtomicBool*>(buffer + calculateReaderEnabledArrayOffset());
-    m_readerCursorArray = reinterpret_cast<AtomicIndex*>(buffer + calculateReaderCursorArrayOffset(maxReaders));
-    m_readerCloseIndexArray = reinterpret_cast<AtomicIndex*>(buffer + calculateReaderCloseIndexArrayOffset(maxReaders));
-    m_dataSize = (m_buffer->size() - calculateDataOffset(wordSize, maxReaders)) / wordSize;
-    m_data = buffer + calculateDataOffset(wordSize, maxReaders);
+    uint32_t magic = 0;
+    if (buffer == m_header || m_buffer->size() <= sizeof(magic)) {
+        return 0;
+    }
+    memcpy(&magic, buffer, sizeof(magic));
+    return MAGIC_NUMBER == magic ? buffer[sizeof(magic)] : 0;
+}
+
+template <typename T>
+bool SharedDataStream<T>::BufferLayout::verifyHeader() const {
+    auto header = getHeader();
+    if (header->magic != MAGIC_NUMBER) {
+        auto legacyVersion = getLegacyVersion();
+        if (legacyVersion) {
+            LOG_ERROR << "verifyHeaderFailed, reason: incompatibleVersion, version: "
+                      << static_cast<int>(legacyVersion);
+        } else {
+            LOG_ERROR <<  "verifyHeaderFailed, reason: magicnumber";
+        }
+        return false;
+    }
+    if (header->version != VERSION) {
+        LOG_ERROR << "verifyHeaderFailed, reason: incompatibleVersion, version: " << static_cast<int>(header->version);
+        return false;
+    }
+    if (header->traitsNameHash != stableHash(T::traitsName)) {
+        LOG_ERROR <<  "verifyHeaderFailed, reason: traitsNameHashMismatch";
+        return false;
+    }
+    return true;
 }
 
 template <typename T>
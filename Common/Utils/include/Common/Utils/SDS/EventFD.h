@@ -0,0 +1,54 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_EVENTFD_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_EVENTFD_H_
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cstdint>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace sds {
+
+/**
+ * Creates a non-blocking eventfd, for a @c Reader to hand to a poll loop.
+ *
+ * @return The new file descriptor, or -1 if there was an error (see @c errno).
+ */
+inline int eventFDCreate() {
+    return eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+/**
+ * Makes an eventfd readable.
+ *
+ * @param fd The eventfd to signal.
+ */
+inline void eventFDSignal(int fd) {
+    uint64_t one = 1;
+    // The only failure on a valid eventfd is a counter overflow, which still leaves it readable.
+    if (::write(fd, &one, sizeof(one)) < 0) {
+        return;
+    }
+}
+
+/**
+ * Clears the signals of an eventfd, so that it is no longer readable.
+ *
+ * @param fd The eventfd to drain.
+ */
+inline void eventFDDrain(int fd) {
+    uint64_t count;
+    // The whole counter is read at once, and a non-blocking read of an unsignalled eventfd fails with EAGAIN.
+    if (::read(fd, &count, sizeof(count)) < 0) {
+        return;
+    }
+}
+
+} // namespace sds
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_EVENTFD_H_
@@ -0,0 +1,62 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_FILEBACKEDSDS_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_FILEBACKEDSDS_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "InterProcessSDS.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace sds {
+
+/**
+ * Structure for specifying the traits of a SharedDataStream kept in a memory-mapped regular file.  The primitives are
+ * the inter-process ones, since other processes may map the same file; the file adds persistence.
+ */
+struct FileBackedSDSTraits {
+    /// A lock-free std::atomic only touches the memory it lives in, so it can be stored in the file.
+    using AtomicIndex = std::atomic<uint64_t>;
+
+    /// A lock-free std::atomic only touches the memory it lives in, so it can be stored in the file.
+    using AtomicBool = std::atomic<bool>;
+
+    /// A mapping of a regular file (see @c SharedMemoryBuffer::createFile() and @c SharedMemoryBuffer::openFile()).
+    using Buffer = SharedMemoryBuffer;
+
+    /// A process-shared, robust pthread mutex.
+    using Mutex = ProcessSharedMutex;
+
+    /// A process-shared pthread condition variable.
+    using ConditionVariable = ProcessSharedConditionVariable;
+
+    /// A unique identifier representing this combination of traits.
+    static constexpr const char* traitsName = "deviceClientSDK::common::utils::sds::FileBackedSDSTraits";
+};
+
+/**
+ * Type alias for a SharedDataStream kept in a memory-mapped file, which survives the processes using it: a rolling
+ * capture of the last @c getDataSize() words written, which the page cache writes back to disk without any copy in
+ * userland.  After a crash or a restart, @c recover() re-attaches to the file left behind and validates its header;
+ * if that fails, the file is recreated:
+ *
+ * @code
+ *     auto buffer = SharedMemoryBuffer::openFile(path);
+ *     auto stream = buffer ? FileBackedSDS::recover(buffer) : nullptr;
+ *     if (!stream) {
+ *         buffer = SharedMemoryBuffer::createFile(path, FileBackedSDS::calculateBufferSize(nWords, wordSize));
+ *         stream = FileBackedSDS::create(buffer, wordSize);
+ *     }
+ * @endcode
+ *
+ * Other processes can @c open() a @c SharedMemoryBuffer mapping the same file while the stream is in use.
+ */
+using FileBackedSDS = SharedDataStream<FileBackedSDSTraits>;
+
+} // namespace sds
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_FILEBACKEDSDS_H_
@@ -0,0 +1,73 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_FUTEX_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_FUTEX_H_
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace sds {
+
+/**
+ * Returns the 32-bit word holding the low half of a 64-bit atomic index.  A futex can only wait on 32 bits, and the
+ * low half is the part of an index which changes on every increment.
+ *
+ * @param index The 64-bit atomic index.
+ * @return The address of its low 32 bits.
+ */
+template <typename AtomicIndex>
+inline uint32_t* futexWord(AtomicIndex* index) {
+    static_assert(sizeof(AtomicIndex) == sizeof(uint64_t), "futexWord() needs a 64-bit atomic index");
+    auto word = reinterpret_cast<uint32_t*>(index);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    ++word;
+#endif
+    return word;
+}
+
+/**
+ * Sleeps until @c futexWake() is called on @c word, unless @c word no longer holds @c expected.  The futex is not
+ * private to the process, so it works on memory shared between processes.
+ *
+ * @param word The word to wait on.
+ * @param expected The value @c word held when the caller decided to sleep.
+ * @param timeout The maximum time to sleep, or zero to sleep until woken.
+ * @return @c false if the timeout expired, else @c true (including spurious and no-sleep returns).
+ */
+inline bool futexWait(uint32_t* word, uint32_t expected, std::chrono::nanoseconds timeout) {
+    timespec relative;
+    timespec* relativePtr = nullptr;
+    if (timeout > std::chrono::nanoseconds::zero()) {
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+        relative.tv_sec = seconds.count();
+        relative.tv_nsec = (timeout - seconds).count();
+        relativePtr = &relative;
+    }
+    if (syscall(SYS_futex, word, FUTEX_WAIT, expected, relativePtr, nullptr, 0) < 0 && ETIMEDOUT == errno) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Wakes every thread sleeping in @c futexWait() on @c word.
+ *
+ * @param word The word to wake the sleepers of.
+ */
+inline void futexWake(uint32_t* word) {
+    syscall(SYS_futex, word, FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+}
+
+} // namespace sds
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_FUTEX_H_
@@ -0,0 +1,307 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_INTERPROCESSSDS_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_INTERPROCESSSDS_H_
+
+#include <pthread.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+
+#include "SharedDataStream.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace sds {
+
+/**
+ * A mutex which can be placed in memory shared between processes.  It wraps a process-shared, robust
+ * @c pthread_mutex_t: if a process dies while holding the lock, the next process to lock it takes it over instead of
+ * deadlocking.
+ */
+class ProcessSharedMutex {
+public:
+    /// Initializes the mutex in place.  This must only be done once, by the process which creates the stream.
+    ProcessSharedMutex();
+
+    /// Destroys the mutex.  This must only be done once, when the last process detaches from the stream.
+    ~ProcessSharedMutex();
+
+    /// Waits indefinitely for the mutex to unlock and then locks the mutex.
+    void lock();
+
+    /**
+     * Locks the mutex if it is not already locked.
+     *
+     * @return @c true if the mutex was locked, else @c false.
+     */
+    bool try_lock();
+
+    /// Unlocks the mutex.
+    void unlock();
+
+    /// Returns the underlying @c pthread_mutex_t.
+    pthread_mutex_t* native_handle();
+
+private:
+    ProcessSharedMutex(const ProcessSharedMutex&) = delete;
+    ProcessSharedMutex& operator=(const ProcessSharedMutex&) = delete;
+
+    /// The underlying mutex.
+    pthread_mutex_t m_mutex;
+};
+
+/**
+ * A condition variable working with @c ProcessSharedMutex, which can be placed in memory shared between processes.
+ * Timed waits are measured against @c CLOCK_MONOTONIC.
+ */
+class ProcessSharedConditionVariable {
+public:
+    /// Initializes the condition variable in place.  This must only be done once, by the process which creates it.
+    ProcessSharedConditionVariable();
+
+    /// Destroys the condition variable.  This must only be done once, when the last process detaches from it.
+    ~ProcessSharedConditionVariable();
+
+    /// Unblocks one of the threads waiting for this condition variable.
+    void notify_one();
+
+    /// Unblocks all the threads waiting for this condition variable.
+    void notify_all();
+
+    /**
+     * Waits indefinitely for a notification.
+     *
+     * @param lock A lock held on the @c ProcessSharedMutex protecting the condition.
+     */
+    void wait(std::unique_lock<ProcessSharedMutex>& lock);
+
+    /**
+     * Waits indefinitely for @c predicate to be satisfied.
+     *
+     * @param lock A lock held on the @c ProcessSharedMutex protecting the condition.
+     * @param predicate The condition to wait for.
+     */
+    template <typename Predicate>
+    void wait(std::unique_lock<ProcessSharedMutex>& lock, Predicate predicate);
+
+    /**
+     * Waits up to @c timeout for @c predicate to be satisfied.
+     *
+     * @param lock A lock held on the @c ProcessSharedMutex protecting the condition.
+     * @param timeout The maximum time to wait.
+     * @param predicate The condition to wait for.
+     * @return The value of @c predicate when the wait ended.
+     */
+    template <typename Rep, typename Period, typename Predicate>
+    bool wait_for(
+        std::unique_lock<ProcessSharedMutex>& lock,
+        const std::chrono::duration<Rep, Period>& timeout,
+        Predicate predicate);
+
+private:
+    ProcessSharedConditionVariable(const ProcessSharedConditionVariable&) = delete;
+    ProcessSharedConditionVariable& operator=(const ProcessSharedConditionVariable&) = delete;
+
+    /**
+     * Waits for a notification until @c deadline (a @c CLOCK_MONOTONIC time).
+     *
+     * @param lock A lock held on the @c ProcessSharedMutex protecting the condition.
+     * @param deadline The time to stop waiting.
+     * @return @c false if the deadline passed, else @c true.
+     */
+    bool waitUntil(std::unique_lock<ProcessSharedMutex>& lock, const timespec& deadline);
+
+    /**
+     * Computes the @c CLOCK_MONOTONIC time @c timeout from now.
+     *
+     * @param timeout The offset from now.
+     * @return The deadline.
+     */
+    static timespec deadlineFromNow(std::chrono::nanoseconds timeout);
+
+    /// The underlying condition variable.
+    pthread_cond_t m_conditionVariable;
+};
+
+/**
+ * A @c Buffer for a @c SharedDataStream which is mapped from a shared memory object, so that streams in several
+ * processes can @c create() and @c open() the same data.  The memory is either a named POSIX shared memory object
+ * (@c shm_open()), an anonymous memfd whose file descriptor is handed to the other processes (by inheritance or
+ * over a unix domain socket), or a regular file, whose contents outlive the processes (see @c FileBackedSDS).
+ */
+class SharedMemoryBuffer {
+public:
+    /**
+     * Creates a new named shared memory object and maps it.
+     *
+     * @param name The name of the object, starting with a '/' (see @c shm_open()).  It must not already exist.
+     * @param size The size of the buffer in bytes (see @c SharedDataStream::calculateBufferSize()).
+     * @return The new buffer, nullptr if there was an error creating it.
+     */
+    static std::shared_ptr<SharedMemoryBuffer> create(const std::string& name, size_t size);
+
+    /**
+     * Maps an existing named shared memory object created by @c create().
+     *
+     * @param name The name of the object.
+     * @return The buffer, nullptr if there was an error opening it.
+     */
+    static std::shared_ptr<SharedMemoryBuffer> open(const std::string& name);
+
+    /**
+     * Creates a new anonymous shared memory object with @c memfd_create() and maps it.  Use @c getFD() to share it.
+     *
+     * @param size The size of the buffer in bytes (see @c SharedDataStream::calculateBufferSize()).
+     * @return The new buffer, nullptr if there was an error creating it.
+     */
+    static std::shared_ptr<SharedMemoryBuffer> createAnonymous(size_t size);
+
+    /**
+     * Maps the shared memory object behind a file descriptor received from another process.  The buffer takes
+     * ownership of @c fd.
+     *
+     * @param fd A file descriptor returned by @c getFD() in another process.
+     * @return The buffer, nullptr if there was an error mapping it.
+     */
+    static std::shared_ptr<SharedMemoryBuffer> fromFD(int fd);
+
+    /**
+     * Creates a regular file, or truncates an existing one, and maps it.  The file starts out zeroed.
+     *
+     * @param path The path of the file.
+     * @param size The size of the buffer in bytes (see @c SharedDataStream::calculateBufferSize()).
+     * @return The new buffer, nullptr if there was an error creating it.
+     */
+    static std::shared_ptr<SharedMemoryBuffer> createFile(const std::string& path, size_t size);
+
+    /**
+     * Maps an existing regular file, keeping its contents.
+     *
+     * @param path The path of the file.
+     * @return The buffer, nullptr if there was an error opening it.
+     */
+    static std::shared_ptr<SharedMemoryBuffer> openFile(const std::string& path);
+
+    /// Unmaps the buffer and closes its file descriptor.  Named objects are not unlinked; see @c unlink().
+    ~SharedMemoryBuffer();
+
+    /**
+     * Removes a named shared memory object.  Processes which have mapped it keep their mapping.
+     *
+     * @param name The name of the object.
+     * @return @c true if the object was removed, else @c false.
+     */
+    static bool unlink(const std::string& name);
+
+    /// Returns the first byte of the mapping.
+    uint8_t* data();
+
+    /// Returns the size of the mapping in bytes.
+    size_t size() const;
+
+    /// Returns the file descriptor of the shared memory object.
+    int getFD() const;
+
+    /**
+     * Writes the mapping back to the file behind it and waits for the write to complete.  The kernel writes dirty
+     * pages back on its own, so this is only needed to bound what a power loss can take away.
+     *
+     * @return @c true if the mapping was written back, else @c false.
+     */
+    bool sync();
+
+private:
+    /**
+     * Constructor.
+     *
+     * @param fd The file descriptor of the shared memory object.
+     * @param data The mapping of the object.
+     * @param size The size of the mapping in bytes.
+     */
+    SharedMemoryBuffer(int fd, uint8_t* data, size_t size);
+
+    /**
+     * Maps @c fd and wraps it into a @c SharedMemoryBuffer.  On failure @c fd is closed.
+     *
+     * @param fd The file descriptor of the shared memory object.
+     * @param size The size to map, or zero to map the current size of the object.
+     * @return The buffer, nullptr if there was an error mapping it.
+     */
+    static std::shared_ptr<SharedMemoryBuffer> map(int fd, size_t size);
+
+    /// The file descriptor of the shared memory object.
+    int m_fd;
+
+    /// The mapping of the shared memory object.
+    uint8_t* m_data;
+
+    /// The size of the mapping in bytes.
+    size_t m_size;
+};
+
+/// Structure for specifying the traits of a SharedDataStream which works between processes.
+struct InterProcessSDSTraits {
+    /// A lock-free std::atomic only touches the shared memory it lives in, so it works between processes.
+    using AtomicIndex = std::atomic<uint64_t>;
+
+    /// A lock-free std::atomic only touches the shared memory it lives in, so it works between processes.
+    using AtomicBool = std::atomic<bool>;
+
+    /// A mapping of a shared memory object holds the header and data seen by every process.
+    using Buffer = SharedMemoryBuffer;
+
+    /// A process-shared, robust pthread mutex.
+    using Mutex = ProcessSharedMutex;
+
+    /// A process-shared pthread condition variable.
+    using ConditionVariable = ProcessSharedConditionVariable;
+
+    /// A unique identifier representing this combination of traits.
+    static constexpr const char* traitsName = "deviceClientSDK::common::utils::sds::InterProcessSDSTraits";
+};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "InterProcessSDS needs lock-free 64-bit atomics");
+static_assert(ATOMIC_BOOL_LOCK_FREE == 2, "InterProcessSDS needs lock-free boolean atomics");
+static_assert(std::is_standard_layout<ProcessSharedMutex>::value, "ProcessSharedMutex must be shareable");
+static_assert(
+    std::is_standard_layout<ProcessSharedConditionVariable>::value,
+    "ProcessSharedConditionVariable must be shareable");
+
+/**
+ * Type alias for a SharedDataStream which works between processes.  One process calls @c create() on a
+ * @c SharedMemoryBuffer, and the others @c open() a @c SharedMemoryBuffer mapping the same shared memory object.
+ */
+using InterProcessSDS = SharedDataStream<InterProcessSDSTraits>;
+
+template <typename Predicate>
+void ProcessSharedConditionVariable::wait(std::unique_lock<ProcessSharedMutex>& lock, Predicate predicate) {
+    while (!predicate()) {
+        wait(lock);
+    }
+}
+
+template <typename Rep, typename Period, typename Predicate>
+bool ProcessSharedConditionVariable::wait_for(
+    std::unique_lock<ProcessSharedMutex>& lock,
+    const std::chrono::duration<Rep, Period>& timeout,
+    Predicate predicate) {
+    auto deadline = deadlineFromNow(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout));
+    while (!predicate()) {
+        if (!waitUntil(lock, deadline)) {
+            return predicate();
+        }
+    }
+    return true;
+}
+
+} // namespace sds
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
+
+#endif // DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_INTERPROCESSSDS_H_
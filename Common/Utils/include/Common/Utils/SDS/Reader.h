@@ -1,14 +1,20 @@
 #ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_READER_H_
 #define DEVICE_CLIENT_SDK_COMMON_UTILS_SDS_READER_H_
 
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
 #include <cstdint>
 #include <cstddef>
 #include <vector>
 #include <mutex>
 #include <limits>
 #include <cstring>
+#include <thread>
 
 #include "Common/Utils/Logger/Log.h"
+#include "EventFD.h"
 #include "SharedDataStream.h"
 #include "ReaderPolicy.h"
 
@@ -100,6 +106,71 @@ public:
      */
     ssize_t read(void* buf, size_t nWords, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
 
+    /**
+     * A contiguous, read-only region of the stream's data, as handed out by @c borrow().
+     */
+    struct Span {
+        /// Pointer to the first byte of the region.
+        const uint8_t* data;
+        /// The number of @c wordSize words in the region.
+        size_t nWords;
+    };
+
+    /**
+     * This function gives the caller direct, read-only access to the next data in the stream, instead of copying it
+     * to a caller buffer as @c read() does.  Because the stream is a ring, the data may be split at the wrap;
+     * @c first receives the part before the wrap and @c second the part after it (with `second->nWords == 0` if the
+     * data does not wrap).  The data stays unconsumed, and the @c Reader does not move, until @c release() is called.
+     * The @c Policy and @c timeout apply as they do for @c read().
+     *
+     * @param nWords The maximum number of @c wordSize words to borrow.
+     * @param[out] first The part of the borrowed data before the wrap.
+     * @param[out] second The part of the borrowed data after the wrap.
+     * @param timeout The maximum time to wait (if @c policy is @c BLOCKING) for data.  If this parameter is zero,
+     *     there is no timeout and blocking borrows will wait forever.  If @c policy is @c NONBLOCKING, this parameter
+     *     is ignored.
+     * @return The number of @c wordSize words borrowed, or zero if the stream has closed, or a negative @c Error code
+     *     if the stream is still open, but no data could be borrowed.
+     *
+     * @note Borrowed data is protected from a @c BLOCKING or @c ALL_OR_NOTHING @c Writer, but a @c NONBLOCKABLE
+     *     @c Writer may overwrite it while it is borrowed.  @c release() reports this with @c Error::OVERRUN, in which
+     *     case whatever the caller did with the data must be discarded.
+     * @note Only one borrow can be outstanding at a time, and @c read() can not be called while it is.
+     */
+    ssize_t borrow(
+        size_t nWords,
+        Span* first,
+        Span* second,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    /**
+     * This function consumes the first @c nWords words of the outstanding borrow, moving the @c Reader past them, and
+     * gives the rest back to the stream.
+     *
+     * @param nWords The number of @c wordSize words to consume.  This can be less than the number of words borrowed
+     *     (including zero, which consumes nothing).
+     * @return The number of @c wordSize words consumed, or a negative @c Error code: @c Error::OVERRUN if the borrowed
+     *     data was overwritten while it was borrowed, or @c Error::INVALID if there is no outstanding borrow or
+     *     @c nWords is larger than it.
+     */
+    ssize_t release(size_t nWords);
+
+    /**
+     * This function sets how much data a @c BLOCKING @c read() or @c borrow() waits for before it returns.  By
+     * default a blocked @c Reader is woken up by every write; with a watermark, the @c Writer only wakes it up once
+     * @c minWords words are available, so a @c Reader consuming large blocks is not woken up for every small write.
+     *
+     * The wait is cut short when the @c Writer closes, at the @c Reader's close index, when fewer words were
+     * requested, and once @c maxLatency has passed with at least one word available.  When a wait ends early, or the
+     * @c read() timeout expires with data available, the data available is returned.
+     *
+     * @param minWords The number of @c wordSize words to wait for.  This must be between 1 and the stream's data size.
+     * @param maxLatency The maximum time to hold back available data waiting for @c minWords, or zero to wait for
+     *     @c minWords regardless.
+     * @return @c true if the watermark was set, else @c false.
+     */
+    bool setWakeWatermark(size_t minWords, std::chrono::milliseconds maxLatency = std::chrono::milliseconds::zero());
+
     /**
      * This function moves the @c Reader to the specified location in the stream.  If successful, subsequent calls to
      * @c read() will start from the new location.  For this function to succeed, the specified location *must* point
@@ -160,6 +231,22 @@ public:
      */
     size_t getWordSize() const;
 
+    /**
+     * This function returns a file descriptor which becomes readable when this @c Reader has data to read, so that a
+     * single thread can wait for many streams with @c poll(), @c epoll or an event loop such as GLib's, instead of
+     * blocking one thread in @c read() per stream.  It is meant for a @c NONBLOCKING @c Reader: when readable, call
+     * @c read() or @c borrow() until they return @c Error::WOULDBLOCK, which rearms the descriptor.  The @c Writer
+     * signals it once the wake watermark is available (see @c setWakeWatermark()), or when it closes.
+     *
+     * The descriptor is created on the first call, and closed with the @c Reader; the caller must not close it.
+     *
+     * @return The file descriptor, or -1 if it could not be created.
+     *
+     * @note The @c Writer can only signal the descriptor from the process which called this function.  The
+     *     @c maxLatency of the watermark is not applied; use the timeout of the poll instead.
+     */
+    int getEventFD();
+
     /**
      * Returns the text of an error code.
      *
@@ -173,6 +260,26 @@ private:
      */
     static const std::string TAG;
 
+    /**
+     * Waits for @c writeStartCursor to reach @c wakeIndex or the @c Writer to close, registering @c wakeIndex so that
+     * the @c Writer does not wake this @c Reader before then.
+     *
+     * @param wakeIndex The stream index to wait for.
+     * @param timeout The maximum time to wait, or zero to wait forever.
+     * @param lock A lock held on @c dataAvailableMutex (unused by single-reader streams).
+     * @return @c true if the wait ended because @c wakeIndex was reached or the @c Writer closed, else @c false.
+     */
+    bool waitForData(Index wakeIndex, std::chrono::milliseconds timeout, std::unique_lock<Mutex>* lock);
+
+    /**
+     * Clears the eventfd and arms it for the @c Writer to signal once the wake watermark is available.  If the data is
+     * already there, the eventfd is signalled straight away.
+     */
+    void armEventFD();
+
+    /// Withdraws the eventfd from the @c Writer, waiting for a signal in flight if need be, and closes it.
+    void closeEventFD();
+
     /// The @c Policy to use for reading from the stream.
     Policy m_policy;
 
@@ -180,16 +287,31 @@ private:
     std::shared_ptr<BufferLayout> m_bufferLayout;
 
     /**
-     * The index in @c BufferLayout::getReaderCursorArray() and @c BufferLayout::getReaderCloseIndexArray() assigned to
-     * this @c Reader.
+     * The index in @c BufferLayout::getReaderCursor() and @c BufferLayout::getReaderCloseIndex() assigned to this
+     * @c Reader.
      */
     uint8_t m_id;
 
-    /// Pointer to this reader's cursor in BufferLayout::getReaderCursorArray().
+    /// Pointer to this reader's cursor, from BufferLayout::getReaderCursor().
     AtomicIndex* m_readerCursor;
 
-    /// Pointer to this reader's close index in BufferLayout::getReaderCloseIndexArray().
+    /// Pointer to this reader's close index, from BufferLayout::getReaderCloseIndex().
     AtomicIndex* m_readerCloseIndex;
+
+    /// The number of words handed out by @c borrow() which have not yet been passed to @c release().
+    size_t m_borrowedWords;
+
+    /// Flag indicating that a borrow made by @c borrow() is outstanding.
+    bool m_hasBorrow;
+
+    /// The number of words a @c BLOCKING read waits for; see @c setWakeWatermark().
+    size_t m_wakeWatermark;
+
+    /// The maximum time to hold back available data waiting for @c m_wakeWatermark words, or zero for no limit.
+    std::chrono::milliseconds m_maxLatency;
+
+    /// The eventfd handed out by @c getEventFD(), or -1 if there is none.
+    int m_eventFD;
 };
 
 template <typename T>
@@ -200,27 +322,42 @@ SharedDataStream<T>::Reader::Reader(Policy policy, std::shared_ptr<BufferLayout>
         m_policy{policy},
         m_bufferLayout{bufferLayout},
         m_id{id},
-        m_readerCursor{&m_bufferLayout->getReaderCursorArray()[m_id]},
-        m_readerCloseIndex{&m_bufferLayout->getReaderCloseIndexArray()[m_id]} {
+        m_readerCursor{m_bufferLayout->getReaderCursor(m_id)},
+        m_readerCloseIndex{m_bufferLayout->getReaderCloseIndex(m_id)},
+        m_borrowedWords{0},
+        m_hasBorrow{false},
+        m_wakeWatermark{1},
+        m_maxLatency{std::chrono::milliseconds::zero()},
+        m_eventFD{-1} {
     // Note - SharedDataStream::createReader() holds readerEnableMutex while calling this function.
     // Read new data only.
-    // Note: It is important that new readers start with their cursor at the writer.  This allows
-    // updateOldestUnconsumedCursor() to be thread-safe without holding readerEnableMutex.  See
-    // updateOldestUnconsumedCursor() comments for further explanation.
+    // Note: It is important that new readers start with their cursor at the writer.  This allows the Writer's scan of
+    // the reader cursors to be thread-safe without holding readerEnableMutex.  See
+    // BufferLayout::findOldestReaderCursor() comments for further explanation.
     *m_readerCursor = m_bufferLayout->getHeader()->writeStartCursor.load();
 
     // Read indefinitely.
     *m_readerCloseIndex = std::numeric_limits<Index>::max();
 
+    // No eventfd until getEventFD() is called.
+    auto wake = m_bufferLayout->getReaderWake(m_id);
+    wake->eventFD = 0;
+    wake->eventState = BufferLayout::EVENT_DISARMED;
+
     m_bufferLayout->enableReaderLocked(m_id);
 }
 
 template <typename T>
 SharedDataStream<T>::Reader::~Reader() {
-    // Note: We can't leave a reader with its cursor in the future; doing so can introduce a race condition in
-    // updateOldestUnconsumedCursor().  See updateOldestUnconsumedCursor() comments for further explanation.
+    // Note: We can't leave a reader with its cursor in the future; doing so can introduce a race condition in the
+    // Writer's scan of the reader cursors.  See BufferLayout::findOldestReaderCursor() comments for further
+    // explanation.
     seek(0, Reference::BEFORE_WRITER);
 
+    if (m_eventFD >= 0) {
+        closeEventFD();
+    }
+
     std::lock_guard<Mutex> lock(m_bufferLayout->getHeader()->readerEnableMutex);
     m_bufferLayout->disableReaderLocked(m_id);
     m_bufferLayout->updateOldestUnconsumedCursor();
@@ -238,6 +375,50 @@ ssize_t SharedDataStream<T>::Reader::read(void* buf, size_t nWords, std::chrono:
         return Error::INVALID;
     }
 
+    if (m_hasBorrow) {
+        LOG_ERROR << "readFailed; reason: borrowOutstanding";
+        return Error::INVALID;
+    }
+
+    Span first;
+    Span second;
+    ssize_t borrowed = borrow(nWords, &first, &second, timeout);
+    if (borrowed <= 0) {
+        return borrowed;
+    }
+
+    // Copy the two segments.
+    auto buf8 = static_cast<uint8_t*>(buf);
+    memcpy(buf8, first.data, first.nWords * getWordSize());
+    if (second.nWords > 0) {
+        memcpy(buf8 + (first.nWords * getWordSize()), second.data, second.nWords * getWordSize());
+    }
+
+    // Advance the read cursor.
+    return release(borrowed);
+}
+
+template <typename T>
+ssize_t SharedDataStream<T>::Reader::borrow(
+    size_t nWords,
+    Span* first,
+    Span* second,
+    std::chrono::milliseconds timeout) {
+    if (nullptr == first || nullptr == second) {
+        LOG_ERROR << "borrowFailed; reason: nullSpan";
+        return Error::INVALID;
+    }
+
+    if (0 == nWords) {
+        LOG_ERROR << "borrowFailed; reason: invalidNumWords";
+        return Error::INVALID;
+    }
+
+    if (m_hasBorrow) {
+        LOG_ERROR << "borrowFailed; reason: borrowOutstanding";
+        return Error::INVALID;
+    }
+
     // Check if closed.
     auto readerCloseIndex = m_readerCloseIndex->load();
     if (*m_readerCursor >= readerCloseIndex) {
@@ -251,27 +432,59 @@ ssize_t SharedDataStream<T>::Reader::read(void* buf, size_t nWords, std::chrono:
         return Error::OVERRUN;
     }
 
+    // A single-reader stream does not need the lock; see waitForSequence().
     std::unique_lock<Mutex> lock(header->dataAvailableMutex, std::defer_lock);
-    if (Policy::BLOCKING == m_policy) {
+    if (Policy::BLOCKING == m_policy && !m_bufferLayout->isSingleReader()) {
         lock.lock();
     }
 
-    // Figure out how much we can actually copy.
+    // Figure out how much we can actually hand out.
     size_t wordsAvailable = tell(Reference::BEFORE_WRITER);
     if (0 == wordsAvailable) {
         if (header->writeEndCursor > 0 && !header->isWriterEnabled) {
             return Error::CLOSED;
         } else if (Policy::NONBLOCKING == m_policy) {
+            if (m_eventFD >= 0) {
+                armEventFD();
+            }
             return Error::WOULDBLOCK;
-        } else if (Policy::BLOCKING == m_policy) {
-            // Condition for returning from read: the Writer has been closed or there is data to read
-            auto predicate = [this, header] {
-                return header->hasWriterBeenClosed || tell(Reference::BEFORE_WRITER) > 0;
-            };
-
-            if (std::chrono::milliseconds::zero() == timeout) {
-                header->dataAvailableConditionVariable.wait(lock, predicate);
-            } else if (!header->dataAvailableConditionVariable.wait_for(lock, timeout, predicate)) {
+        }
+    }
+
+    // Figure out how much to wait for: the watermark, unless less was asked for or the close index comes first.
+    size_t wordsWanted = m_wakeWatermark;
+    if (wordsWanted > nWords) {
+        wordsWanted = nWords;
+    }
+    if (wordsWanted > readerCloseIndex - *m_readerCursor) {
+        wordsWanted = readerCloseIndex - *m_readerCursor;
+    }
+
+    if (Policy::BLOCKING == m_policy && wordsAvailable < wordsWanted) {
+        // Wait for the watermark, but only up to the max latency if that comes before the timeout.
+        auto start = std::chrono::steady_clock::now();
+        auto wait = timeout;
+        bool limitedByLatency = false;
+        if (m_maxLatency != std::chrono::milliseconds::zero() &&
+            (std::chrono::milliseconds::zero() == timeout || m_maxLatency < timeout)) {
+            wait = m_maxLatency;
+            limitedByLatency = true;
+        }
+        if (!waitForData(*m_readerCursor + wordsWanted, wait, &lock) && 0 == tell(Reference::BEFORE_WRITER)) {
+            if (!limitedByLatency) {
+                return Error::TIMEDOUT;
+            }
+
+            // The max latency passed without any data; any data will do from now on.
+            auto remaining = timeout;
+            if (timeout != std::chrono::milliseconds::zero()) {
+                remaining -= std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start);
+                if (remaining <= std::chrono::milliseconds::zero()) {
+                    return Error::TIMEDOUT;
+                }
+            }
+            if (!waitForData(*m_readerCursor + 1, remaining, &lock)) {
                 return Error::TIMEDOUT;
             }
         }
@@ -283,7 +496,7 @@ ssize_t SharedDataStream<T>::Reader::read(void* buf, size_t nWords, std::chrono:
         }
     }
 
-    if (Policy::BLOCKING == m_policy) {
+    if (lock) {
         lock.unlock();
     }
     if (nWords > wordsAvailable) {
@@ -300,26 +513,42 @@ ssize_t SharedDataStream<T>::Reader::read(void* buf, size_t nWords, std::chrono:
     if (beforeWrap > nWords) {
         beforeWrap = nWords;
     }
-    size_t afterWrap = nWords - beforeWrap;
+    first->data = m_bufferLayout->getData(*m_readerCursor);
+    first->nWords = beforeWrap;
+    second->data = m_bufferLayout->getData(*m_readerCursor + beforeWrap);
+    second->nWords = nWords - beforeWrap;
 
-    // Copy the two segments.
-    auto buf8 = static_cast<uint8_t*>(buf);
-    memcpy(buf8, m_bufferLayout->getData(*m_readerCursor), beforeWrap * getWordSize());
-    if (afterWrap > 0) {
-        memcpy(
-            buf8 + (beforeWrap * getWordSize()),
-            m_bufferLayout->getData(*m_readerCursor + beforeWrap),
-            afterWrap * getWordSize());
+    m_borrowedWords = nWords;
+    m_hasBorrow = true;
+    return nWords;
+}
+
+template <typename T>
+ssize_t SharedDataStream<T>::Reader::release(size_t nWords) {
+    if (!m_hasBorrow) {
+        LOG_ERROR << "releaseFailed; reason: noBorrow";
+        return Error::INVALID;
+    }
+    if (nWords > m_borrowedWords) {
+        LOG_ERROR << "releaseFailed; reason: releaseExceedsBorrow";
+        return Error::INVALID;
     }
 
-    // Advance the read cursor.
-    *m_readerCursor += nWords;
+    m_hasBorrow = false;
+    m_borrowedWords = 0;
 
-    // Final check for overrun (do this before the updateOldestUnconsumedCursor() call below for improved accuracy).
+    // Check whether the writer has overwritten any of the data while it was borrowed (do this before moving the
+    // cursor below for improved accuracy).
+    auto header = m_bufferLayout->getHeader();
     bool overrun = ((header->writeEndCursor - *m_readerCursor) > m_bufferLayout->getDataSize());
 
-    // Move the unconsumed cursor before returning.
-    m_bufferLayout->updateOldestUnconsumedCursor();
+    // Advance the read cursor.
+    *m_readerCursor += nWords;
+
+    // Let a waiting Writer know it may have more room; it updates oldestUnconsumedCursor itself.
+    if (nWords > 0) {
+        m_bufferLayout->notifySpaceAvailable();
+    }
 
     // Now we can safely error out if there was an overrun.
     if (overrun) {
@@ -329,6 +558,106 @@ ssize_t SharedDataStream<T>::Reader::read(void* buf, size_t nWords, std::chrono:
     return nWords;
 }
 
+template <typename T>
+bool SharedDataStream<T>::Reader::setWakeWatermark(size_t minWords, std::chrono::milliseconds maxLatency) {
+    if (0 == minWords || minWords > m_bufferLayout->getDataSize()) {
+        LOG_ERROR << "setWakeWatermarkFailed; reason: invalidNumWords";
+        return false;
+    }
+    if (maxLatency < std::chrono::milliseconds::zero()) {
+        LOG_ERROR << "setWakeWatermarkFailed; reason: negativeMaxLatency";
+        return false;
+    }
+    m_wakeWatermark = minWords;
+    m_maxLatency = maxLatency;
+    return true;
+}
+
+template <typename T>
+bool SharedDataStream<T>::Reader::waitForData(
+    Index wakeIndex,
+    std::chrono::milliseconds timeout,
+    std::unique_lock<Mutex>* lock) {
+    auto header = m_bufferLayout->getHeader();
+    auto wake = m_bufferLayout->getReaderWake(m_id);
+
+    // The index is published before the sleeping flag, and the Writer checks them in the opposite order, so the
+    // Writer never compares writeStartCursor against the index of a previous wait.
+    wake->index = wakeIndex;
+    auto predicate = [header, wakeIndex] {
+        return header->hasWriterBeenClosed || header->writeStartCursor >= wakeIndex;
+    };
+
+    if (m_bufferLayout->isSingleReader()) {
+        return m_bufferLayout->waitForSequence(
+            &header->isReaderSleeping, &header->readerWakeSequence, timeout, predicate);
+    }
+
+    // The flag is raised while holding dataAvailableMutex, which the Writer holds while moving writeStartCursor.
+    wake->isSleeping = true;
+    bool ready = true;
+    if (std::chrono::milliseconds::zero() == timeout) {
+        wake->dataAvailableConditionVariable.wait(*lock, predicate);
+    } else {
+        ready = wake->dataAvailableConditionVariable.wait_for(*lock, timeout, predicate);
+    }
+    wake->isSleeping = false;
+    return ready;
+}
+
+template <typename T>
+void SharedDataStream<T>::Reader::armEventFD() {
+    auto header = m_bufferLayout->getHeader();
+    auto wake = m_bufferLayout->getReaderWake(m_id);
+
+    // Wait for the watermark, but not past the close index.
+    Index wakeIndex = *m_readerCursor + m_wakeWatermark;
+    if (wakeIndex > *m_readerCloseIndex) {
+        wakeIndex = *m_readerCloseIndex;
+    }
+
+    // As in waitForData(), the index is published before the descriptor is armed, and the Writer checks them in the
+    // opposite order.  A Writer which is signalling an earlier arming may still compare against the old index, so
+    // wait for it to finish (it is only a write() away).
+    wake->index = wakeIndex;
+    while (true) {
+        Index state = wake->eventState;
+        if (BufferLayout::EVENT_SIGNALLING != state &&
+            wake->eventState.compare_exchange_strong(state, BufferLayout::EVENT_ARMED)) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+
+    // Clear the earlier signals, so the descriptor only becomes readable again once there is more to read.  The
+    // Writer moves writeStartCursor before it checks the state, so if it signalled before the drain, or missed the
+    // arming altogether, the check below sees the move.
+    eventFDDrain(m_eventFD);
+    if (header->hasWriterBeenClosed || header->writeStartCursor >= wakeIndex) {
+        eventFDSignal(m_eventFD);
+    }
+}
+
+template <typename T>
+void SharedDataStream<T>::Reader::closeEventFD() {
+    auto wake = m_bufferLayout->getReaderWake(m_id);
+    wake->eventFD = 0;
+
+    // A Writer which has already started signalling holds on to the old descriptor until it moves the state back to
+    // disarmed, which is only a write() away.
+    while (true) {
+        Index state = wake->eventState;
+        if (BufferLayout::EVENT_SIGNALLING != state &&
+            wake->eventState.compare_exchange_strong(state, BufferLayout::EVENT_DISARMED)) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+
+    ::close(m_eventFD);
+    m_eventFD = -1;
+}
+
 template <typename T>
 bool SharedDataStream<T>::Reader::seek(Index offset, Reference reference) {
     auto header = m_bufferLayout->getHeader();
@@ -364,8 +693,8 @@ bool SharedDataStream<T>::Reader::seek(Index offset, Reference reference) {
         return false;
     }
 
-    // Per documentation of updateOldestUnconsumedCursor(), don't try to seek backwards while oldestConsumedCursor is
-    // being updated.
+    // Per documentation of BufferLayout::findOldestReaderCursor(), don't try to seek backwards while
+    // oldestUnconsumedCursor is being updated.
     bool backward = absolute < *m_readerCursor;
     std::unique_lock<Mutex> lock(header->backwardSeekMutex, std::defer_lock);
     if (backward) {
@@ -383,11 +712,16 @@ bool SharedDataStream<T>::Reader::seek(Index offset, Reference reference) {
 
     *m_readerCursor = absolute;
 
+    // oldestUnconsumedCursor lags behind the readers, but a backward seek can land behind it; pull it back before a
+    // Writer (which checks it with backwardSeekMutex held) can use the stale value to overwrite us.  Only a forward
+    // seek frees space.
     if (backward) {
-        m_bufferLayout->updateOldestUnconsumedCursorLocked();
+        if (absolute < header->oldestUnconsumedCursor) {
+            header->oldestUnconsumedCursor = absolute;
+        }
         lock.unlock();
     } else {
-        m_bufferLayout->updateOldestUnconsumedCursor();
+        m_bufferLayout->notifySpaceAvailable();
     }
 
     return true;
@@ -445,6 +779,27 @@ void SharedDataStream<T>::Reader::close(Index offset, Reference reference) {
     *m_readerCloseIndex = absolute;
 }
 
+template <typename T>
+int SharedDataStream<T>::Reader::getEventFD() {
+    if (m_eventFD >= 0) {
+        return m_eventFD;
+    }
+    m_eventFD = eventFDCreate();
+    if (m_eventFD < 0) {
+        LOG_ERROR << "getEventFDFailed; reason: " << strerror(errno);
+        return -1;
+    }
+
+    // Tag the descriptor with our process id, so a Writer in another process does not signal whatever descriptor has
+    // the same number there.
+    m_bufferLayout->getReaderWake(m_id)->eventFD =
+        (static_cast<Index>(getpid()) << 32) | static_cast<Index>(m_eventFD);
+
+    // Data may already be waiting, in which case the descriptor has to start out readable.
+    armEventFD();
+    return m_eventFD;
+}
+
 template <typename T>
 size_t SharedDataStream<T>::Reader::getId() const {
     return m_id;
@@ -452,7 +807,7 @@ size_t SharedDataStream<T>::Reader::getId() const {
 
 template <typename T>
 size_t SharedDataStream<T>::Reader::getWordSize() const {
-    return m_bufferLayout->getHeader()->wordSize;
+    return m_bufferLayout->getWordSize();
 }
 
 template <typename T>
@@ -21,16 +21,22 @@ using namespace logger;
  * appropriate types for the template parameters which will work reliably for the execution environment where the
  * @c SharedDataStream will be used.
  *
+ * A stream created with `maxReaders == 1` takes a single-producer/single-consumer fast path: @c read() and
+ * @c write() only move the cursors with atomics, and a @c BLOCKING side which has to wait sleeps on a futex instead of
+ * @c ConditionVariable.  The @c Mutex and @c ConditionVariable traits are then only used to create, attach and close.
+ *
  * @tparam T::AtomicIndex An atomic version of @c Index (see below) which implements the following methods:
  *     @li @c DefaultConstructible `(std::is_default_constructible<AtomicIndex> == true)`.
  *     @li Basic arithmetic, conversion and assignment operations with @c Index.
  *     @li @c load() performs an atomic read of the @c Index.
+ *     @li @c compare_exchange_strong(expected, desired) atomically replaces @c expected with @c desired, as
+ *         @c std::atomic does.
  *     @li If the stream will be shared between processes, the @c AtomicIndex type *must* be a PODType:
  *         `(std::is_pod<AtomicIndex> == true)`.
  *
  *     This should be an equivalent type to @c Index, but which ensures atomic reads and writes between readers and
- *     writers in the execution environment where the @c SharedDataStream will be used.  No methods are called on this
- *     type; it must simply be readable and writable with values of type @c Index or @c AtomicIndex.
+ *     writers in the execution environment where the @c SharedDataStream will be used.  Apart from the methods above,
+ *     it must simply be readable and writable with values of type @c Index or @c AtomicIndex.
  *
  * @tparam T::AtomicBool An atomic boolean type which implements the following methods:
  *     @li @c DefaultConstructible `(std::is_default_constructible<AtomicIndex> == true)`.
@@ -116,7 +122,9 @@ public:
      * This function calculates the buffer size needed to support a @c SharedDataStream with the specified parameters.
      * This function can be safely called from multiple threads or processes.
      *
-     * @param nWords The number of data words the stream will be able to hold.
+     * @param nWords The number of data words the stream will be able to hold.  This is rounded up to a power of two,
+     *     so that positions in the stream wrap with a mask (see @c getDataSize()): a request for 96000 words sizes the
+     *     buffer for 131072.  Pass a power of two to avoid paying for words that were not asked for.
      * @param wordSize The size (in bytes) of words in the stream.  All @c SharedDataStream operations that work with
      *     data or position in the stream are quantified in words.  The stream's data storage capacity in bytes is
      *     `nWords * wordSize`.  This parameter defaults to 1.
@@ -134,7 +142,9 @@ public:
      *
      * @param buffer The @c Buffer which this stream will use to store its header and stream data.  Existing contents
      *     of @c buffer will be overwritten by this function.  Note that this function will fail if @c buffer is not
-     *     large enough to hold the header or is not a multiple of @c wordSize (see @c calculateBufferSize()).
+     *     large enough to hold the header or is not a multiple of @c wordSize (see @c calculateBufferSize()).  The
+     *     stream holds the largest power of two words which fits after the header; a buffer which was not sized with
+     *     @c calculateBufferSize() leaves the rest unused, up to almost half of it, and a warning is logged.
      * @param wordSize The size (in bytes) of words in the stream.  All @c SharedDataStream operations that work with
      *     data or position in the stream are quantified in words.  This parameter defaults to 1.
      * @param maxReaders The maximum number of readers the stream will support.  This parameter defaults to 1.
@@ -157,6 +167,21 @@ public:
      */
     static std::unique_ptr<SharedDataStream> open(std::shared_ptr<Buffer> buffer);
 
+    /**
+     * This function creates a new @c SharedDataStream on a @c Buffer left behind by an earlier stream whose users are
+     * all gone, such as a file-backed buffer after a crash or a restart.  Like @c open(), it verifies that @c buffer
+     * contains a valid header which is compatible with this stream's traits.  It then re-initializes the header,
+     * releasing every @c Reader and @c Writer of the earlier stream, but keeps the stream data and the write position:
+     * a @c Reader created with `startWithNewData == false` starts at the oldest data still in the buffer, and a new
+     * @c Writer carries on after the newest.
+     *
+     * @param buffer The @c Buffer which this stream will use to store its header and stream data.
+     * @return The new stream if @c buffer contains a valid and compatible header, else @c nullptr.
+     *
+     * @note No other stream may be attached to @c buffer while this function is called.
+     */
+    static std::unique_ptr<SharedDataStream> recover(std::shared_ptr<Buffer> buffer);
+
     /**
      * This function reports the maximum number of readers supported by this @c SharedDataStream.  This function can be
      * safely called from multiple threads or processes.
@@ -302,8 +327,14 @@ size_t SharedDataStream<T>::calculateBufferSize(size_t nWords, size_t wordSize,
         LOG_ERROR << "calculateBufferSizeFailed; reason: wordSizeZero";
         return 0;
     }
-    size_t overhead = BufferLayout::calculateDataOffset(wordSize, maxReaders);
-    size_t dataSize = nWords * wordSize;
+    size_t dataWords = BufferLayout::roundUpToPowerOfTwo(nWords);
+    if (0 == dataWords) {
+        LOG_ERROR << "calculateBufferSizeFailed; reason: numWordsTooLarge";
+        return 0;
+    }
+    // The header is placed on the first cache line boundary in the buffer, which may be up to a line in.
+    size_t overhead = BufferLayout::CACHE_LINE_SIZE + BufferLayout::calculateDataOffset(maxReaders);
+    size_t dataSize = dataWords * wordSize;
     return overhead + dataSize;
 }
 
@@ -334,6 +365,10 @@ std::unique_ptr<SharedDataStream<T>> SharedDataStream<T>::create(
 
 template <typename T>
 std::unique_ptr<SharedDataStream<T>> SharedDataStream<T>::open(std::shared_ptr<Buffer> buffer) {
+    if (nullptr == buffer) {
+        LOG_ERROR << "openFailed; reason: nullBuffer";
+        return nullptr;
+    }
     std::unique_ptr<SharedDataStream<T>> sds(new SharedDataStream<T>(buffer));
     if (!sds->m_bufferLayout->attach()) {
         // Logged in attach().
@@ -343,6 +378,23 @@ std::unique_ptr<SharedDataStream<T>> SharedDataStream<T>::open(std::shared_ptr<B
     }
 }
 
+template <typename T>
+std::unique_ptr<SharedDataStream<T>> SharedDataStream<T>::recover(std::shared_ptr<Buffer> buffer) {
+    if (nullptr == buffer) {
+        LOG_ERROR << "recoverFailed; reason: nullBuffer";
+        return nullptr;
+    } else if (calculateBufferSize(1, 1, 1) > buffer->size()) {
+        LOG_ERROR << "recoverFailed; reason: bufferSizeTooSmall";
+        return nullptr;
+    }
+    std::unique_ptr<SharedDataStream<T>> sds(new SharedDataStream<T>(buffer));
+    if (!sds->m_bufferLayout->recover()) {
+        // Logged in recover().
+        return nullptr;
+    }
+    return sds;
+}
+
 template <typename T>
 size_t SharedDataStream<T>::getMaxReaders() const {
     return m_bufferLayout->getHeader()->maxReaders;
@@ -355,7 +407,7 @@ typename SharedDataStream<T>::Index SharedDataStream<T>::getDataSize() const {
 
 template <typename T>
 size_t SharedDataStream<T>::getWordSize() const {
-    return m_bufferLayout->getHeader()->wordSize;
+    return m_bufferLayout->getWordSize();
 }
 
 template <typename T>
@@ -413,21 +465,20 @@ std::unique_ptr<typename SharedDataStream<T>::Reader> SharedDataStream<T>::creat
 
         return nullptr;
     } else {
-        // Note: Reader constructor does not call updateUnconsumedCursor() automatically, because we may be seeking to
-        // a blocked writer's cursor below (if !startWithNewData), and we don't want the writer to start moving before
-        // we seek.
+        // Note: Reader constructor does not wake up the writer automatically, because we may be seeking to a blocked
+        // writer's cursor below (if !startWithNewData), and we don't want the writer to start moving before we seek.
         auto reader = std::unique_ptr<Reader>(new Reader(policy, m_bufferLayout, id));
         lock->unlock();
 
         if (startWithNewData) {
-            // We're not moving the cursor again, so call updateUnconsumedCursor() now.
-            m_bufferLayout->updateOldestUnconsumedCursor();
+            // A writer which filled the buffer while there were no readers can move on now; its rescan will find this
+            // reader at the write cursor.
+            m_bufferLayout->notifySpaceAvailable();
         } else {
             Index offset = m_bufferLayout->getDataSize();
             if (m_bufferLayout->getHeader()->writeStartCursor < offset) {
                 offset = m_bufferLayout->getHeader()->writeStartCursor;
             }
-            // Note: seek() will call updateUnconsumedCursor().
             if (!reader->seek(offset, Reader::Reference::BEFORE_WRITER)) {
                 // Logged in seek().
                 return nullptr;
@@ -82,6 +82,57 @@ public:
      */
     ssize_t write(const void* buf, size_t nWords, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
 
+    /**
+     * A contiguous region of the stream's data, as handed out by @c reserve().
+     */
+    struct Span {
+        /// Pointer to the first byte of the region.
+        uint8_t* data;
+        /// The number of @c wordSize words in the region.
+        size_t nWords;
+    };
+
+    /**
+     * This function reserves space in the stream so that the caller can produce data directly into the stream,
+     * instead of producing it into a buffer of its own and copying it in with @c write().  Because the stream is a
+     * ring, the reserved space may be split at the wrap; @c first receives the part before the wrap and @c second the
+     * part after it (with `second->nWords == 0` if the reservation does not wrap).  Reserved data is not visible to
+     * @c Readers until it is published with @c commit().
+     *
+     * @param nWords The maximum number of @c wordSize words to reserve.
+     * @param[out] first The part of the reservation before the wrap.
+     * @param[out] second The part of the reservation after the wrap.
+     * @param timeout The maximum time to wait (if @c policy is @c BLOCKING) for space to reserve.  If this parameter
+     *     is zero, there is no timeout and blocking reservations will wait forever.  If @c policy is not @C BLOCKING,
+     *     this parameter is ignored.
+     * @return The number of @c wordSize words reserved, or zero if the stream has closed, or a negative @c Error code
+     *     if the stream is still open, but no space could be reserved.
+     *
+     * The @c Policy applies as it does for @c write(): a @c NONBLOCKABLE @c Writer truncates the reservation to the
+     * buffer size and may overrun @c Readers, an @c ALL_OR_NOTHING @c Writer reserves all of @c nWords or returns
+     * @c Error::WOULDBLOCK, and a @c BLOCKING @c Writer waits for space and reserves as much as is available.  Since
+     * there is no caller data which could be discarded, an @c ALL_OR_NOTHING reservation larger than the buffer is
+     * rejected with @c Error::INVALID.  While a reservation is outstanding, @c Readers can not seek backward into it.
+     *
+     * @note Only one reservation can be outstanding at a time, and @c write() can not be called while it is.
+     */
+    ssize_t reserve(
+        size_t nWords,
+        Span* first,
+        Span* second,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    /**
+     * This function publishes the first @c nWords words of the outstanding reservation to the @c Readers and releases
+     * the rest of it.
+     *
+     * @param nWords The number of @c wordSize words which have been produced into the reservation.  This can be less
+     *     than the number of words reserved (including zero, which cancels the reservation).
+     * @return The number of @c wordSize words published, or a negative @c Error code if there is no outstanding
+     *     reservation or @c nWords is larger than it.
+     */
+    ssize_t commit(size_t nWords);
+
     /**
      * This function reports the current position of the @c Writer in the stream.
      *
@@ -111,6 +162,40 @@ public:
     static std::string errorToString(Error error);
 
 private:
+    /**
+     * This function applies the @c Policy to claim space for up to @c nWords words at @c writeStartCursor, waiting
+     * for space if needed, and moves @c writeEndCursor to the end of the claimed space.
+     *
+     * @param nWords The number of @c wordSize words to claim.
+     * @param timeout The maximum time to wait (if @c policy is @c BLOCKING) for space.
+     * @return The number of @c wordSize words claimed, which may be less than @c nWords for truncating policies or
+     *     more than the buffer size for @c ALL_OR_NOTHING, or zero if the stream has closed, or a negative @c Error
+     *     code if no space could be claimed.
+     */
+    ssize_t claimSpace(size_t nWords, std::chrono::milliseconds timeout);
+
+    /**
+     * This function returns the number of words which can be written at @c writeStartCursor without overrunning
+     * @c oldestUnconsumedCursor (at most the buffer size).
+     *
+     * @return The number of @c wordSize words which can be written.
+     */
+    Index getSpaceAvailable() const;
+
+    /**
+     * This function checks whether writing up to @c writeEnd would overrun @c oldestUnconsumedCursor.
+     *
+     * @param writeEnd The end of the write.
+     * @return @c true if the write would overrun a reader, else @c false.
+     */
+    bool wouldOverrunReaders(Index writeEnd) const;
+
+    /**
+     * This function publishes the data between @c writeStartCursor and @c writeEndCursor to the @c Readers by moving
+     * @c writeStartCursor up to @c writeEndCursor and notifying any blocked @c Readers.
+     */
+    void advanceWriteStartCursor();
+
     /**
      * The tag associated with log entries from this class.
      */
@@ -128,6 +213,12 @@ private:
      * @c Header::WriterEnabledMutex.
      */
     bool m_closed;
+
+    /// The number of words reserved by @c reserve() which have not yet been passed to @c commit().
+    size_t m_reservedWords;
+
+    /// Flag indicating that a reservation made by @c reserve() is outstanding.
+    bool m_hasReservation;
 };
 
 template <typename T>
@@ -137,7 +228,9 @@ template <typename T>
 SharedDataStream<T>::Writer::Writer(Policy policy, std::shared_ptr<BufferLayout> bufferLayout) :
         m_policy{policy},
         m_bufferLayout{bufferLayout},
-        m_closed{false} {
+        m_closed{false},
+        m_reservedWords{0},
+        m_hasReservation{false} {
     // Note - SharedDataStream::createWriter() holds writerEnableMutex while calling this function.
     auto header = m_bufferLayout->getHeader();
     header->isWriterEnabled = true;
@@ -159,15 +252,107 @@ ssize_t SharedDataStream<T>::Writer::write(const void* buf, size_t nWords, std::
         LOG_ERROR << "writeFailed; reason: zeroNumWords";
         return Error::INVALID;
     }
+    if (m_hasReservation) {
+        LOG_ERROR << "writeFailed; reason: reservationOutstanding";
+        return Error::INVALID;
+    }
+
+    ssize_t claimed = claimSpace(nWords, timeout);
+    if (claimed <= 0) {
+        // Logged in claimSpace() where appropriate.
+        return claimed;
+    }
+    nWords = claimed;
 
+    auto header = m_bufferLayout->getHeader();
+    auto wordsToCopy = nWords;
+    auto buf8 = static_cast<const uint8_t*>(buf);
+
+    if (Policy::ALL_OR_NOTHING == m_policy) {
+        // If we have more data than the SDS can hold and we're not going to be overwriting oldestUnconsumedCursor, we
+        // can safely discard the initial data and just leave the trailing data in the buffer.
+        if (wordsToCopy > m_bufferLayout->getDataSize()) {
+            wordsToCopy = m_bufferLayout->getDataSize();
+            buf8 += (nWords - wordsToCopy) * getWordSize();
+        }
+    }
+
+    // Split it across the wrap.
+    size_t beforeWrap = m_bufferLayout->wordsUntilWrap(header->writeStartCursor);
+    if (beforeWrap > wordsToCopy) {
+        beforeWrap = wordsToCopy;
+    }
+    size_t afterWrap = wordsToCopy - beforeWrap;
+
+    // Copy the two segments.
+    memcpy(m_bufferLayout->getData(header->writeStartCursor), buf8, beforeWrap * getWordSize());
+    if (afterWrap > 0) {
+        memcpy(
+            m_bufferLayout->getData(header->writeStartCursor + beforeWrap),
+            buf8 + beforeWrap * getWordSize(),
+            afterWrap * getWordSize());
+    }
+
+    advanceWriteStartCursor();
+
+    return nWords;
+}
+
+template <typename T>
+ssize_t SharedDataStream<T>::Writer::reserve(
+    size_t nWords,
+    Span* first,
+    Span* second,
+    std::chrono::milliseconds timeout) {
+    if (nullptr == first || nullptr == second) {
+        LOG_ERROR << "reserveFailed; reason: nullSpan";
+        return Error::INVALID;
+    }
+    if (0 == nWords) {
+        LOG_ERROR << "reserveFailed; reason: zeroNumWords";
+        return Error::INVALID;
+    }
+    if (m_hasReservation) {
+        LOG_ERROR << "reserveFailed; reason: reservationOutstanding";
+        return Error::INVALID;
+    }
+    if (Policy::ALL_OR_NOTHING == m_policy && nWords > m_bufferLayout->getDataSize()) {
+        // Unlike write(), there is no caller data to discard, so the reservation has to fit in the buffer.
+        LOG_ERROR << "reserveFailed; reason: reservationExceedsBuffer";
+        return Error::INVALID;
+    }
+
+    ssize_t claimed = claimSpace(nWords, timeout);
+    if (claimed <= 0) {
+        // Logged in claimSpace() where appropriate.
+        return claimed;
+    }
+    nWords = claimed;
+
+    // Split it across the wrap.
+    auto header = m_bufferLayout->getHeader();
+    size_t beforeWrap = m_bufferLayout->wordsUntilWrap(header->writeStartCursor);
+    if (beforeWrap > nWords) {
+        beforeWrap = nWords;
+    }
+    first->data = m_bufferLayout->getData(header->writeStartCursor);
+    first->nWords = beforeWrap;
+    second->data = m_bufferLayout->getData(header->writeStartCursor + beforeWrap);
+    second->nWords = nWords - beforeWrap;
+
+    m_reservedWords = nWords;
+    m_hasReservation = true;
+    return nWords;
+}
+
+template <typename T>
+ssize_t SharedDataStream<T>::Writer::claimSpace(size_t nWords, std::chrono::milliseconds timeout) {
     auto header = m_bufferLayout->getHeader();
     if (!header->isWriterEnabled) {
-        LOG_ERROR << "writeFailed; reason: writerDisabled";
+        LOG_ERROR << "claimSpaceFailed; reason: writerDisabled";
         return Error::CLOSED;
     }
 
-    auto wordsToCopy = nWords;
-    auto buf8 = static_cast<const uint8_t*>(buf);
     std::unique_lock<Mutex> backwardSeekLock(header->backwardSeekMutex, std::defer_lock);
     Index writeEnd = header->writeStartCursor + nWords;
 
@@ -175,7 +360,7 @@ ssize_t SharedDataStream<T>::Writer::write(const void* buf, size_t nWords, std::
         case Policy::NONBLOCKABLE:
             // For NONBLOCKABLE, we can truncate the write if it won't fit in the buffer.
             if (nWords > m_bufferLayout->getDataSize()) {
-                wordsToCopy = nWords = m_bufferLayout->getDataSize();
+                nWords = m_bufferLayout->getDataSize();
                 writeEnd = header->writeStartCursor + nWords;
             }
             break;
@@ -185,50 +370,61 @@ ssize_t SharedDataStream<T>::Writer::write(const void* buf, size_t nWords, std::
             // data which has not been written yet).
 
             // Note - this check must be performed while locked to prevent a reader from backwards-seeking into the
-            // write region between here and the writeEndCursor update below.
-            backwardSeekLock.lock();
-            if ((writeEnd >= header->oldestUnconsumedCursor) &&
-                ((writeEnd - header->oldestUnconsumedCursor) > m_bufferLayout->getDataSize())) {
-                return Error::WOULDBLOCK;
+            // write region between here and the writeEndCursor update below.  A single reader is not locked out; if
+            // it seeks backwards into the write region anyway, its read reports the overrun.
+            if (!m_bufferLayout->isSingleReader()) {
+                backwardSeekLock.lock();
+            }
+            if (wouldOverrunReaders(writeEnd)) {
+                // oldestUnconsumedCursor lags behind the readers; bring it up to date before giving up.
+                m_bufferLayout->updateOldestUnconsumedCursorLocked();
+                if (wouldOverrunReaders(writeEnd)) {
+                    return Error::WOULDBLOCK;
+                }
             }
             break;
-        case Policy::BLOCKING:
+        case Policy::BLOCKING: {
             // For BLOCKING, we need to wait until there is room for at least one word.
 
-            // Condition for returning from write: there is space for a write.
-            auto predicate = [this, header] {
-                return (header->writeStartCursor < header->oldestUnconsumedCursor) ||
-                       (header->writeStartCursor - header->oldestUnconsumedCursor) < m_bufferLayout->getDataSize();
-            };
-
             // Note - this check must be performed while locked to prevent a reader from backwards-seeking into the
-            // write region between here and the writeEndCursor update below.
-            backwardSeekLock.lock();
+            // write region between here and the writeEndCursor update below.  See the ALL_OR_NOTHING note above
+            // about not locking out a single reader.
+            if (!m_bufferLayout->isSingleReader()) {
+                backwardSeekLock.lock();
+            }
 
-            // Wait for space to become available.
-            if (std::chrono::milliseconds::zero() == timeout) {
-                header->spaceAvailableConditionVariable.wait(backwardSeekLock, predicate);
-            } else if (!header->spaceAvailableConditionVariable.wait_for(backwardSeekLock, timeout, predicate)) {
-                return Error::TIMEDOUT;
+            // oldestUnconsumedCursor lags behind the readers; bring it up to date if it would truncate the write.
+            if (getSpaceAvailable() < nWords) {
+                m_bufferLayout->updateOldestUnconsumedCursorLocked();
             }
 
-            // Figure out how much space we have.
-            auto spaceAvailable = m_bufferLayout->getDataSize();
-            if (header->writeStartCursor >= header->oldestUnconsumedCursor) {
-                auto wordsToOverrun =
-                    m_bufferLayout->getDataSize() - (header->writeStartCursor - header->oldestUnconsumedCursor);
-                if (wordsToOverrun < spaceAvailable) {
-                    spaceAvailable = wordsToOverrun;
+            // Condition for returning from write: there is space for a write.
+            auto predicate = [this] {
+                m_bufferLayout->updateOldestUnconsumedCursorLocked();
+                return getSpaceAvailable() > 0;
+            };
+
+            // Wait for space to become available.
+            if (0 == getSpaceAvailable()) {
+                if (m_bufferLayout->isSingleReader()) {
+                    if (!m_bufferLayout->waitForSequence(
+                            &header->isWriterSleeping, &header->writerWakeSequence, timeout, predicate)) {
+                        return Error::TIMEDOUT;
+                    }
+                } else if (!m_bufferLayout->waitForSpaceLocked(&backwardSeekLock, timeout, predicate)) {
+                    return Error::TIMEDOUT;
                 }
             }
 
             // For BLOCKING, we can truncate the write if it won't fit in the buffer.
+            auto spaceAvailable = getSpaceAvailable();
             if (spaceAvailable < nWords) {
-                wordsToCopy = nWords = spaceAvailable;
+                nWords = spaceAvailable;
                 writeEnd = header->writeStartCursor + nWords;
             }
 
             break;
+        }
     }
 
     header->writeEndCursor = writeEnd;
@@ -238,37 +434,75 @@ ssize_t SharedDataStream<T>::Writer::write(const void* buf, size_t nWords, std::
         backwardSeekLock.unlock();
     }
 
-    if (Policy::ALL_OR_NOTHING == m_policy) {
-        // If we have more data than the SDS can hold and we're not going to be overwriting oldestUnconsumedCursor, we
-        // can safely discard the initial data and just leave the trailing data in the buffer.
-        if (wordsToCopy > m_bufferLayout->getDataSize()) {
-            wordsToCopy = m_bufferLayout->getDataSize();
-            buf8 += (nWords - wordsToCopy) * getWordSize();
-        }
+    return nWords;
+}
+
+template <typename T>
+typename SharedDataStream<T>::Index SharedDataStream<T>::Writer::getSpaceAvailable() const {
+    auto header = m_bufferLayout->getHeader();
+    Index writeStartCursor = header->writeStartCursor;
+    Index oldestUnconsumedCursor = header->oldestUnconsumedCursor;
+    if (writeStartCursor < oldestUnconsumedCursor) {
+        // Readers are waiting for future data, so the whole buffer can be written.
+        return m_bufferLayout->getDataSize();
+    }
+    Index wordsInUse = writeStartCursor - oldestUnconsumedCursor;
+    if (wordsInUse >= m_bufferLayout->getDataSize()) {
+        // A NONBLOCKABLE writer may already have overrun the oldest reader.
+        return 0;
     }
+    return m_bufferLayout->getDataSize() - wordsInUse;
+}
 
-    // Split it across the wrap.
-    size_t beforeWrap = m_bufferLayout->wordsUntilWrap(header->writeStartCursor);
-    if (beforeWrap > wordsToCopy) {
-        beforeWrap = wordsToCopy;
+template <typename T>
+bool SharedDataStream<T>::Writer::wouldOverrunReaders(Index writeEnd) const {
+    Index oldestUnconsumedCursor = m_bufferLayout->getHeader()->oldestUnconsumedCursor;
+    return (writeEnd >= oldestUnconsumedCursor) &&
+           ((writeEnd - oldestUnconsumedCursor) > m_bufferLayout->getDataSize());
+}
+
+template <typename T>
+ssize_t SharedDataStream<T>::Writer::commit(size_t nWords) {
+    if (!m_hasReservation) {
+        LOG_ERROR << "commitFailed; reason: noReservation";
+        return Error::INVALID;
+    }
+    if (nWords > m_reservedWords) {
+        LOG_ERROR << "commitFailed; reason: commitExceedsReservation";
+        return Error::INVALID;
     }
-    size_t afterWrap = wordsToCopy - beforeWrap;
 
-    // Copy the two segments.
-    memcpy(m_bufferLayout->getData(header->writeStartCursor), buf8, beforeWrap * getWordSize());
-    if (afterWrap > 0) {
-        memcpy(
-            m_bufferLayout->getData(header->writeStartCursor + beforeWrap),
-            buf8 + beforeWrap * getWordSize(),
-            afterWrap * getWordSize());
+    m_hasReservation = false;
+    m_reservedWords = 0;
+
+    // Give back the part of the reservation which was not used.  Shrinking writeEndCursor never moves it over a
+    // Reader, so this does not need to be locked.
+    auto header = m_bufferLayout->getHeader();
+    header->writeEndCursor = header->writeStartCursor + nWords;
+
+    if (nWords > 0) {
+        advanceWriteStartCursor();
     }
+    return nWords;
+}
+
+template <typename T>
+void SharedDataStream<T>::Writer::advanceWriteStartCursor() {
+    auto header = m_bufferLayout->getHeader();
 
     // Advance the write cursor.
     // Note: To prevent a race condition and ensure that readers which block on dataAvailableConditionVariable don't
-    // miss a notify, we should always lock the dataAvailableConditionVariable mutex while moving writeStartCursor.  As
+    // miss a notify, we should always lock the dataAvailableMutex while moving writeStartCursor.  As
     // an optimization, we skip that lock for NONBLOCKABLE writers under the assumption that they will be writing
     // continuously, so a missed notification is not significant.
     // Note: As a further optimization, the lock could be omitted if no blocking readers are in use (ACSDK-251).
+    // Note: A single-reader stream has no lock to take: the Reader raises isReaderSleeping before it last checks
+    // writeStartCursor, so it is woken up if it decided to sleep before the move below.
+    if (m_bufferLayout->isSingleReader()) {
+        header->writeStartCursor = header->writeEndCursor.load();
+        m_bufferLayout->notifyDataAvailable();
+        return;
+    }
     std::unique_lock<Mutex> dataAvailableLock(header->dataAvailableMutex, std::defer_lock);
     if (Policy::NONBLOCKABLE != m_policy) {
         dataAvailableLock.lock();
@@ -278,11 +512,8 @@ ssize_t SharedDataStream<T>::Writer::write(const void* buf, size_t nWords, std::
         dataAvailableLock.unlock();
     }
 
-    // Notify the reader(s).
-    // Note: as an optimization, we could skip this if there are no blocking readers (ACSDK-251).
-    header->dataAvailableConditionVariable.notify_all();
-
-    return nWords;
+    // Notify the reader(s) which have as much data as they asked to wait for.
+    m_bufferLayout->notifyDataAvailable();
 }
 
 template <typename T>
@@ -304,14 +535,14 @@ void SharedDataStream<T>::Writer::close() {
 
         header->hasWriterBeenClosed = true;
 
-        header->dataAvailableConditionVariable.notify_all();
+        m_bufferLayout->notifyDataAvailable(true);
     }
     m_closed = true;
 }
 
 template <typename T>
 size_t SharedDataStream<T>::Writer::getWordSize() const {
-    return m_bufferLayout->getHeader()->wordSize;
+    return m_bufferLayout->getWordSize();
 }
 
 template <typename T>
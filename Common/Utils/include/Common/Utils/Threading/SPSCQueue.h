@@ -0,0 +1,160 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_THREADING_SPSCQUEUE_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_THREADING_SPSCQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace threading {
+
+/**
+ * A bounded, lock-free queue handing values from one producer thread to one consumer thread.
+ *
+ * The values are stored in a ring allocated up front, so pushing and popping never allocate, lock or make a system
+ * call; they can be used from a real-time thread. @c push() must only be called from the producer thread, and
+ * @c pop() from the consumer thread. The queue does not wake anyone up: a consumer which sleeps is expected to be
+ * told about new values some other way, such as with an eventfd.
+ *
+ * @tparam T The type of the values, which must be default constructible and move assignable. A value popped is moved
+ * out of the ring, so that the queue holds no reference to it.
+ */
+template <typename T>
+class SPSCQueue {
+public:
+    /**
+     * Constructor.
+     *
+     * @param capacity The number of values the queue can hold.
+     */
+    explicit SPSCQueue(size_t capacity);
+
+    /**
+     * Appends a value to the queue. Must only be called from the producer thread.
+     *
+     * @param value The value to append.
+     * @return @c true if the value was appended, @c false if the queue is full.
+     */
+    bool push(const T& value);
+
+    /**
+     * Appends a value to the queue, moving it in. Must only be called from the producer thread.
+     *
+     * @param value The value to append, which is left untouched if the queue is full.
+     * @return @c true if the value was appended, @c false if the queue is full.
+     */
+    bool push(T&& value);
+
+    /**
+     * Removes the oldest value from the queue. Must only be called from the consumer thread.
+     *
+     * @param[out] value The value removed.
+     * @return @c true if a value was removed, @c false if the queue is empty.
+     */
+    bool pop(T* value);
+
+    /**
+     * Returns the number of values in the queue. The result is only a snapshot when called from another thread than
+     * the producer or the consumer.
+     *
+     * @return The number of values in the queue.
+     */
+    size_t size() const;
+
+    /**
+     * Returns the number of values the queue can hold.
+     *
+     * @return The capacity of the queue.
+     */
+    size_t capacity() const;
+
+private:
+    /**
+     * Finds the element to push the next value to.
+     *
+     * @param[out] tail The index of the element to push the value to.
+     * @param[out] nextTail The index of the tail once the value is pushed.
+     * @return @c true if the queue has room for a value.
+     */
+    bool reserveTail(size_t* tail, size_t* nextTail);
+
+    /// Size of a cache line, which the producer and consumer indices are kept apart by.
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    /// The ring, with one more element than the capacity so that a full queue can be told apart from an empty one.
+    std::vector<T> m_ring;
+
+    /// Index of the next value to pop, written by the consumer only.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head;
+
+    /// Index of the next value to push, written by the producer only.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;
+};
+
+template <typename T>
+SPSCQueue<T>::SPSCQueue(size_t capacity) : m_ring(capacity + 1), m_head{0}, m_tail{0} {
+}
+
+template <typename T>
+bool SPSCQueue<T>::reserveTail(size_t* tail, size_t* nextTail) {
+    *tail = m_tail.load(std::memory_order_relaxed);
+    *nextTail = (*tail + 1) % m_ring.size();
+    return *nextTail != m_head.load(std::memory_order_acquire);
+}
+
+template <typename T>
+bool SPSCQueue<T>::push(const T& value) {
+    size_t tail, nextTail;
+    if (!reserveTail(&tail, &nextTail)) {
+        return false;
+    }
+    m_ring[tail] = value;
+    // Publish the value along with the index, for the acquire load of pop().
+    m_tail.store(nextTail, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SPSCQueue<T>::push(T&& value) {
+    size_t tail, nextTail;
+    if (!reserveTail(&tail, &nextTail)) {
+        return false;
+    }
+    m_ring[tail] = std::move(value);
+    m_tail.store(nextTail, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SPSCQueue<T>::pop(T* value) {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    *value = std::move(m_ring[head]);
+    // Hand the element back to the producer only once it has been read.
+    m_head.store((head + 1) % m_ring.size(), std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+size_t SPSCQueue<T>::size() const {
+    const size_t head = m_head.load(std::memory_order_acquire);
+    const size_t tail = m_tail.load(std::memory_order_acquire);
+    return (tail + m_ring.size() - head) % m_ring.size();
+}
+
+template <typename T>
+size_t SPSCQueue<T>::capacity() const {
+    return m_ring.size() - 1;
+}
+
+}  // namespace threading
+}  // namespace utils
+}  // namespace common
+}  // namespace deviceClientSDK
+
+#endif  // DEVICE_CLIENT_SDK_COMMON_UTILS_THREADING_SPSCQUEUE_H_
@@ -0,0 +1,25 @@
+#ifndef DEVICE_CLIENT_SDK_COMMON_UTILS_THREADING_THREADAFFINITY_H_
+#define DEVICE_CLIENT_SDK_COMMON_UTILS_THREADING_THREADAFFINITY_H_
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace threading {
+
+/// CPU index meaning that a thread may run on any CPU.
+constexpr int ANY_CPU = -1;
+
+/**
+ * Pins the calling thread to a CPU, or lets it run on any CPU again.
+ *
+ * @param cpu The index of the CPU, or @c ANY_CPU.
+ * @return @c true on success, @c false if the CPU does not exist or the platform can't pin threads.
+ */
+bool setThisThreadAffinity(int cpu);
+
+}  // namespace threading
+}  // namespace utils
+}  // namespace common
+}  // namespace deviceClientSDK
+
+#endif  // DEVICE_CLIENT_SDK_COMMON_UTILS_THREADING_THREADAFFINITY_H_
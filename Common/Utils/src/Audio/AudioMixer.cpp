@@ -0,0 +1,248 @@
+#include "Common/Utils/Audio/AudioMixer.h"
+#include "Common/Utils/Audio/FormatConverter.h"
+#include "Common/Utils/Audio/PCMKernels.h"
+#include "Common/Utils/Logger/Log.h"
+
+#include <algorithm>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_AUDIOMIXER = "AudioMixer\t";
+
+// Size of a sample, and of a word of the streams mixed.
+constexpr size_t SAMPLE_SIZE = sizeof(int16_t);
+
+// The identifier of a free input slot.
+constexpr int NO_INPUT = -1;
+
+std::unique_ptr<AudioMixer> AudioMixer::create(
+    const AudioFormat& format,
+    std::shared_ptr<AudioInputStream::Writer> output,
+    size_t maxInputs,
+    size_t blockFrames) {
+    if(AudioFormat::Encoding::LPCM != format.encoding || 16 != format.sampleSizeInBits || !format.dataSigned ||
+       FormatConverter::getHostEndianness() != format.endianness || 0 == format.numChannels ||
+       (format.numChannels > 1 && AudioFormat::Layout::INTERLEAVED != format.layout)) {
+        LOG_ERROR << TAG_AUDIOMIXER << "createFailed; reason: unsupported format; encoding: " << format.encoding
+                  << "; sampleSizeInBits: " << format.sampleSizeInBits << "; numChannels: " << format.numChannels;
+        return nullptr;
+    }
+    if(!output || SAMPLE_SIZE != output->getWordSize()) {
+        LOG_ERROR << TAG_AUDIOMIXER << "createFailed; reason: invalid output";
+        return nullptr;
+    }
+    if(0 == maxInputs || 0 == blockFrames) {
+        LOG_ERROR << TAG_AUDIOMIXER << "createFailed; reason: invalid size; maxInputs: " << maxInputs
+                  << "; blockFrames: " << blockFrames;
+        return nullptr;
+    }
+
+    return std::unique_ptr<AudioMixer>(new AudioMixer(format, std::move(output), maxInputs, blockFrames));
+}
+
+AudioMixer::AudioMixer(
+    const AudioFormat& format,
+    std::shared_ptr<AudioInputStream::Writer> output,
+    size_t maxInputs,
+    size_t blockFrames) :
+        m_format(format),
+        m_output{std::move(output)},
+        m_blockFrames{blockFrames},
+        m_inputs{new Input[maxInputs]},
+        m_maxInputs{maxInputs},
+        m_nextId{0},
+        m_accumulator(blockFrames * format.numChannels),
+        m_accumulated{0},
+        m_statistics() {
+    for(size_t i = 0; i < m_maxInputs; ++i) {
+        m_inputs[i].id = NO_INPUT;
+        m_inputs[i].gain = 0.0f;
+    }
+}
+
+int AudioMixer::addInput(std::shared_ptr<AudioInputStream::Reader> reader, float gain) {
+    if(!reader || SAMPLE_SIZE != reader->getWordSize()) {
+        LOG_ERROR << TAG_AUDIOMIXER << "addInputFailed; reason: invalid reader";
+        return NO_INPUT;
+    }
+    if(!(gain >= 0.0f)) {
+        LOG_ERROR << TAG_AUDIOMIXER << "addInputFailed; reason: invalid gain; gain: " << gain;
+        return NO_INPUT;
+    }
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for(size_t i = 0; i < m_maxInputs; ++i) {
+        Input& input = m_inputs[i];
+        if(NO_INPUT == input.id) {
+            const int id = m_nextId++;
+            input.reader = std::move(reader);
+            input.gain = gain;
+            input.id = id;
+            LOG_DEBUG << TAG_AUDIOMIXER << "addInput; id: " << id << "; gain: " << gain;
+            return id;
+        }
+    }
+
+    LOG_ERROR << TAG_AUDIOMIXER << "addInputFailed; reason: too many inputs; maxInputs: " << m_maxInputs;
+    return NO_INPUT;
+}
+
+bool AudioMixer::removeInput(int id) {
+    if(NO_INPUT == id) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for(size_t i = 0; i < m_maxInputs; ++i) {
+        Input& input = m_inputs[i];
+        if(id == input.id) {
+            input.id = NO_INPUT;
+            input.reader.reset();
+            LOG_DEBUG << TAG_AUDIOMIXER << "removeInput; id: " << id;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AudioMixer::setGain(int id, float gain) {
+    if(NO_INPUT == id || !(gain >= 0.0f)) {
+        return false;
+    }
+
+    for(size_t i = 0; i < m_maxInputs; ++i) {
+        Input& input = m_inputs[i];
+        if(id == input.id) {
+            input.gain = gain;
+            return true;
+        }
+    }
+    return false;
+}
+
+void AudioMixer::accumulate(const int16_t* samples, size_t offset, size_t count, float gain) {
+    float* sums = m_accumulator.data() + offset;
+    if(offset >= m_accumulated) {
+        // Past the sums of the inputs mixed before: start the sums, rather than clearing them first.
+        scaleToFloat(samples, count, gain, sums);
+    } else if(offset + count <= m_accumulated) {
+        accumulateScaled(samples, count, gain, sums);
+    } else {
+        const size_t overlap = m_accumulated - offset;
+        accumulateScaled(samples, overlap, gain, sums);
+        scaleToFloat(samples + overlap, count - overlap, gain, sums + overlap);
+    }
+    m_accumulated = std::max(m_accumulated, offset + count);
+}
+
+size_t AudioMixer::mix() {
+    const auto start = std::chrono::steady_clock::now();
+    const size_t channels = m_format.numChannels;
+    const size_t blockSamples = m_blockFrames * channels;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_accumulated = 0;
+
+    for(size_t i = 0; i < m_maxInputs; ++i) {
+        Input& input = m_inputs[i];
+        if(NO_INPUT == input.id) {
+            continue;
+        }
+
+        AudioInputStream::Reader::Span first, second;
+        ssize_t borrowed = input.reader->borrow(blockSamples, &first, &second);
+        if(AudioInputStream::Reader::Error::OVERRUN == borrowed) {
+            // Skip the audio overwritten, and pick up from the latest audio on the next block.
+            ++m_statistics.inputOverruns;
+            input.reader->seek(0, AudioInputStream::Reader::Reference::BEFORE_WRITER);
+            continue;
+        }
+        if(AudioInputStream::Reader::Error::CLOSED == borrowed) {
+            LOG_DEBUG << TAG_AUDIOMIXER << "mix; reason: input closed; id: " << input.id;
+            input.id = NO_INPUT;
+            input.reader.reset();
+            continue;
+        }
+        if(borrowed < 0) {
+            ++m_statistics.inputUnderruns;
+            continue;
+        }
+
+        // Only mix whole frames, so that the channels of the inputs stay aligned.
+        const size_t samples = borrowed - borrowed % channels;
+        if(samples < blockSamples) {
+            ++m_statistics.inputUnderruns;
+        }
+        if(0 == samples) {
+            input.reader->release(0);
+            continue;
+        }
+
+        const float gain = input.gain;
+        const size_t firstSamples = std::min(samples, first.nWords);
+        accumulate(reinterpret_cast<const int16_t*>(first.data), 0, firstSamples, gain);
+        if(samples > firstSamples) {
+            accumulate(reinterpret_cast<const int16_t*>(second.data), firstSamples, samples - firstSamples, gain);
+        }
+
+        if(AudioInputStream::Reader::Error::OVERRUN == input.reader->release(samples)) {
+            // The writer caught up with the audio while it was mixed: it is mixed anyway, as it is already summed.
+            ++m_statistics.inputOverruns;
+            input.reader->seek(0, AudioInputStream::Reader::Reference::BEFORE_WRITER);
+        }
+    }
+
+    size_t written = 0;
+    if(m_accumulated > 0) {
+        AudioInputStream::Writer::Span first, second;
+        ssize_t reserved = m_output->reserve(m_accumulated, &first, &second);
+        if(reserved > 0) {
+            written = reserved - reserved % channels;
+            const size_t firstSamples = std::min(written, first.nWords);
+            saturateToInt16(m_accumulator.data(), firstSamples, reinterpret_cast<int16_t*>(first.data));
+            if(written > firstSamples) {
+                saturateToInt16(
+                    m_accumulator.data() + firstSamples,
+                    written - firstSamples,
+                    reinterpret_cast<int16_t*>(second.data));
+            }
+            m_output->commit(written);
+        }
+        if(written < m_accumulated) {
+            m_statistics.framesDropped += (m_accumulated - written) / channels;
+        }
+
+        ++m_statistics.blocksMixed;
+        m_statistics.framesMixed += written / channels;
+    }
+
+    const auto elapsed =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    m_statistics.lastBlockTime = elapsed;
+    m_statistics.maxBlockTime = std::max(m_statistics.maxBlockTime, elapsed);
+
+    return written / channels;
+}
+
+AudioFormat AudioMixer::getAudioFormat() const {
+    return m_format;
+}
+
+size_t AudioMixer::getBlockFrames() const {
+    return m_blockFrames;
+}
+
+AudioMixer::Statistics AudioMixer::getStatistics() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_statistics;
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
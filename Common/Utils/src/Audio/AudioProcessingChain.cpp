@@ -0,0 +1,155 @@
+#include "Common/Utils/Audio/AudioProcessingChain.h"
+#include "Common/Utils/Logger/Log.h"
+
+#include <algorithm>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_AUDIOPROCESSINGCHAIN = "AudioProcessingChain\t";
+
+static size_t getFrameSize(const AudioFormat& format) {
+    return format.numChannels * format.sampleSizeInBits / 8;
+}
+
+std::unique_ptr<AudioProcessingChain> AudioProcessingChain::create(
+    const AudioFormat& inputFormat,
+    size_t maxFrames,
+    std::vector<std::shared_ptr<AudioProcessingStage>> stages) {
+    if(0 == maxFrames || 0 == getFrameSize(inputFormat)) {
+        LOG_ERROR << TAG_AUDIOPROCESSINGCHAIN << "createFailed; reason: invalid input; maxFrames: " << maxFrames
+                  << "; numChannels: " << inputFormat.numChannels
+                  << "; sampleSizeInBits: " << inputFormat.sampleSizeInBits;
+        return nullptr;
+    }
+
+    std::unique_ptr<AudioProcessingChain> chain(new AudioProcessingChain(inputFormat, maxFrames, stages.size()));
+    AudioFormat format = inputFormat;
+    size_t frames = maxFrames;
+    size_t bufferSize = 0;
+    for(size_t i = 0; i < stages.size(); ++i) {
+        if(!stages[i]) {
+            LOG_ERROR << TAG_AUDIOPROCESSINGCHAIN << "createFailed; reason: null stage; index: " << i;
+            return nullptr;
+        }
+
+        AudioFormat outputFormat = format;
+        size_t outputFrames = frames;
+        if(!stages[i]->configure(format, frames, &outputFormat, &outputFrames) || 0 == getFrameSize(outputFormat)) {
+            LOG_ERROR << TAG_AUDIOPROCESSINGCHAIN << "createFailed; reason: stage configuration failed; stage: "
+                      << stages[i]->getName() << "; index: " << i;
+            return nullptr;
+        }
+
+        Stage& stage = chain->m_stages[i];
+        stage.stage = stages[i];
+        stage.inPlace = stages[i]->canProcessInPlace();
+        bufferSize = std::max(bufferSize, outputFrames * getFrameSize(outputFormat));
+        format = outputFormat;
+        frames = outputFrames;
+    }
+
+    chain->m_outputFormat = format;
+    for(auto& buffer : chain->m_buffers) {
+        buffer.resize(bufferSize);
+    }
+    return chain;
+}
+
+AudioProcessingChain::AudioProcessingChain(const AudioFormat& inputFormat, size_t maxFrames, size_t numStages) :
+        m_inputFormat(inputFormat),
+        m_maxFrames{maxFrames},
+        m_outputFormat(inputFormat),
+        m_stages{new Stage[numStages]},
+        m_numStages{numStages} {
+    for(size_t i = 0; i < m_numStages; ++i) {
+        m_stages[i].inPlace = false;
+        m_stages[i].blocks = 0;
+        m_stages[i].frames = 0;
+        m_stages[i].lastTime = 0;
+        m_stages[i].maxTime = 0;
+        m_stages[i].totalTime = 0;
+    }
+}
+
+size_t AudioProcessingChain::process(const unsigned char* input, size_t inputSize, const unsigned char** output) {
+    if(!input || !output) {
+        LOG_ERROR << TAG_AUDIOPROCESSINGCHAIN << "processFailed; reason: buffer is null";
+        return 0;
+    }
+    size_t frames = inputSize / getFrameSize(m_inputFormat);
+    if(frames > m_maxFrames) {
+        LOG_ERROR << TAG_AUDIOPROCESSINGCHAIN << "processFailed; reason: block too large; frames: " << frames
+                  << "; maxFrames: " << m_maxFrames;
+        return 0;
+    }
+
+    // The input belongs to the caller, so the first stage always writes to a buffer of the chain; after that, a stage
+    // working in place writes over its input.
+    const unsigned char* current = input;
+    int currentBuffer = -1;
+    for(size_t i = 0; i < m_numStages && frames > 0; ++i) {
+        Stage& stage = m_stages[i];
+        if(!stage.inPlace || currentBuffer < 0) {
+            currentBuffer = 0 == currentBuffer ? 1 : 0;
+        }
+        unsigned char* next = m_buffers[currentBuffer].data();
+
+        const auto start = std::chrono::steady_clock::now();
+        const size_t inputFrames = frames;
+        frames = stage.stage->process(current, next, inputFrames);
+        const int64_t elapsed =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        // Only this thread writes the counters: they are atomic so that they can be read from any thread.
+        stage.blocks.fetch_add(1, std::memory_order_relaxed);
+        stage.frames.fetch_add(inputFrames, std::memory_order_relaxed);
+        stage.lastTime.store(elapsed, std::memory_order_relaxed);
+        stage.totalTime.fetch_add(elapsed, std::memory_order_relaxed);
+        if(elapsed > stage.maxTime.load(std::memory_order_relaxed)) {
+            stage.maxTime.store(elapsed, std::memory_order_relaxed);
+        }
+        current = next;
+    }
+
+    *output = current;
+    return frames * getFrameSize(m_outputFormat);
+}
+
+AudioFormat AudioProcessingChain::getInputFormat() const {
+    return m_inputFormat;
+}
+
+AudioFormat AudioProcessingChain::getOutputFormat() const {
+    return m_outputFormat;
+}
+
+size_t AudioProcessingChain::getMaxFrames() const {
+    return m_maxFrames;
+}
+
+std::vector<AudioProcessingChain::StageStatistics> AudioProcessingChain::getStatistics() const {
+    std::vector<StageStatistics> statistics;
+    statistics.reserve(m_numStages);
+    for(size_t i = 0; i < m_numStages; ++i) {
+        const Stage& stage = m_stages[i];
+        StageStatistics stageStatistics;
+        stageStatistics.name = stage.stage->getName();
+        stageStatistics.blocks = stage.blocks.load(std::memory_order_relaxed);
+        stageStatistics.frames = stage.frames.load(std::memory_order_relaxed);
+        stageStatistics.lastTime = std::chrono::nanoseconds(stage.lastTime.load(std::memory_order_relaxed));
+        stageStatistics.maxTime = std::chrono::nanoseconds(stage.maxTime.load(std::memory_order_relaxed));
+        stageStatistics.totalTime = std::chrono::nanoseconds(stage.totalTime.load(std::memory_order_relaxed));
+        statistics.push_back(stageStatistics);
+    }
+    return statistics;
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
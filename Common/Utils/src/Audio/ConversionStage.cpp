@@ -0,0 +1,63 @@
+#include "Common/Utils/Audio/ConversionStage.h"
+#include "Common/Utils/Logger/Log.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_CONVERSIONSTAGE = "ConversionStage\t";
+
+ConversionStage::ConversionStage(const AudioFormat& targetFormat) :
+        m_targetFormat(targetFormat),
+        m_inputFrameSize{0},
+        m_outputFrameSize{0} {
+}
+
+AudioFormat ConversionStage::getFloatFormat(unsigned int numChannels) {
+    AudioFormat format;
+    format.encoding = AudioFormat::Encoding::LPCM;
+    format.endianness = FormatConverter::getHostEndianness();
+    format.sampleRateHz = 0;
+    format.sampleSizeInBits = 32;
+    format.numChannels = numChannels;
+    format.dataSigned = true;
+    format.layout = AudioFormat::Layout::INTERLEAVED;
+    return format;
+}
+
+std::string ConversionStage::getName() const {
+    return "Conversion";
+}
+
+bool ConversionStage::configure(
+    const AudioFormat& inputFormat,
+    size_t maxInputFrames,
+    AudioFormat* outputFormat,
+    size_t* maxOutputFrames) {
+    AudioFormat targetFormat = m_targetFormat;
+    targetFormat.sampleRateHz = inputFormat.sampleRateHz;
+    m_converter = FormatConverter::create(inputFormat, targetFormat);
+    if(!m_converter) {
+        LOG_ERROR << TAG_CONVERSIONSTAGE << "configureFailed; reason: unsupported conversion";
+        return false;
+    }
+    m_converter->reserve(maxInputFrames);
+    m_inputFrameSize = inputFormat.numChannels * inputFormat.sampleSizeInBits / 8;
+    m_outputFrameSize = targetFormat.numChannels * targetFormat.sampleSizeInBits / 8;
+    *outputFormat = targetFormat;
+    *maxOutputFrames = maxInputFrames;
+    return true;
+}
+
+size_t ConversionStage::process(const unsigned char* input, unsigned char* output, size_t frames) {
+    return m_converter->convert(input, frames * m_inputFrameSize, output, frames * m_outputFrameSize) /
+           m_outputFrameSize;
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
@@ -0,0 +1,150 @@
+#include "Common/Utils/Audio/DuckingStage.h"
+#include "Common/Utils/Audio/FormatConverter.h"
+#include "Common/Utils/Audio/PCMKernels.h"
+#include "Common/Utils/Logger/Log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_DUCKINGSTAGE = "DuckingStage\t";
+
+DuckingStage::DuckingStage(float duckedGain, std::chrono::milliseconds attack, std::chrono::milliseconds release) :
+        m_ducked{false},
+        m_duckedGain{duckedGain >= 0.0f && duckedGain <= 1.0f ? duckedGain : 0.25f},
+        m_attackMs{std::max<int64_t>(attack.count(), 0)},
+        m_releaseMs{std::max<int64_t>(release.count(), 0)},
+        m_gain{1.0f},
+        m_sampleRateHz{0},
+        m_numChannels{1},
+        m_currentGain{1.0f},
+        m_rampTarget{1.0f},
+        m_rampStep{0.0f},
+        m_rampFrames{0} {
+}
+
+void DuckingStage::duck() {
+    m_ducked = true;
+}
+
+void DuckingStage::unduck() {
+    m_ducked = false;
+}
+
+bool DuckingStage::isDucked() const {
+    return m_ducked;
+}
+
+bool DuckingStage::setDuckedGain(float duckedGain) {
+    if(!(duckedGain >= 0.0f && duckedGain <= 1.0f)) {
+        LOG_ERROR << TAG_DUCKINGSTAGE << "setDuckedGainFailed; reason: invalid gain; duckedGain: " << duckedGain;
+        return false;
+    }
+    m_duckedGain = duckedGain;
+    return true;
+}
+
+bool DuckingStage::setAttack(std::chrono::milliseconds attack) {
+    if(attack.count() < 0) {
+        LOG_ERROR << TAG_DUCKINGSTAGE << "setAttackFailed; reason: invalid attack; attack: " << attack.count();
+        return false;
+    }
+    m_attackMs = attack.count();
+    return true;
+}
+
+bool DuckingStage::setRelease(std::chrono::milliseconds release) {
+    if(release.count() < 0) {
+        LOG_ERROR << TAG_DUCKINGSTAGE << "setReleaseFailed; reason: invalid release; release: " << release.count();
+        return false;
+    }
+    m_releaseMs = release.count();
+    return true;
+}
+
+float DuckingStage::getGain() const {
+    return m_gain;
+}
+
+std::string DuckingStage::getName() const {
+    return "Ducking";
+}
+
+bool DuckingStage::configure(
+    const AudioFormat& inputFormat,
+    size_t maxInputFrames,
+    AudioFormat* outputFormat,
+    size_t* maxOutputFrames) {
+    if(!FormatConverter::isHostFloat(inputFormat)) {
+        LOG_ERROR << TAG_DUCKINGSTAGE << "configureFailed; reason: input is not float; sampleSizeInBits: "
+                  << inputFormat.sampleSizeInBits;
+        return false;
+    }
+    m_sampleRateHz = inputFormat.sampleRateHz;
+    m_numChannels = inputFormat.numChannels;
+    *outputFormat = inputFormat;
+    *maxOutputFrames = maxInputFrames;
+    return true;
+}
+
+bool DuckingStage::canProcessInPlace() const {
+    return true;
+}
+
+size_t DuckingStage::process(const unsigned char* input, unsigned char* output, size_t frames) {
+    const float* samples = reinterpret_cast<const float*>(input);
+    float* ducked = reinterpret_cast<float*>(output);
+    const bool isDucked = m_ducked;
+    const float duckedGain = m_duckedGain;
+    const float target = isDucked ? duckedGain : 1.0f;
+
+    if(target != m_rampTarget) {
+        // A full swing between the full and the ducked gain takes the attack or release time, a partial one the same
+        // share of it. The ramp is planned once, so that it ends on the target exactly, whichever block it ends in.
+        const int64_t timeMs = isDucked ? m_attackMs : m_releaseMs;
+        const float distance = std::fabs(target - m_currentGain);
+        const float range = std::max(std::fabs(1.0f - duckedGain), distance);
+        const double rampFrames = std::ceil(distance / range * timeMs * m_sampleRateHz / 1000.0);
+        m_rampTarget = target;
+        m_rampFrames = distance > 0.0f ? std::max<size_t>(static_cast<size_t>(rampFrames), 1) : 0;
+        m_rampStep = m_rampFrames > 0 ? (target - m_currentGain) / m_rampFrames : 0.0f;
+    }
+
+    size_t rampFrames = 0;
+    if(m_rampFrames > 0) {
+        rampFrames = std::min(frames, m_rampFrames);
+        rampFloat(samples, rampFrames, m_numChannels, m_currentGain + m_rampStep, m_rampStep, ducked);
+        m_rampFrames -= rampFrames;
+        m_currentGain = 0 == m_rampFrames ? m_rampTarget : m_currentGain + m_rampStep * rampFrames;
+    }
+
+    const size_t offset = rampFrames * m_numChannels;
+    const size_t count = (frames - rampFrames) * m_numChannels;
+    if(m_currentGain != 1.0f) {
+        scaleFloat(samples + offset, count, m_currentGain, ducked + offset);
+    } else if(input != output) {
+        memcpy(ducked + offset, samples + offset, count * sizeof(float));
+    }
+
+    m_gain = m_currentGain;
+    return frames;
+}
+
+void DuckingStage::onEventFired(const bluetooth::BluetoothEvent& event) {
+    if(bluetooth::BluetoothEventType::AUDIO_DUCKING_CHANGED != event.getType()) {
+        return;
+    }
+    m_ducked = event.isDucked();
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
@@ -0,0 +1,198 @@
+#include "Common/Utils/Audio/EqualizerStage.h"
+#include "Common/Utils/Audio/FormatConverter.h"
+#include "Common/Utils/Logger/Log.h"
+
+#include <cmath>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_EQUALIZERSTAGE = "EqualizerStage\t";
+
+constexpr size_t EqualizerStage::MAX_BANDS;
+constexpr unsigned int EqualizerStage::NEW_SET;
+
+static bool isValid(const EqualizerStage::Band& band) {
+    return band.frequencyHz > 0.0f && band.q > 0.0f && std::isfinite(band.gainDb) && std::isfinite(band.q);
+}
+
+EqualizerStage::EqualizerStage() :
+        m_sampleRateHz{0},
+        m_spareSet{1},
+        m_pendingSet{2},
+        m_currentSet{0},
+        m_numChannels{1} {
+    for(auto& set : m_sets) {
+        set.numSections = 0;
+    }
+}
+
+bool EqualizerStage::setBands(const std::vector<Band>& bands) {
+    if(bands.size() > MAX_BANDS) {
+        LOG_ERROR << TAG_EQUALIZERSTAGE << "setBandsFailed; reason: too many bands; bands: " << bands.size();
+        return false;
+    }
+    for(const auto& band : bands) {
+        if(!isValid(band)) {
+            LOG_ERROR << TAG_EQUALIZERSTAGE << "setBandsFailed; reason: invalid band; frequencyHz: " << band.frequencyHz
+                      << "; gainDb: " << band.gainDb << "; q: " << band.q;
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(m_bandsMutex);
+    if(m_sampleRateHz > 0 && !publish(bands, m_sampleRateHz)) {
+        return false;
+    }
+    m_bands = bands;
+    return true;
+}
+
+std::vector<EqualizerStage::Band> EqualizerStage::getBands() const {
+    std::lock_guard<std::mutex> guard(m_bandsMutex);
+    return m_bands;
+}
+
+bool EqualizerStage::computeCoefficients(
+    const Band& band,
+    unsigned int sampleRateHz,
+    BiquadCoefficients* coefficients) {
+    if(!isValid(band) || 2 * band.frequencyHz >= sampleRateHz) {
+        LOG_ERROR << TAG_EQUALIZERSTAGE << "computeCoefficientsFailed; reason: invalid band; frequencyHz: "
+                  << band.frequencyHz << "; sampleRateHz: " << sampleRateHz;
+        return false;
+    }
+
+    // Computed in double precision, as the coefficients of low bands are close to each other.
+    const double a = std::pow(10.0, band.gainDb / 40.0);
+    const double w0 = 2.0 * M_PI * band.frequencyHz / sampleRateHz;
+    const double cosW0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * band.q);
+    const double shelfAlpha = 2.0 * std::sqrt(a) * alpha;
+    double b0, b1, b2, a0, a1, a2;
+    switch(band.type) {
+        case FilterType::PEAKING:
+            b0 = 1.0 + alpha * a;
+            b1 = -2.0 * cosW0;
+            b2 = 1.0 - alpha * a;
+            a0 = 1.0 + alpha / a;
+            a1 = -2.0 * cosW0;
+            a2 = 1.0 - alpha / a;
+            break;
+        case FilterType::LOW_SHELF:
+            b0 = a * ((a + 1.0) - (a - 1.0) * cosW0 + shelfAlpha);
+            b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cosW0);
+            b2 = a * ((a + 1.0) - (a - 1.0) * cosW0 - shelfAlpha);
+            a0 = (a + 1.0) + (a - 1.0) * cosW0 + shelfAlpha;
+            a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cosW0);
+            a2 = (a + 1.0) + (a - 1.0) * cosW0 - shelfAlpha;
+            break;
+        case FilterType::HIGH_SHELF:
+            b0 = a * ((a + 1.0) + (a - 1.0) * cosW0 + shelfAlpha);
+            b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cosW0);
+            b2 = a * ((a + 1.0) + (a - 1.0) * cosW0 - shelfAlpha);
+            a0 = (a + 1.0) - (a - 1.0) * cosW0 + shelfAlpha;
+            a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cosW0);
+            a2 = (a + 1.0) - (a - 1.0) * cosW0 - shelfAlpha;
+            break;
+        case FilterType::LOW_PASS:
+            b0 = (1.0 - cosW0) / 2.0;
+            b1 = 1.0 - cosW0;
+            b2 = (1.0 - cosW0) / 2.0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cosW0;
+            a2 = 1.0 - alpha;
+            break;
+        case FilterType::HIGH_PASS:
+            b0 = (1.0 + cosW0) / 2.0;
+            b1 = -(1.0 + cosW0);
+            b2 = (1.0 + cosW0) / 2.0;
+            a0 = 1.0 + alpha;
+            a1 = -2.0 * cosW0;
+            a2 = 1.0 - alpha;
+            break;
+        default:
+            LOG_ERROR << TAG_EQUALIZERSTAGE << "computeCoefficientsFailed; reason: unknown filter type";
+            return false;
+    }
+
+    coefficients->b0 = static_cast<float>(b0 / a0);
+    coefficients->b1 = static_cast<float>(b1 / a0);
+    coefficients->b2 = static_cast<float>(b2 / a0);
+    coefficients->a1 = static_cast<float>(a1 / a0);
+    coefficients->a2 = static_cast<float>(a2 / a0);
+    return true;
+}
+
+bool EqualizerStage::publish(const std::vector<Band>& bands, unsigned int sampleRateHz) {
+    CoefficientSet& set = m_sets[m_spareSet];
+    for(size_t i = 0; i < bands.size(); ++i) {
+        if(!computeCoefficients(bands[i], sampleRateHz, &set.sections[i])) {
+            return false;
+        }
+    }
+    set.numSections = bands.size();
+    // The exchange releases the coefficients to the audio thread, and hands over the set it did not pick up, if any.
+    m_spareSet = m_pendingSet.exchange(m_spareSet | NEW_SET) & ~NEW_SET;
+    return true;
+}
+
+std::string EqualizerStage::getName() const {
+    return "Equalizer";
+}
+
+bool EqualizerStage::configure(
+    const AudioFormat& inputFormat,
+    size_t maxInputFrames,
+    AudioFormat* outputFormat,
+    size_t* maxOutputFrames) {
+    if(!FormatConverter::isHostFloat(inputFormat)) {
+        LOG_ERROR << TAG_EQUALIZERSTAGE << "configureFailed; reason: input is not float; sampleSizeInBits: "
+                  << inputFormat.sampleSizeInBits;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(m_bandsMutex);
+    if(!publish(m_bands, inputFormat.sampleRateHz)) {
+        LOG_ERROR << TAG_EQUALIZERSTAGE << "configureFailed; reason: bands invalid for the sample rate; sampleRateHz: "
+                  << inputFormat.sampleRateHz;
+        return false;
+    }
+    m_sampleRateHz = inputFormat.sampleRateHz;
+    m_numChannels = inputFormat.numChannels;
+    const unsigned int groups = (m_numChannels + BIQUAD_LANES - 1) / BIQUAD_LANES;
+    m_state.assign(MAX_BANDS * groups * 2 * BIQUAD_LANES, 0.0f);
+
+    *outputFormat = inputFormat;
+    *maxOutputFrames = maxInputFrames;
+    return true;
+}
+
+bool EqualizerStage::canProcessInPlace() const {
+    return true;
+}
+
+size_t EqualizerStage::process(const unsigned char* input, unsigned char* output, size_t frames) {
+    if(m_pendingSet.load() & NEW_SET) {
+        m_currentSet = m_pendingSet.exchange(m_currentSet) & ~NEW_SET;
+    }
+    const CoefficientSet& set = m_sets[m_currentSet];
+    biquadCascade(
+        reinterpret_cast<const float*>(input),
+        frames,
+        m_numChannels,
+        set.sections,
+        set.numSections,
+        m_state.data(),
+        reinterpret_cast<float*>(output));
+    return frames;
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
@@ -0,0 +1,296 @@
+#include "Common/Utils/Audio/FormatConverter.h"
+#include "Common/Utils/Audio/PCMKernels.h"
+#include "Common/Utils/Logger/Log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_FORMATCONVERTER = "FormatConverter\t";
+
+// The float equal to the full scale of a 16-bit sample.
+constexpr float INT16_FULL_SCALE = 32768.0f;
+
+/**
+ * The kernels working on the bytes of a sample type.
+ */
+template <typename Sample>
+struct SampleTraits;
+
+template <>
+struct SampleTraits<int16_t> {
+    using Word = uint16_t;
+
+    static void swap(const Word* input, size_t count, Word* output) {
+        swapBytes16(input, count, output);
+    }
+};
+
+template <>
+struct SampleTraits<float> {
+    using Word = uint32_t;
+
+    static void swap(const Word* input, size_t count, Word* output) {
+        swapBytes32(input, count, output);
+    }
+};
+
+/**
+ * The kernel converting samples of one type to another.
+ */
+template <typename From, typename To>
+struct SampleConversion;
+
+template <>
+struct SampleConversion<int16_t, float> {
+    static void convert(const int16_t* input, size_t count, float* output) {
+        scaleToFloat(input, count, 1.0f / INT16_FULL_SCALE, output);
+    }
+};
+
+template <>
+struct SampleConversion<float, int16_t> {
+    static void convert(const float* input, size_t count, int16_t* output) {
+        scaleToInt16(input, count, INT16_FULL_SCALE, output);
+    }
+};
+
+template <typename Sample>
+static void copyStep(const uint8_t* input, size_t frames, unsigned int channels, uint8_t* output) {
+    memcpy(output, input, frames * channels * sizeof(Sample));
+}
+
+template <typename Sample>
+static void swapStep(const uint8_t* input, size_t frames, unsigned int channels, uint8_t* output) {
+    using Word = typename SampleTraits<Sample>::Word;
+    SampleTraits<Sample>::swap(
+        reinterpret_cast<const Word*>(input), frames * channels, reinterpret_cast<Word*>(output));
+}
+
+template <typename From, typename To>
+static void convertStep(const uint8_t* input, size_t frames, unsigned int channels, uint8_t* output) {
+    SampleConversion<From, To>::convert(
+        reinterpret_cast<const From*>(input), frames * channels, reinterpret_cast<To*>(output));
+}
+
+template <typename Sample>
+static void downmixStep(const uint8_t* input, size_t frames, unsigned int /*channels*/, uint8_t* output) {
+    downmixStereo(reinterpret_cast<const Sample*>(input), frames, reinterpret_cast<Sample*>(output));
+}
+
+template <typename Sample>
+static void interleaveStereoStep(const uint8_t* input, size_t frames, unsigned int /*channels*/, uint8_t* output) {
+    const Sample* planes = reinterpret_cast<const Sample*>(input);
+    interleaveStereo(planes, planes + frames, frames, reinterpret_cast<Sample*>(output));
+}
+
+template <typename Sample>
+static void interleaveStep(const uint8_t* input, size_t frames, unsigned int channels, uint8_t* output) {
+    const Sample* planes = reinterpret_cast<const Sample*>(input);
+    Sample* samples = reinterpret_cast<Sample*>(output);
+    for(unsigned int channel = 0; channel < channels; ++channel) {
+        const Sample* plane = planes + channel * frames;
+        for(size_t frame = 0; frame < frames; ++frame) {
+            samples[frame * channels + channel] = plane[frame];
+        }
+    }
+}
+
+template <typename Sample>
+static void deinterleaveStereoStep(const uint8_t* input, size_t frames, unsigned int /*channels*/, uint8_t* output) {
+    Sample* planes = reinterpret_cast<Sample*>(output);
+    deinterleaveStereo(reinterpret_cast<const Sample*>(input), frames, planes, planes + frames);
+}
+
+template <typename Sample>
+static void deinterleaveStep(const uint8_t* input, size_t frames, unsigned int channels, uint8_t* output) {
+    const Sample* samples = reinterpret_cast<const Sample*>(input);
+    Sample* planes = reinterpret_cast<Sample*>(output);
+    for(unsigned int channel = 0; channel < channels; ++channel) {
+        Sample* plane = planes + channel * frames;
+        for(size_t frame = 0; frame < frames; ++frame) {
+            plane[frame] = samples[frame * channels + channel];
+        }
+    }
+}
+
+// Whether a supported format holds float samples.
+static bool isFloat(const AudioFormat& format) {
+    return 32 == format.sampleSizeInBits;
+}
+
+// Whether a supported format holds a plane per channel.
+static bool isPlanar(const AudioFormat& format) {
+    return format.numChannels > 1 && AudioFormat::Layout::NON_INTERLEAVED == format.layout;
+}
+
+std::unique_ptr<FormatConverter> FormatConverter::create(const AudioFormat& source, const AudioFormat& target) {
+    if(!isSupported(source) || !isSupported(target)) {
+        LOG_ERROR << TAG_FORMATCONVERTER << "createFailed; reason: unsupported format; source: " << source.encoding
+                  << "/" << source.sampleSizeInBits << "bit/" << source.numChannels << "ch; target: " << target.encoding
+                  << "/" << target.sampleSizeInBits << "bit/" << target.numChannels << "ch";
+        return nullptr;
+    }
+    if(source.sampleRateHz != target.sampleRateHz) {
+        LOG_ERROR << TAG_FORMATCONVERTER << "createFailed; reason: sample rates differ; source: " << source.sampleRateHz
+                  << "; target: " << target.sampleRateHz;
+        return nullptr;
+    }
+    if(source.numChannels != target.numChannels && !(2 == source.numChannels && 1 == target.numChannels)) {
+        LOG_ERROR << TAG_FORMATCONVERTER << "createFailed; reason: unsupported channel conversion; source: "
+                  << source.numChannels << "; target: " << target.numChannels;
+        return nullptr;
+    }
+
+    return std::unique_ptr<FormatConverter>(new FormatConverter(source, target));
+}
+
+bool FormatConverter::isSupported(const AudioFormat& format) {
+    return AudioFormat::Encoding::LPCM == format.encoding && format.dataSigned &&
+           (16 == format.sampleSizeInBits || 32 == format.sampleSizeInBits) && format.numChannels > 0;
+}
+
+bool FormatConverter::isHostFloat(const AudioFormat& format) {
+    return isSupported(format) && isFloat(format) && !isPlanar(format) && getHostEndianness() == format.endianness;
+}
+
+AudioFormat::Endianness FormatConverter::getHostEndianness() {
+    const uint16_t probe = 1;
+    uint8_t firstByte;
+    memcpy(&firstByte, &probe, 1);
+    return 1 == firstByte ? AudioFormat::Endianness::LITTLE : AudioFormat::Endianness::BIG;
+}
+
+FormatConverter::FormatConverter(const AudioFormat& source, const AudioFormat& target) :
+        m_source(source),
+        m_target(target),
+        m_sourceFrameSize{source.numChannels * source.sampleSizeInBits / 8},
+        m_targetFrameSize{target.numChannels * target.sampleSizeInBits / 8},
+        m_numSteps{0},
+        m_maxIntermediateFrameSize{0} {
+    const bool sourceFloat = isFloat(source);
+    const bool targetFloat = isFloat(target);
+    const size_t sourceSampleSize = source.sampleSizeInBits / 8;
+    const size_t targetSampleSize = target.sampleSizeInBits / 8;
+    const bool downmix = source.numChannels != target.numChannels;
+    unsigned int channels = source.numChannels;
+
+    // Bring the samples to the host byte order and interleave them, so that the other kernels can work on them.
+    if(getHostEndianness() != source.endianness) {
+        addStep(sourceFloat ? swapStep<float> : swapStep<int16_t>, channels, sourceSampleSize);
+    }
+    if(isPlanar(source)) {
+        if(2 == channels) {
+            addStep(
+                sourceFloat ? interleaveStereoStep<float> : interleaveStereoStep<int16_t>, channels, sourceSampleSize);
+        } else {
+            addStep(sourceFloat ? interleaveStep<float> : interleaveStep<int16_t>, channels, sourceSampleSize);
+        }
+    }
+
+    // Mix down on the float side of the conversion, if any, where the average is not rounded.
+    if(downmix && sourceFloat) {
+        addStep(downmixStep<float>, channels, sourceSampleSize);
+        channels = 1;
+    }
+    if(sourceFloat != targetFloat) {
+        addStep(sourceFloat ? convertStep<float, int16_t> : convertStep<int16_t, float>, channels, targetSampleSize);
+    }
+    if(downmix && !sourceFloat) {
+        addStep(targetFloat ? downmixStep<float> : downmixStep<int16_t>, channels, targetSampleSize);
+        channels = 1;
+    }
+
+    if(isPlanar(target)) {
+        if(2 == channels) {
+            addStep(
+                targetFloat ? deinterleaveStereoStep<float> : deinterleaveStereoStep<int16_t>,
+                channels,
+                targetSampleSize);
+        } else {
+            addStep(targetFloat ? deinterleaveStep<float> : deinterleaveStep<int16_t>, channels, targetSampleSize);
+        }
+    }
+    if(getHostEndianness() != target.endianness) {
+        addStep(targetFloat ? swapStep<float> : swapStep<int16_t>, channels, targetSampleSize);
+    }
+
+    if(0 == m_numSteps) {
+        addStep(targetFloat ? copyStep<float> : copyStep<int16_t>, channels, targetSampleSize);
+    }
+}
+
+void FormatConverter::addStep(Step step, unsigned int channels, size_t outputSampleSize) {
+    m_steps[m_numSteps] = step;
+    m_stepChannels[m_numSteps] = channels;
+    ++m_numSteps;
+    m_maxIntermediateFrameSize = std::max(m_maxIntermediateFrameSize, channels * outputSampleSize);
+}
+
+size_t FormatConverter::convert(
+    const unsigned char* input,
+    size_t inputSize,
+    unsigned char* output,
+    size_t outputSize) {
+    if(!input || !output) {
+        LOG_ERROR << TAG_FORMATCONVERTER << "convertFailed; reason: buffer is null";
+        return 0;
+    }
+    const size_t frames = inputSize / m_sourceFrameSize;
+    const size_t convertedSize = frames * m_targetFrameSize;
+    if(outputSize < convertedSize) {
+        LOG_ERROR << TAG_FORMATCONVERTER << "convertFailed; reason: output too small; outputSize: " << outputSize
+                  << "; needed: " << convertedSize;
+        return 0;
+    }
+    if(0 == frames) {
+        return 0;
+    }
+
+    reserve(frames);
+
+    // Each step reads what the one before produced, alternating between the intermediate buffers, and the last one
+    // writes the output.
+    const uint8_t* from = input;
+    for(size_t i = 0; i < m_numSteps; ++i) {
+        uint8_t* to = i + 1 == m_numSteps ? output : m_intermediate[i % 2].data();
+        m_steps[i](from, frames, m_stepChannels[i], to);
+        from = to;
+    }
+    return convertedSize;
+}
+
+void FormatConverter::reserve(size_t frames) {
+    if(m_numSteps < 2) {
+        return;
+    }
+    const size_t intermediateSize = frames * m_maxIntermediateFrameSize;
+    for(auto& intermediate : m_intermediate) {
+        if(intermediate.size() < intermediateSize) {
+            intermediate.resize(intermediateSize);
+        }
+    }
+}
+
+size_t FormatConverter::getOutputSize(size_t inputSize) const {
+    return inputSize / m_sourceFrameSize * m_targetFrameSize;
+}
+
+AudioFormat FormatConverter::getSourceFormat() const {
+    return m_source;
+}
+
+AudioFormat FormatConverter::getTargetFormat() const {
+    return m_target;
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
@@ -0,0 +1,112 @@
+#include "Common/Utils/Audio/FractionalResampler.h"
+#include "Common/Utils/Logger/Log.h"
+
+#include <algorithm>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_FRACTIONALRESAMPLER = "FractionalResampler\t";
+
+// Number of input frames kept from one block to the next: the interpolation around a position needs one frame before
+// it and two after it.
+constexpr size_t HISTORY_FRAMES = 3;
+
+// One input frame in 32.32 fixed point.
+constexpr uint64_t ONE_FRAME = uint64_t(1) << 32;
+
+FractionalResampler::FractionalResampler(unsigned int numChannels) : m_ratio{1.0}, m_step{ONE_FRAME} {
+    reset(numChannels);
+}
+
+void FractionalResampler::reset(unsigned int numChannels) {
+    m_numChannels = std::max(numChannels, 1u);
+    m_history.assign(HISTORY_FRAMES * m_numChannels, 0);
+    m_position = ONE_FRAME;
+    m_primed = false;
+}
+
+void FractionalResampler::setRatio(double ratio) {
+    if(ratio <= 0) {
+        LOG_ERROR << TAG_FRACTIONALRESAMPLER << "setRatioFailed; reason: invalid ratio; ratio: " << ratio;
+        return;
+    }
+    m_ratio = ratio;
+    m_step = static_cast<uint64_t>(ratio * ONE_FRAME + 0.5);
+}
+
+double FractionalResampler::getRatio() const {
+    return m_ratio;
+}
+
+unsigned int FractionalResampler::getNumChannels() const {
+    return m_numChannels;
+}
+
+size_t FractionalResampler::getMaxOutputFrames(size_t inputFrames) const {
+    return static_cast<size_t>(inputFrames / m_ratio) + 2;
+}
+
+size_t FractionalResampler::process(const int16_t* input, size_t inputFrames, int16_t* output, size_t outputFrames) {
+    if(0 == inputFrames) {
+        return 0;
+    }
+
+    const size_t channels = m_numChannels;
+    if(!m_primed) {
+        // Start from the first frame held still, rather than from silence.
+        for(size_t i = 0; i < m_history.size(); ++i) {
+            m_history[i] = input[i % channels];
+        }
+        m_primed = true;
+    }
+
+    // The frames interpolated between are numbered across the history and the input block.
+    auto sampleAt = [&](size_t frame, size_t channel) -> float {
+        return frame < HISTORY_FRAMES ? m_history[frame * channels + channel]
+                                      : input[(frame - HISTORY_FRAMES) * channels + channel];
+    };
+
+    size_t produced = 0;
+    // The last position interpolated from this block needs the last input frame two frames after it.
+    while((m_position >> 32) <= inputFrames && produced < outputFrames) {
+        const size_t frame = static_cast<size_t>(m_position >> 32);
+        const float t = static_cast<float>(m_position & (ONE_FRAME - 1)) / ONE_FRAME;
+        for(size_t channel = 0; channel < channels; ++channel) {
+            const float x0 = sampleAt(frame - 1, channel);
+            const float x1 = sampleAt(frame, channel);
+            const float x2 = sampleAt(frame + 1, channel);
+            const float x3 = sampleAt(frame + 2, channel);
+            const float y =
+                x1 + 0.5f * t * (x2 - x0 + t * (2 * x0 - 5 * x1 + 4 * x2 - x3 + t * (3 * (x1 - x2) + x3 - x0)));
+            output[channel] = static_cast<int16_t>(std::min(std::max(y + (y < 0 ? -0.5f : 0.5f), -32768.0f), 32767.0f));
+        }
+        output += channels;
+        ++produced;
+        m_position += m_step;
+    }
+
+    if((m_position >> 32) <= inputFrames) {
+        LOG_ERROR << TAG_FRACTIONALRESAMPLER << "processFailed; reason: output buffer too small";
+        m_position = ((inputFrames + 1) << 32) | (m_position & (ONE_FRAME - 1));
+    }
+
+    // Keep the last frames for the next block, and make the position relative to them.
+    for(size_t frame = 0; frame < HISTORY_FRAMES; ++frame) {
+        for(size_t channel = 0; channel < channels; ++channel) {
+            m_history[frame * channels + channel] = static_cast<int16_t>(sampleAt(inputFrames + frame, channel));
+        }
+    }
+    m_position -= static_cast<uint64_t>(inputFrames) << 32;
+
+    return produced;
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
@@ -0,0 +1,64 @@
+#include "Common/Utils/Audio/GainStage.h"
+#include "Common/Utils/Audio/FormatConverter.h"
+#include "Common/Utils/Audio/PCMKernels.h"
+#include "Common/Utils/Logger/Log.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_GAINSTAGE = "GainStage\t";
+
+GainStage::GainStage(float gain) : m_gain{gain >= 0.0f ? gain : 1.0f}, m_numChannels{1} {
+}
+
+bool GainStage::setGain(float gain) {
+    if(!(gain >= 0.0f)) {
+        LOG_ERROR << TAG_GAINSTAGE << "setGainFailed; reason: invalid gain; gain: " << gain;
+        return false;
+    }
+    m_gain = gain;
+    return true;
+}
+
+float GainStage::getGain() const {
+    return m_gain;
+}
+
+std::string GainStage::getName() const {
+    return "Gain";
+}
+
+bool GainStage::configure(
+    const AudioFormat& inputFormat,
+    size_t maxInputFrames,
+    AudioFormat* outputFormat,
+    size_t* maxOutputFrames) {
+    if(!FormatConverter::isHostFloat(inputFormat)) {
+        LOG_ERROR << TAG_GAINSTAGE << "configureFailed; reason: input is not float; sampleSizeInBits: "
+                  << inputFormat.sampleSizeInBits;
+        return false;
+    }
+    m_numChannels = inputFormat.numChannels;
+    *outputFormat = inputFormat;
+    *maxOutputFrames = maxInputFrames;
+    return true;
+}
+
+bool GainStage::canProcessInPlace() const {
+    return true;
+}
+
+size_t GainStage::process(const unsigned char* input, unsigned char* output, size_t frames) {
+    scaleFloat(
+        reinterpret_cast<const float*>(input), frames * m_numChannels, m_gain, reinterpret_cast<float*>(output));
+    return frames;
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
@@ -0,0 +1,201 @@
+#include "Common/Utils/Audio/LimiterStage.h"
+#include "Common/Utils/Audio/FormatConverter.h"
+#include "Common/Utils/Logger/Log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_LIMITERSTAGE = "LimiterStage\t";
+
+// Wraps a position past the end of a ring back to its start, cheaper than a division on the audio path.
+static size_t wrap(size_t position, size_t size) {
+    return position >= size ? position - size : position;
+}
+
+LimiterStage::LimiterStage(float ceiling, std::chrono::microseconds lookAhead, std::chrono::milliseconds release) :
+        m_lookAhead{std::max(lookAhead, std::chrono::microseconds(0))},
+        m_ceiling{ceiling > 0.0f ? ceiling : 1.0f},
+        m_releaseCoefficient{1.0f},
+        m_lastGain{1.0f},
+        m_release{std::max(release, std::chrono::milliseconds(0))},
+        m_sampleRateHz{0},
+        m_numChannels{1},
+        m_windowFrames{1},
+        m_frameIndex{0},
+        m_position{0},
+        m_minGainsStart{0},
+        m_minGainsSize{0},
+        m_releasedGain{1.0f} {
+}
+
+bool LimiterStage::setCeiling(float ceiling) {
+    if(!(ceiling > 0.0f)) {
+        LOG_ERROR << TAG_LIMITERSTAGE << "setCeilingFailed; reason: invalid ceiling; ceiling: " << ceiling;
+        return false;
+    }
+    m_ceiling = ceiling;
+    return true;
+}
+
+bool LimiterStage::setRelease(std::chrono::milliseconds release) {
+    if(release.count() < 0) {
+        LOG_ERROR << TAG_LIMITERSTAGE << "setReleaseFailed; reason: invalid release; release: " << release.count();
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(m_parametersMutex);
+    m_release = release;
+    if(m_sampleRateHz > 0) {
+        m_releaseCoefficient = computeReleaseCoefficient(m_release, m_sampleRateHz);
+    }
+    return true;
+}
+
+size_t LimiterStage::getLatencyFrames() const {
+    return m_windowFrames - 1;
+}
+
+float LimiterStage::getGain() const {
+    return m_lastGain;
+}
+
+float LimiterStage::computeReleaseCoefficient(std::chrono::milliseconds release, unsigned int sampleRateHz) {
+    const double releaseFrames = release.count() * sampleRateHz / 1000.0;
+    return releaseFrames < 1.0 ? 1.0f : static_cast<float>(1.0 - std::exp(-1.0 / releaseFrames));
+}
+
+std::string LimiterStage::getName() const {
+    return "Limiter";
+}
+
+bool LimiterStage::configure(
+    const AudioFormat& inputFormat,
+    size_t maxInputFrames,
+    AudioFormat* outputFormat,
+    size_t* maxOutputFrames) {
+    if(!FormatConverter::isHostFloat(inputFormat)) {
+        LOG_ERROR << TAG_LIMITERSTAGE << "configureFailed; reason: input is not float; sampleSizeInBits: "
+                  << inputFormat.sampleSizeInBits;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_parametersMutex);
+        m_sampleRateHz = inputFormat.sampleRateHz;
+        m_releaseCoefficient = computeReleaseCoefficient(m_release, m_sampleRateHz);
+    }
+
+    // The window covers the frame leaving the delay and the look-ahead time after it.
+    m_numChannels = inputFormat.numChannels;
+    m_windowFrames = 1 + static_cast<size_t>(m_lookAhead.count() * inputFormat.sampleRateHz / 1000000);
+    m_frameIndex = 0;
+    m_position = 0;
+    m_delay.assign(m_windowFrames * m_numChannels, 0.0f);
+    m_minGains.assign(m_windowFrames, 1.0f);
+    m_minGainIndices.assign(m_windowFrames, 0);
+    m_minGainsStart = 0;
+    m_minGainsSize = 0;
+    m_heldGains.assign(m_windowFrames, 1.0f);
+    m_releasedGain = 1.0f;
+    m_lastGain = 1.0f;
+
+    *outputFormat = inputFormat;
+    *maxOutputFrames = maxInputFrames;
+    return true;
+}
+
+bool LimiterStage::canProcessInPlace() const {
+    return true;
+}
+
+size_t LimiterStage::process(const unsigned char* input, unsigned char* output, size_t frames) {
+    const float* samples = reinterpret_cast<const float*>(input);
+    float* limited = reinterpret_cast<float*>(output);
+    const unsigned int channels = m_numChannels;
+    const float ceiling = m_ceiling;
+    const float releaseCoefficient = m_releaseCoefficient;
+    const size_t window = m_windowFrames;
+    const double averageScale = 1.0 / window;
+    float* minGains = m_minGains.data();
+    uint64_t* minGainIndices = m_minGainIndices.data();
+    float* heldGains = m_heldGains.data();
+    float* delay = m_delay.data();
+
+    // The state is worked on in locals, which the compiler can keep in registers as they cannot alias the output.
+    uint64_t frameIndex = m_frameIndex;
+    size_t position = m_position;
+    size_t minGainsStart = m_minGainsStart;
+    size_t minGainsSize = m_minGainsSize;
+    float releasedGain = m_releasedGain;
+    float lowestGain = 1.0f;
+
+    // The sum of the window is taken again for each block, so that rounding errors do not build up.
+    double heldGainsSum = 0.0;
+    for(size_t i = 0; i < window; ++i) {
+        heldGainsSum += heldGains[i];
+    }
+
+    for(size_t i = 0; i < frames; ++i, ++frameIndex) {
+        const float* frame = samples + i * channels;
+        float peak = 0.0f;
+        for(unsigned int channel = 0; channel < channels; ++channel) {
+            peak = std::max(peak, std::fabs(frame[channel]));
+        }
+        const float neededGain = peak > ceiling ? ceiling / peak : 1.0f;
+
+        // Hold the lowest gain needed over the window, keeping the gains which may become the lowest as older ones
+        // leave the window in increasing order.
+        if(minGainsSize > 0 && minGainIndices[minGainsStart] + window <= frameIndex) {
+            minGainsStart = wrap(minGainsStart + 1, window);
+            --minGainsSize;
+        }
+        while(minGainsSize > 0 && minGains[wrap(minGainsStart + minGainsSize - 1, window)] >= neededGain) {
+            --minGainsSize;
+        }
+        const size_t back = wrap(minGainsStart + minGainsSize, window);
+        minGains[back] = neededGain;
+        minGainIndices[back] = frameIndex;
+        ++minGainsSize;
+        const float heldGain = minGains[minGainsStart];
+
+        // Drop to the held gain at once, recover from it slowly; the average over the window then ramps the drop.
+        releasedGain =
+            heldGain < releasedGain ? heldGain : releasedGain + (heldGain - releasedGain) * releaseCoefficient;
+        heldGainsSum += releasedGain - heldGains[position];
+        heldGains[position] = releasedGain;
+        const float gain = std::min(static_cast<float>(heldGainsSum * averageScale), 1.0f);
+        lowestGain = std::min(lowestGain, gain);
+
+        // Push the frame into the delay, and send out the oldest one, which entered it a window ago.
+        const size_t next = wrap(position + 1, window);
+        float* delayed = delay + position * channels;
+        const float* oldest = delay + next * channels;
+        float* out = limited + i * channels;
+        for(unsigned int channel = 0; channel < channels; ++channel) {
+            delayed[channel] = frame[channel];
+        }
+        for(unsigned int channel = 0; channel < channels; ++channel) {
+            out[channel] = oldest[channel] * gain;
+        }
+        position = next;
+    }
+
+    m_frameIndex = frameIndex;
+    m_position = position;
+    m_minGainsStart = minGainsStart;
+    m_minGainsSize = minGainsSize;
+    m_releasedGain = releasedGain;
+    m_lastGain = lowestGain;
+    return frames;
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
@@ -0,0 +1,80 @@
+#include "Common/Utils/Audio/MeterStage.h"
+#include "Common/Utils/Audio/FormatConverter.h"
+#include "Common/Utils/Audio/PCMKernels.h"
+#include "Common/Utils/Logger/Log.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_METERSTAGE = "MeterStage\t";
+
+MeterStage::MeterStage() : m_numChannels{1}, m_peak{0.0f}, m_rms{0.0f}, m_maxPeak{0.0f} {
+}
+
+float MeterStage::getPeak() const {
+    return m_peak;
+}
+
+float MeterStage::getRms() const {
+    return m_rms;
+}
+
+float MeterStage::takeMaxPeak() {
+    return m_maxPeak.exchange(0.0f);
+}
+
+std::string MeterStage::getName() const {
+    return "Meter";
+}
+
+bool MeterStage::configure(
+    const AudioFormat& inputFormat,
+    size_t maxInputFrames,
+    AudioFormat* outputFormat,
+    size_t* maxOutputFrames) {
+    if(!FormatConverter::isHostFloat(inputFormat)) {
+        LOG_ERROR << TAG_METERSTAGE << "configureFailed; reason: input is not float; sampleSizeInBits: "
+                  << inputFormat.sampleSizeInBits;
+        return false;
+    }
+    m_numChannels = inputFormat.numChannels;
+    *outputFormat = inputFormat;
+    *maxOutputFrames = maxInputFrames;
+    return true;
+}
+
+bool MeterStage::canProcessInPlace() const {
+    return true;
+}
+
+size_t MeterStage::process(const unsigned char* input, unsigned char* output, size_t frames) {
+    const size_t count = frames * m_numChannels;
+    const float* samples = reinterpret_cast<const float*>(input);
+    if(input != output) {
+        memcpy(output, input, count * sizeof(float));
+    }
+    if(0 == count) {
+        return frames;
+    }
+
+    const float peak = peakAbsolute(samples, count);
+    m_peak = peak;
+    m_rms = std::sqrt(dotProduct(samples, samples, count) / count);
+    // Only this thread raises the maximum, but another may reset it: retry if it did meanwhile.
+    float maxPeak = m_maxPeak.load();
+    while(peak > maxPeak && !m_maxPeak.compare_exchange_weak(maxPeak, peak)) {
+    }
+    return frames;
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
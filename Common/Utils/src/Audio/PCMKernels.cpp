@@ -0,0 +1,697 @@
+#include "Common/Utils/Audio/PCMKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PCM_KERNELS_NEON
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PCM_KERNELS_SSE2
+#endif
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+// Range of a 16-bit sample, as floats.
+constexpr float INT16_MIN_FLOAT = -32768.0f;
+constexpr float INT16_MAX_FLOAT = 32767.0f;
+
+// Number of samples processed per iteration of the vectorized loops.
+constexpr size_t VECTOR_SAMPLES = 8;
+
+// State of a biquad section below which it is flushed to zero, so that a filter fading out on silence does not run on
+// denormals, which are very slow on some processors.
+constexpr float BIQUAD_STATE_FLOOR = 1e-15f;
+
+static int16_t saturateSample(float value) {
+    return static_cast<int16_t>(std::lrint(std::min(std::max(value, INT16_MIN_FLOAT), INT16_MAX_FLOAT)));
+}
+
+const char* getPCMKernelsName() {
+#if defined(PCM_KERNELS_NEON)
+    return "NEON";
+#elif defined(PCM_KERNELS_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void scaleToFloat(const int16_t* input, size_t count, float gain, float* output) {
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON)
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        const int16x8_t samples = vld1q_s16(input + i);
+        vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))), gain));
+        vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))), gain));
+    }
+#elif defined(PCM_KERNELS_SSE2)
+    const __m128 gains = _mm_set1_ps(gain);
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        // Sign extend by moving each sample to the top half of a 32-bit lane, and shifting it back down.
+        const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), gains));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), gains));
+    }
+#endif
+    for(; i < count; ++i) {
+        output[i] = input[i] * gain;
+    }
+}
+
+void accumulateScaled(const int16_t* input, size_t count, float gain, float* accumulator) {
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON)
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        const int16x8_t samples = vld1q_s16(input + i);
+        const float32x4_t low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples)));
+        const float32x4_t high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples)));
+        vst1q_f32(accumulator + i, vmlaq_n_f32(vld1q_f32(accumulator + i), low, gain));
+        vst1q_f32(accumulator + i + 4, vmlaq_n_f32(vld1q_f32(accumulator + i + 4), high, gain));
+    }
+#elif defined(PCM_KERNELS_SSE2)
+    const __m128 gains = _mm_set1_ps(gain);
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+        _mm_storeu_ps(
+            accumulator + i, _mm_add_ps(_mm_loadu_ps(accumulator + i), _mm_mul_ps(_mm_cvtepi32_ps(low), gains)));
+        _mm_storeu_ps(
+            accumulator + i + 4,
+            _mm_add_ps(_mm_loadu_ps(accumulator + i + 4), _mm_mul_ps(_mm_cvtepi32_ps(high), gains)));
+    }
+#endif
+    for(; i < count; ++i) {
+        accumulator[i] += input[i] * gain;
+    }
+}
+
+void scaleFloat(const float* input, size_t count, float gain, float* output) {
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON)
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        vst1q_f32(output + i, vmulq_n_f32(vld1q_f32(input + i), gain));
+        vst1q_f32(output + i + 4, vmulq_n_f32(vld1q_f32(input + i + 4), gain));
+    }
+#elif defined(PCM_KERNELS_SSE2)
+    const __m128 gains = _mm_set1_ps(gain);
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_loadu_ps(input + i), gains));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_loadu_ps(input + i + 4), gains));
+    }
+#endif
+    for(; i < count; ++i) {
+        output[i] = input[i] * gain;
+    }
+}
+
+void rampFloat(
+    const float* input,
+    size_t frames,
+    unsigned int channels,
+    float startGain,
+    float step,
+    float* output) {
+    if(0 == channels) {
+        return;
+    }
+    const size_t count = frames * channels;
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON) || defined(PCM_KERNELS_SSE2)
+    // Mono, stereo and four channel frames fit whole in a vector, so the lanes can be given the offsets of their frames
+    // once; frames of other widths are scaled one sample at a time.
+    if(4 % channels == 0) {
+        const size_t vectorFrames = VECTOR_SAMPLES / channels;
+        float offsets[VECTOR_SAMPLES];
+        for(size_t lane = 0; lane < VECTOR_SAMPLES; ++lane) {
+            offsets[lane] = static_cast<float>(lane / channels);
+        }
+        size_t frame = 0;
+#if defined(PCM_KERNELS_NEON)
+        const float32x4_t lowOffsets = vld1q_f32(offsets);
+        const float32x4_t highOffsets = vld1q_f32(offsets + 4);
+        for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES, frame += vectorFrames) {
+            const float32x4_t base = vdupq_n_f32(startGain + step * frame);
+            const float32x4_t lowGains = vmlaq_n_f32(base, lowOffsets, step);
+            const float32x4_t highGains = vmlaq_n_f32(base, highOffsets, step);
+            vst1q_f32(output + i, vmulq_f32(vld1q_f32(input + i), lowGains));
+            vst1q_f32(output + i + 4, vmulq_f32(vld1q_f32(input + i + 4), highGains));
+        }
+#else
+        const __m128 steps = _mm_set1_ps(step);
+        const __m128 lowOffsets = _mm_mul_ps(_mm_loadu_ps(offsets), steps);
+        const __m128 highOffsets = _mm_mul_ps(_mm_loadu_ps(offsets + 4), steps);
+        for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES, frame += vectorFrames) {
+            const __m128 base = _mm_set1_ps(startGain + step * frame);
+            const __m128 lowGains = _mm_add_ps(base, lowOffsets);
+            const __m128 highGains = _mm_add_ps(base, highOffsets);
+            _mm_storeu_ps(output + i, _mm_mul_ps(_mm_loadu_ps(input + i), lowGains));
+            _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_loadu_ps(input + i + 4), highGains));
+        }
+#endif
+    }
+#endif
+    for(size_t frame = i / channels; frame < frames; ++frame) {
+        const float gain = startGain + step * frame;
+        for(unsigned int channel = 0; channel < channels; ++channel) {
+            output[frame * channels + channel] = input[frame * channels + channel] * gain;
+        }
+    }
+}
+
+float peakAbsolute(const float* input, size_t count) {
+    size_t i = 0;
+    float peak = 0.0f;
+#if defined(PCM_KERNELS_NEON)
+    float32x4_t peaks = vdupq_n_f32(0.0f);
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        peaks = vmaxq_f32(peaks, vabsq_f32(vld1q_f32(input + i)));
+        peaks = vmaxq_f32(peaks, vabsq_f32(vld1q_f32(input + i + 4)));
+    }
+    const float32x2_t pairs = vmax_f32(vget_low_f32(peaks), vget_high_f32(peaks));
+    peak = vget_lane_f32(vpmax_f32(pairs, pairs), 0);
+#elif defined(PCM_KERNELS_SSE2)
+    // Clearing the sign bit gives the magnitude.
+    const __m128 magnitude = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 peaks = _mm_setzero_ps();
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        peaks = _mm_max_ps(peaks, _mm_and_ps(_mm_loadu_ps(input + i), magnitude));
+        peaks = _mm_max_ps(peaks, _mm_and_ps(_mm_loadu_ps(input + i + 4), magnitude));
+    }
+    peaks = _mm_max_ps(peaks, _mm_movehl_ps(peaks, peaks));
+    peaks = _mm_max_ss(peaks, _mm_shuffle_ps(peaks, peaks, _MM_SHUFFLE(1, 1, 1, 1)));
+    peak = _mm_cvtss_f32(peaks);
+#endif
+    for(; i < count; ++i) {
+        peak = std::max(peak, std::fabs(input[i]));
+    }
+    return peak;
+}
+
+float dotProduct(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(PCM_KERNELS_NEON)
+    // Two accumulators, so that consecutive multiply-adds do not wait for each other.
+    float32x4_t low = vdupq_n_f32(0.0f);
+    float32x4_t high = vdupq_n_f32(0.0f);
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        low = vmlaq_f32(low, vld1q_f32(a + i), vld1q_f32(b + i));
+        high = vmlaq_f32(high, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    const float32x4_t sums = vaddq_f32(low, high);
+    const float32x2_t pairs = vadd_f32(vget_low_f32(sums), vget_high_f32(sums));
+    sum = vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+#elif defined(PCM_KERNELS_SSE2)
+    __m128 low = _mm_setzero_ps();
+    __m128 high = _mm_setzero_ps();
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        low = _mm_add_ps(low, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        high = _mm_add_ps(high, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    __m128 sums = _mm_add_ps(low, high);
+    sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+    sums = _mm_add_ss(sums, _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 1, 1, 1)));
+    sum = _mm_cvtss_f32(sums);
+#endif
+    for(; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+#if defined(PCM_KERNELS_NEON)
+/**
+ * Loads the samples of a group of channels of a frame into the first lanes of a vector, the other lanes being zero.
+ *
+ * @tparam LANES The number of channels of the group, at most @c BIQUAD_LANES.
+ * @param input The first sample of the group.
+ * @return The vector.
+ */
+template <unsigned int LANES>
+static float32x4_t loadLanes(const float* input) {
+    float samples[BIQUAD_LANES] = {0.0f, 0.0f, 0.0f, 0.0f};
+    memcpy(samples, input, LANES * sizeof(float));
+    return vld1q_f32(samples);
+}
+
+template <>
+float32x4_t loadLanes<1>(const float* input) {
+    return vld1q_lane_f32(input, vdupq_n_f32(0.0f), 0);
+}
+
+template <>
+float32x4_t loadLanes<2>(const float* input) {
+    return vcombine_f32(vld1_f32(input), vdup_n_f32(0.0f));
+}
+
+template <>
+float32x4_t loadLanes<4>(const float* input) {
+    return vld1q_f32(input);
+}
+
+/**
+ * Stores the first lanes of a vector as the samples of a group of channels of a frame.
+ *
+ * @tparam LANES The number of channels of the group, at most @c BIQUAD_LANES.
+ * @param samples The vector.
+ * @param output The first sample of the group.
+ */
+template <unsigned int LANES>
+static void storeLanes(float32x4_t samples, float* output) {
+    float lanes[BIQUAD_LANES];
+    vst1q_f32(lanes, samples);
+    memcpy(output, lanes, LANES * sizeof(float));
+}
+
+template <>
+void storeLanes<1>(float32x4_t samples, float* output) {
+    vst1q_lane_f32(output, samples, 0);
+}
+
+template <>
+void storeLanes<2>(float32x4_t samples, float* output) {
+    vst1_f32(output, vget_low_f32(samples));
+}
+
+template <>
+void storeLanes<4>(float32x4_t samples, float* output) {
+    vst1q_f32(output, samples);
+}
+#elif defined(PCM_KERNELS_SSE2)
+/**
+ * Loads the samples of a group of channels of a frame into the first lanes of a vector, the other lanes being zero.
+ * Loading each group at its own width avoids stalls on the samples stored by the section before.
+ *
+ * @tparam LANES The number of channels of the group, at most @c BIQUAD_LANES.
+ * @param input The first sample of the group.
+ * @return The vector.
+ */
+template <unsigned int LANES>
+static __m128 loadLanes(const float* input) {
+    float samples[BIQUAD_LANES] = {0.0f, 0.0f, 0.0f, 0.0f};
+    memcpy(samples, input, LANES * sizeof(float));
+    return _mm_loadu_ps(samples);
+}
+
+template <>
+__m128 loadLanes<1>(const float* input) {
+    return _mm_load_ss(input);
+}
+
+template <>
+__m128 loadLanes<2>(const float* input) {
+    return _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(input)));
+}
+
+template <>
+__m128 loadLanes<4>(const float* input) {
+    return _mm_loadu_ps(input);
+}
+
+/**
+ * Stores the first lanes of a vector as the samples of a group of channels of a frame.
+ *
+ * @tparam LANES The number of channels of the group, at most @c BIQUAD_LANES.
+ * @param samples The vector.
+ * @param output The first sample of the group.
+ */
+template <unsigned int LANES>
+static void storeLanes(__m128 samples, float* output) {
+    float lanes[BIQUAD_LANES];
+    _mm_storeu_ps(lanes, samples);
+    memcpy(output, lanes, LANES * sizeof(float));
+}
+
+template <>
+void storeLanes<1>(__m128 samples, float* output) {
+    _mm_store_ss(output, samples);
+}
+
+template <>
+void storeLanes<2>(__m128 samples, float* output) {
+    _mm_store_sd(reinterpret_cast<double*>(output), _mm_castps_pd(samples));
+}
+
+template <>
+void storeLanes<4>(__m128 samples, float* output) {
+    _mm_storeu_ps(output, samples);
+}
+#endif
+
+/**
+ * Runs the channels of a group through a biquad section.
+ *
+ * @tparam LANES The number of channels of the group, at most @c BIQUAD_LANES.
+ * @param input The first sample of the group in the first frame.
+ * @param frames The number of frames.
+ * @param stride The number of samples of a frame.
+ * @param coefficients The coefficients of the section.
+ * @param state The state of the section for the group, @c 2 * BIQUAD_LANES floats.
+ * @param output The first sample of the group in the first output frame.
+ */
+template <unsigned int LANES>
+static void biquadSection(
+    const float* input,
+    size_t frames,
+    unsigned int stride,
+    const BiquadCoefficients& coefficients,
+    float* state,
+    float* output) {
+#if defined(PCM_KERNELS_NEON)
+    float32x4_t state1 = vld1q_f32(state);
+    float32x4_t state2 = vld1q_f32(state + BIQUAD_LANES);
+    for(size_t i = 0; i < frames; ++i) {
+        const float32x4_t x = loadLanes<LANES>(input + i * stride);
+        const float32x4_t y = vmlaq_n_f32(state1, x, coefficients.b0);
+        state1 = vmlsq_n_f32(vmlaq_n_f32(state2, x, coefficients.b1), y, coefficients.a1);
+        state2 = vmlsq_n_f32(vmulq_n_f32(x, coefficients.b2), y, coefficients.a2);
+        storeLanes<LANES>(y, output + i * stride);
+    }
+    vst1q_f32(state, state1);
+    vst1q_f32(state + BIQUAD_LANES, state2);
+#elif defined(PCM_KERNELS_SSE2)
+    const __m128 b0 = _mm_set1_ps(coefficients.b0);
+    const __m128 b1 = _mm_set1_ps(coefficients.b1);
+    const __m128 b2 = _mm_set1_ps(coefficients.b2);
+    const __m128 a1 = _mm_set1_ps(coefficients.a1);
+    const __m128 a2 = _mm_set1_ps(coefficients.a2);
+    __m128 state1 = _mm_loadu_ps(state);
+    __m128 state2 = _mm_loadu_ps(state + BIQUAD_LANES);
+    for(size_t i = 0; i < frames; ++i) {
+        const __m128 x = loadLanes<LANES>(input + i * stride);
+        const __m128 y = _mm_add_ps(_mm_mul_ps(x, b0), state1);
+        state1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(x, b1), state2), _mm_mul_ps(y, a1));
+        state2 = _mm_sub_ps(_mm_mul_ps(x, b2), _mm_mul_ps(y, a2));
+        storeLanes<LANES>(y, output + i * stride);
+    }
+    _mm_storeu_ps(state, state1);
+    _mm_storeu_ps(state + BIQUAD_LANES, state2);
+#else
+    // Local copies of the state, which the compiler can keep in registers as they cannot alias the output.
+    float state1[LANES];
+    float state2[LANES];
+    memcpy(state1, state, LANES * sizeof(float));
+    memcpy(state2, state + BIQUAD_LANES, LANES * sizeof(float));
+    for(size_t i = 0; i < frames; ++i) {
+        for(unsigned int lane = 0; lane < LANES; ++lane) {
+            const float x = input[i * stride + lane];
+            const float y = coefficients.b0 * x + state1[lane];
+            state1[lane] = coefficients.b1 * x + state2[lane] - coefficients.a1 * y;
+            state2[lane] = coefficients.b2 * x - coefficients.a2 * y;
+            output[i * stride + lane] = y;
+        }
+    }
+    memcpy(state, state1, LANES * sizeof(float));
+    memcpy(state + BIQUAD_LANES, state2, LANES * sizeof(float));
+#endif
+    for(unsigned int i = 0; i < 2 * BIQUAD_LANES; ++i) {
+        if(std::fabs(state[i]) < BIQUAD_STATE_FLOOR) {
+            state[i] = 0.0f;
+        }
+    }
+}
+
+void biquadCascade(
+    const float* input,
+    size_t frames,
+    unsigned int channels,
+    const BiquadCoefficients* sections,
+    size_t numSections,
+    float* state,
+    float* output) {
+    if(0 == numSections) {
+        if(input != output) {
+            memmove(output, input, frames * channels * sizeof(float));
+        }
+        return;
+    }
+
+    const unsigned int groups = (channels + BIQUAD_LANES - 1) / BIQUAD_LANES;
+    for(size_t section = 0; section < numSections; ++section) {
+        // The first section reads the input, the others filter the output of the one before in place.
+        const float* sectionInput = 0 == section ? input : output;
+        for(unsigned int group = 0; group < groups; ++group) {
+            const unsigned int channel = group * BIQUAD_LANES;
+            float* groupState = state + (section * groups + group) * 2 * BIQUAD_LANES;
+            switch(std::min(channels - channel, BIQUAD_LANES)) {
+                case 1:
+                    biquadSection<1>(
+                        sectionInput + channel, frames, channels, sections[section], groupState, output + channel);
+                    break;
+                case 2:
+                    biquadSection<2>(
+                        sectionInput + channel, frames, channels, sections[section], groupState, output + channel);
+                    break;
+                case 3:
+                    biquadSection<3>(
+                        sectionInput + channel, frames, channels, sections[section], groupState, output + channel);
+                    break;
+                default:
+                    biquadSection<4>(
+                        sectionInput + channel, frames, channels, sections[section], groupState, output + channel);
+                    break;
+            }
+        }
+    }
+}
+
+void saturateToInt16(const float* input, size_t count, int16_t* output) {
+    scaleToInt16(input, count, 1.0f, output);
+}
+
+void scaleToInt16(const float* input, size_t count, float gain, int16_t* output) {
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON)
+    const float32x4_t minimum = vdupq_n_f32(INT16_MIN_FLOAT);
+    const float32x4_t maximum = vdupq_n_f32(INT16_MAX_FLOAT);
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        const float32x4_t low = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(input + i), gain), minimum), maximum);
+        const float32x4_t high = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(input + i + 4), gain), minimum), maximum);
+#if defined(__aarch64__)
+        const int32x4_t lowSamples = vcvtnq_s32_f32(low);
+        const int32x4_t highSamples = vcvtnq_s32_f32(high);
+#else
+        // ARMv7 only converts toward zero: round half away from zero instead, by adding a half of the same sign.
+        const uint32x4_t signBit = vdupq_n_u32(0x80000000u);
+        const uint32x4_t half = vreinterpretq_u32_f32(vdupq_n_f32(0.5f));
+        const int32x4_t lowSamples = vcvtq_s32_f32(vaddq_f32(
+            low, vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(low), signBit), half))));
+        const int32x4_t highSamples = vcvtq_s32_f32(vaddq_f32(
+            high, vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(high), signBit), half))));
+#endif
+        vst1q_s16(output + i, vcombine_s16(vqmovn_s32(lowSamples), vqmovn_s32(highSamples)));
+    }
+#elif defined(PCM_KERNELS_SSE2)
+    // Converting a float out of the 32-bit range gives INT32_MIN, so clamp first; the pack then cannot saturate.
+    const __m128 gains = _mm_set1_ps(gain);
+    const __m128 minimum = _mm_set1_ps(INT16_MIN_FLOAT);
+    const __m128 maximum = _mm_set1_ps(INT16_MAX_FLOAT);
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        const __m128 low = _mm_mul_ps(_mm_loadu_ps(input + i), gains);
+        const __m128 high = _mm_mul_ps(_mm_loadu_ps(input + i + 4), gains);
+        const __m128i lowSamples = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(low, minimum), maximum));
+        const __m128i highSamples = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(high, minimum), maximum));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(lowSamples, highSamples));
+    }
+#endif
+    for(; i < count; ++i) {
+        output[i] = saturateSample(input[i] * gain);
+    }
+}
+
+void swapBytes16(const uint16_t* input, size_t count, uint16_t* output) {
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON)
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        const uint8x16_t words = vld1q_u8(reinterpret_cast<const uint8_t*>(input + i));
+        vst1q_u8(reinterpret_cast<uint8_t*>(output + i), vrev16q_u8(words));
+    }
+#elif defined(PCM_KERNELS_SSE2)
+    for(; i + VECTOR_SAMPLES <= count; i += VECTOR_SAMPLES) {
+        const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(output + i), _mm_or_si128(_mm_slli_epi16(words, 8), _mm_srli_epi16(words, 8)));
+    }
+#endif
+    for(; i < count; ++i) {
+        output[i] = static_cast<uint16_t>((input[i] << 8) | (input[i] >> 8));
+    }
+}
+
+void swapBytes32(const uint32_t* input, size_t count, uint32_t* output) {
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON)
+    for(; i + 4 <= count; i += 4) {
+        const uint8x16_t words = vld1q_u8(reinterpret_cast<const uint8_t*>(input + i));
+        vst1q_u8(reinterpret_cast<uint8_t*>(output + i), vrev32q_u8(words));
+    }
+#elif defined(PCM_KERNELS_SSE2)
+    for(; i + 4 <= count; i += 4) {
+        __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        // Swap the 16-bit halves of each word, then the bytes of each half.
+        words = _mm_shufflehi_epi16(_mm_shufflelo_epi16(words, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(output + i), _mm_or_si128(_mm_slli_epi16(words, 8), _mm_srli_epi16(words, 8)));
+    }
+#endif
+    for(; i < count; ++i) {
+        const uint32_t word = input[i];
+        output[i] = (word << 24) | ((word << 8) & 0x00ff0000u) | ((word >> 8) & 0x0000ff00u) | (word >> 24);
+    }
+}
+
+void downmixStereo(const int16_t* input, size_t frames, int16_t* output) {
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON)
+    for(; i + VECTOR_SAMPLES <= frames; i += VECTOR_SAMPLES) {
+        // Add the channels of each frame pairwise into 32 bits, and halve the sums while narrowing them back.
+        const int32x4_t low = vpaddlq_s16(vld1q_s16(input + 2 * i));
+        const int32x4_t high = vpaddlq_s16(vld1q_s16(input + 2 * i + 8));
+        vst1q_s16(output + i, vcombine_s16(vshrn_n_s32(low, 1), vshrn_n_s32(high, 1)));
+    }
+#elif defined(PCM_KERNELS_SSE2)
+    const __m128i ones = _mm_set1_epi16(1);
+    for(; i + VECTOR_SAMPLES <= frames; i += VECTOR_SAMPLES) {
+        // Multiplying by one and adding adjacent products sums the channels of each frame into 32 bits.
+        const __m128i low = _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 2 * i)), ones);
+        const __m128i high = _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 2 * i + 8)), ones);
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(_mm_srai_epi32(low, 1), _mm_srai_epi32(high, 1)));
+    }
+#endif
+    for(; i < frames; ++i) {
+        output[i] = static_cast<int16_t>((input[2 * i] + input[2 * i + 1]) >> 1);
+    }
+}
+
+void downmixStereo(const float* input, size_t frames, float* output) {
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON)
+    for(; i + 4 <= frames; i += 4) {
+        const float32x4x2_t channels = vld2q_f32(input + 2 * i);
+        vst1q_f32(output + i, vmulq_n_f32(vaddq_f32(channels.val[0], channels.val[1]), 0.5f));
+    }
+#elif defined(PCM_KERNELS_SSE2)
+    const __m128 half = _mm_set1_ps(0.5f);
+    for(; i + 4 <= frames; i += 4) {
+        const __m128 low = _mm_loadu_ps(input + 2 * i);
+        const __m128 high = _mm_loadu_ps(input + 2 * i + 4);
+        const __m128 left = _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 right = _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_add_ps(left, right), half));
+    }
+#endif
+    for(; i < frames; ++i) {
+        output[i] = (input[2 * i] + input[2 * i + 1]) * 0.5f;
+    }
+}
+
+void deinterleaveStereo(const int16_t* input, size_t frames, int16_t* left, int16_t* right) {
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON)
+    for(; i + VECTOR_SAMPLES <= frames; i += VECTOR_SAMPLES) {
+        const int16x8x2_t channels = vld2q_s16(input + 2 * i);
+        vst1q_s16(left + i, channels.val[0]);
+        vst1q_s16(right + i, channels.val[1]);
+    }
+#elif defined(PCM_KERNELS_SSE2)
+    for(; i + VECTOR_SAMPLES <= frames; i += VECTOR_SAMPLES) {
+        // Seen as 32-bit lanes, each frame holds the first channel in its low half and the second in its high half.
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 2 * i));
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 2 * i + 8));
+        const __m128i lowLeft = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+        const __m128i highLeft = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(left + i), _mm_packs_epi32(lowLeft, highLeft));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(right + i), _mm_packs_epi32(_mm_srai_epi32(low, 16), _mm_srai_epi32(high, 16)));
+    }
+#endif
+    for(; i < frames; ++i) {
+        left[i] = input[2 * i];
+        right[i] = input[2 * i + 1];
+    }
+}
+
+void deinterleaveStereo(const float* input, size_t frames, float* left, float* right) {
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON)
+    for(; i + 4 <= frames; i += 4) {
+        const float32x4x2_t channels = vld2q_f32(input + 2 * i);
+        vst1q_f32(left + i, channels.val[0]);
+        vst1q_f32(right + i, channels.val[1]);
+    }
+#elif defined(PCM_KERNELS_SSE2)
+    for(; i + 4 <= frames; i += 4) {
+        const __m128 low = _mm_loadu_ps(input + 2 * i);
+        const __m128 high = _mm_loadu_ps(input + 2 * i + 4);
+        _mm_storeu_ps(left + i, _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+#endif
+    for(; i < frames; ++i) {
+        left[i] = input[2 * i];
+        right[i] = input[2 * i + 1];
+    }
+}
+
+void interleaveStereo(const int16_t* left, const int16_t* right, size_t frames, int16_t* output) {
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON)
+    for(; i + VECTOR_SAMPLES <= frames; i += VECTOR_SAMPLES) {
+        int16x8x2_t channels;
+        channels.val[0] = vld1q_s16(left + i);
+        channels.val[1] = vld1q_s16(right + i);
+        vst2q_s16(output + 2 * i, channels);
+    }
+#elif defined(PCM_KERNELS_SSE2)
+    for(; i + VECTOR_SAMPLES <= frames; i += VECTOR_SAMPLES) {
+        const __m128i leftSamples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i));
+        const __m128i rightSamples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + i));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(output + 2 * i), _mm_unpacklo_epi16(leftSamples, rightSamples));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(output + 2 * i + 8), _mm_unpackhi_epi16(leftSamples, rightSamples));
+    }
+#endif
+    for(; i < frames; ++i) {
+        output[2 * i] = left[i];
+        output[2 * i + 1] = right[i];
+    }
+}
+
+void interleaveStereo(const float* left, const float* right, size_t frames, float* output) {
+    size_t i = 0;
+#if defined(PCM_KERNELS_NEON)
+    for(; i + 4 <= frames; i += 4) {
+        float32x4x2_t channels;
+        channels.val[0] = vld1q_f32(left + i);
+        channels.val[1] = vld1q_f32(right + i);
+        vst2q_f32(output + 2 * i, channels);
+    }
+#elif defined(PCM_KERNELS_SSE2)
+    for(; i + 4 <= frames; i += 4) {
+        const __m128 leftSamples = _mm_loadu_ps(left + i);
+        const __m128 rightSamples = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(output + 2 * i, _mm_unpacklo_ps(leftSamples, rightSamples));
+        _mm_storeu_ps(output + 2 * i + 4, _mm_unpackhi_ps(leftSamples, rightSamples));
+    }
+#endif
+    for(; i < frames; ++i) {
+        output[2 * i] = left[i];
+        output[2 * i + 1] = right[i];
+    }
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
@@ -0,0 +1,198 @@
+#include "Common/Utils/Audio/PolyphaseResampler.h"
+#include "Common/Utils/Audio/PCMKernels.h"
+#include "Common/Utils/Logger/Log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_POLYPHASERESAMPLER = "PolyphaseResampler\t";
+
+// Number of taps of each phase when the input is not decimated; decimating by D needs D times as many, to keep the
+// same transition band relative to the lower Nyquist frequency.
+constexpr double BASE_TAPS = 32;
+
+// The number of taps of each phase is rounded up to a multiple of this, the number of floats per kernel iteration.
+constexpr size_t TAPS_ALIGNMENT = 8;
+
+// The cutoff of the filter, relative to the lower of the two Nyquist frequencies.
+constexpr double CUTOFF = 0.9;
+
+// The shape parameter of the Kaiser window, which gives about 80dB of stop band attenuation.
+constexpr double KAISER_BETA = 8.0;
+
+// Number of input samples added to the window at once.
+constexpr size_t CHUNK_FRAMES = 256;
+
+static unsigned int greatestCommonDivisor(unsigned int a, unsigned int b) {
+    while(b != 0) {
+        const unsigned int remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+    return a;
+}
+
+// The zeroth order modified Bessel function of the first kind, from its power series.
+static double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for(int k = 1; k < 50 && term > sum * 1e-12; ++k) {
+        const double factor = x / (2.0 * k);
+        term *= factor * factor;
+        sum += term;
+    }
+    return sum;
+}
+
+std::unique_ptr<PolyphaseResampler> PolyphaseResampler::create(unsigned int inputRateHz, unsigned int outputRateHz) {
+    if(0 == inputRateHz || 0 == outputRateHz) {
+        LOG_ERROR << TAG_POLYPHASERESAMPLER << "createFailed; reason: invalid rate; inputRateHz: " << inputRateHz
+                  << "; outputRateHz: " << outputRateHz;
+        return nullptr;
+    }
+
+    const unsigned int divisor = greatestCommonDivisor(inputRateHz, outputRateHz);
+    const unsigned int interpolation = outputRateHz / divisor;
+    const unsigned int decimation = inputRateHz / divisor;
+    if(interpolation > MAX_PHASES) {
+        LOG_ERROR << TAG_POLYPHASERESAMPLER << "createFailed; reason: too many phases; inputRateHz: " << inputRateHz
+                  << "; outputRateHz: " << outputRateHz << "; phases: " << interpolation;
+        return nullptr;
+    }
+
+    return std::unique_ptr<PolyphaseResampler>(
+        new PolyphaseResampler(inputRateHz, outputRateHz, getFilterBank(interpolation, decimation)));
+}
+
+std::shared_ptr<const PolyphaseResampler::FilterBank> PolyphaseResampler::getFilterBank(
+    unsigned int interpolation,
+    unsigned int decimation) {
+    static std::mutex banksMutex;
+    static std::map<std::pair<unsigned int, unsigned int>, std::shared_ptr<const FilterBank>> banks;
+
+    std::lock_guard<std::mutex> guard(banksMutex);
+    auto found = banks.find(std::make_pair(interpolation, decimation));
+    if(found != banks.end()) {
+        return found->second;
+    }
+
+    auto bank = std::make_shared<FilterBank>();
+    bank->interpolation = interpolation;
+    bank->decimation = decimation;
+    const double decimationRatio = std::max(1.0, static_cast<double>(decimation) / interpolation);
+    const size_t minimumTaps = static_cast<size_t>(std::ceil(BASE_TAPS * decimationRatio));
+    bank->taps = (minimumTaps + TAPS_ALIGNMENT - 1) / TAPS_ALIGNMENT * TAPS_ALIGNMENT;
+
+    // The prototype filter runs at the upsampled rate, where the lower Nyquist frequency is 1 / (2 * max(L, M)).
+    const size_t length = interpolation * bank->taps;
+    const double cutoff = CUTOFF * 0.5 / std::max(interpolation, decimation);
+    const double center = (length - 1) / 2.0;
+    const double windowNorm = besselI0(KAISER_BETA);
+    std::vector<double> prototype(length);
+    double sum = 0.0;
+    for(size_t n = 0; n < length; ++n) {
+        const double offset = n - center;
+        const double phase = 2.0 * M_PI * cutoff * offset;
+        const double sinc = 0.0 == offset ? 1.0 : std::sin(phase) / phase;
+        const double ratio = 2.0 * n / (length - 1) - 1.0;
+        const double window = besselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / windowNorm;
+        prototype[n] = sinc * window;
+        sum += prototype[n];
+    }
+
+    // Each phase sees one input sample in L of the zero stuffed signal: a gain of L keeps the level of the input.
+    const double gain = interpolation / sum;
+    bank->coefficients.resize(length);
+    for(unsigned int phase = 0; phase < interpolation; ++phase) {
+        for(size_t tap = 0; tap < bank->taps; ++tap) {
+            bank->coefficients[phase * bank->taps + bank->taps - 1 - tap] =
+                static_cast<float>(prototype[phase + interpolation * tap] * gain);
+        }
+    }
+
+    LOG_DEBUG << TAG_POLYPHASERESAMPLER << "getFilterBank; interpolation: " << interpolation
+              << "; decimation: " << decimation << "; taps: " << bank->taps;
+    banks[std::make_pair(interpolation, decimation)] = bank;
+    return bank;
+}
+
+PolyphaseResampler::PolyphaseResampler(
+    unsigned int inputRateHz,
+    unsigned int outputRateHz,
+    std::shared_ptr<const FilterBank> bank) :
+        m_inputRateHz{inputRateHz},
+        m_outputRateHz{outputRateHz},
+        m_bank{std::move(bank)},
+        m_window(m_bank->taps - 1 + CHUNK_FRAMES) {
+    reset();
+}
+
+void PolyphaseResampler::reset() {
+    // Start with a window full of silence before the first sample.
+    std::fill(m_window.begin(), m_window.end(), 0.0f);
+    m_windowFrames = m_bank->taps - 1;
+    m_position = 0;
+    m_phase = 0;
+}
+
+size_t PolyphaseResampler::getMaxOutputFrames(size_t inputFrames) const {
+    return (inputFrames * m_bank->interpolation + m_bank->decimation - 1) / m_bank->decimation + 1;
+}
+
+size_t PolyphaseResampler::process(const float* input, size_t inputFrames, float* output) {
+    const size_t taps = m_bank->taps;
+    const unsigned int interpolation = m_bank->interpolation;
+    const unsigned int decimation = m_bank->decimation;
+    const float* coefficients = m_bank->coefficients.data();
+    size_t produced = 0;
+
+    while(inputFrames > 0) {
+        const size_t chunk = std::min(inputFrames, CHUNK_FRAMES);
+        memcpy(m_window.data() + m_windowFrames, input, chunk * sizeof(float));
+        m_windowFrames += chunk;
+        input += chunk;
+        inputFrames -= chunk;
+
+        while(m_position + taps <= m_windowFrames) {
+            output[produced++] = dotProduct(m_window.data() + m_position, coefficients + m_phase * taps, taps);
+            m_phase += decimation;
+            m_position += m_phase / interpolation;
+            m_phase %= interpolation;
+        }
+
+        // Keep the samples the next output samples need; when decimating, the next window may start past them all.
+        const size_t consumed = std::min(m_position, m_windowFrames);
+        memmove(m_window.data(), m_window.data() + consumed, (m_windowFrames - consumed) * sizeof(float));
+        m_windowFrames -= consumed;
+        m_position -= consumed;
+    }
+    return produced;
+}
+
+unsigned int PolyphaseResampler::getInputRate() const {
+    return m_inputRateHz;
+}
+
+unsigned int PolyphaseResampler::getOutputRate() const {
+    return m_outputRateHz;
+}
+
+size_t PolyphaseResampler::getTapsPerPhase() const {
+    return m_bank->taps;
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
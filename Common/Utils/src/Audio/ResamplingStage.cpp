@@ -0,0 +1,79 @@
+#include "Common/Utils/Audio/ResamplingStage.h"
+#include "Common/Utils/Audio/FormatConverter.h"
+#include "Common/Utils/Audio/PCMKernels.h"
+#include "Common/Utils/Logger/Log.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_RESAMPLINGSTAGE = "ResamplingStage\t";
+
+ResamplingStage::ResamplingStage(unsigned int outputRateHz) :
+        m_outputRateHz{outputRateHz},
+        m_maxInputFrames{0},
+        m_maxOutputFrames{0} {
+}
+
+std::string ResamplingStage::getName() const {
+    return "Resampling";
+}
+
+bool ResamplingStage::configure(
+    const AudioFormat& inputFormat,
+    size_t maxInputFrames,
+    AudioFormat* outputFormat,
+    size_t* maxOutputFrames) {
+    if(!FormatConverter::isHostFloat(inputFormat) || inputFormat.numChannels > 2) {
+        LOG_ERROR << TAG_RESAMPLINGSTAGE << "configureFailed; reason: input is not mono or stereo float; "
+                  << "numChannels: " << inputFormat.numChannels;
+        return false;
+    }
+
+    m_resamplers.clear();
+    for(unsigned int channel = 0; channel < inputFormat.numChannels; ++channel) {
+        auto resampler = PolyphaseResampler::create(inputFormat.sampleRateHz, m_outputRateHz);
+        if(!resampler) {
+            LOG_ERROR << TAG_RESAMPLINGSTAGE << "configureFailed; reason: unsupported rates; inputRateHz: "
+                      << inputFormat.sampleRateHz << "; outputRateHz: " << m_outputRateHz;
+            return false;
+        }
+        m_resamplers.push_back(std::move(resampler));
+    }
+
+    m_maxInputFrames = maxInputFrames;
+    m_maxOutputFrames = m_resamplers.front()->getMaxOutputFrames(maxInputFrames);
+    m_planes.assign(m_resamplers.size() > 1 ? 2 * (m_maxInputFrames + m_maxOutputFrames) : 0, 0.0f);
+
+    *outputFormat = inputFormat;
+    outputFormat->sampleRateHz = m_outputRateHz;
+    *maxOutputFrames = m_maxOutputFrames;
+    return true;
+}
+
+size_t ResamplingStage::process(const unsigned char* input, unsigned char* output, size_t frames) {
+    const float* samples = reinterpret_cast<const float*>(input);
+    float* resampled = reinterpret_cast<float*>(output);
+    if(1 == m_resamplers.size()) {
+        return m_resamplers.front()->process(samples, frames, resampled);
+    }
+
+    // Both channels go through the same phases, so they produce the same number of frames.
+    float* left = m_planes.data();
+    float* right = left + m_maxInputFrames;
+    float* resampledLeft = right + m_maxInputFrames;
+    float* resampledRight = resampledLeft + m_maxOutputFrames;
+    deinterleaveStereo(samples, frames, left, right);
+    const size_t produced = m_resamplers[0]->process(left, frames, resampledLeft);
+    m_resamplers[1]->process(right, frames, resampledRight);
+    interleaveStereo(resampledLeft, resampledRight, produced, resampled);
+    return produced;
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
@@ -0,0 +1,195 @@
+#include "Common/Utils/Audio/ResamplingTap.h"
+#include "Common/Utils/Audio/PCMKernels.h"
+#include "Common/Utils/Logger/Log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace audio {
+
+using namespace logger;
+
+static const std::string TAG_RESAMPLINGTAP = "ResamplingTap\t";
+
+// The float equal to the full scale of a 16-bit sample, as produced by the converter.
+constexpr float INT16_FULL_SCALE = 32768.0f;
+
+// The largest size of a frame of the source stream: two float samples.
+constexpr size_t MAX_SOURCE_FRAME_SIZE = 2 * sizeof(float);
+
+std::unique_ptr<ResamplingTap> ResamplingTap::create(
+    const AudioFormat& sourceFormat,
+    std::shared_ptr<AudioInputStream::Reader> reader,
+    std::shared_ptr<AudioInputStream::Writer> writer,
+    unsigned int targetRateHz,
+    size_t blockFrames) {
+    if(sourceFormat.numChannels > 2 ||
+       (sourceFormat.numChannels > 1 && AudioFormat::Layout::INTERLEAVED != sourceFormat.layout)) {
+        LOG_ERROR << TAG_RESAMPLINGTAP << "createFailed; reason: unsupported source format; numChannels: "
+                  << sourceFormat.numChannels;
+        return nullptr;
+    }
+    if(!reader || reader->getWordSize() * 8 != sourceFormat.sampleSizeInBits) {
+        LOG_ERROR << TAG_RESAMPLINGTAP << "createFailed; reason: invalid reader";
+        return nullptr;
+    }
+    if(!writer || sizeof(int16_t) != writer->getWordSize()) {
+        LOG_ERROR << TAG_RESAMPLINGTAP << "createFailed; reason: invalid writer";
+        return nullptr;
+    }
+    if(0 == blockFrames) {
+        LOG_ERROR << TAG_RESAMPLINGTAP << "createFailed; reason: invalid blockFrames";
+        return nullptr;
+    }
+
+    // The audio is resampled as mono floats, and only rounded to 16 bits on its way to the target stream.
+    AudioFormat monoFormat = sourceFormat;
+    monoFormat.endianness = FormatConverter::getHostEndianness();
+    monoFormat.sampleSizeInBits = 32;
+    monoFormat.numChannels = 1;
+    monoFormat.layout = AudioFormat::Layout::INTERLEAVED;
+    auto converter = FormatConverter::create(sourceFormat, monoFormat);
+    if(!converter) {
+        LOG_ERROR << TAG_RESAMPLINGTAP << "createFailed; reason: unsupported source format";
+        return nullptr;
+    }
+    auto resampler = PolyphaseResampler::create(sourceFormat.sampleRateHz, targetRateHz);
+    if(!resampler) {
+        LOG_ERROR << TAG_RESAMPLINGTAP << "createFailed; reason: unsupported rates; sourceRateHz: "
+                  << sourceFormat.sampleRateHz << "; targetRateHz: " << targetRateHz;
+        return nullptr;
+    }
+
+    AudioFormat targetFormat = monoFormat;
+    targetFormat.sampleRateHz = targetRateHz;
+    targetFormat.sampleSizeInBits = 16;
+
+    return std::unique_ptr<ResamplingTap>(new ResamplingTap(
+        std::move(reader),
+        std::move(writer),
+        std::move(converter),
+        std::move(resampler),
+        targetFormat,
+        blockFrames));
+}
+
+ResamplingTap::ResamplingTap(
+    std::shared_ptr<AudioInputStream::Reader> reader,
+    std::shared_ptr<AudioInputStream::Writer> writer,
+    std::unique_ptr<FormatConverter> converter,
+    std::unique_ptr<PolyphaseResampler> resampler,
+    const AudioFormat& targetFormat,
+    size_t blockFrames) :
+        m_reader{std::move(reader)},
+        m_writer{std::move(writer)},
+        m_converter{std::move(converter)},
+        m_resampler{std::move(resampler)},
+        m_targetFormat(targetFormat),
+        m_blockFrames{blockFrames},
+        m_sourceChannels{m_converter->getSourceFormat().numChannels},
+        m_mono(blockFrames),
+        m_resampled(m_resampler->getMaxOutputFrames(blockFrames)),
+        m_statistics() {
+    m_converter->reserve(blockFrames);
+}
+
+ssize_t ResamplingTap::process(std::chrono::milliseconds timeout) {
+    AudioInputStream::Reader::Span first, second;
+    ssize_t borrowed = m_reader->borrow(m_blockFrames * m_sourceChannels, &first, &second, timeout);
+    if(AudioInputStream::Reader::Error::OVERRUN == borrowed) {
+        // Skip the audio overwritten, and pick up from the latest audio.
+        m_reader->seek(0, AudioInputStream::Reader::Reference::BEFORE_WRITER);
+        std::lock_guard<std::mutex> guard(m_statisticsMutex);
+        ++m_statistics.overruns;
+        return borrowed;
+    }
+    if(0 == borrowed) {
+        LOG_DEBUG << TAG_RESAMPLINGTAP << "process; reason: source closed";
+        m_writer->close();
+        return 0;
+    }
+    if(borrowed < 0) {
+        return borrowed;
+    }
+
+    const size_t frames = borrowed / m_sourceChannels;
+    if(0 == frames) {
+        // Only part of a frame was written so far.
+        m_reader->release(0);
+        return AudioInputStream::Reader::Error::WOULDBLOCK;
+    }
+
+    // Convert the whole frames of the first span, the frame split by the wrap of the ring buffer if any, and the rest
+    // from the second span.
+    const size_t wordSize = m_reader->getWordSize();
+    const size_t frameSize = m_sourceChannels * wordSize;
+    unsigned char* mono = reinterpret_cast<unsigned char*>(m_mono.data());
+    const size_t firstFrames = std::min(frames, first.nWords / m_sourceChannels);
+    size_t converted = m_converter->convert(first.data, firstFrames * frameSize, mono, firstFrames * sizeof(float));
+    if(firstFrames < frames) {
+        const unsigned char* next = second.data;
+        const size_t splitWords = first.nWords - firstFrames * m_sourceChannels;
+        if(splitWords > 0) {
+            unsigned char frame[MAX_SOURCE_FRAME_SIZE];
+            memcpy(frame, first.data + firstFrames * frameSize, splitWords * wordSize);
+            memcpy(frame + splitWords * wordSize, second.data, frameSize - splitWords * wordSize);
+            converted += m_converter->convert(frame, frameSize, mono + converted, sizeof(float));
+            next += frameSize - splitWords * wordSize;
+        }
+        const size_t remainingFrames = frames - converted / sizeof(float);
+        converted += m_converter->convert(
+            next, remainingFrames * frameSize, mono + converted, remainingFrames * sizeof(float));
+    }
+
+    if(AudioInputStream::Reader::Error::OVERRUN == m_reader->release(frames * m_sourceChannels)) {
+        // The writer caught up with the audio while it was converted: drop it, and pick up from the latest audio.
+        m_reader->seek(0, AudioInputStream::Reader::Reference::BEFORE_WRITER);
+        std::lock_guard<std::mutex> guard(m_statisticsMutex);
+        ++m_statistics.overruns;
+        return AudioInputStream::Reader::Error::OVERRUN;
+    }
+
+    const size_t produced = m_resampler->process(m_mono.data(), frames, m_resampled.data());
+    size_t written = 0;
+    if(produced > 0) {
+        AudioInputStream::Writer::Span target, wrapped;
+        ssize_t reserved = m_writer->reserve(produced, &target, &wrapped);
+        if(reserved > 0) {
+            written = static_cast<size_t>(reserved);
+            const size_t targetFrames = std::min(written, target.nWords);
+            scaleToInt16(
+                m_resampled.data(), targetFrames, INT16_FULL_SCALE, reinterpret_cast<int16_t*>(target.data));
+            if(written > targetFrames) {
+                scaleToInt16(
+                    m_resampled.data() + targetFrames,
+                    written - targetFrames,
+                    INT16_FULL_SCALE,
+                    reinterpret_cast<int16_t*>(wrapped.data));
+            }
+            m_writer->commit(written);
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(m_statisticsMutex);
+    m_statistics.framesRead += frames;
+    m_statistics.framesWritten += written;
+    m_statistics.framesDropped += produced - written;
+    return frames;
+}
+
+AudioFormat ResamplingTap::getTargetFormat() const {
+    return m_targetFormat;
+}
+
+ResamplingTap::Statistics ResamplingTap::getStatistics() const {
+    std::lock_guard<std::mutex> guard(m_statisticsMutex);
+    return m_statistics;
+}
+
+} // namespace audio
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
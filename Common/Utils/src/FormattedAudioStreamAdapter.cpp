@@ -1,6 +1,8 @@
 #include "Common/Utils/Bluetooth/FormattedAudioStreamAdapter.h"
 #include "Common/Utils/Logger/Log.h"
 
+#include <algorithm>
+
 namespace deviceClientSDK {
 namespace common {
 namespace utils {
@@ -10,6 +12,12 @@ using namespace logger;
 
 static const std::string TAG_FORMATTEDAUDIO = "FormattedAudioStreamAdapter\t";
 
+static bool isSameFormat(const AudioFormat& a, const AudioFormat& b) {
+    return a.encoding == b.encoding && a.endianness == b.endianness && a.sampleRateHz == b.sampleRateHz &&
+           a.sampleSizeInBits == b.sampleSizeInBits && a.numChannels == b.numChannels &&
+           a.dataSigned == b.dataSigned && a.layout == b.layout;
+}
+
 FormattedAudioStreamAdapter::FormattedAudioStreamAdapter(const AudioFormat& audioFormat) {
     m_audioFormat = audioFormat;
 }
@@ -23,6 +31,16 @@ void FormattedAudioStreamAdapter::setListener(std::shared_ptr<FormattedAudioStre
     m_listener = listener;
 }
 
+bool FormattedAudioStreamAdapter::setProcessingChain(std::shared_ptr<audio::AudioProcessingChain> chain) {
+    if(chain && !isSameFormat(chain->getInputFormat(), m_audioFormat)) {
+        LOG_ERROR << TAG_FORMATTEDAUDIO << "setProcessingChainFailed. Reason: chain input format does not match";
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(m_readerFunctionMutex);
+    m_processingChain = chain;
+    return true;
+}
+
 size_t FormattedAudioStreamAdapter::send(const unsigned char* buffer, size_t size) {
     if(!buffer) {
         LOG_ERROR << TAG_FORMATTEDAUDIO << "sendFailed. Reason: buffer is null";
@@ -33,17 +51,34 @@ size_t FormattedAudioStreamAdapter::send(const unsigned char* buffer, size_t siz
         return 0;
     }
     std::shared_ptr<FormattedAudioStreamAdapterListener> listener;
+    std::shared_ptr<audio::AudioProcessingChain> chain;
     {
         std::lock_guard<std::mutex> guard(m_readerFunctionMutex);
         listener = m_listener.lock();
+        chain = m_processingChain;
     }
 
-    if(listener) {
+    if(!listener) {
+        return 0;
+    }
+    if(!chain) {
         listener->onFormattedAudioStreamAdapterData(m_audioFormat, buffer, size);
         return size;
-    } else {
-        return 0;
     }
+
+    // Run the chain over blocks of at most the size it was configured for; a block producing no frames yet, such as
+    // one absorbed by the delay of a resampler, is not published.
+    const AudioFormat outputFormat = chain->getOutputFormat();
+    const size_t frameSize = m_audioFormat.numChannels * m_audioFormat.sampleSizeInBits / 8;
+    const size_t blockSize = chain->getMaxFrames() * frameSize;
+    for(size_t offset = 0; offset < size; offset += blockSize) {
+        const unsigned char* output = nullptr;
+        size_t outputSize = chain->process(buffer + offset, std::min(blockSize, size - offset), &output);
+        if(outputSize > 0) {
+            listener->onFormattedAudioStreamAdapterData(outputFormat, output, outputSize);
+        }
+    }
+    return size;
 }
 
 }  // namespace bluetooth
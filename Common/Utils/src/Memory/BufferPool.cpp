@@ -0,0 +1,183 @@
+#include "Common/Utils/Memory/BufferPool.h"
+#include "Common/Utils/Logger/Log.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace memory {
+
+using namespace common::utils::logger;
+
+static const std::string TAG_BUFFERPOOL = "BufferPool\t";
+
+// Alignment of the buffers, so that no two buffers share a cache line.
+static constexpr size_t BUFFER_ALIGNMENT = 64;
+
+// Index marking the end of the free list.
+static constexpr uint32_t END_OF_LIST = std::numeric_limits<uint32_t>::max();
+
+// Returns the top of the free list made of an index and an update count.
+static uint64_t makeTop(uint32_t index, uint64_t top) {
+    return ((top >> 32) + 1) << 32 | index;
+}
+
+// Returns the index of the first buffer of the free list.
+static uint32_t indexOf(uint64_t top) {
+    return static_cast<uint32_t>(top);
+}
+
+BufferPool::Buffer::Buffer() : m_header{nullptr} {
+}
+
+BufferPool::Buffer::Buffer(Header* header) : m_header{header} {
+}
+
+BufferPool::Buffer::Buffer(const Buffer& other) : m_header{other.m_header} {
+    if (m_header) {
+        m_header->referenceCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+BufferPool::Buffer::Buffer(Buffer&& other) : m_header{other.m_header} {
+    other.m_header = nullptr;
+}
+
+BufferPool::Buffer& BufferPool::Buffer::operator=(const Buffer& other) {
+    if (this != &other) {
+        // Take the new reference first, in case both handles hold the same buffer.
+        if (other.m_header) {
+            other.m_header->referenceCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        reset();
+        m_header = other.m_header;
+    }
+    return *this;
+}
+
+BufferPool::Buffer& BufferPool::Buffer::operator=(Buffer&& other) {
+    if (this != &other) {
+        reset();
+        m_header = other.m_header;
+        other.m_header = nullptr;
+    }
+    return *this;
+}
+
+BufferPool::Buffer::~Buffer() {
+    reset();
+}
+
+void BufferPool::Buffer::reset() {
+    if (!m_header) {
+        return;
+    }
+    // The last handle to go sees every write made through the others before the buffer is reused.
+    if (1 == m_header->referenceCount.fetch_sub(1, std::memory_order_acq_rel)) {
+        m_header->pool->release(m_header);
+    }
+    m_header = nullptr;
+}
+
+BufferPool::Buffer::operator bool() const {
+    return nullptr != m_header;
+}
+
+uint8_t* BufferPool::Buffer::data() const {
+    return m_header ? m_header->data : nullptr;
+}
+
+size_t BufferPool::Buffer::capacity() const {
+    return m_header ? m_header->pool->m_bufferSize : 0;
+}
+
+size_t BufferPool::Buffer::size() const {
+    return m_header ? m_header->size : 0;
+}
+
+void BufferPool::Buffer::setSize(size_t size) {
+    if (m_header) {
+        m_header->size = size;
+    }
+}
+
+size_t BufferPool::Buffer::useCount() const {
+    return m_header ? m_header->referenceCount.load(std::memory_order_relaxed) : 0;
+}
+
+BufferPool::BufferPool(size_t bufferSize, size_t bufferCount) :
+        m_bufferSize{bufferSize},
+        m_bufferCount{std::min(bufferCount, static_cast<size_t>(END_OF_LIST))},
+        m_headers{new Header[m_bufferCount]},
+        m_freeList{makeTop(m_bufferCount > 0 ? 0 : END_OF_LIST, 0)},
+        m_availableCount{m_bufferCount} {
+    const size_t stride = (bufferSize + BUFFER_ALIGNMENT - 1) / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT;
+    m_slab.resize(stride * m_bufferCount + BUFFER_ALIGNMENT);
+
+    const uintptr_t slabStart = reinterpret_cast<uintptr_t>(m_slab.data());
+    uint8_t* first = m_slab.data() + (BUFFER_ALIGNMENT - slabStart % BUFFER_ALIGNMENT) % BUFFER_ALIGNMENT;
+
+    for (size_t i = 0; i < m_bufferCount; ++i) {
+        m_headers[i].pool = this;
+        m_headers[i].data = first + i * stride;
+        m_headers[i].referenceCount = 0;
+        m_headers[i].next = i + 1 < m_bufferCount ? static_cast<uint32_t>(i + 1) : END_OF_LIST;
+        m_headers[i].size = 0;
+    }
+}
+
+BufferPool::~BufferPool() {
+    if (m_availableCount != m_bufferCount) {
+        LOG_ERROR << TAG_BUFFERPOOL << "~BufferPoolFailed; reason: buffers still in use; count: "
+                  << m_bufferCount - m_availableCount;
+    }
+}
+
+BufferPool::Buffer BufferPool::acquire() {
+    uint64_t top = m_freeList.load(std::memory_order_acquire);
+    while (true) {
+        const uint32_t index = indexOf(top);
+        if (END_OF_LIST == index) {
+            return Buffer();
+        }
+        // The next index may be stale if another thread takes the buffer first, in which case the update count
+        // makes the exchange fail.
+        const uint32_t next = m_headers[index].next.load(std::memory_order_relaxed);
+        if (m_freeList.compare_exchange_weak(top, makeTop(next, top), std::memory_order_acquire)) {
+            m_availableCount.fetch_sub(1, std::memory_order_relaxed);
+            Header* header = &m_headers[index];
+            header->referenceCount.store(1, std::memory_order_relaxed);
+            header->size = 0;
+            return Buffer(header);
+        }
+    }
+}
+
+void BufferPool::release(Header* header) {
+    const uint32_t index = static_cast<uint32_t>(header - m_headers.get());
+    m_availableCount.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t top = m_freeList.load(std::memory_order_relaxed);
+    do {
+        header->next.store(indexOf(top), std::memory_order_relaxed);
+    } while (!m_freeList.compare_exchange_weak(top, makeTop(index, top), std::memory_order_release));
+}
+
+size_t BufferPool::getBufferSize() const {
+    return m_bufferSize;
+}
+
+size_t BufferPool::getBufferCount() const {
+    return m_bufferCount;
+}
+
+size_t BufferPool::getAvailableCount() const {
+    return m_availableCount.load(std::memory_order_relaxed);
+}
+
+}  // namespace memory
+}  // namespace utils
+}  // namespace common
+}  // namespace deviceClientSDK
@@ -0,0 +1,286 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "Common/Utils/Logger/Log.h"
+#include "Common/Utils/SDS/InterProcessSDS.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace sds {
+
+using namespace logger;
+
+static const std::string TAG_INTERPROCESSSDS = "InterProcessSDS\t";
+
+#ifndef MFD_CLOEXEC
+// Flag of memfd_create(), missing from the headers of older C libraries.
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+// Name given to anonymous shared memory objects; only visible in /proc/<pid>/fd.
+static const char* MEMFD_NAME = "sds";
+
+// Number of nanoseconds in a second.
+static const long NANOSECONDS_PER_SECOND = 1000000000L;
+
+ProcessSharedMutex::ProcessSharedMutex() {
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+    int error = pthread_mutex_init(&m_mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+    if (error) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "ProcessSharedMutexFailed; reason: " << strerror(error);
+    }
+}
+
+ProcessSharedMutex::~ProcessSharedMutex() {
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void ProcessSharedMutex::lock() {
+    int error = pthread_mutex_lock(&m_mutex);
+    if (EOWNERDEAD == error) {
+        // The previous owner died while holding the lock.  The state it protects is made of atomics which are always
+        // consistent on their own, so take the lock over.
+        LOG_WARN << TAG_INTERPROCESSSDS << "lock; reason: previousOwnerDied";
+        pthread_mutex_consistent(&m_mutex);
+    } else if (error) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "lockFailed; reason: " << strerror(error);
+    }
+}
+
+bool ProcessSharedMutex::try_lock() {
+    int error = pthread_mutex_trylock(&m_mutex);
+    if (EOWNERDEAD == error) {
+        LOG_WARN << TAG_INTERPROCESSSDS << "tryLock; reason: previousOwnerDied";
+        pthread_mutex_consistent(&m_mutex);
+        return true;
+    }
+    return 0 == error;
+}
+
+void ProcessSharedMutex::unlock() {
+    pthread_mutex_unlock(&m_mutex);
+}
+
+pthread_mutex_t* ProcessSharedMutex::native_handle() {
+    return &m_mutex;
+}
+
+ProcessSharedConditionVariable::ProcessSharedConditionVariable() {
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    int error = pthread_cond_init(&m_conditionVariable, &attributes);
+    pthread_condattr_destroy(&attributes);
+    if (error) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "ProcessSharedConditionVariableFailed; reason: " << strerror(error);
+    }
+}
+
+ProcessSharedConditionVariable::~ProcessSharedConditionVariable() {
+    pthread_cond_destroy(&m_conditionVariable);
+}
+
+void ProcessSharedConditionVariable::notify_one() {
+    pthread_cond_signal(&m_conditionVariable);
+}
+
+void ProcessSharedConditionVariable::notify_all() {
+    pthread_cond_broadcast(&m_conditionVariable);
+}
+
+void ProcessSharedConditionVariable::wait(std::unique_lock<ProcessSharedMutex>& lock) {
+    int error = pthread_cond_wait(&m_conditionVariable, lock.mutex()->native_handle());
+    if (EOWNERDEAD == error) {
+        LOG_WARN << TAG_INTERPROCESSSDS << "wait; reason: previousOwnerDied";
+        pthread_mutex_consistent(lock.mutex()->native_handle());
+    }
+}
+
+bool ProcessSharedConditionVariable::waitUntil(std::unique_lock<ProcessSharedMutex>& lock, const timespec& deadline) {
+    int error = pthread_cond_timedwait(&m_conditionVariable, lock.mutex()->native_handle(), &deadline);
+    if (EOWNERDEAD == error) {
+        LOG_WARN << TAG_INTERPROCESSSDS << "waitUntil; reason: previousOwnerDied";
+        pthread_mutex_consistent(lock.mutex()->native_handle());
+    }
+    return ETIMEDOUT != error;
+}
+
+timespec ProcessSharedConditionVariable::deadlineFromNow(std::chrono::nanoseconds timeout) {
+    timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    auto nanoseconds = deadline.tv_nsec + timeout.count() % NANOSECONDS_PER_SECOND;
+    deadline.tv_sec += timeout.count() / NANOSECONDS_PER_SECOND + nanoseconds / NANOSECONDS_PER_SECOND;
+    deadline.tv_nsec = nanoseconds % NANOSECONDS_PER_SECOND;
+    return deadline;
+}
+
+std::shared_ptr<SharedMemoryBuffer> SharedMemoryBuffer::create(const std::string& name, size_t size) {
+    if (0 == size) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "createFailed; reason: zeroSize";
+        return nullptr;
+    }
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "createFailed; reason: shm_open; name: " << name << "; error: "
+                  << strerror(errno);
+        return nullptr;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "createFailed; reason: ftruncate; error: " << strerror(errno);
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    auto buffer = map(fd, size);
+    if (!buffer) {
+        shm_unlink(name.c_str());
+    }
+    return buffer;
+}
+
+std::shared_ptr<SharedMemoryBuffer> SharedMemoryBuffer::open(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "openFailed; reason: shm_open; name: " << name << "; error: "
+                  << strerror(errno);
+        return nullptr;
+    }
+    return map(fd, 0);
+}
+
+std::shared_ptr<SharedMemoryBuffer> SharedMemoryBuffer::createAnonymous(size_t size) {
+    if (0 == size) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "createAnonymousFailed; reason: zeroSize";
+        return nullptr;
+    }
+#ifdef SYS_memfd_create
+    // Called through syscall() because older C libraries have no memfd_create() wrapper.
+    int fd = static_cast<int>(syscall(SYS_memfd_create, MEMFD_NAME, MFD_CLOEXEC));
+#else
+    int fd = -1;
+    errno = ENOSYS;
+#endif
+    if (fd < 0) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "createAnonymousFailed; reason: memfd_create; name: " << MEMFD_NAME
+                  << "; error: " << strerror(errno);
+        return nullptr;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "createAnonymousFailed; reason: ftruncate; error: " << strerror(errno);
+        close(fd);
+        return nullptr;
+    }
+    return map(fd, size);
+}
+
+std::shared_ptr<SharedMemoryBuffer> SharedMemoryBuffer::fromFD(int fd) {
+    if (fd < 0) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "fromFDFailed; reason: invalidFD";
+        return nullptr;
+    }
+    return map(fd, 0);
+}
+
+std::shared_ptr<SharedMemoryBuffer> SharedMemoryBuffer::createFile(const std::string& path, size_t size) {
+    if (0 == size) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "createFileFailed; reason: zeroSize";
+        return nullptr;
+    }
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "createFileFailed; reason: open; path: " << path << "; error: "
+                  << strerror(errno);
+        return nullptr;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "createFileFailed; reason: ftruncate; error: " << strerror(errno);
+        close(fd);
+        return nullptr;
+    }
+    return map(fd, size);
+}
+
+std::shared_ptr<SharedMemoryBuffer> SharedMemoryBuffer::openFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "openFileFailed; reason: open; path: " << path << "; error: "
+                  << strerror(errno);
+        return nullptr;
+    }
+    return map(fd, 0);
+}
+
+SharedMemoryBuffer::~SharedMemoryBuffer() {
+    munmap(m_data, m_size);
+    close(m_fd);
+}
+
+bool SharedMemoryBuffer::unlink(const std::string& name) {
+    if (shm_unlink(name.c_str()) < 0) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "unlinkFailed; name: " << name << "; error: " << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+uint8_t* SharedMemoryBuffer::data() {
+    return m_data;
+}
+
+size_t SharedMemoryBuffer::size() const {
+    return m_size;
+}
+
+int SharedMemoryBuffer::getFD() const {
+    return m_fd;
+}
+
+bool SharedMemoryBuffer::sync() {
+    if (msync(m_data, m_size, MS_SYNC) < 0) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "syncFailed; error: " << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+SharedMemoryBuffer::SharedMemoryBuffer(int fd, uint8_t* data, size_t size) : m_fd{fd}, m_data{data}, m_size{size} {
+}
+
+std::shared_ptr<SharedMemoryBuffer> SharedMemoryBuffer::map(int fd, size_t size) {
+    if (0 == size) {
+        struct stat status;
+        if (fstat(fd, &status) < 0 || status.st_size <= 0) {
+            LOG_ERROR << TAG_INTERPROCESSSDS << "mapFailed; reason: invalidObjectSize";
+            close(fd);
+            return nullptr;
+        }
+        size = static_cast<size_t>(status.st_size);
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == data) {
+        LOG_ERROR << TAG_INTERPROCESSSDS << "mapFailed; reason: mmap; error: " << strerror(errno);
+        close(fd);
+        return nullptr;
+    }
+
+    return std::shared_ptr<SharedMemoryBuffer>(new SharedMemoryBuffer(fd, static_cast<uint8_t*>(data), size));
+}
+
+} // namespace sds
+} // namespace utils
+} // namespace common
+} // namespace deviceClientSDK
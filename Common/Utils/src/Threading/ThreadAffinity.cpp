@@ -0,0 +1,39 @@
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#include "Common/Utils/Threading/ThreadAffinity.h"
+
+namespace deviceClientSDK {
+namespace common {
+namespace utils {
+namespace threading {
+
+bool setThisThreadAffinity(int cpu) {
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+
+    if (ANY_CPU == cpu) {
+        const long cpuCount = sysconf(_SC_NPROCESSORS_CONF);
+        for (long i = 0; i < cpuCount && i < CPU_SETSIZE; ++i) {
+            CPU_SET(i, &cpus);
+        }
+    } else if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &cpus);
+    } else {
+        return false;
+    }
+
+    return 0 == pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#else
+    return ANY_CPU == cpu;
+#endif
+}
+
+}  // namespace threading
+}  // namespace utils
+}  // namespace common
+}  // namespace deviceClientSDK
@@ -0,0 +1,144 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "Common/Utils/Audio/ConversionStage.h"
+#include "Common/Utils/Audio/DuckingStage.h"
+#include "Common/Utils/Bluetooth/BluetoothEventBus.h"
+#include "Common/Utils/Bluetooth/BluetoothEvents.h"
+
+using namespace deviceClientSDK::common::utils;
+using namespace deviceClientSDK::common::utils::audio;
+using namespace deviceClientSDK::common::utils::bluetooth;
+
+// Sample rate of the stream.
+static const unsigned int SAMPLE_RATE = 48000;
+
+// Gain of the ducked audio.
+static const float DUCKED_GAIN = 0.25f;
+
+// Time taken to duck the audio.
+static const std::chrono::milliseconds ATTACK{10};
+
+// Time taken to restore the audio.
+static const std::chrono::milliseconds RELEASE{100};
+
+// Number of frames of each block, which does not divide the ramps so that they span several blocks unevenly.
+static const size_t BLOCK_FRAMES = 100;
+
+// Block at the start of which the audio is ducked.
+static const size_t DUCK_BLOCK = 3;
+
+// Block at the start of which the audio is restored, long after the attack is over.
+static const size_t UNDUCK_BLOCK = 20;
+
+// Number of blocks processed.
+static const size_t BLOCK_COUNT = 80;
+
+// Tolerance on a gain, for the rounding of the ramp steps.
+static const float TOLERANCE = 1e-5f;
+
+/**
+ * Runs a stream of full scale samples through a @c DuckingStage, ducking it from the bus at the start of
+ * @c DUCK_BLOCK and restoring it at the start of @c UNDUCK_BLOCK.
+ *
+ * @param numChannels The number of channels of the stream.
+ * @param[out] gains The gain applied to each frame.
+ * @return @c true if every channel of each frame got the same gain and the bus drove the stage, else @c false.
+ */
+static bool runStage(unsigned int numChannels, std::vector<float>* gains) {
+    auto bus = std::make_shared<BluetoothEventBus>();
+    auto stage = std::make_shared<DuckingStage>(DUCKED_GAIN, ATTACK, RELEASE);
+    bus->addListener({BluetoothEventType::AUDIO_DUCKING_CHANGED}, stage);
+
+    AudioFormat inputFormat = ConversionStage::getFloatFormat(numChannels);
+    inputFormat.sampleRateHz = SAMPLE_RATE;
+    AudioFormat outputFormat;
+    size_t maxOutputFrames = 0;
+    if (!stage->configure(inputFormat, BLOCK_FRAMES, &outputFormat, &maxOutputFrames)) {
+        printf("configure failed\n");
+        return false;
+    }
+
+    std::vector<float> block(BLOCK_FRAMES * numChannels);
+    for (size_t i = 0; i < BLOCK_COUNT; ++i) {
+        if (DUCK_BLOCK == i || UNDUCK_BLOCK == i) {
+            bus->sendEvent(AudioDuckingChangedEvent(DUCK_BLOCK == i));
+            if (stage->isDucked() != (DUCK_BLOCK == i)) {
+                printf("event not heard: block %zu\n", i);
+                return false;
+            }
+        }
+
+        std::fill(block.begin(), block.end(), 1.0f);
+        unsigned char* data = reinterpret_cast<unsigned char*>(block.data());
+        if (stage->process(data, data, BLOCK_FRAMES) != BLOCK_FRAMES) {
+            printf("process failed: block %zu\n", i);
+            return false;
+        }
+
+        for (size_t frame = 0; frame < BLOCK_FRAMES; ++frame) {
+            for (unsigned int channel = 1; channel < numChannels; ++channel) {
+                if (block[frame * numChannels + channel] != block[frame * numChannels]) {
+                    printf("channels differ: block %zu, frame %zu\n", i, frame);
+                    return false;
+                }
+            }
+            gains->push_back(block[frame * numChannels]);
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks that a ramp starting at a frame lands on its target after the number of frames of its duration, and moves
+ * monotonically until then.
+ *
+ * @param gains The gain applied to each frame.
+ * @param start The first frame of the ramp.
+ * @param from The gain before the ramp.
+ * @param to The target of the ramp.
+ * @param duration The duration of the ramp.
+ * @return @c true if the ramp is right, else @c false.
+ */
+static bool checkRamp(
+    const std::vector<float>& gains,
+    size_t start,
+    float from,
+    float to,
+    std::chrono::milliseconds duration) {
+    const size_t rampFrames = SAMPLE_RATE * duration.count() / 1000;
+    const size_t end = start + rampFrames - 1;
+
+    if (std::fabs(gains[start - 1] - from) > TOLERANCE) {
+        printf("ramp started early: frame %zu, gain %f\n", start - 1, gains[start - 1]);
+        return false;
+    }
+    for (size_t frame = start; frame < end; ++frame) {
+        const bool moving = from > to ? gains[frame] < gains[frame - 1] : gains[frame] > gains[frame - 1];
+        if (!moving || std::fabs(gains[frame] - to) <= TOLERANCE) {
+            printf("ramp off course: frame %zu, gain %f\n", frame, gains[frame]);
+            return false;
+        }
+    }
+    if (std::fabs(gains[end] - to) > TOLERANCE || std::fabs(gains[end + 1] - to) > TOLERANCE) {
+        printf("ramp missed its target: frame %zu, gain %f, expected %f\n", end, gains[end], to);
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    bool passed = true;
+    for (unsigned int numChannels : {1u, 2u, 3u}) {
+        std::vector<float> gains;
+        bool ok = runStage(numChannels, &gains) &&
+                  checkRamp(gains, DUCK_BLOCK * BLOCK_FRAMES, 1.0f, DUCKED_GAIN, ATTACK) &&
+                  checkRamp(gains, UNDUCK_BLOCK * BLOCK_FRAMES, DUCKED_GAIN, 1.0f, RELEASE);
+        printf("%u channels: %s\n", numChannels, ok ? "passed" : "FAILED");
+        passed = passed && ok;
+    }
+    return passed ? 0 : 1;
+}
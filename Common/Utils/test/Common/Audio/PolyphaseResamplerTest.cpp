@@ -0,0 +1,203 @@
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/Utils/Audio/PolyphaseResampler.h"
+
+using namespace deviceClientSDK::common::utils::audio;
+
+// Sample rate of the output, the one of speech recognition.
+static const unsigned int OUTPUT_RATE = 16000;
+
+// Duration of the input signal, in seconds.
+static const double DURATION = 1.0;
+
+// Frequency of the tone resampled, well within the pass band.
+static const double TONE_FREQUENCY = 1000.0;
+
+// Frequency of a tone above the output Nyquist frequency, which the filter must remove.
+static const double ALIAS_FREQUENCY = 10000.0;
+
+// Amplitude of the tones.
+static const double AMPLITUDE = 0.5;
+
+// Largest relative error on the level of the tone, for the pass band ripple.
+static const double LEVEL_TOLERANCE = 0.01;
+
+// Largest level of what is left after taking the tone out of the output, relative to the tone: -60dB.
+static const double RESIDUAL_TOLERANCE = 0.001;
+
+// Largest level of the aliased tone, relative to the input: -60dB.
+static const double ALIAS_TOLERANCE = 0.001;
+
+// Sizes of the blocks fed to the resampler, odd and prime so that the blocks never line up with the ratio.
+static const size_t BLOCK_SIZES[] = {1, 7, 97, 441, 1021, 4801};
+
+/**
+ * Generates a tone.
+ *
+ * @param rate The sample rate.
+ * @param frequency The frequency of the tone.
+ * @return @c DURATION seconds of the tone, at @c AMPLITUDE.
+ */
+static std::vector<float> makeTone(unsigned int rate, double frequency) {
+    std::vector<float> tone(static_cast<size_t>(rate * DURATION));
+    for (size_t i = 0; i < tone.size(); ++i) {
+        tone[i] = static_cast<float>(AMPLITUDE * std::sin(2.0 * M_PI * frequency * i / rate));
+    }
+    return tone;
+}
+
+/**
+ * Resamples a signal in blocks of a given size.
+ *
+ * @param resampler The resampler, which is reset first.
+ * @param input The signal.
+ * @param blockSize The number of samples of each block.
+ * @return The output of the resampler, or an empty vector if a block produced more than @c getMaxOutputFrames().
+ */
+static std::vector<float> resample(PolyphaseResampler* resampler, const std::vector<float>& input, size_t blockSize) {
+    resampler->reset();
+    std::vector<float> output;
+    std::vector<float> block(resampler->getMaxOutputFrames(blockSize));
+    for (size_t offset = 0; offset < input.size(); offset += blockSize) {
+        const size_t frames = std::min(blockSize, input.size() - offset);
+        const size_t produced = resampler->process(input.data() + offset, frames, block.data());
+        if (produced > resampler->getMaxOutputFrames(frames)) {
+            printf("block of %zu produced %zu samples\n", frames, produced);
+            return std::vector<float>();
+        }
+        output.insert(output.end(), block.begin(), block.begin() + produced);
+    }
+    return output;
+}
+
+/**
+ * Fits a tone of a given frequency to a signal, past the delay of the filter, by least squares.
+ *
+ * @param signal The signal.
+ * @param start The first sample fitted.
+ * @param rate The sample rate of the signal.
+ * @param frequency The frequency of the tone.
+ * @param[out] residual The RMS level of the signal minus the tone.
+ * @return The amplitude of the tone.
+ */
+static double fitTone(
+    const std::vector<float>& signal,
+    size_t start,
+    unsigned int rate,
+    double frequency,
+    double* residual) {
+    double sinSum = 0.0;
+    double cosSum = 0.0;
+    for (size_t i = start; i < signal.size(); ++i) {
+        const double phase = 2.0 * M_PI * frequency * i / rate;
+        sinSum += signal[i] * std::sin(phase);
+        cosSum += signal[i] * std::cos(phase);
+    }
+    const double count = static_cast<double>(signal.size() - start);
+    const double sinAmplitude = 2.0 * sinSum / count;
+    const double cosAmplitude = 2.0 * cosSum / count;
+
+    double energy = 0.0;
+    for (size_t i = start; i < signal.size(); ++i) {
+        const double phase = 2.0 * M_PI * frequency * i / rate;
+        const double error = signal[i] - sinAmplitude * std::sin(phase) - cosAmplitude * std::cos(phase);
+        energy += error * error;
+    }
+    *residual = std::sqrt(energy / count);
+    return std::sqrt(sinAmplitude * sinAmplitude + cosAmplitude * cosAmplitude);
+}
+
+/**
+ * Returns the RMS level of a signal, past the delay of the filter.
+ *
+ * @param signal The signal.
+ * @param start The first sample measured.
+ * @return The RMS level.
+ */
+static double rms(const std::vector<float>& signal, size_t start) {
+    double energy = 0.0;
+    for (size_t i = start; i < signal.size(); ++i) {
+        energy += static_cast<double>(signal[i]) * signal[i];
+    }
+    return std::sqrt(energy / (signal.size() - start));
+}
+
+/**
+ * Resamples a tone to @c OUTPUT_RATE in blocks of every size of @c BLOCK_SIZES, and checks that the output is the same
+ * tone at the same level, that the output does not depend on the block size, and that a tone above the output Nyquist
+ * frequency is filtered out.
+ *
+ * @param inputRate The sample rate of the input.
+ * @return @c true if the output is right.
+ */
+static bool testRate(unsigned int inputRate) {
+    auto resampler = PolyphaseResampler::create(inputRate, OUTPUT_RATE);
+    if (!resampler) {
+        printf("create failed\n");
+        return false;
+    }
+
+    // Past the delay of the filter, in output samples, with some margin.
+    const size_t settled = resampler->getTapsPerPhase() * 2;
+    const std::vector<float> tone = makeTone(inputRate, TONE_FREQUENCY);
+    const size_t expectedFrames = tone.size() * OUTPUT_RATE / inputRate;
+
+    bool ok = true;
+    std::vector<float> reference;
+    for (size_t blockSize : BLOCK_SIZES) {
+        std::vector<float> output = resample(resampler.get(), tone, blockSize);
+        if (output.size() + 1 < expectedFrames || output.size() > expectedFrames + 1) {
+            printf("block size %zu: %zu samples out, %zu expected\n", blockSize, output.size(), expectedFrames);
+            ok = false;
+            continue;
+        }
+        if (reference.empty()) {
+            reference = output;
+        } else if (output != reference) {
+            printf("block size %zu: output differs from block size %zu\n", blockSize, BLOCK_SIZES[0]);
+            ok = false;
+        }
+    }
+    if (reference.size() <= settled) {
+        return false;
+    }
+
+    // The delay of the filter is not a whole number of output samples, so the phase of the tone is fitted too.
+    double residual = 0.0;
+    const double level = fitTone(reference, settled, OUTPUT_RATE, TONE_FREQUENCY, &residual);
+    if (std::fabs(level - AMPLITUDE) > AMPLITUDE * LEVEL_TOLERANCE || residual > AMPLITUDE * RESIDUAL_TOLERANCE) {
+        printf("tone level %f, residual %f\n", level, residual);
+        ok = false;
+    }
+
+    const double aliasLevel = rms(resample(resampler.get(), makeTone(inputRate, ALIAS_FREQUENCY), 441), settled);
+    if (aliasLevel > AMPLITUDE * ALIAS_TOLERANCE) {
+        printf("alias level %f\n", aliasLevel);
+        ok = false;
+    }
+    return ok;
+}
+
+/**
+ * Reports the outcome of a test.
+ *
+ * @param name The name of the test.
+ * @param ok Whether the test passed.
+ * @return @c ok.
+ */
+static bool report(const std::string& name, bool ok) {
+    printf("%-44s %s\n", name.c_str(), ok ? "passed" : "FAILED");
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    for (unsigned int inputRate : {44100u, 48000u}) {
+        ok = report(std::to_string(inputRate) + " to " + std::to_string(OUTPUT_RATE), testRate(inputRate)) && ok;
+    }
+    return ok ? 0 : 1;
+}
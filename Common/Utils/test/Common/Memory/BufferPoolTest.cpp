@@ -0,0 +1,115 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/Utils/Memory/BufferPool.h"
+
+using namespace deviceClientSDK::common::utils;
+
+// Number of bytes of each buffer of the pool.
+static const size_t POOL_BUFFER_SIZE = 256;
+
+// Number of buffers of the pool, fewer than the threads, so that the free list is always contended.
+static const size_t POOL_BUFFER_COUNT = 3;
+
+// Number of threads sharing the pool.
+static const size_t POOL_THREADS = 8;
+
+// Number of buffers each thread acquires.
+static const size_t POOL_ACQUIRES = 100000;
+
+/**
+ * Has @c POOL_THREADS threads acquire and drop the buffers of a pool with fewer buffers than threads, so that the
+ * tagged free list is popped and pushed concurrently all the time, which is where an ABA problem would hand one buffer
+ * to two threads.  Each thread fills the buffers it holds with its own pattern, shares them through copied handles,
+ * and checks that the pattern is still there before dropping them.
+ *
+ * @return @c true if no buffer was ever held by two threads, and every buffer returned to the pool.
+ */
+static bool testPool() {
+    memory::BufferPool pool(POOL_BUFFER_SIZE, POOL_BUFFER_COUNT);
+    std::atomic<bool> ok{true};
+    std::atomic<size_t> empty{0};
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < POOL_THREADS; ++i) {
+        threads.push_back(std::thread([&pool, &ok, &empty, i] {
+            const uint8_t pattern = static_cast<uint8_t>(i + 1);
+            for (size_t n = 0; n < POOL_ACQUIRES && ok; ++n) {
+                memory::BufferPool::Buffer buffer = pool.acquire();
+                if (!buffer) {
+                    ++empty;
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (buffer.useCount() != 1 || buffer.size() != 0 || buffer.capacity() != POOL_BUFFER_SIZE) {
+                    printf("buffer acquired in use\n");
+                    ok = false;
+                }
+
+                memset(buffer.data(), pattern, POOL_BUFFER_SIZE);
+                buffer.setSize(POOL_BUFFER_SIZE);
+                memory::BufferPool::Buffer copy = buffer;
+                buffer.reset();
+                if (0 == n % 16) {
+                    std::this_thread::yield();
+                }
+
+                for (size_t byte = 0; byte < POOL_BUFFER_SIZE; ++byte) {
+                    if (copy.data()[byte] != pattern) {
+                        printf("buffer held by two threads\n");
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (pool.getAvailableCount() != POOL_BUFFER_COUNT) {
+        printf("buffers lost: %zu available\n", pool.getAvailableCount());
+        ok = false;
+    }
+
+    // Every buffer is back on the free list: all of them can be acquired at once, and no more.
+    std::vector<memory::BufferPool::Buffer> buffers;
+    for (size_t i = 0; i < POOL_BUFFER_COUNT; ++i) {
+        buffers.push_back(pool.acquire());
+        if (!buffers.back()) {
+            printf("free list lost a buffer\n");
+            ok = false;
+        }
+    }
+    if (pool.acquire()) {
+        printf("free list handed out a buffer twice\n");
+        ok = false;
+    }
+    if (0 == empty) {
+        printf("the pool was never exhausted\n");
+    }
+    return ok;
+}
+
+/**
+ * Reports the outcome of a test.
+ *
+ * @param name The name of the test.
+ * @param ok Whether the test passed.
+ * @return @c ok.
+ */
+static bool report(const std::string& name, bool ok) {
+    printf("%-44s %s\n", name.c_str(), ok ? "passed" : "FAILED");
+    return ok;
+}
+
+int main() {
+    bool ok = report("BufferPool, " + std::to_string(POOL_THREADS) + " threads", testPool());
+    return ok ? 0 : 1;
+}
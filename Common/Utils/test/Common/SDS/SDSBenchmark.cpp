@@ -0,0 +1,141 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Common/Utils/SDS/InProcessSDS.h"
+
+using namespace deviceClientSDK::common::utils::sds;
+
+// Size of a sample, in bytes.
+static const size_t WORD_SIZE = sizeof(int16_t);
+
+// Size of the stream, in samples.
+static const size_t BUFFER_WORDS = 64 * 1024;
+
+// Number of samples moved by each write and read (10ms of 16kHz audio).
+static const size_t CHUNK_WORDS = 160;
+
+// Number of chunks written in each run.
+static const size_t CHUNKS = 100000;
+
+// Reader counts to compare.
+static const size_t READER_COUNTS[] = {1, 4, 16, 32};
+
+/**
+ * Streams @c CHUNKS chunks from a @c BLOCKING writer to @c nReaders @c NONBLOCKING readers, all on this thread.  The
+ * writer writes a chunk and then every reader reads it, so this measures the bookkeeping cost of @c read() and
+ * @c write() without any thread switches.
+ *
+ * @param nReaders The number of readers.
+ * @return The time the run took.
+ */
+static std::chrono::nanoseconds runSingleThreaded(size_t nReaders) {
+    auto buffer = std::make_shared<InProcessSDS::Buffer>(
+        InProcessSDS::calculateBufferSize(BUFFER_WORDS, WORD_SIZE, nReaders));
+    auto stream = InProcessSDS::create(buffer, WORD_SIZE, nReaders);
+    auto writer = stream->createWriter(InProcessSDS::Writer::Policy::BLOCKING);
+
+    std::vector<std::unique_ptr<InProcessSDS::Reader>> readers;
+    for (size_t i = 0; i < nReaders; ++i) {
+        readers.push_back(stream->createReader(InProcessSDS::Reader::Policy::NONBLOCKING));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    int16_t chunk[CHUNK_WORDS] = {0};
+    for (size_t i = 0; i < CHUNKS; ++i) {
+        if (writer->write(chunk, CHUNK_WORDS) != static_cast<ssize_t>(CHUNK_WORDS)) {
+            printf("write failed\n");
+            break;
+        }
+        for (auto& reader : readers) {
+            if (reader->read(chunk, CHUNK_WORDS) != static_cast<ssize_t>(CHUNK_WORDS)) {
+                printf("read failed\n");
+                break;
+            }
+        }
+    }
+
+    return std::chrono::steady_clock::now() - start;
+}
+
+/**
+ * Streams @c CHUNKS chunks from a @c BLOCKING writer to @c nReaders @c BLOCKING readers, each on its own thread.
+ *
+ * @param nReaders The number of readers.
+ * @return The time the run took.
+ */
+static std::chrono::nanoseconds runThreaded(size_t nReaders) {
+    auto buffer = std::make_shared<InProcessSDS::Buffer>(
+        InProcessSDS::calculateBufferSize(BUFFER_WORDS, WORD_SIZE, nReaders));
+    auto stream = InProcessSDS::create(buffer, WORD_SIZE, nReaders);
+    auto writer = stream->createWriter(InProcessSDS::Writer::Policy::BLOCKING);
+
+    std::vector<std::unique_ptr<InProcessSDS::Reader>> readers;
+    for (size_t i = 0; i < nReaders; ++i) {
+        readers.push_back(stream->createReader(InProcessSDS::Reader::Policy::BLOCKING));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> readerThreads;
+    for (auto& reader : readers) {
+        auto rawReader = reader.get();
+        readerThreads.push_back(std::thread([rawReader] {
+            int16_t chunk[CHUNK_WORDS];
+            while (rawReader->read(chunk, CHUNK_WORDS) > 0) {
+            }
+        }));
+    }
+
+    int16_t chunk[CHUNK_WORDS] = {0};
+    for (size_t i = 0; i < CHUNKS; ++i) {
+        size_t written = 0;
+        while (written < CHUNK_WORDS) {
+            auto result = writer->write(chunk + written, CHUNK_WORDS - written);
+            if (result <= 0) {
+                printf("write failed: %zd\n", result);
+                break;
+            }
+            written += result;
+        }
+    }
+    writer->close();
+
+    for (auto& thread : readerThreads) {
+        thread.join();
+    }
+    return std::chrono::steady_clock::now() - start;
+}
+
+/**
+ * Prints one line of results.
+ *
+ * @param nReaders The number of readers.
+ * @param elapsed The time the run took.
+ */
+static void report(size_t nReaders, std::chrono::nanoseconds elapsed) {
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    double words = static_cast<double>(CHUNKS * CHUNK_WORDS);
+    double reads = static_cast<double>(CHUNKS * nReaders);
+    printf(
+        "%8zu %12.1f %14.2f %14.1f\n", nReaders, seconds * 1000, words / seconds / 1e6, elapsed.count() / reads);
+}
+
+int main() {
+    printf("Single thread (bookkeeping cost):\n");
+    printf("%8s %12s %14s %14s\n", "readers", "time (ms)", "Mwords/s", "ns/read");
+    for (auto nReaders : READER_COUNTS) {
+        report(nReaders, runSingleThreaded(nReaders));
+    }
+
+    printf("One thread per reader:\n");
+    printf("%8s %12s %14s %14s\n", "readers", "time (ms)", "Mwords/s", "ns/read");
+    for (auto nReaders : READER_COUNTS) {
+        report(nReaders, runThreaded(nReaders));
+    }
+    return 0;
+}
@@ -0,0 +1,536 @@
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/Utils/SDS/FileBackedSDS.h"
+#include "Common/Utils/SDS/InProcessSDS.h"
+
+using namespace deviceClientSDK::common::utils::sds;
+
+// Size of a word; each word holds its own index in the stream, so that a word out of place is caught.
+static const size_t WORD_SIZE = sizeof(uint32_t);
+
+// Size of the stream, in words, small enough to wrap many times in a run.
+static const size_t BUFFER_WORDS = 1024;
+
+// Largest number of words moved by one write or read.
+static const size_t MAX_CHUNK_WORDS = 300;
+
+// Number of words written in each run.
+static const size_t TOTAL_WORDS = 200000;
+
+// Reader counts to test; a single reader takes the futex path.
+static const size_t READER_COUNTS[] = {1, 2, 4};
+
+// Time after which a blocked writer or reader is taken to have missed its wake up.
+static const std::chrono::milliseconds TIMEOUT{5000};
+
+// Number of words a watermarked reader waits for.
+static const size_t WATERMARK_WORDS = 64;
+
+// Time a watermarked reader holds back data waiting for the watermark.
+static const std::chrono::milliseconds WATERMARK_LATENCY{2};
+
+/// Counters of a reader.
+struct ReaderResult {
+    /// Whether every word read was in its place.
+    bool ok = true;
+
+    /// Number of words read.
+    size_t words = 0;
+
+    /// Number of overruns by the writer.
+    size_t overruns = 0;
+
+    /// Position of the reader at the end.
+    size_t position = 0;
+};
+
+/**
+ * Checks that the words of a span hold their index in the stream.
+ *
+ * @param data The words.
+ * @param nWords The number of words.
+ * @param position The index of the first word.
+ * @return @c true if every word is in its place.
+ */
+static bool checkWords(const uint8_t* data, size_t nWords, size_t position) {
+    for (size_t i = 0; i < nWords; ++i) {
+        uint32_t word;
+        memcpy(&word, data + i * WORD_SIZE, WORD_SIZE);
+        if (word != static_cast<uint32_t>(position + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Fills a span with the index of each of its words in the stream.
+ *
+ * @param data The words.
+ * @param nWords The number of words.
+ * @param position The index of the first word.
+ */
+static void fillWords(uint8_t* data, size_t nWords, size_t position) {
+    for (size_t i = 0; i < nWords; ++i) {
+        uint32_t word = static_cast<uint32_t>(position + i);
+        memcpy(data + i * WORD_SIZE, &word, WORD_SIZE);
+    }
+}
+
+/**
+ * Writes @c TOTAL_WORDS words in chunks of random sizes, then closes the writer.
+ *
+ * @param writer The writer.
+ * @param useReserve Whether to write with @c reserve() and @c commit(), committing less than reserved at times,
+ *     rather than with @c write().
+ * @param seed The seed of the chunk sizes.
+ * @param[out] wrapped Set if a reservation was split at the wrap.
+ * @return @c true if every word was written.
+ */
+template <typename SDS>
+static bool writeWords(typename SDS::Writer* writer, bool useReserve, unsigned int seed, bool* wrapped) {
+    std::minstd_rand random(seed);
+    std::vector<uint8_t> chunk(MAX_CHUNK_WORDS * WORD_SIZE);
+    size_t position = 0;
+    auto lastProgress = std::chrono::steady_clock::now();
+    while (position < TOTAL_WORDS) {
+        size_t nWords = std::min<size_t>(1 + random() % MAX_CHUNK_WORDS, TOTAL_WORDS - position);
+        ssize_t result;
+        if (useReserve) {
+            typename SDS::Writer::Span first, second;
+            result = writer->reserve(nWords, &first, &second, TIMEOUT);
+            if (result > 0) {
+                fillWords(first.data, first.nWords, position);
+                fillWords(second.data, second.nWords, position + first.nWords);
+                *wrapped = *wrapped || second.nWords > 0;
+                size_t committed = (result > 1 && 0 == random() % 4) ? result - 1 : result;
+                result = writer->commit(committed);
+            }
+        } else {
+            fillWords(chunk.data(), nWords, position);
+            result = writer->write(chunk.data(), nWords, TIMEOUT);
+        }
+
+        if (SDS::Writer::Error::WOULDBLOCK == result) {
+            // The space freed by the readers must be seen without them waking the writer up.
+            if (std::chrono::steady_clock::now() - lastProgress > TIMEOUT) {
+                printf("writer starved: position %zu\n", position);
+                writer->close();
+                return false;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        if (result <= 0) {
+            printf("write failed: position %zu, error %zd\n", position, result);
+            writer->close();
+            return false;
+        }
+        position += result;
+        lastProgress = std::chrono::steady_clock::now();
+    }
+    writer->close();
+    return true;
+}
+
+/**
+ * Reads the stream until the writer closes, checking every word, with @c read() or @c borrow().
+ *
+ * @param reader The reader.
+ * @param useBorrow Whether to read with @c borrow() and @c release(), releasing less than borrowed at times.
+ * @param slow Whether to sleep now and then, so that the writer has to wait for this reader.
+ * @param seed The seed of the chunk sizes.
+ * @param[out] result The counters of the reader.
+ */
+static void readWords(
+    InProcessSDS::Reader* reader,
+    bool useBorrow,
+    bool slow,
+    unsigned int seed,
+    ReaderResult* result) {
+    std::minstd_rand random(seed);
+    std::vector<uint8_t> chunk(MAX_CHUNK_WORDS * WORD_SIZE);
+    for (size_t i = 0;; ++i) {
+        if (slow && 0 == i % 64) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+
+        size_t nWords = 1 + random() % MAX_CHUNK_WORDS;
+        size_t position = reader->tell();
+        ssize_t read;
+        if (useBorrow) {
+            InProcessSDS::Reader::Span first, second;
+            read = reader->borrow(nWords, &first, &second, TIMEOUT);
+            if (read > 0) {
+                bool inPlace = checkWords(first.data, first.nWords, position) &&
+                               checkWords(second.data, second.nWords, position + first.nWords);
+                size_t released = (read > 1 && 0 == random() % 4) ? read - 1 : read;
+                read = reader->release(released);
+                // The words checked may have been overwritten while borrowed, which release() reports.
+                if (!inPlace && InProcessSDS::Reader::Error::OVERRUN != read) {
+                    printf("borrowed words out of place: position %zu\n", position);
+                    result->ok = false;
+                }
+            }
+        } else {
+            read = reader->read(chunk.data(), nWords, TIMEOUT);
+            if (read > 0 && !checkWords(chunk.data(), read, position)) {
+                printf("read words out of place: position %zu\n", position);
+                result->ok = false;
+            }
+        }
+
+        if (read > 0) {
+            result->words += read;
+        } else if (InProcessSDS::Reader::Error::OVERRUN == read) {
+            ++result->overruns;
+            reader->seek(0, InProcessSDS::Reader::Reference::BEFORE_WRITER);
+        } else if (InProcessSDS::Reader::Error::CLOSED == read) {
+            break;
+        } else {
+            printf("read failed: position %zu, error %zd\n", position, read);
+            result->ok = false;
+            break;
+        }
+    }
+    result->position = reader->tell();
+}
+
+/**
+ * Streams @c TOTAL_WORDS words from a writer to @c nReaders @c BLOCKING readers, each on its own thread.  Half of the
+ * readers borrow instead of reading, and half of them wait for a watermark, so that each reader is woken up on its
+ * own terms.  The first reader is slow, so that the writer waits for it while the others keep up.
+ *
+ * @param policy The policy of the writer.
+ * @param useReserve Whether the writer reserves and commits rather than writes.
+ * @param nReaders The number of readers.
+ * @return @c true if every reader read every word in place, or, for a @c NONBLOCKABLE writer, every word it was not
+ *     overrun on.
+ */
+static bool testPolicy(InProcessSDS::Writer::Policy policy, bool useReserve, size_t nReaders) {
+    auto buffer = std::make_shared<InProcessSDS::Buffer>(
+        InProcessSDS::calculateBufferSize(BUFFER_WORDS, WORD_SIZE, nReaders));
+    auto stream = InProcessSDS::create(buffer, WORD_SIZE, nReaders);
+    auto writer = stream->createWriter(policy);
+
+    std::vector<std::unique_ptr<InProcessSDS::Reader>> readers;
+    for (size_t i = 0; i < nReaders; ++i) {
+        readers.push_back(stream->createReader(InProcessSDS::Reader::Policy::BLOCKING));
+        if (1 == i % 2) {
+            readers.back()->setWakeWatermark(WATERMARK_WORDS, WATERMARK_LATENCY);
+        }
+    }
+
+    std::vector<ReaderResult> results(nReaders);
+    std::vector<std::thread> readerThreads;
+    for (size_t i = 0; i < nReaders; ++i) {
+        readerThreads.push_back(std::thread(
+            readWords, readers[i].get(), 1 == i % 2 || 1 == nReaders, 0 == i && nReaders > 1, i + 1, &results[i]));
+    }
+
+    bool wrapped = false;
+    bool ok = writeWords<InProcessSDS>(writer.get(), useReserve, 0, &wrapped);
+    for (auto& thread : readerThreads) {
+        thread.join();
+    }
+
+    if (useReserve && !wrapped) {
+        printf("no reservation was split at the wrap\n");
+        ok = false;
+    }
+    for (size_t i = 0; i < nReaders; ++i) {
+        ok = ok && results[i].ok && TOTAL_WORDS == results[i].position;
+        if (InProcessSDS::Writer::Policy::NONBLOCKABLE != policy &&
+            (results[i].overruns > 0 || TOTAL_WORDS != results[i].words)) {
+            printf("reader %zu lost data: read %zu, overruns %zu\n", i, results[i].words, results[i].overruns);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/**
+ * Streams @c TOTAL_WORDS words from a @c BLOCKING writer to @c nReaders @c NONBLOCKING readers, which are all served
+ * from this thread by polling their eventfds.  A reader is only read once its eventfd says so, until @c read() returns
+ * @c Error::WOULDBLOCK, so a missed wake up stalls the stream until the poll times out.
+ *
+ * @param nReaders The number of readers.
+ * @return @c true if every reader read every word in place.
+ */
+static bool testEventFD(size_t nReaders) {
+    auto buffer = std::make_shared<InProcessSDS::Buffer>(
+        InProcessSDS::calculateBufferSize(BUFFER_WORDS, WORD_SIZE, nReaders));
+    auto stream = InProcessSDS::create(buffer, WORD_SIZE, nReaders);
+    auto writer = stream->createWriter(InProcessSDS::Writer::Policy::BLOCKING);
+
+    std::vector<std::unique_ptr<InProcessSDS::Reader>> readers;
+    std::vector<pollfd> pollFDs;
+    for (size_t i = 0; i < nReaders; ++i) {
+        readers.push_back(stream->createReader(InProcessSDS::Reader::Policy::NONBLOCKING));
+        if (1 == i % 2) {
+            readers.back()->setWakeWatermark(WATERMARK_WORDS);
+        }
+        pollfd pollFD = {readers.back()->getEventFD(), POLLIN, 0};
+        if (pollFD.fd < 0) {
+            printf("getEventFD failed\n");
+            return false;
+        }
+        pollFDs.push_back(pollFD);
+    }
+
+    bool wrapped = false;
+    bool writeOk = false;
+    std::thread writerThread([&writer, &wrapped, &writeOk] {
+        writeOk = writeWords<InProcessSDS>(writer.get(), false, 0, &wrapped);
+    });
+
+    bool ok = true;
+    std::vector<uint8_t> chunk(MAX_CHUNK_WORDS * WORD_SIZE);
+    size_t open = nReaders;
+    while (ok && open > 0) {
+        int ready = poll(pollFDs.data(), pollFDs.size(), static_cast<int>(TIMEOUT.count()));
+        if (ready <= 0) {
+            printf("poll timed out: a wake up was missed\n");
+            ok = false;
+            break;
+        }
+        for (size_t i = 0; i < nReaders; ++i) {
+            if (!(pollFDs[i].revents & POLLIN)) {
+                continue;
+            }
+            while (true) {
+                size_t position = readers[i]->tell();
+                ssize_t read = readers[i]->read(chunk.data(), MAX_CHUNK_WORDS);
+                if (read > 0) {
+                    if (!checkWords(chunk.data(), read, position)) {
+                        printf("words out of place: reader %zu, position %zu\n", i, position);
+                        ok = false;
+                    }
+                    continue;
+                }
+                if (InProcessSDS::Reader::Error::CLOSED == read) {
+                    if (TOTAL_WORDS != position) {
+                        printf("reader %zu closed early: position %zu\n", i, position);
+                        ok = false;
+                    }
+                    // Stop polling this reader.
+                    pollFDs[i].fd = -1;
+                    --open;
+                } else if (InProcessSDS::Reader::Error::WOULDBLOCK != read) {
+                    printf("read failed: reader %zu, position %zu\n", i, position);
+                    ok = false;
+                }
+                break;
+            }
+        }
+    }
+
+    if (!ok) {
+        // Let the writer finish rather than wait for readers which are gone.
+        for (auto& reader : readers) {
+            reader->close(0, InProcessSDS::Reader::Reference::AFTER_READER);
+        }
+        readers.clear();
+    }
+    writerThread.join();
+    return ok && writeOk;
+}
+
+/**
+ * Leaves a file-backed stream behind as a crashed process would, with data written over the wrap and a reservation
+ * never committed, then recovers it.  A reader of the recovered stream must find the last @c getDataSize() words
+ * committed, minus the oldest ones the reservation overwrote, which are silenced, and a new writer must carry on after
+ * them.  A file with a broken header must not be recovered.
+ *
+ * @return @c true if the stream was recovered with its data.
+ */
+static bool testRecover() {
+    char path[] = "/tmp/SDSIntegrityTestXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        printf("mkstemp failed\n");
+        return false;
+    }
+    close(fd);
+
+    const size_t chunkWords = BUFFER_WORDS / 3;
+    const size_t committed = chunkWords * 10;
+    const size_t reserved = BUFFER_WORDS / 4;
+    {
+        auto buffer = SharedMemoryBuffer::createFile(path, FileBackedSDS::calculateBufferSize(BUFFER_WORDS, WORD_SIZE));
+        auto stream = FileBackedSDS::create(buffer, WORD_SIZE);
+        auto writer = stream->createWriter(FileBackedSDS::Writer::Policy::NONBLOCKABLE);
+        std::vector<uint8_t> chunk(chunkWords * WORD_SIZE);
+        for (size_t position = 0; position < committed; position += chunkWords) {
+            fillWords(chunk.data(), chunkWords, position);
+            writer->write(chunk.data(), chunkWords);
+        }
+
+        FileBackedSDS::Writer::Span first, second;
+        if (writer->reserve(reserved, &first, &second) > 0) {
+            memset(first.data, 0xff, first.nWords * WORD_SIZE);
+            memset(second.data, 0xff, second.nWords * WORD_SIZE);
+        }
+
+        // Crash: nothing is closed or unmapped.
+        writer.release();
+        stream.release();
+    }
+
+    bool ok = true;
+    {
+        auto buffer = SharedMemoryBuffer::openFile(path);
+        auto stream = buffer ? FileBackedSDS::recover(buffer) : nullptr;
+        if (!stream) {
+            printf("recover failed\n");
+            unlink(path);
+            return false;
+        }
+
+        auto reader = stream->createReader(FileBackedSDS::Reader::Policy::NONBLOCKING);
+        std::vector<uint8_t> chunk(BUFFER_WORDS * WORD_SIZE);
+        size_t position = reader->tell();
+        ssize_t read = reader->read(chunk.data(), BUFFER_WORDS);
+        const std::vector<uint8_t> silence(reserved * WORD_SIZE, 0);
+        if (position != committed - stream->getDataSize() || read != static_cast<ssize_t>(stream->getDataSize()) ||
+            0 != memcmp(chunk.data(), silence.data(), silence.size()) ||
+            !checkWords(chunk.data() + silence.size(), read - reserved, position + reserved)) {
+            printf("recovered data wrong: position %zu, read %zd\n", position, read);
+            ok = false;
+        }
+
+        auto writer = stream->createWriter(FileBackedSDS::Writer::Policy::NONBLOCKABLE);
+        if (!writer || writer->tell() != committed) {
+            printf("recovered writer misplaced\n");
+            ok = false;
+        } else {
+            fillWords(chunk.data(), BUFFER_WORDS / 2, committed);
+            writer->write(chunk.data(), BUFFER_WORDS / 2);
+            read = reader->read(chunk.data(), BUFFER_WORDS);
+            ok = ok && read == static_cast<ssize_t>(BUFFER_WORDS / 2) && checkWords(chunk.data(), read, committed);
+        }
+    }
+
+    {
+        auto buffer = SharedMemoryBuffer::openFile(path);
+        memset(buffer->data(), 0, sizeof(uint32_t));
+        if (FileBackedSDS::recover(buffer)) {
+            printf("recovered a broken header\n");
+            ok = false;
+        }
+    }
+
+    unlink(path);
+    return ok;
+}
+
+/**
+ * Seeks a reader back behind @c oldestUnconsumedCursor, which the writer has brought up to date, and checks that an
+ * @c ALL_OR_NOTHING writer does not overwrite the words the reader seeked back to.
+ *
+ * @return @c true if the writer was held off and the reader read the words in place.
+ */
+static bool testBackwardSeek() {
+    const size_t nReaders = 2;
+    auto buffer = std::make_shared<InProcessSDS::Buffer>(
+        InProcessSDS::calculateBufferSize(BUFFER_WORDS, WORD_SIZE, nReaders));
+    auto stream = InProcessSDS::create(buffer, WORD_SIZE, nReaders);
+    auto writer = stream->createWriter(InProcessSDS::Writer::Policy::ALL_OR_NOTHING);
+    std::vector<std::unique_ptr<InProcessSDS::Reader>> readers;
+    for (size_t i = 0; i < nReaders; ++i) {
+        readers.push_back(stream->createReader(InProcessSDS::Reader::Policy::NONBLOCKING));
+    }
+
+    std::vector<uint8_t> chunk(BUFFER_WORDS * WORD_SIZE);
+    size_t position = 0;
+    auto writeChunk = [&writer, &chunk, &position](size_t nWords) {
+        fillWords(chunk.data(), nWords, position);
+        ssize_t result = writer->write(chunk.data(), nWords);
+        if (result > 0) {
+            position += result;
+        }
+        return result;
+    };
+
+    // Fill the buffer, read it all, and write again so that the writer brings oldestUnconsumedCursor up to date.
+    bool ok = writeChunk(BUFFER_WORDS) == static_cast<ssize_t>(BUFFER_WORDS);
+    for (auto& reader : readers) {
+        ok = reader->read(chunk.data(), BUFFER_WORDS) == static_cast<ssize_t>(BUFFER_WORDS) && ok;
+    }
+    ok = writeChunk(BUFFER_WORDS / 2) == static_cast<ssize_t>(BUFFER_WORDS / 2) && ok;
+    if (!ok) {
+        printf("backward seek setup failed\n");
+        return false;
+    }
+
+    // Seek back within the buffer, behind oldestUnconsumedCursor; the next write would overwrite the seeked words.
+    const size_t seekPosition = position - BUFFER_WORDS + BUFFER_WORDS / 8;
+    if (!readers[0]->seek(seekPosition, InProcessSDS::Reader::Reference::ABSOLUTE)) {
+        printf("backward seek failed\n");
+        return false;
+    }
+    ssize_t result = writeChunk(BUFFER_WORDS / 2);
+    if (InProcessSDS::Writer::Error::WOULDBLOCK != result) {
+        printf("write over a backward seek: result %zd\n", result);
+        ok = false;
+    }
+
+    const size_t nWords = BUFFER_WORDS / 4;
+    ssize_t read = readers[0]->read(chunk.data(), nWords);
+    if (read != static_cast<ssize_t>(nWords) || !checkWords(chunk.data(), nWords, seekPosition)) {
+        printf("read after a backward seek: result %zd\n", read);
+        ok = false;
+    }
+    return ok;
+}
+
+/**
+ * Reports the outcome of a test.
+ *
+ * @param name The name of the test.
+ * @param ok Whether the test passed.
+ * @return @c ok.
+ */
+static bool report(const std::string& name, bool ok) {
+    printf("%-44s %s\n", name.c_str(), ok ? "passed" : "FAILED");
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    const struct {
+        const char* name;
+        InProcessSDS::Writer::Policy policy;
+    } policies[] = {
+        {"NONBLOCKABLE", InProcessSDS::Writer::Policy::NONBLOCKABLE},
+        {"ALL_OR_NOTHING", InProcessSDS::Writer::Policy::ALL_OR_NOTHING},
+        {"BLOCKING", InProcessSDS::Writer::Policy::BLOCKING},
+    };
+    for (auto& policy : policies) {
+        for (auto nReaders : READER_COUNTS) {
+            for (bool useReserve : {false, true}) {
+                std::string name = std::string(policy.name) + (useReserve ? " reserve, " : " write, ") +
+                                   std::to_string(nReaders) + " readers";
+                ok = report(name, testPolicy(policy.policy, useReserve, nReaders)) && ok;
+            }
+        }
+    }
+    for (auto nReaders : READER_COUNTS) {
+        ok = report("eventfd, " + std::to_string(nReaders) + " readers", testEventFD(nReaders)) && ok;
+    }
+    ok = report("FileBackedSDS recover", testRecover()) && ok;
+    ok = report("backward seek", testBackwardSeek()) && ok;
+    return ok ? 0 : 1;
+}
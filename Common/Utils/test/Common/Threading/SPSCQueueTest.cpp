@@ -0,0 +1,88 @@
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "Common/Utils/Threading/SPSCQueue.h"
+
+using namespace deviceClientSDK::common::utils;
+
+// Number of values handed through the queue in each run.
+static const uint64_t QUEUE_VALUES = 1000000;
+
+// Queue capacities to test; a small ring is full or empty most of the time, so that every push and pop races.
+static const size_t QUEUE_CAPACITIES[] = {1, 7, 1024};
+
+/**
+ * Hands @c QUEUE_VALUES increasing values from a producer thread to a consumer thread, which checks that it gets every
+ * value once and in order.  The values are moved through the queue in a @c std::unique_ptr, so that a value copied
+ * instead of moved, or popped twice, is caught.
+ *
+ * @param capacity The capacity of the queue.
+ * @return @c true if every value went through in order.
+ */
+static bool testQueue(size_t capacity) {
+    threading::SPSCQueue<std::unique_ptr<uint64_t>> queue(capacity);
+    if (queue.capacity() != capacity) {
+        printf("capacity %zu instead of %zu\n", queue.capacity(), capacity);
+        return false;
+    }
+
+    std::thread producer([&queue] {
+        for (uint64_t value = 0; value < QUEUE_VALUES; ++value) {
+            std::unique_ptr<uint64_t> item(new uint64_t(value));
+            while (!queue.push(std::move(item))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    bool ok = true;
+    for (uint64_t expected = 0; expected < QUEUE_VALUES;) {
+        std::unique_ptr<uint64_t> item;
+        if (!queue.pop(&item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        // Keep popping after a failure, so that the producer is not left blocked on a full queue.
+        if (ok && (!item || *item != expected)) {
+            printf("value out of order: expected %llu\n", static_cast<unsigned long long>(expected));
+            ok = false;
+        }
+        if (ok && queue.size() > capacity) {
+            printf("size %zu over capacity %zu\n", queue.size(), capacity);
+            ok = false;
+        }
+        ++expected;
+    }
+
+    producer.join();
+
+    std::unique_ptr<uint64_t> item;
+    if (ok && (queue.pop(&item) || 0 != queue.size())) {
+        printf("queue not empty at the end\n");
+        ok = false;
+    }
+    return ok;
+}
+
+/**
+ * Reports the outcome of a test.
+ *
+ * @param name The name of the test.
+ * @param ok Whether the test passed.
+ * @return @c ok.
+ */
+static bool report(const std::string& name, bool ok) {
+    printf("%-44s %s\n", name.c_str(), ok ? "passed" : "FAILED");
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    for (auto capacity : QUEUE_CAPACITIES) {
+        ok = report("SPSCQueue, capacity " + std::to_string(capacity), testQueue(capacity)) && ok;
+    }
+    return ok ? 0 : 1;
+}